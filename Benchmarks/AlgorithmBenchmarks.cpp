@@ -0,0 +1,113 @@
+#include "../catch.hpp"
+#include "../Std/Algorithm.h"
+#include "../Std/Vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+namespace
+{
+	//In the L2 cache and far out of every cache
+	const size_t CACHED_BYTES = 64 * 1024;
+	const size_t MEMORY_BYTES = 64 * 1024 * 1024;
+	const size_t BYTES_PER_RUN = 256 * 1024 * 1024;
+
+	//Best of a few runs in milliseconds
+	double BestMilliseconds(const std::function<void()>& run)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		double best = -1.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			run();
+			const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			if (best < 0.0 || elapsed < best)
+				best = elapsed;
+		}
+		return best;
+	}
+
+	//GB/s of the algorithm with every SIMD level the CPU supports, None is the generic scalar loop
+	void ReportLevels(const char* pName, const size_t bytes, const std::function<void()>& run)
+	{
+		printf("%-24s", pName);
+		const SimdLevel levels[] = { SimdLevel::None, SimdLevel::Sse2, SimdLevel::Avx2 };
+		for (const SimdLevel level : levels)
+		{
+			if (level > DetectSimdLevel())
+			{
+				printf(" %10s", "-");
+				continue;
+			}
+			SetSimdLevel(level);
+			const double milliseconds = BestMilliseconds(run);
+			printf(" %10.2f", bytes / milliseconds / 1e6);
+		}
+		printf("\n");
+		SetSimdLevel(DetectSimdLevel());
+	}
+
+	//Values without the one that is searched for and replaced, the minimum and maximum are in the middle
+	template<typename T>
+	void ReportAlgorithms(const char* pType, const size_t bytes)
+	{
+		const size_t size = bytes / sizeof(T);
+		const size_t repeats = BYTES_PER_RUN > bytes ? BYTES_PER_RUN / bytes : 1;
+		Vector<T> values(size);
+		for (size_t i = 0; i < size; ++i)
+			values[i] = (T)(rand() % 100 + 1);
+		values[size / 2] = (T)0;
+		values[size / 2 + 1] = (T)101;
+
+		printf("\n%s, %zu KB %24s %10s %10s\n", pType, bytes / 1024, "None GB/s", "Sse2", "Avx2");
+		size_t checksum = 0;
+		ReportLevels("Find", repeats * bytes, [&]()
+		{
+			for (size_t i = 0; i < repeats; ++i)
+				checksum += Find(values.Begin(), values.End(), (T)127) - values.Begin();
+		});
+		ReportLevels("MinElement", repeats * bytes, [&]()
+		{
+			for (size_t i = 0; i < repeats; ++i)
+				checksum += MinElement(values.Begin(), values.End()) - values.Begin();
+		});
+		ReportLevels("MaxElement", repeats * bytes, [&]()
+		{
+			for (size_t i = 0; i < repeats; ++i)
+				checksum += MaxElement(values.Begin(), values.End()) - values.Begin();
+		});
+		ReportLevels("Replace", repeats * bytes, [&]()
+		{
+			for (size_t i = 0; i < repeats; ++i)
+				Replace(values.Begin(), values.End(), (T)127, (T)126);
+		});
+		Vector<T> filled(size);
+		ReportLevels("Fill", repeats * bytes, [&]()
+		{
+			for (size_t i = 0; i < repeats; ++i)
+				Fill(filled.Begin(), filled.End(), (T)i);
+		});
+		REQUIRE(checksum != 0);
+	}
+}
+
+TEST_CASE("Algorithm - SIMD kernels against the generic loops", "[.][Benchmark][Algorithm]")
+{
+	srand(25);
+	const size_t sizes[] = { CACHED_BYTES, MEMORY_BYTES };
+	for (const size_t bytes : sizes)
+	{
+		ReportAlgorithms<uint8_t>("uint8_t", bytes);
+		ReportAlgorithms<int16_t>("int16_t", bytes);
+		ReportAlgorithms<int32_t>("int32_t", bytes);
+		ReportAlgorithms<int64_t>("int64_t", bytes);
+		ReportAlgorithms<float>("float", bytes);
+		ReportAlgorithms<double>("double", bytes);
+	}
+}
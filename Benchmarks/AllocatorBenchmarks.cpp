@@ -0,0 +1,139 @@
+#include "../catch.hpp"
+#include "../Std/SmallObjectPool.h"
+#include "../Std/Map.h"
+#include <stdlib.h>
+#include <thread>
+#include <vector>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+namespace
+{
+	const int THREAD_COUNT = 4;
+	const size_t OBJECT_COUNT = 2000;
+	const int ROUND_COUNT = 50;
+
+	struct MallocAllocator
+	{
+		static void* Allocate(const size_t size) { return malloc(size); }
+		static void Free(void* pPtr, const size_t) { free(pPtr); }
+	};
+
+	struct PoolAllocator
+	{
+		static void* Allocate(const size_t size) { return SmallObjectPool::Allocate(size); }
+		static void Free(void* pPtr, const size_t size) { SmallObjectPool::Free(pPtr, size); }
+	};
+
+	//Sizes of tree and list nodes, and short strings
+	size_t ObjectSize(const size_t i)
+	{
+		return 16 + (i * 7919) % 240;
+	}
+
+	//Every thread builds up a set of objects and frees them in another order than they were allocated
+	template<typename Allocator>
+	void AllocateAndFree()
+	{
+		std::vector<std::thread> threads;
+		for (int t = 0; t < THREAD_COUNT; ++t)
+		{
+			threads.emplace_back([]()
+			{
+				std::vector<void*> objects(OBJECT_COUNT);
+				for (int round = 0; round < ROUND_COUNT; ++round)
+				{
+					for (size_t i = 0; i < OBJECT_COUNT; ++i)
+						objects[i] = Allocator::Allocate(ObjectSize(i));
+					for (size_t i = 0; i < OBJECT_COUNT; ++i)
+					{
+						const size_t index = (i * 997) % OBJECT_COUNT;
+						Allocator::Free(objects[index], ObjectSize(index));
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+	}
+
+	//Half of the threads allocate, the other half frees what they allocated
+	template<typename Allocator>
+	void ProducerConsumer()
+	{
+		std::vector<std::vector<void*>> objects(THREAD_COUNT / 2, std::vector<void*>(OBJECT_COUNT));
+		for (int round = 0; round < ROUND_COUNT / 5; ++round)
+		{
+			std::vector<std::thread> threads;
+			for (int t = 0; t < THREAD_COUNT / 2; ++t)
+			{
+				threads.emplace_back([t, &objects]()
+				{
+					for (size_t i = 0; i < OBJECT_COUNT; ++i)
+						objects[t][i] = Allocator::Allocate(ObjectSize(i));
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+			threads.clear();
+			for (int t = 0; t < THREAD_COUNT / 2; ++t)
+			{
+				threads.emplace_back([t, &objects]()
+				{
+					for (size_t i = 0; i < OBJECT_COUNT; ++i)
+						Allocator::Free(objects[t][i], ObjectSize(i));
+				});
+			}
+			for (std::thread& thread : threads)
+				thread.join();
+		}
+	}
+}
+
+TEST_CASE("SmallObjectPool - Threads allocating and freeing", "[.][Benchmark][SmallObjectPool]")
+{
+	BENCHMARK("malloc - 4 threads, 400k allocations")
+	{
+		AllocateAndFree<MallocAllocator>();
+	}
+
+	BENCHMARK("SmallObjectPool - 4 threads, 400k allocations")
+	{
+		AllocateAndFree<PoolAllocator>();
+	}
+}
+
+TEST_CASE("SmallObjectPool - Freeing on other threads", "[.][Benchmark][SmallObjectPool]")
+{
+	BENCHMARK("malloc - 2 producers, 2 consumers")
+	{
+		ProducerConsumer<MallocAllocator>();
+	}
+
+	BENCHMARK("SmallObjectPool - 2 producers, 2 consumers")
+	{
+		ProducerConsumer<PoolAllocator>();
+	}
+}
+
+TEST_CASE("BlockAllocator - Node heavy containers", "[.][Benchmark][BlockAllocator]")
+{
+	BENCHMARK("Map - 1M inserts")
+	{
+		Map<int, int> map;
+		for (int i = 0; i < 1000000; ++i)
+			map.Insert(i, i);
+	}
+
+	BENCHMARK("Alloc and Free - 1M nodes")
+	{
+		BlockAllocator::Block* pBlock = BlockAllocator::Initialize(48);
+		std::vector<void*> nodes(1000000);
+		for (size_t i = 0; i < nodes.size(); ++i)
+			nodes[i] = BlockAllocator::Alloc(pBlock);
+		for (size_t i = 0; i < nodes.size(); ++i)
+			BlockAllocator::Free(pBlock, nodes[i]);
+		BlockAllocator::Uninitialize(pBlock);
+	}
+}
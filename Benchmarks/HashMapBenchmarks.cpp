@@ -0,0 +1,226 @@
+#include "../catch.hpp"
+#include "../Std/HashMap.h"
+#include "../Std/MemoryResource.h"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include <stdio.h>
+#include <algorithm>
+#include <chrono>
+#include <vector>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+namespace
+{
+	const int LOOKUP_COUNT = 100000;
+
+	template<typename Map, typename Key>
+	size_t LookupAll(const Map& map, const Vector<Key>& keys)
+	{
+		size_t found = 0;
+		for (size_t i = 0; i < keys.Size(); ++i)
+			found += map.Find(keys[i]) != map.End();
+		return found;
+	}
+}
+
+TEST_CASE("HashMap - Lookup int keys", "[.][Benchmark][HashMap]")
+{
+	Vector<int> keys;
+	keys.Reserve(LOOKUP_COUNT);
+	HashMap<int, int, std::hash<int>, EqualTo<int>, PowerOfTwoBucketPolicy> powerOfTwo;
+	HashMap<int, int, std::hash<int>, EqualTo<int>, PrimeBucketPolicy> prime;
+	//Random keys. std::hash<int> is the identity with GCC and clang, which maps a sequence on the buckets without any
+	//collision.
+	uint32_t random = 12345;
+	for (int i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		random = random * 1664525u + 1013904223u;
+		const int key = (int)(random >> 1);
+		keys.Push(key);
+		powerOfTwo[key] = i;
+		prime[key] = i;
+	}
+
+	//Duplicates in the random keys can overwrite each other, they are still found
+	size_t found = 0;
+	BENCHMARK("PowerOfTwoBucketPolicy - 100k int lookups")
+	{
+		found = LookupAll(powerOfTwo, keys);
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+
+	BENCHMARK("PrimeBucketPolicy - 100k int lookups")
+	{
+		found = LookupAll(prime, keys);
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+}
+
+TEST_CASE("HashMap - Lookup String keys", "[.][Benchmark][HashMap]")
+{
+	Vector<String*> keys;
+	keys.Reserve(LOOKUP_COUNT);
+	HashMap<String, int, String::Hash, EqualTo<String>, PowerOfTwoBucketPolicy> powerOfTwo;
+	HashMap<String, int, String::Hash, EqualTo<String>, PrimeBucketPolicy> prime;
+	for (int i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		char buffer[32];
+		snprintf(buffer, sizeof(buffer), "key_%d", i);
+		String* pKey = new String(buffer);
+		keys.Push(pKey);
+		powerOfTwo[*pKey] = i;
+		prime[*pKey] = i;
+	}
+
+	size_t found = 0;
+	BENCHMARK("PowerOfTwoBucketPolicy - 100k String lookups")
+	{
+		found = 0;
+		for (size_t i = 0; i < keys.Size(); ++i)
+			found += powerOfTwo.Find(*keys[i]) != powerOfTwo.End();
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+
+	BENCHMARK("PrimeBucketPolicy - 100k String lookups")
+	{
+		found = 0;
+		for (size_t i = 0; i < keys.Size(); ++i)
+			found += prime.Find(*keys[i]) != prime.End();
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+
+	for (size_t i = 0; i < keys.Size(); ++i)
+		delete keys[i];
+}
+
+TEST_CASE("HashMap - Lookup long String keys", "[.][Benchmark][HashMap]")
+{
+	//Asset paths, the equality check compares the whole key on every hit
+	Vector<String*> keys;
+	keys.Reserve(LOOKUP_COUNT);
+	HashMap<String, int, String::Hash, EqualTo<>> map;
+	for (int i = 0; i < LOOKUP_COUNT; ++i)
+	{
+		String* pKey = new String(String::Printf("assets/textures/environment/forest/tree_%06d_diffuse.dds", i));
+		keys.Push(pKey);
+		map[*pKey] = i;
+	}
+
+	size_t found = 0;
+	BENCHMARK("100k long String lookups")
+	{
+		found = 0;
+		for (size_t i = 0; i < keys.Size(); ++i)
+			found += map.Find(*keys[i]) != map.End();
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+
+	BENCHMARK("100k long const char* lookups")
+	{
+		found = 0;
+		for (size_t i = 0; i < keys.Size(); ++i)
+			found += map.Find(keys[i]->C_Str()) != map.End();
+	}
+	REQUIRE(found == (size_t)LOOKUP_COUNT);
+
+	for (size_t i = 0; i < keys.Size(); ++i)
+		delete keys[i];
+}
+
+namespace
+{
+	template<typename Map>
+	void ReportInsertLatency(const char* pName, Map& map, const int count)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		std::vector<long long> latencies((size_t)count);
+		for (int i = 0; i < count; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			map[i] = i;
+			latencies[(size_t)i] = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+		}
+		std::sort(latencies.begin(), latencies.end());
+		const size_t last = latencies.size() - 1;
+		printf("%-28s p50 %6lld ns | p99 %6lld ns | p99.9 %8lld ns | p99.99 %8lld ns | max %9lld ns\n", pName,
+			latencies[last * 50 / 100], latencies[last * 99 / 100], latencies[last * 999 / 1000], latencies[last * 9999 / 10000], latencies[last]);
+	}
+}
+
+TEST_CASE("HashMap - Insert latency", "[.][Benchmark][HashMap]")
+{
+	const int count = 1 << 21;
+	{
+		HashMap<int, int> map;
+		ReportInsertLatency("Rehash at once", map, count);
+		REQUIRE(map.Size() == (size_t)count);
+	}
+	{
+		//Raised to the least step that moves the old table before the next grow
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(1);
+		ReportInsertLatency("Incremental rehash (1)", map, count);
+		REQUIRE(map.Size() == (size_t)count);
+	}
+	{
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(4);
+		ReportInsertLatency("Incremental rehash (4)", map, count);
+		REQUIRE(map.Size() == (size_t)count);
+	}
+
+	//Most slow inserts above are page faults on the first touch of the nodes and the tables. Memory that was touched
+	//before shows the cost of the rehash alone.
+	std::vector<char> buffer((size_t)512 * 1024 * 1024, 1);
+	{
+		MonotonicResource resource(buffer.data(), buffer.size());
+		HashMap<int, int> map(&resource);
+		ReportInsertLatency("Rehash at once, touched", map, count);
+		REQUIRE(map.Size() == (size_t)count);
+	}
+	{
+		MonotonicResource resource(buffer.data(), buffer.size());
+		HashMap<int, int> map(&resource);
+		map.SetIncrementalRehash(1);
+		ReportInsertLatency("Incremental (1), touched", map, count);
+		REQUIRE(map.Size() == (size_t)count);
+	}
+}
+
+TEST_CASE("HashMap - Bulk build", "[.][Benchmark][HashMap]")
+{
+	using P = KeyValuePair<int, int>;
+	std::vector<P> pairs;
+	pairs.reserve((size_t)LOOKUP_COUNT);
+	for (int i = 0; i < LOOKUP_COUNT; ++i)
+		pairs.push_back(P(i, i));
+
+	size_t size = 0;
+	BENCHMARK("Insert one by one - 100k")
+	{
+		HashMap<int, int> map;
+		for (size_t i = 0; i < pairs.size(); ++i)
+			map.Insert(pairs[i]);
+		size = map.Size();
+	}
+	REQUIRE(size == (size_t)LOOKUP_COUNT);
+
+	BENCHMARK("Reserve and insert - 100k")
+	{
+		HashMap<int, int> map;
+		map.Reserve(pairs.size());
+		for (size_t i = 0; i < pairs.size(); ++i)
+			map.Insert(pairs[i]);
+		size = map.Size();
+	}
+	REQUIRE(size == (size_t)LOOKUP_COUNT);
+
+	BENCHMARK("Range constructor - 100k")
+	{
+		HashMap<int, int> map(pairs.begin(), pairs.end());
+		size = map.Size();
+	}
+	REQUIRE(size == (size_t)LOOKUP_COUNT);
+}
@@ -0,0 +1,156 @@
+#include "../catch.hpp"
+#include "../Std/Map.h"
+#include "../Std/PriorityQueue.h"
+#include "../Std/Vector.h"
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+#include <functional>
+#include <queue>
+#include <vector>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+namespace
+{
+	const size_t QUEUE_SIZE = 1000000;
+	const size_t HOLD_SIZE = 10000;
+	const size_t HOLD_STEPS = 5000000;
+
+	uint64_t NextRandom(uint64_t& state)
+	{
+		state = state * 6364136223846793005ull + 1442695040888963407ull;
+		return state >> 20;
+	}
+
+	//Best of a few runs in milliseconds
+	double BestMilliseconds(const std::function<void()>& run)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		double best = -1.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			const Clock::time_point start = Clock::now();
+			run();
+			const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			if (best < 0.0 || elapsed < best)
+				best = elapsed;
+		}
+		return best;
+	}
+
+	//Pushes a million random values and pops them all, then the hold model of a timer queue: the earliest timer fires
+	//and a new one is scheduled a random time after it
+	template<typename Push, typename Pop>
+	void Report(const char* pName, Push push, Pop pop)
+	{
+		uint64_t checksum = 0;
+		const double pushPop = BestMilliseconds([&]()
+		{
+			uint64_t state = 1;
+			for (size_t i = 0; i < QUEUE_SIZE; ++i)
+				push(NextRandom(state));
+			for (size_t i = 0; i < QUEUE_SIZE; ++i)
+				checksum += pop();
+		});
+		const double hold = BestMilliseconds([&]()
+		{
+			uint64_t state = 2;
+			for (size_t i = 0; i < HOLD_SIZE; ++i)
+				push(NextRandom(state) % 1000000);
+			for (size_t i = 0; i < HOLD_STEPS; ++i)
+				push(pop() + NextRandom(state) % 1000000);
+			for (size_t i = 0; i < HOLD_SIZE; ++i)
+				checksum += pop();
+		});
+		printf("%-28s %14.1f %18.1f\n", pName, pushPop, hold);
+		REQUIRE(checksum != 0);
+	}
+}
+
+TEST_CASE("PriorityQueue - Push and pop", "[.][Benchmark][PriorityQueue]")
+{
+	printf("%-28s %14s %18s\n", "uint64_t", "1M push+pop ms", "10k hold 5M ms");
+	PriorityQueue<uint64_t, GreaterThan<uint64_t>, 2> binary;
+	Report("PriorityQueue 2-ary", [&binary](uint64_t value) { binary.Push(value); }, [&binary]() { return binary.Pop(); });
+	PriorityQueue<uint64_t, GreaterThan<uint64_t>> quaternary;
+	Report("PriorityQueue 4-ary", [&quaternary](uint64_t value) { quaternary.Push(value); }, [&quaternary]() { return quaternary.Pop(); });
+	PriorityQueue<uint64_t, GreaterThan<uint64_t>, 8> octonary;
+	Report("PriorityQueue 8-ary", [&octonary](uint64_t value) { octonary.Push(value); }, [&octonary]() { return octonary.Pop(); });
+	std::priority_queue<uint64_t, std::vector<uint64_t>, std::greater<uint64_t>> stdQueue;
+	Report("std::priority_queue", [&stdQueue](uint64_t value) { stdQueue.push(value); }, [&stdQueue]()
+	{
+		const uint64_t top = stdQueue.top();
+		stdQueue.pop();
+		return top;
+	});
+
+	//Map keys are unique, the low bits keep equal priorities apart
+	Map<uint64_t, int> map;
+	uint64_t sequence = 0;
+	Report("Map as a queue", [&map, &sequence](uint64_t value) { map.Insert((value << 20) | (sequence++ & 0xFFFFF), 0); }, [&map]()
+	{
+		const uint64_t top = map.Begin()->Key;
+		map.Erase(top);
+		return top >> 20;
+	});
+}
+
+TEST_CASE("PriorityQueue - DecreaseKey", "[.][Benchmark][PriorityQueue]")
+{
+	//Dijkstra-like: ids get pushed, their priorities lowered a few times and then popped
+	const size_t idCount = 1 << 20;
+	printf("%-28s %10s\n", "1M ids, 4 decreases each", "ms");
+	IndexedPriorityQueue<uint64_t, GreaterThan<uint64_t>, 2> binary(idCount);
+	IndexedPriorityQueue<uint64_t> quaternary(idCount);
+	//The order of the pops is checked once after the timed runs, an assertion per pop would dominate them
+	bool sorted = true;
+	auto run = [idCount, &sorted](auto& queue)
+	{
+		uint64_t state = 3;
+		for (size_t id = 0; id < idCount; ++id)
+			queue.Push(id, (NextRandom(state) % 1000000) + 4000000);
+		for (int round = 0; round < 4; ++round)
+		{
+			for (size_t id = 0; id < idCount; ++id)
+				queue.DecreaseKey(id, queue.GetPriority(id) - NextRandom(state) % 1000000);
+		}
+		uint64_t previous = 0;
+		while (!queue.Empty())
+		{
+			sorted &= queue.TopPriority() >= previous;
+			previous = queue.TopPriority();
+			queue.Pop();
+		}
+	};
+	printf("%-28s %10.1f\n", "IndexedPriorityQueue 2-ary", BestMilliseconds([&]() { run(binary); }));
+	printf("%-28s %10.1f\n", "IndexedPriorityQueue 4-ary", BestMilliseconds([&]() { run(quaternary); }));
+	REQUIRE(sorted);
+
+	//The same with a Map of (priority, id) and a table of the priorities, a decrease is an erase and an insert
+	const double map = BestMilliseconds([idCount]()
+	{
+		Map<uint64_t, int> queue;
+		Vector<uint64_t> keys(idCount);
+		uint64_t state = 3;
+		for (size_t id = 0; id < idCount; ++id)
+		{
+			keys[id] = (((NextRandom(state) % 1000000) + 4000000) << 20) | id;
+			queue.Insert(keys[id], 0);
+		}
+		for (int round = 0; round < 4; ++round)
+		{
+			for (size_t id = 0; id < idCount; ++id)
+			{
+				queue.Erase(keys[id]);
+				keys[id] = (((keys[id] >> 20) - NextRandom(state) % 1000000) << 20) | id;
+				queue.Insert(keys[id], 0);
+			}
+		}
+		while (queue.Size() > 0)
+			queue.Erase(queue.Begin()->Key);
+	});
+	printf("%-28s %10.1f\n", "Map as a queue", map);
+}
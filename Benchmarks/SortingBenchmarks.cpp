@@ -0,0 +1,334 @@
+#include "../catch.hpp"
+#include "../Std/ParallelSort.h"
+#include "../Std/RadixSort.h"
+#include "../Std/Sorting.h"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+namespace
+{
+	const size_t SORT_COUNT = 1000000;
+
+	Vector<int> MakeInput(const char* pShape)
+	{
+		Vector<int> values;
+		values.Reserve(SORT_COUNT);
+		srand(1234);
+		for (size_t i = 0; i < SORT_COUNT; ++i)
+		{
+			if (strcmp(pShape, "random") == 0)
+				values.Push((int)(rand() ^ ((unsigned)rand() << 15)));
+			else if (strcmp(pShape, "sorted") == 0)
+				values.Push((int)i);
+			else if (strcmp(pShape, "reversed") == 0)
+				values.Push((int)(SORT_COUNT - i));
+			else if (strcmp(pShape, "organ pipe") == 0)
+				values.Push((int)(i < SORT_COUNT / 2 ? i : SORT_COUNT - i));
+			else if (strcmp(pShape, "sawtooth") == 0)
+				values.Push((int)(i % 1000));
+			else if (strcmp(pShape, "nearly sorted") == 0)
+				values.Push(rand() % 100 == 0 ? rand() : (int)i);
+			else if (strcmp(pShape, "two runs") == 0)
+				values.Push((int)(i < SORT_COUNT / 2 ? i * 2 : (i - SORT_COUNT / 2) * 2 + 1));
+			else
+				values.Push(rand() % 16);
+		}
+		return values;
+	}
+
+	//Best of a few runs, divided by the element count
+	template<typename T, typename SortFunction>
+	double NsPerElement(const Vector<T>& input, SortFunction sort)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		Vector<T> values;
+		long long best = -1;
+		for (int run = 0; run < 5; ++run)
+		{
+			values = input;
+			const Clock::time_point start = Clock::now();
+			sort(values.begin().pPtr, values.end().pPtr);
+			const long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+			if (best < 0 || elapsed < best)
+				best = elapsed;
+		}
+		REQUIRE(IsSorted(values.Begin(), values.End()));
+		return (double)best / input.Size();
+	}
+
+	template<typename T>
+	void ReportNsPerElement(const char* pType)
+	{
+		const char* shapes[] = { "random", "sorted", "reversed", "few unique", "organ pipe", "sawtooth" };
+		printf("%-6s %-12s %14s %14s %14s\n", pType, "ns/element", "UnstableSort", "Sort", "std::sort");
+		for (const char* pShape : shapes)
+		{
+			const Vector<int> ints = MakeInput(pShape);
+			Vector<T> input;
+			input.Reserve(ints.Size());
+			for (size_t i = 0; i < ints.Size(); ++i)
+				input.Push((T)ints[i]);
+
+			const double unstable = NsPerElement(input, [](T* pBegin, T* pEnd) { UnstableSort(pBegin, pEnd); });
+			const double sort = NsPerElement(input, [](T* pBegin, T* pEnd) { Sort(pBegin, pEnd); });
+			const double stdSort = NsPerElement(input, [](T* pBegin, T* pEnd) { std::sort(pBegin, pEnd); });
+			printf("%-6s %-12s %14.2f %14.2f %14.2f\n", "", pShape, unstable, sort, stdSort);
+		}
+	}
+
+	//Random values spread over the whole range of the type, negative ones included
+	template<typename T>
+	Vector<T> MakeRadixInput(const char* pShape)
+	{
+		Vector<T> values;
+		values.Reserve(SORT_COUNT);
+		srand(1234);
+		for (size_t i = 0; i < SORT_COUNT; ++i)
+		{
+			const uint64_t random = ((uint64_t)rand() << 60) ^ ((uint64_t)rand() << 45) ^ ((uint64_t)rand() << 30) ^ ((uint64_t)rand() << 15) ^ (uint64_t)rand();
+			if (strcmp(pShape, "random") == 0)
+				values.Push((T)0.5 != (T)0 ? (T)((double)(int64_t)random / 1e6) : (T)random);
+			else if (strcmp(pShape, "sorted") == 0)
+				values.Push((T)i);
+			else
+				values.Push((T)(random % 16));
+		}
+		return values;
+	}
+
+	template<typename T>
+	void ReportRadixNsPerElement(const char* pType)
+	{
+		const char* shapes[] = { "random", "sorted", "few unique" };
+		printf("%-8s %-12s %10s %10s %10s %14s %10s\n", pType, "ns/element", "Radix 8", "Radix 11", "Radix 16", "UnstableSort", "std::sort");
+		for (const char* pShape : shapes)
+		{
+			const Vector<T> input = MakeRadixInput<T>(pShape);
+			const double radix8 = NsPerElement(input, [](T* pBegin, T* pEnd) { RadixSort<8>(pBegin, pEnd); });
+			const double radix11 = NsPerElement(input, [](T* pBegin, T* pEnd) { RadixSort<11>(pBegin, pEnd); });
+			const double radix16 = NsPerElement(input, [](T* pBegin, T* pEnd) { RadixSort<16>(pBegin, pEnd); });
+			const double unstable = NsPerElement(input, [](T* pBegin, T* pEnd) { UnstableSort(pBegin, pEnd); });
+			const double stdSort = NsPerElement(input, [](T* pBegin, T* pEnd) { std::sort(pBegin, pEnd); });
+			printf("%-8s %-12s %10.2f %10.2f %10.2f %14.2f %10.2f\n", "", pShape, radix8, radix11, radix16, unstable, stdSort);
+		}
+	}
+
+	//Best of a few runs in milliseconds
+	template<typename SortFunction>
+	double BestMilliseconds(const Vector<uint64_t>& input, SortFunction sort)
+	{
+		using Clock = std::chrono::high_resolution_clock;
+		Vector<uint64_t> values;
+		double best = -1.0;
+		for (int run = 0; run < 3; ++run)
+		{
+			values = input;
+			const Clock::time_point start = Clock::now();
+			sort(values.Begin(), values.End());
+			const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			if (best < 0.0 || elapsed < best)
+				best = elapsed;
+		}
+		REQUIRE(IsSorted(values.Begin(), values.End()));
+		return best;
+	}
+
+	template<typename T>
+	void ReportStableNsPerElement(const char* pType)
+	{
+		const char* shapes[] = { "random", "sorted", "reversed", "few unique", "nearly sorted", "two runs" };
+		printf("%-6s %-14s %12s %12s %16s\n", pType, "ns/element", "StableSort", "In place", "std::stable_sort");
+		for (const char* pShape : shapes)
+		{
+			const Vector<int> ints = MakeInput(pShape);
+			Vector<T> input;
+			input.Reserve(ints.Size());
+			for (size_t i = 0; i < ints.Size(); ++i)
+				input.Push((T)ints[i]);
+
+			const double stable = NsPerElement(input, [](T* pBegin, T* pEnd) { StableSort(pBegin, pEnd); });
+			const double inPlace = NsPerElement(input, [](T* pBegin, T* pEnd) { StableSort(pBegin, pEnd, LessThan<>(), nullptr); });
+			const double stdStable = NsPerElement(input, [](T* pBegin, T* pEnd) { std::stable_sort(pBegin, pEnd); });
+			printf("%-6s %-14s %12.2f %12.2f %16.2f\n", "", pShape, stable, inPlace, stdStable);
+		}
+	}
+}
+
+TEST_CASE("Sorting - Sort 1M ints", "[.][Benchmark][Sorting]")
+{
+	const char* shapes[] = { "random", "sorted", "reversed", "few unique" };
+	for (const char* pShape : shapes)
+	{
+		const Vector<int> input = MakeInput(pShape);
+		Vector<int> values;
+
+		BENCHMARK(std::string("Sort - ") + pShape)
+		{
+			values = input;
+			Sort(values.Begin(), values.End());
+		}
+
+		BENCHMARK(std::string("std::sort - ") + pShape)
+		{
+			values = input;
+			std::sort(values.begin().pPtr, values.end().pPtr);
+		}
+	}
+}
+
+TEST_CASE("Sorting - UnstableSort ns per element", "[.][Benchmark][Sorting]")
+{
+	ReportNsPerElement<int>("int");
+	ReportNsPerElement<float>("float");
+	ReportNsPerElement<double>("double");
+}
+
+TEST_CASE("Sorting - StableSort ns per element", "[.][Benchmark][Sorting]")
+{
+	ReportStableNsPerElement<int>("int");
+	ReportStableNsPerElement<double>("double");
+}
+
+TEST_CASE("Sorting - Parallel scaling", "[.][Benchmark][Sorting]")
+{
+	//Efficiency is the time on one thread divided by the thread count times the time on that many threads
+	const size_t count = 1 << 24;
+	Vector<uint64_t> input;
+	input.Reserve(count);
+	srand(1234);
+	for (size_t i = 0; i < count; ++i)
+		input.Push(((uint64_t)rand() << 45) ^ ((uint64_t)rand() << 30) ^ ((uint64_t)rand() << 15) ^ (uint64_t)rand());
+
+	const size_t hardwareThreads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+	printf("16M uint64_t, %zu hardware threads\n", hardwareThreads);
+	printf("%-8s %16s %12s %20s %12s\n", "threads", "ParallelSort ms", "efficiency", "ParallelStableSort ms", "efficiency");
+	double sortBase = 0.0;
+	double stableBase = 0.0;
+	std::vector<size_t> threadCounts;
+	for (size_t threads = 1; threads < hardwareThreads; threads *= 2)
+		threadCounts.push_back(threads);
+	threadCounts.push_back(hardwareThreads);
+	for (size_t threads : threadCounts)
+	{
+		TaskScheduler scheduler(threads);
+		const double sort = BestMilliseconds(input, [&scheduler](RandomAccessIterator<uint64_t> begin, RandomAccessIterator<uint64_t> end)
+		{
+			ParallelSort(begin, end, LessThan<>(), scheduler);
+		});
+		const double stable = BestMilliseconds(input, [&scheduler](RandomAccessIterator<uint64_t> begin, RandomAccessIterator<uint64_t> end)
+		{
+			ParallelStableSort(begin, end, LessThan<>(), scheduler);
+		});
+		if (threads == 1)
+		{
+			sortBase = sort;
+			stableBase = stable;
+		}
+		printf("%-8zu %16.1f %11.0f%% %20.1f %11.0f%%\n", threads, sort, 100.0 * sortBase / (threads * sort), stable, 100.0 * stableBase / (threads * stable));
+	}
+}
+
+TEST_CASE("Sorting - RadixSort ns per element", "[.][Benchmark][Sorting]")
+{
+	ReportRadixNsPerElement<uint32_t>("uint32_t");
+	ReportRadixNsPerElement<int32_t>("int32_t");
+	ReportRadixNsPerElement<uint64_t>("uint64_t");
+	ReportRadixNsPerElement<float>("float");
+	ReportRadixNsPerElement<double>("double");
+
+	//Structs sorted on a field, against StableSort which gives the same order
+	struct Record
+	{
+		bool operator<(const Record& other) const { return Key < other.Key; }
+
+		uint32_t Key;
+		uint32_t Payload[3];
+	};
+	Vector<Record> records;
+	const Vector<uint32_t> keys = MakeRadixInput<uint32_t>("random");
+	for (size_t i = 0; i < keys.Size(); ++i)
+		records.Push(Record{ keys[i], { (uint32_t)i, 0, 0 } });
+	const auto less = [](const Record& a, const Record& b) { return a.Key < b.Key; };
+	const double radix = NsPerElement(records, [](Record* pBegin, Record* pEnd) { RadixSort(pBegin, pEnd, [](const Record& record) { return record.Key; }); });
+	const double stable = NsPerElement(records, [&less](Record* pBegin, Record* pEnd) { StableSort(pBegin, pEnd, less); });
+	const double stdStable = NsPerElement(records, [&less](Record* pBegin, Record* pEnd) { std::stable_sort(pBegin, pEnd, less); });
+	printf("%-8s %-12s %10s %14s %18s\n", "Record", "ns/element", "RadixSort", "StableSort", "std::stable_sort");
+	printf("%-8s %-12s %10.2f %14.2f %18.2f\n", "", "random", radix, stable, stdStable);
+
+	//Strings of random lengths, half of them with a shared prefix
+	Vector<String> strings;
+	srand(1234);
+	for (size_t i = 0; i < SORT_COUNT; ++i)
+	{
+		String string(i % 2 ? "" : "https://example.com/");
+		const int length = 4 + rand() % 20;
+		for (int c = 0; c < length; ++c)
+			string += (char)('a' + rand() % 26);
+		strings.Push(Move(string));
+	}
+	const double msd = NsPerElement(strings, [](String* pBegin, String* pEnd) { RadixSort(pBegin, pEnd); });
+	const double unstableStrings = NsPerElement(strings, [](String* pBegin, String* pEnd) { UnstableSort(pBegin, pEnd); });
+	const double stdStrings = NsPerElement(strings, [](String* pBegin, String* pEnd) { std::sort(pBegin, pEnd); });
+	printf("%-8s %-12s %10s %14s %18s\n", "String", "ns/element", "RadixSort", "UnstableSort", "std::sort");
+	printf("%-8s %-12s %10.2f %14.2f %18.2f\n", "", "random", msd, unstableStrings, stdStrings);
+}
+
+TEST_CASE("Sorting - Top 100 of 10M", "[.][Benchmark][Sorting]")
+{
+	using Clock = std::chrono::high_resolution_clock;
+	const size_t count = 10000000;
+	Vector<double> input;
+	input.Reserve(count);
+	srand(1234);
+	for (size_t i = 0; i < count; ++i)
+		input.Push((double)((unsigned)rand() ^ ((unsigned)rand() << 15)));
+
+	//Best of a few runs in milliseconds, the input is copied before the clock starts
+	Vector<double> values;
+	auto best = [&input, &values](const char* pName, const std::function<void()>& run)
+	{
+		double bestMs = -1.0;
+		for (int i = 0; i < 3; ++i)
+		{
+			values = input;
+			const Clock::time_point start = Clock::now();
+			run();
+			const double elapsed = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+			if (bestMs < 0.0 || elapsed < bestMs)
+				bestMs = elapsed;
+		}
+		printf("%-24s %10.2f ms\n", pName, bestMs);
+	};
+	const size_t k = 100;
+	best("TopK", [&values, k]()
+	{
+		TopK<double, GreaterThan<double>> top(k);
+		top.Push(values.Begin(), values.End());
+		REQUIRE(top.Extract().Size() == k);
+	});
+	best("PartialSort", [&values, k]() { PartialSort(values.Begin(), values.Begin() + k, values.End(), GreaterThan<>()); });
+	best("std::partial_sort", [&values, k]() { std::partial_sort(values.begin().pPtr, values.begin().pPtr + k, values.end().pPtr, std::greater<double>()); });
+	best("NthElement + sort", [&values, k]()
+	{
+		NthElement(values.Begin(), values.Begin() + k, values.End(), GreaterThan<>());
+		UnstableSort(values.Begin(), values.Begin() + k, GreaterThan<>());
+	});
+	best("std::nth_element", [&values, k]() { std::nth_element(values.begin().pPtr, values.begin().pPtr + k, values.end().pPtr, std::greater<double>()); });
+	best("NthElement median", [&values]() { NthElement(values.Begin(), values.Begin() + values.Size() / 2, values.End()); });
+	best("std::nth_element median", [&values]() { std::nth_element(values.begin().pPtr, values.begin().pPtr + values.Size() / 2, values.end().pPtr); });
+	best("PartialSort half", [&values]() { PartialSort(values.Begin(), values.Begin() + values.Size() / 2, values.End()); });
+	best("std::partial_sort half", [&values]() { std::partial_sort(values.begin().pPtr, values.begin().pPtr + values.Size() / 2, values.end().pPtr); });
+	best("UnstableSort", [&values]() { UnstableSort(values.Begin(), values.End(), GreaterThan<>()); });
+}
@@ -0,0 +1,175 @@
+#include "../catch.hpp"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include <string.h>
+#include <string>
+using namespace StlStd;
+
+//The benchmarks are hidden, run them with: StdLearnings.exe "[Benchmark]"
+
+TEST_CASE("String - Construct short strings", "[.][Benchmark][String]")
+{
+	const int count = 100000;
+	const char* keys[] = { "id", "name", "position", "log.render.frame" };
+	size_t size = 0;
+	BENCHMARK("String - 100k short strings")
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			String key(keys[i & 3]);
+			String copy(key);
+			size += copy.Size();
+		}
+	}
+	BENCHMARK("std::string - 100k short strings")
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			std::string key(keys[i & 3]);
+			std::string copy(key);
+			size += copy.size();
+		}
+	}
+	REQUIRE(size > 0);
+}
+
+TEST_CASE("String - Build with appends", "[.][Benchmark][String]")
+{
+	const int count = 100000;
+	size_t size = 0;
+	BENCHMARK("String - 100k appends")
+	{
+		String output;
+		for (int i = 0; i < count; ++i)
+			output.Append("item ").AppendNumber(i).Append(", ");
+		size = output.Size();
+	}
+	REQUIRE(size > 0);
+
+	BENCHMARK("std::string - 100k appends")
+	{
+		std::string output;
+		for (int i = 0; i < count; ++i)
+		{
+			output.append("item ");
+			output.append(std::to_string(i));
+			output.append(", ");
+		}
+		size = output.size();
+	}
+	REQUIRE(size > 0);
+
+	BENCHMARK("String - 100k formatted appends")
+	{
+		String output;
+		for (int i = 0; i < count; ++i)
+			output.AppendFormat("item %d, ", i);
+		size = output.Size();
+	}
+	REQUIRE(size > 0);
+}
+
+namespace
+{
+	//Log lines of a few MB, the needles are only in the first and the last line
+	String MakeLog(const size_t size)
+	{
+		const char* lines[] = { "[info] render frame finished in 16 ms\n", "[info] loaded texture grass_diffuse.dds\n",
+			"[warning] audio buffer underrun on device 2\n", "[info] network tick 60 players connected\n" };
+		String log;
+		log.Reserve(size + 128);
+		log.Append("[start] session 42 opened by the launcher\n");
+		for (int i = 0; log.Size() < size; ++i)
+			log.Append(lines[i & 3]);
+		log.Append("[error] lost connection to the match server 10.0.0.12, reconnecting\n");
+		return log;
+	}
+}
+
+TEST_CASE("String - Find in a large buffer", "[.][Benchmark][String]")
+{
+	const size_t size = 4 * 1024 * 1024;
+	const String log = MakeLog(size);
+	const std::string stdLog(log.Data(), log.Size());
+	size_t found = 0;
+
+	BENCHMARK("String::Find - 4 MB")
+	{
+		found = log.Find("[error]") + log.Find("lost connection to the match server 10.0.0.12") + log.Find('#');
+	}
+	REQUIRE(found != 0);
+
+	BENCHMARK("String::RFind - 4 MB")
+	{
+		found = log.RFind("[start]") + log.RFind("session 42 opened by the launcher") + log.RFind('$');
+	}
+	REQUIRE(found != 0);
+
+	BENCHMARK("std::string::rfind - 4 MB")
+	{
+		found = stdLog.rfind("[start]") + stdLog.rfind("session 42 opened by the launcher") + stdLog.rfind('$');
+	}
+	REQUIRE(found != 0);
+
+	BENCHMARK("std::string::find - 4 MB")
+	{
+		found = stdLog.find("[error]") + stdLog.find("lost connection to the match server 10.0.0.12") + stdLog.find('#');
+	}
+	REQUIRE(found != 0);
+
+	BENCHMARK("strstr & strchr - 4 MB")
+	{
+		found = (size_t)(strstr(log.Data(), "[error]") - log.Data()) + (size_t)(strstr(log.Data(), "lost connection to the match server 10.0.0.12") - log.Data())
+			+ (size_t)strchr(log.Data(), '#');
+	}
+	REQUIRE(found != 0);
+
+#ifdef __GLIBC__
+	BENCHMARK("memmem & memchr - 4 MB")
+	{
+		found = (size_t)memmem(log.Data(), log.Size(), "[error]", 7) + (size_t)memmem(log.Data(), log.Size(), "lost connection to the match server 10.0.0.12", 45)
+			+ (size_t)memchr(log.Data(), '#', log.Size());
+	}
+	REQUIRE(found != 0);
+#endif
+}
+
+TEST_CASE("String - Tokenize a config", "[.][Benchmark][String]")
+{
+	//About 1 MB of key=value lines
+	String config;
+	for (int i = 0; config.Size() < 1024 * 1024; ++i)
+		config.AppendFormat("render.quality.setting_%d=%d\n", i, i * 7);
+	size_t size = 0;
+
+	BENCHMARK("Substring - 1 MB")
+	{
+		size = 0;
+		const char* pData = config.Data();
+		size_t from = 0;
+		for (size_t i = 0; i < config.Size(); ++i)
+		{
+			if (pData[i] != '\n')
+				continue;
+			const String line = config.Substring((unsigned int)from, i - from);
+			const size_t equal = line.Find('=');
+			size += line.Substring(0, equal).Size() + line.Substring((unsigned int)equal + 1).Size();
+			from = i + 1;
+		}
+	}
+	REQUIRE(size > 0);
+
+	BENCHMARK("StringView Split - 1 MB")
+	{
+		size = 0;
+		Vector<StringView> lines = config.View().Split('\n');
+		for (size_t i = 0; i < lines.Size(); ++i)
+		{
+			const size_t equal = lines[i].Find('=');
+			if (equal == StringView::Npos)
+				continue;
+			size += lines[i].Substring(0, equal).Size() + lines[i].Substring(equal + 1).Size();
+		}
+	}
+	REQUIRE(size > 0);
+}
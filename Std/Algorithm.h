@@ -1,7 +1,342 @@
 #pragma once
+#include "Iterator.h"
+#include "Simd.h"
+#include "Utility.h"
 
 namespace StlStd
 {
+#pragma region Simd
+
+	//Kernels for Fill, Find, Replace, MinElement and MaxElement on the built in types. Ops is the SimdOps of an
+	//instruction set and of the SimdElement type of T. The ranges aren't aligned: the kernels use unaligned loads and a
+	//last vector that overlaps the one before instead of a scalar tail.
+
+	//Where the aligned vectors start after the first one at p, which is stored unaligned. A store across two cache lines
+	//costs about twice as much.
+	template<typename Ops, typename T>
+	T* AlignAfterFirstVector_Internal(T* p)
+	{
+		const size_t vectorBytes = Ops::LANES * sizeof(T);
+		const size_t misalignment = (size_t)((uintptr_t)p % vectorBytes);
+		if (misalignment % sizeof(T) != 0)
+			return p + Ops::LANES;
+		return p + (vectorBytes - misalignment) / sizeof(T);
+	}
+
+	template<typename Ops, typename T>
+	void FillSimd_Internal(T* pBegin, T* pEnd, const T value)
+	{
+		const size_t lanes = Ops::LANES;
+		if ((size_t)(pEnd - pBegin) < lanes)
+		{
+			for (T* p = pBegin; p != pEnd; ++p)
+				*p = value;
+			return;
+		}
+		const typename Ops::Vec pattern = Ops::Broadcast(value);
+		Ops::Store(pBegin, pattern);
+		T* p = AlignAfterFirstVector_Internal<Ops>(pBegin);
+		for (; (size_t)(pEnd - p) >= 4 * lanes; p += 4 * lanes)
+		{
+			Ops::Store(p, pattern);
+			Ops::Store(p + lanes, pattern);
+			Ops::Store(p + 2 * lanes, pattern);
+			Ops::Store(p + 3 * lanes, pattern);
+		}
+		for (; (size_t)(pEnd - p) >= lanes; p += lanes)
+			Ops::Store(p, pattern);
+		if (p != pEnd)
+			Ops::Store(pEnd - lanes, pattern);
+	}
+
+	//Compares four vectors at once and only looks for the lane when one of them matched
+	template<typename Ops, typename T>
+	T* FindSimd_Internal(T* pBegin, T* pEnd, const typename RemoveConst<T>::Type value)
+	{
+		typedef typename Ops::Vec Vec;
+		const size_t lanes = Ops::LANES;
+		if ((size_t)(pEnd - pBegin) < lanes)
+		{
+			for (T* p = pBegin; p != pEnd; ++p)
+			{
+				if (*p == value)
+					return p;
+			}
+			return pEnd;
+		}
+		const Vec pattern = Ops::Broadcast(value);
+		T* p = pBegin;
+		for (; (size_t)(pEnd - p) >= 4 * lanes; p += 4 * lanes)
+		{
+			const Vec equal0 = Ops::Equal(Ops::Load(p), pattern);
+			const Vec equal1 = Ops::Equal(Ops::Load(p + lanes), pattern);
+			const Vec equal2 = Ops::Equal(Ops::Load(p + 2 * lanes), pattern);
+			const Vec equal3 = Ops::Equal(Ops::Load(p + 3 * lanes), pattern);
+			if (Ops::Mask(Ops::Or(Ops::Or(equal0, equal1), Ops::Or(equal2, equal3))) != 0)
+				break;
+		}
+		for (; (size_t)(pEnd - p) >= lanes; p += lanes)
+		{
+			const uint32_t mask = Ops::Mask(Ops::Equal(Ops::Load(p), pattern));
+			if (mask != 0)
+				return p + CountTrailingZeros(mask) / Ops::MASK_STRIDE;
+		}
+		if (p != pEnd)
+		{
+			//The lanes the last vector shares with the one before didn't match
+			p = pEnd - lanes;
+			const uint32_t mask = Ops::Mask(Ops::Equal(Ops::Load(p), pattern));
+			if (mask != 0)
+				return p + CountTrailingZeros(mask) / Ops::MASK_STRIDE;
+		}
+		return pEnd;
+	}
+
+	//Replacing twice gives the same values, so the vectors can overlap
+	template<typename Ops, typename T>
+	void ReplaceSimd_Internal(T* pBegin, T* pEnd, const T oldValue, const T newValue)
+	{
+		typedef typename Ops::Vec Vec;
+		const size_t lanes = Ops::LANES;
+		if ((size_t)(pEnd - pBegin) < lanes)
+		{
+			for (T* p = pBegin; p != pEnd; ++p)
+			{
+				if (*p == oldValue)
+					*p = newValue;
+			}
+			return;
+		}
+		const Vec oldPattern = Ops::Broadcast(oldValue);
+		const Vec newPattern = Ops::Broadcast(newValue);
+		const Vec first = Ops::Load(pBegin);
+		Ops::Store(pBegin, Ops::Select(Ops::Equal(first, oldPattern), first, newPattern));
+		T* p = AlignAfterFirstVector_Internal<Ops>(pBegin);
+		for (; (size_t)(pEnd - p) >= 2 * lanes; p += 2 * lanes)
+		{
+			const Vec values0 = Ops::Load(p);
+			const Vec values1 = Ops::Load(p + lanes);
+			Ops::Store(p, Ops::Select(Ops::Equal(values0, oldPattern), values0, newPattern));
+			Ops::Store(p + lanes, Ops::Select(Ops::Equal(values1, oldPattern), values1, newPattern));
+		}
+		if (p != pEnd)
+		{
+			p = (size_t)(pEnd - p) >= lanes ? p : pEnd - lanes;
+			const Vec values = Ops::Load(p);
+			Ops::Store(p, Ops::Select(Ops::Equal(values, oldPattern), values, newPattern));
+			if (p + lanes != pEnd)
+			{
+				p = pEnd - lanes;
+				const Vec last = Ops::Load(p);
+				Ops::Store(p, Ops::Select(Ops::Equal(last, oldPattern), last, newPattern));
+			}
+		}
+	}
+
+	//Elements per block of MinMaxSimd_Internal, in vectors
+	static const size_t MIN_MAX_SIMD_BLOCK_VECTORS = 128;
+
+	template<bool Max, typename T>
+	bool IsBetter_Internal(const T& value, const T& best)
+	{
+		return Max ? best < value : value < best;
+	}
+
+	template<typename Ops, bool Max>
+	typename Ops::Vec Reduce_Internal(const typename Ops::Vec a, const typename Ops::Vec b)
+	{
+		return Max ? Ops::Max(a, b) : Ops::Min(a, b);
+	}
+
+	//First smallest (Max false) or largest element. The packed minimum or maximum doesn't say where the value is: every
+	//block is reduced to its best value, the first block with the overall best one is remembered and searched for it at
+	//the end. Returns nullptr for ranges with a NaN, in which < isn't an order and the scalar loop decides, and for
+	//ranges shorter than two vectors.
+	template<typename Ops, bool Max, typename T>
+	T* MinMaxSimd_Internal(T* pBegin, T* pEnd)
+	{
+		typedef typename Ops::Vec Vec;
+		typedef typename RemoveConst<T>::Type Value;
+		const size_t lanes = Ops::LANES;
+		const size_t blockSize = MIN_MAX_SIMD_BLOCK_VECTORS * lanes;
+		if ((size_t)(pEnd - pBegin) < 2 * lanes)
+			return nullptr;
+
+		Value best = *pBegin;
+		T* pBestBlock = pBegin;
+		for (T* pBlock = pBegin; pBlock != pEnd;)
+		{
+			//A block shorter than a vector is merged into the one before
+			T* pBlockEnd = (size_t)(pEnd - pBlock) >= blockSize + lanes ? pBlock + blockSize : pEnd;
+			Vec reduced0 = Ops::Load(pBlock);
+			Vec reduced1 = Ops::Load(pBlockEnd - lanes);
+			Vec unordered = Ops::Or(Ops::Unordered(reduced0), Ops::Unordered(reduced1));
+			T* p = pBlock + lanes;
+			for (; (size_t)(pBlockEnd - p) >= 2 * lanes; p += 2 * lanes)
+			{
+				const Vec values0 = Ops::Load(p);
+				const Vec values1 = Ops::Load(p + lanes);
+				reduced0 = Reduce_Internal<Ops, Max>(reduced0, values0);
+				reduced1 = Reduce_Internal<Ops, Max>(reduced1, values1);
+				unordered = Ops::Or(unordered, Ops::Or(Ops::Unordered(values0), Ops::Unordered(values1)));
+			}
+			if ((size_t)(pBlockEnd - p) >= lanes)
+			{
+				const Vec values = Ops::Load(p);
+				reduced0 = Reduce_Internal<Ops, Max>(reduced0, values);
+				unordered = Ops::Or(unordered, Ops::Unordered(values));
+			}
+			if (Ops::Mask(unordered) != 0)
+				return nullptr;
+
+			Value values[Ops::LANES];
+			Ops::Store(values, Reduce_Internal<Ops, Max>(reduced0, reduced1));
+			Value blockBest = values[0];
+			for (size_t i = 1; i < lanes; ++i)
+			{
+				if (IsBetter_Internal<Max>(values[i], blockBest))
+					blockBest = values[i];
+			}
+			if (IsBetter_Internal<Max>(blockBest, best))
+			{
+				best = blockBest;
+				pBestBlock = pBlock;
+			}
+			pBlock = pBlockEnd;
+		}
+		//Equal to the best with ==, -0.0 and 0.0 are the same value like they are for the scalar loop
+		T* pBestBlockEnd = (size_t)(pEnd - pBestBlock) >= blockSize + lanes ? pBestBlock + blockSize : pEnd;
+		return FindSimd_Internal<Ops>(pBestBlock, pBestBlockEnd, best);
+	}
+
+	template<typename T>
+	void Fill_Internal(T* pBegin, T* pEnd, const T& value, FalseType)
+	{
+		for (; pBegin != pEnd; ++pBegin)
+			*pBegin = value;
+	}
+
+	template<typename T>
+	void Fill_Internal(T* pBegin, T* pEnd, const T& value, TrueType)
+	{
+		typedef typename SimdElement<T>::Type Element;
+		switch (GetSimdLevel())
+		{
+#ifdef STLSTD_AVX2
+		case SimdLevel::Avx2:
+			FillSimd_Internal<SimdOps<SimdAvx2, Element>>(pBegin, pEnd, value);
+			return;
+#endif
+#ifdef STLSTD_SSE2
+		case SimdLevel::Sse2:
+			FillSimd_Internal<SimdOps<SimdSse2, Element>>(pBegin, pEnd, value);
+			return;
+#endif
+		default:
+			Fill_Internal(pBegin, pEnd, value, FalseType());
+		}
+	}
+
+	template<typename T>
+	T* Find_Internal(T* pBegin, T* pEnd, const typename RemoveConst<T>::Type& value, FalseType)
+	{
+		for (; pBegin != pEnd; ++pBegin)
+		{
+			if (*pBegin == value)
+				return pBegin;
+		}
+		return pEnd;
+	}
+
+	template<typename T>
+	T* Find_Internal(T* pBegin, T* pEnd, const typename RemoveConst<T>::Type& value, TrueType)
+	{
+		typedef typename SimdElement<typename RemoveConst<T>::Type>::Type Element;
+		switch (GetSimdLevel())
+		{
+#ifdef STLSTD_AVX2
+		case SimdLevel::Avx2:
+			return FindSimd_Internal<SimdOps<SimdAvx2, Element>>(pBegin, pEnd, value);
+#endif
+#ifdef STLSTD_SSE2
+		case SimdLevel::Sse2:
+			return FindSimd_Internal<SimdOps<SimdSse2, Element>>(pBegin, pEnd, value);
+#endif
+		default:
+			return Find_Internal(pBegin, pEnd, value, FalseType());
+		}
+	}
+
+	template<typename T>
+	void Replace_Internal(T* pBegin, T* pEnd, const T& oldValue, const T& newValue, FalseType)
+	{
+		for (; pBegin != pEnd; ++pBegin)
+		{
+			if (*pBegin == oldValue)
+				*pBegin = newValue;
+		}
+	}
+
+	template<typename T>
+	void Replace_Internal(T* pBegin, T* pEnd, const T& oldValue, const T& newValue, TrueType)
+	{
+		typedef typename SimdElement<T>::Type Element;
+		switch (GetSimdLevel())
+		{
+#ifdef STLSTD_AVX2
+		case SimdLevel::Avx2:
+			ReplaceSimd_Internal<SimdOps<SimdAvx2, Element>>(pBegin, pEnd, oldValue, newValue);
+			return;
+#endif
+#ifdef STLSTD_SSE2
+		case SimdLevel::Sse2:
+			ReplaceSimd_Internal<SimdOps<SimdSse2, Element>>(pBegin, pEnd, oldValue, newValue);
+			return;
+#endif
+		default:
+			Replace_Internal(pBegin, pEnd, oldValue, newValue, FalseType());
+		}
+	}
+
+	template<bool Max, typename T>
+	T* MinMaxElement_Internal(T* pBegin, T* pEnd, FalseType)
+	{
+		if (pBegin == pEnd)
+			return pEnd;
+		T* pBest = pBegin++;
+		for (; pBegin != pEnd; ++pBegin)
+		{
+			if (IsBetter_Internal<Max>(*pBegin, *pBest))
+				pBest = pBegin;
+		}
+		return pBest;
+	}
+
+	template<bool Max, typename T>
+	T* MinMaxElement_Internal(T* pBegin, T* pEnd, TrueType)
+	{
+		typedef typename SimdElement<typename RemoveConst<T>::Type>::Type Element;
+		T* pBest = nullptr;
+		switch (GetSimdLevel())
+		{
+#ifdef STLSTD_AVX2
+		case SimdLevel::Avx2:
+			pBest = MinMaxSimd_Internal<SimdOps<SimdAvx2, Element>, Max>(pBegin, pEnd);
+			break;
+#endif
+#ifdef STLSTD_SSE2
+		case SimdLevel::Sse2:
+			pBest = MinMaxSimd_Internal<SimdOps<SimdSse2, Element>, Max>(pBegin, pEnd);
+			break;
+#endif
+		default:
+			break;
+		}
+		return pBest != nullptr ? pBest : MinMaxElement_Internal<Max>(pBegin, pEnd, FalseType());
+	}
+
+#pragma endregion Simd
+
 	template<typename T, typename UnaryPredicate>
 	void ForEach(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd, UnaryPredicate functor)
 	{
@@ -32,40 +367,26 @@ namespace StlStd
 		}
 	}
 
+	//The built in types are filled with SIMD stores, see GetSimdLevel
 	template<typename T>
 	void Fill(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd, const T& value)
 	{
-		while (pBegin != pEnd)
-		{
-			*pBegin = value;
-			++pBegin;
-		}
+		Fill_Internal(pBegin.pPtr, pEnd.pPtr, value, BoolConstant<SimdElement<T>::Value>());
 	}
 
 #pragma region Search
 
+	//The built in types are compared a vector at a time, see GetSimdLevel
 	template<typename T>
 	RandomAccessIterator<T> Find(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd, const T& value)
 	{
-		while (pBegin != pEnd)
-		{
-			if (*pBegin == value)
-				return pBegin;
-			++pBegin;
-		}
-		return pEnd;
+		return Find_Internal(pBegin.pPtr, pEnd.pPtr, value, BoolConstant<SimdElement<T>::Value>());
 	}
 
 	template<typename T>
 	RandomAccessConstIterator<T> Find(RandomAccessConstIterator<T> pBegin, RandomAccessConstIterator<T> pEnd, const T& value)
 	{
-		while (pBegin != pEnd)
-		{
-			if (*pBegin == value)
-				return pBegin;
-			++pBegin;
-		}
-		return pEnd;
+		return Find_Internal(pBegin.pPtr, pEnd.pPtr, value, BoolConstant<SimdElement<T>::Value>());
 	}
 
 	template<typename T, typename UnaryPredicate>
@@ -92,7 +413,7 @@ namespace StlStd
 		return pEnd;
 	}
 
-#pragma region Search
+#pragma endregion Search
 
 	template<class T>
 	void Reverse(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd)
@@ -107,12 +428,7 @@ namespace StlStd
 	template<class T>
 	void Replace(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd, const T& oldValue, const T& newValue)
 	{
-		while (pBegin != pEnd)
-		{
-			if (*pBegin == oldValue)
-				*pBegin = newValue;
-			++pBegin;
-		}
+		Replace_Internal(pBegin.pPtr, pEnd.pPtr, oldValue, newValue, BoolConstant<SimdElement<T>::Value>());
 	}
 
 	template<class T, typename UnaryPredicate>
@@ -140,34 +456,17 @@ namespace StlStd
 		return compare(a, b) ? b : a;
 	}
 
+	//The first largest element. The built in types are reduced a vector at a time, see GetSimdLevel.
 	template<class T>
 	RandomAccessIterator<T> MaxElement(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd)
 	{
-		if (pBegin == pEnd)
-			return pEnd;
-		RandomAccessIterator<T> pLargest = pBegin++;
-		while (pBegin != pEnd)
-		{
-			if (*pLargest < *pBegin)
-				pLargest = pBegin;
-			++pBegin;
-		}
-		return pLargest;
+		return MinMaxElement_Internal<true>(pBegin.pPtr, pEnd.pPtr, BoolConstant<SimdElement<T>::MinMax>());
 	}
 
 	template<class T>
 	RandomAccessConstIterator<T> MaxElement(RandomAccessConstIterator<T> pBegin, RandomAccessConstIterator<T> pEnd)
 	{
-		if (pBegin == pEnd)
-			return pEnd;
-		RandomAccessConstIterator<T> pLargest = pBegin++;
-		while (pBegin != pEnd)
-		{
-			if (*pLargest < *pBegin)
-				pLargest = pBegin;
-			++pBegin;
-		}
-		return pLargest;
+		return MinMaxElement_Internal<true>(pBegin.pPtr, pEnd.pPtr, BoolConstant<SimdElement<T>::MinMax>());
 	}
 
 	template<class T, typename Compare>
@@ -214,34 +513,17 @@ namespace StlStd
 		return compare(a, b) ? a : b;
 	}
 
+	//The first smallest element. The built in types are reduced a vector at a time, see GetSimdLevel.
 	template<class T>
 	RandomAccessIterator<T> MinElement(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd)
 	{
-		if (pBegin == pEnd)
-			return pEnd;
-		RandomAccessIterator<T> pSmallest = pBegin++;
-		while (pBegin != pEnd)
-		{
-			if (*pBegin < *pSmallest)
-				pSmallest = pBegin;
-			++pBegin;
-		}
-		return pSmallest;
+		return MinMaxElement_Internal<false>(pBegin.pPtr, pEnd.pPtr, BoolConstant<SimdElement<T>::MinMax>());
 	}
 
 	template<class T>
 	RandomAccessConstIterator<T> MinElement(RandomAccessConstIterator<T> pBegin, RandomAccessConstIterator<T> pEnd)
 	{
-		if (pBegin == pEnd)
-			return pEnd;
-		RandomAccessConstIterator<T> pSmallest = pBegin++;
-		while (pBegin != pEnd)
-		{
-			if (*pBegin < *pSmallest)
-				pSmallest = pBegin;
-			++pBegin;
-		}
-		return pSmallest;
+		return MinMaxElement_Internal<false>(pBegin.pPtr, pEnd.pPtr, BoolConstant<SimdElement<T>::MinMax>());
 	}
 
 	template<class T, typename Compare>
@@ -1,6 +1,7 @@
 #pragma once
 #include <assert.h>
 #include "Iterator.h"
+#include "Utility.h"
 
 namespace StlStd
 {
@@ -48,14 +49,14 @@ namespace StlStd
 		const T* Data() const { return &m_Data[0]; }
 
 		Iterator begin() { return Iterator(m_Data); }
-		Iterator end() { return Iterator(m_Data + size - 1); }
+		Iterator end() { return Iterator(m_Data + size); }
 		ConstIterator begin() const { return ConstIterator(m_Data); }
-		ConstIterator end() const { return ConstIterator(m_Data + size - 1); }
+		ConstIterator end() const { return ConstIterator(m_Data + size); }
 
 		Iterator Begin() { return Iterator(m_Data); }
-		Iterator End() { return Iterator(m_Data + size - 1); }
+		Iterator End() { return Iterator(m_Data + size); }
 		ConstIterator Begin() const { return ConstIterator(m_Data); }
-		ConstIterator End() const { return ConstIterator(m_Data + size - 1); }
+		ConstIterator End() const { return ConstIterator(m_Data + size); }
 
 		constexpr size_t Size() const { return size; }
 		constexpr size_t MaxSize() const { size_t nr = 0; nr = ~nr; return nr; }
@@ -1,28 +1,84 @@
 #pragma once
+#include "MemoryResource.h"
 
 namespace StlStd
-{ 
+{
+	//Hands out nodes of a single size from blocks of memory. A free node holds the link to the next free node, a node that
+	//is in use costs nothing on top of its own size.
+	//The allocator grows by a block as large as all the previous ones together, kept within the minimum and maximum block
+	//size. The nodes of the newest block are handed out in order and only get linked once they are freed.
+	//Blocks are only given back by Trim, when none of their nodes are in use, and by Uninitialize.
 	class BlockAllocator
 	{
 	private:
-		struct BlockNode
+		struct FreeNode
 		{
-			BlockNode* pNext;
+			FreeNode* pNext;
 		};
 
 	public:
+		//The amount of nodes of the blocks the allocator grows by, unless SetBlockSizes changes them
+		static const size_t DEFAULT_MIN_BLOCK = 16;
+		static const size_t DEFAULT_MAX_BLOCK = 64 * 1024;
+
+		//The memory use of an allocator, see GetStats
+		struct Stats
+		{
+			//All the blocks, headers included
+			size_t BytesReserved;
+			//The nodes that are handed out
+			size_t BytesInUse;
+			size_t BlockCount;
+			//The freed nodes that wait to be handed out again
+			size_t FreeListLength;
+			//The part of the free nodes that sits in blocks with nodes in use, which Trim can't give back.
+			//0 when there are no free nodes or all of them are in blocks that are empty.
+			float Fragmentation;
+		};
+
+		//The header of every block, the first block is the allocator itself
 		struct Block
 		{
+			//The size of the nodes, rounded up to the alignment and to fit the link to the next free node
 			size_t NodeSize;
+			size_t Alignment;
+			//The amount of nodes in this block
 			size_t Capacity;
-			BlockNode* pFree;
+			//The nodes of this block that aren't in use, only up to date during Trim and GetStats
+			size_t FreeCount;
 			Block* pNext;
+			//Where the blocks are allocated from, and the size of this block
+			MemoryResource* pResource;
+			size_t Bytes;
+
+			//The rest is only used on the first block
+			size_t TotalCapacity;
+			size_t MinBlock;
+			size_t MaxBlock;
+			FreeNode* pFree;
+			//The nodes of the newest block that were never handed out
+			char* pUnused;
+			char* pUnusedEnd;
 		};
 
 	public:
-		static Block* Initialize(size_t nodeSize, size_t capacity = 1)
+		//The alignment has to be a power of two, the first block holds the given capacity
+		static Block* Initialize(size_t nodeSize, size_t capacity = 1, MemoryResource* pResource = GetDefaultResource(), size_t alignment = MemoryResource::DEFAULT_ALIGNMENT)
 		{
-			Block* pBlock = AllocateBlock(nullptr, nodeSize, capacity);
+			assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+			if (alignment < alignof(FreeNode))
+				alignment = alignof(FreeNode);
+			if (nodeSize < sizeof(FreeNode))
+				nodeSize = sizeof(FreeNode);
+			nodeSize = (nodeSize + alignment - 1) & ~(alignment - 1);
+
+			Block* pBlock = AllocateBlock(nodeSize, alignment, capacity, pResource);
+			pBlock->TotalCapacity = pBlock->Capacity;
+			pBlock->MinBlock = DEFAULT_MIN_BLOCK;
+			pBlock->MaxBlock = DEFAULT_MAX_BLOCK;
+			pBlock->pFree = nullptr;
+			pBlock->pUnused = GetNodes(pBlock);
+			pBlock->pUnusedEnd = pBlock->pUnused + pBlock->Capacity * nodeSize;
 			return pBlock;
 		}
 
@@ -31,89 +87,244 @@ namespace StlStd
 			while (pAllocator)
 			{
 				Block* pNext = pAllocator->pNext;
-				delete[] reinterpret_cast<char*>(pAllocator);
+				pAllocator->pResource->Deallocate(pAllocator, pAllocator->Bytes, GetBlockAlignment(pAllocator->Alignment));
 				pAllocator = pNext;
 			}
 		}
 
+		//The amount of nodes of the blocks the allocator grows by, in between the capacity it has so far is added at once
+		static void SetBlockSizes(Block* pAllocator, size_t minBlock, size_t maxBlock)
+		{
+			if (pAllocator == nullptr)
+				return;
+			pAllocator->MinBlock = minBlock > 0 ? minBlock : 1;
+			pAllocator->MaxBlock = maxBlock > pAllocator->MinBlock ? maxBlock : pAllocator->MinBlock;
+		}
+
 		static void* Alloc(Block* pAllocator)
 		{
 			if (pAllocator == nullptr)
 				return nullptr;
 
-			if (pAllocator->pFree == nullptr)
+			FreeNode* pFree = pAllocator->pFree;
+			if (pFree)
+			{
+				pAllocator->pFree = pFree->pNext;
+				return pFree;
+			}
+			if (pAllocator->pUnused == pAllocator->pUnusedEnd)
 			{
-				size_t newCapacity = (pAllocator->Capacity + 1) >> 1;
-				AllocateBlock(pAllocator, pAllocator->NodeSize, newCapacity);
-				pAllocator->Capacity += newCapacity;
+				size_t capacity = pAllocator->TotalCapacity;
+				if (capacity < pAllocator->MinBlock)
+					capacity = pAllocator->MinBlock;
+				if (capacity > pAllocator->MaxBlock)
+					capacity = pAllocator->MaxBlock;
+				AddBlock(pAllocator, capacity);
 			}
-			BlockNode* pFree = pAllocator->pFree;
-			void* pPtr = reinterpret_cast<char*>(pFree) + sizeof(BlockNode);
-			pAllocator->pFree = pFree->pNext;
-			pFree->pNext = nullptr;
+			void* pPtr = pAllocator->pUnused;
+			pAllocator->pUnused += pAllocator->NodeSize;
 			return pPtr;
 		}
 
+		//Make sure the allocator holds at least the given amount of nodes, allocates a single block for the difference
+		static void Reserve(Block* pAllocator, size_t capacity)
+		{
+			if (pAllocator == nullptr || pAllocator->TotalCapacity >= capacity)
+				return;
+			AddBlock(pAllocator, capacity - pAllocator->TotalCapacity);
+		}
+
 		static void Free(Block* pAllocator, void* pPtr)
 		{
 			if (pAllocator == nullptr || pPtr == nullptr)
 				return;
-			char* pData = reinterpret_cast<char*>(pPtr);
-			BlockNode* pNode = reinterpret_cast<BlockNode*>(pData - sizeof(BlockNode));
-
+			FreeNode* pNode = static_cast<FreeNode*>(pPtr);
 			pNode->pNext = pAllocator->pFree;
 			pAllocator->pFree = pNode;
 		}
 
+		//The amount of nodes in all the blocks
 		static size_t GetSize(const Block* pBlock)
 		{
-			size_t size = 0;
-			while (pBlock != nullptr)
+			return pBlock ? pBlock->TotalCapacity : 0;
+		}
+
+		//Gives back the blocks that have no nodes in use, except the first one. Returns the amount of bytes given back.
+		//Walks all the free nodes, so it is meant for after a peak and not for every Free.
+		static size_t Trim(Block* pAllocator)
+		{
+			if (pAllocator == nullptr || pAllocator->pNext == nullptr)
+				return 0;
+
+			const size_t count = GetBlockCount(pAllocator);
+			MemoryResource* pResource = pAllocator->pResource;
+			Block** pBlocks = static_cast<Block**>(pResource->Allocate(count * sizeof(Block*), alignof(Block*)));
+			CountFreeNodes(pAllocator, pBlocks, count);
+
+			//Only keep the free nodes of the blocks that stay
+			FreeNode** ppLink = &pAllocator->pFree;
+			for (FreeNode* pNode = pAllocator->pFree; pNode != nullptr; pNode = pNode->pNext)
+			{
+				if (!IsReleasable(pAllocator, FindBlock(pBlocks, count, pNode)))
+				{
+					*ppLink = pNode;
+					ppLink = &pNode->pNext;
+				}
+			}
+			*ppLink = nullptr;
+			if (pAllocator->pUnused != pAllocator->pUnusedEnd && IsReleasable(pAllocator, FindBlock(pBlocks, count, pAllocator->pUnused)))
+			{
+				pAllocator->pUnused = nullptr;
+				pAllocator->pUnusedEnd = nullptr;
+			}
+			pResource->Deallocate(pBlocks, count * sizeof(Block*), alignof(Block*));
+
+			size_t released = 0;
+			Block** ppNext = &pAllocator->pNext;
+			while (*ppNext != nullptr)
 			{
-				size += pBlock->Capacity;
-				pBlock = pBlock->pNext;
+				Block* pBlock = *ppNext;
+				if (IsReleasable(pAllocator, pBlock))
+				{
+					*ppNext = pBlock->pNext;
+					pAllocator->TotalCapacity -= pBlock->Capacity;
+					released += pBlock->Bytes;
+					pResource->Deallocate(pBlock, pBlock->Bytes, GetBlockAlignment(pBlock->Alignment));
+				}
+				else
+				{
+					ppNext = &pBlock->pNext;
+				}
 			}
-			return size;
+			return released;
+		}
+
+		//Walks all the free nodes to find out how many of each block are in use, it writes the FreeCount of every block
+		static Stats GetStats(Block* pAllocator)
+		{
+			Stats stats = {};
+			if (pAllocator == nullptr)
+				return stats;
+
+			const size_t count = GetBlockCount(pAllocator);
+			MemoryResource* pResource = pAllocator->pResource;
+			Block** pBlocks = static_cast<Block**>(pResource->Allocate(count * sizeof(Block*), alignof(Block*)));
+			CountFreeNodes(pAllocator, pBlocks, count);
+			pResource->Deallocate(pBlocks, count * sizeof(Block*), alignof(Block*));
+
+			size_t freeCount = 0;
+			size_t fragmented = 0;
+			for (Block* pBlock = pAllocator; pBlock != nullptr; pBlock = pBlock->pNext)
+			{
+				stats.BytesReserved += pBlock->Bytes;
+				freeCount += pBlock->FreeCount;
+				if (pBlock->FreeCount < pBlock->Capacity)
+					fragmented += pBlock->FreeCount;
+			}
+			stats.BlockCount = count;
+			stats.BytesInUse = (pAllocator->TotalCapacity - freeCount) * pAllocator->NodeSize;
+			stats.FreeListLength = freeCount - (pAllocator->pUnusedEnd - pAllocator->pUnused) / pAllocator->NodeSize;
+			stats.Fragmentation = freeCount > 0 ? (float)fragmented / freeCount : 0.0f;
+			return stats;
 		}
 
 	private:
-		static Block* AllocateBlock(Block* pAllocator, size_t nodeSize, size_t capacity)
+		static size_t GetBlockAlignment(const size_t alignment)
+		{
+			return alignment > alignof(Block) ? alignment : alignof(Block);
+		}
+
+		//The nodes start after the header, at the alignment
+		static size_t GetHeaderSize(const size_t alignment)
+		{
+			return (sizeof(Block) + alignment - 1) & ~(alignment - 1);
+		}
+
+		static char* GetNodes(Block* pBlock)
+		{
+			return reinterpret_cast<char*>(pBlock) + GetHeaderSize(pBlock->Alignment);
+		}
+
+		static Block* AllocateBlock(size_t nodeSize, size_t alignment, size_t capacity, MemoryResource* pResource)
 		{
 			if (capacity == 0)
 				capacity = 1;
 
-			char* pBlockPtr = new char[sizeof(Block) + capacity * (sizeof(BlockNode) + nodeSize)];
-			Block* pBlock = reinterpret_cast<Block*>(pBlockPtr);
+			const size_t bytes = GetHeaderSize(alignment) + capacity * nodeSize;
+			Block* pBlock = static_cast<Block*>(pResource->Allocate(bytes, GetBlockAlignment(alignment)));
 			pBlock->NodeSize = nodeSize;
+			pBlock->Alignment = alignment;
 			pBlock->Capacity = capacity;
-			pBlock->pFree = nullptr;
+			pBlock->FreeCount = 0;
 			pBlock->pNext = nullptr;
+			pBlock->pResource = pResource;
+			pBlock->Bytes = bytes;
+			return pBlock;
+		}
 
-			if (!pAllocator)
-			{
-				pAllocator = pBlock;
-			}
-			else
+		//The nodes of the previous block that were never handed out go on the free list, the new block is handed out next
+		static void AddBlock(Block* pAllocator, size_t capacity)
+		{
+			Block* pBlock = AllocateBlock(pAllocator->NodeSize, pAllocator->Alignment, capacity, pAllocator->pResource);
+			pBlock->pNext = pAllocator->pNext;
+			pAllocator->pNext = pBlock;
+			pAllocator->TotalCapacity += pBlock->Capacity;
+
+			while (pAllocator->pUnused != pAllocator->pUnusedEnd)
 			{
-				pBlock->pNext = pAllocator->pNext;
-				pAllocator->pNext = pBlock;
+				Free(pAllocator, pAllocator->pUnused);
+				pAllocator->pUnused += pAllocator->NodeSize;
 			}
+			pAllocator->pUnused = GetNodes(pBlock);
+			pAllocator->pUnusedEnd = pAllocator->pUnused + pBlock->Capacity * pAllocator->NodeSize;
+		}
+
+		static size_t GetBlockCount(const Block* pAllocator)
+		{
+			size_t count = 0;
+			for (; pAllocator != nullptr; pAllocator = pAllocator->pNext)
+				++count;
+			return count;
+		}
 
-			char* pNodePtr = pBlockPtr + sizeof(Block);
-			BlockNode* pNode = reinterpret_cast<BlockNode*>(pNodePtr);
-			for (size_t i = 0; i < capacity - 1; ++i)
+		//Sorts the blocks on their address in the given array and sets the free count of every block
+		static void CountFreeNodes(Block* pAllocator, Block** pBlocks, const size_t count)
+		{
+			size_t sorted = 0;
+			for (Block* pBlock = pAllocator; pBlock != nullptr; pBlock = pBlock->pNext)
 			{
-				BlockNode* pNewNode = reinterpret_cast<BlockNode*>(pNodePtr);
-				pNewNode->pNext = reinterpret_cast<BlockNode*>(pNodePtr + sizeof(BlockNode) + nodeSize);
-				pNodePtr += sizeof(BlockNode) + nodeSize;
+				pBlock->FreeCount = 0;
+				size_t i = sorted++;
+				for (; i > 0 && (uintptr_t)pBlocks[i - 1] > (uintptr_t)pBlock; --i)
+					pBlocks[i] = pBlocks[i - 1];
+				pBlocks[i] = pBlock;
 			}
+			if (pAllocator->pUnused != pAllocator->pUnusedEnd)
+				FindBlock(pBlocks, count, pAllocator->pUnused)->FreeCount += (pAllocator->pUnusedEnd - pAllocator->pUnused) / pAllocator->NodeSize;
+			for (FreeNode* pNode = pAllocator->pFree; pNode != nullptr; pNode = pNode->pNext)
+				++FindBlock(pBlocks, count, pNode)->FreeCount;
+		}
+
+		//The last block that starts before the node
+		static Block* FindBlock(Block** pBlocks, const size_t count, const void* pNode)
+		{
+			size_t low = 0;
+			size_t high = count;
+			while (high - low > 1)
 			{
-				BlockNode* pNewNode = reinterpret_cast<BlockNode*>(pNodePtr);
-				pNewNode->pNext = nullptr;
+				const size_t middle = (low + high) >> 1;
+				if ((uintptr_t)pBlocks[middle] <= (uintptr_t)pNode)
+					low = middle;
+				else
+					high = middle;
 			}
+			return pBlocks[low];
+		}
 
-			pAllocator->pFree = pNode;
-			return pBlock;
+		//The first block is the allocator, it stays even when it is empty
+		static bool IsReleasable(const Block* pAllocator, const Block* pBlock)
+		{
+			return pBlock != pAllocator && pBlock->FreeCount == pBlock->Capacity;
 		}
 	};
-}
\ No newline at end of file
+}
@@ -0,0 +1,328 @@
+#pragma once
+#include <atomic>
+#include <new>
+#include "BlockAllocator.h"
+#include "MemoryResource.h"
+#include "TaggedStack.h"
+
+namespace StlStd
+{
+	//Thread-safe variant of BlockAllocator with the same interface, Alloc and Free can be called on a shared allocator
+	//from any thread. The free nodes are kept on a lock-free tagged stack. A thread that finds it empty allocates a new
+	//block, keeps one node and pushes the others, and links the block in with a compare exchange, so no thread waits on
+	//another one. Several threads running out at once each add a block. The blocks grow like the ones of BlockAllocator.
+	//Initialize, SetBlockSizes, Reserve, Trim, GetStats and Uninitialize aren't thread-safe. The resource has to be thread-safe when the
+	//allocator grows on several threads, the new/delete resource is.
+	class ConcurrentBlockAllocator
+	{
+	private:
+		//The link is kept in a header in front of the node and not in the free node itself. A thread that is about to pop
+		//a node reads its link, while another thread can already have taken that node and be writing to it.
+		struct BlockNode
+		{
+			std::atomic<BlockNode*> pNext;
+		};
+
+	public:
+		using Stats = BlockAllocator::Stats;
+
+		struct Block
+		{
+			//The distance between the nodes, header included
+			size_t NodeSize;
+			size_t Alignment;
+			//The amount of nodes in this block
+			size_t Capacity;
+			//The nodes of this block that aren't in use, only up to date during Trim and GetStats
+			size_t FreeCount;
+			//Only used on the first block
+			std::atomic<size_t> TotalCapacity;
+			TaggedStack<BlockNode> FreeNodes;
+			size_t MinBlock;
+			size_t MaxBlock;
+			std::atomic<Block*> pNext;
+			//Where the blocks are allocated from, and the size of this block
+			MemoryResource* pResource;
+			size_t Bytes;
+		};
+
+	public:
+		//The alignment has to be a power of two
+		static Block* Initialize(size_t nodeSize, size_t capacity = 1, MemoryResource* pResource = GetDefaultResource(), size_t alignment = MemoryResource::DEFAULT_ALIGNMENT)
+		{
+			assert(alignment > 0 && (alignment & (alignment - 1)) == 0);
+			if (alignment < alignof(BlockNode))
+				alignment = alignof(BlockNode);
+			if (capacity == 0)
+				capacity = 1;
+			nodeSize = (sizeof(BlockNode) + nodeSize + alignment - 1) & ~(alignment - 1);
+			Block* pBlock = AllocateBlock(nodeSize, alignment, capacity, pResource);
+			pBlock->MinBlock = BlockAllocator::DEFAULT_MIN_BLOCK;
+			pBlock->MaxBlock = BlockAllocator::DEFAULT_MAX_BLOCK;
+			pBlock->FreeNodes.PushChain(GetNode(pBlock, 0), GetNode(pBlock, capacity - 1));
+			return pBlock;
+		}
+
+		static void Uninitialize(Block* pAllocator)
+		{
+			while (pAllocator)
+			{
+				Block* pNext = pAllocator->pNext.load(std::memory_order_relaxed);
+				MemoryResource* pResource = pAllocator->pResource;
+				const size_t bytes = pAllocator->Bytes;
+				const size_t alignment = pAllocator->Alignment;
+				pAllocator->~Block();
+				pResource->Deallocate(pAllocator, bytes, GetBlockAlignment(alignment));
+				pAllocator = pNext;
+			}
+		}
+
+		//The amount of nodes of the blocks the allocator grows by, see BlockAllocator::SetBlockSizes
+		static void SetBlockSizes(Block* pAllocator, size_t minBlock, size_t maxBlock)
+		{
+			if (pAllocator == nullptr)
+				return;
+			pAllocator->MinBlock = minBlock > 0 ? minBlock : 1;
+			pAllocator->MaxBlock = maxBlock > pAllocator->MinBlock ? maxBlock : pAllocator->MinBlock;
+		}
+
+		static void* Alloc(Block* pAllocator)
+		{
+			if (pAllocator == nullptr)
+				return nullptr;
+
+			BlockNode* pNode = pAllocator->FreeNodes.Pop();
+			if (pNode == nullptr)
+			{
+				size_t capacity = pAllocator->TotalCapacity.load(std::memory_order_relaxed);
+				if (capacity < pAllocator->MinBlock)
+					capacity = pAllocator->MinBlock;
+				if (capacity > pAllocator->MaxBlock)
+					capacity = pAllocator->MaxBlock;
+				pNode = Grow(pAllocator, capacity);
+			}
+			return reinterpret_cast<char*>(pNode) + sizeof(BlockNode);
+		}
+
+		//Make sure the allocator holds at least the given amount of nodes, allocates a single block for the difference
+		static void Reserve(Block* pAllocator, size_t capacity)
+		{
+			if (pAllocator == nullptr)
+				return;
+			const size_t current = pAllocator->TotalCapacity.load(std::memory_order_relaxed);
+			if (current >= capacity)
+				return;
+			pAllocator->FreeNodes.Push(Grow(pAllocator, capacity - current));
+		}
+
+		static void Free(Block* pAllocator, void* pPtr)
+		{
+			if (pAllocator == nullptr || pPtr == nullptr)
+				return;
+			char* pData = reinterpret_cast<char*>(pPtr);
+			pAllocator->FreeNodes.Push(reinterpret_cast<BlockNode*>(pData - sizeof(BlockNode)));
+		}
+
+		static size_t GetSize(const Block* pBlock)
+		{
+			return pBlock ? pBlock->TotalCapacity.load(std::memory_order_relaxed) : 0;
+		}
+
+		//Gives back the blocks that have no nodes in use, except the first one, see BlockAllocator::Trim
+		static size_t Trim(Block* pAllocator)
+		{
+			if (pAllocator == nullptr || pAllocator->pNext.load(std::memory_order_relaxed) == nullptr)
+				return 0;
+
+			const size_t count = GetBlockCount(pAllocator);
+			MemoryResource* pResource = pAllocator->pResource;
+			Block** pBlocks = static_cast<Block**>(pResource->Allocate(count * sizeof(Block*), alignof(Block*)));
+			BlockNode* pFree = pAllocator->FreeNodes.PopAll();
+			CountFreeNodes(pAllocator, pFree, pBlocks, count);
+
+			//Only the free nodes of the blocks that stay go back on the stack
+			BlockNode* pFirst = nullptr;
+			BlockNode* pLast = nullptr;
+			while (pFree != nullptr)
+			{
+				BlockNode* pNext = pFree->pNext.load(std::memory_order_relaxed);
+				if (!IsReleasable(pAllocator, FindBlock(pBlocks, count, pFree)))
+				{
+					if (pLast)
+						pLast->pNext.store(pFree, std::memory_order_relaxed);
+					else
+						pFirst = pFree;
+					pLast = pFree;
+				}
+				pFree = pNext;
+			}
+			if (pFirst)
+				pAllocator->FreeNodes.PushChain(pFirst, pLast);
+			pResource->Deallocate(pBlocks, count * sizeof(Block*), alignof(Block*));
+
+			size_t released = 0;
+			Block* pPrevious = pAllocator;
+			Block* pBlock = pAllocator->pNext.load(std::memory_order_relaxed);
+			while (pBlock != nullptr)
+			{
+				Block* pNext = pBlock->pNext.load(std::memory_order_relaxed);
+				if (IsReleasable(pAllocator, pBlock))
+				{
+					pPrevious->pNext.store(pNext, std::memory_order_relaxed);
+					pAllocator->TotalCapacity.fetch_sub(pBlock->Capacity, std::memory_order_relaxed);
+					const size_t bytes = pBlock->Bytes;
+					const size_t alignment = pBlock->Alignment;
+					released += bytes;
+					pBlock->~Block();
+					pResource->Deallocate(pBlock, bytes, GetBlockAlignment(alignment));
+				}
+				else
+				{
+					pPrevious = pBlock;
+				}
+				pBlock = pNext;
+			}
+			return released;
+		}
+
+		static Stats GetStats(Block* pAllocator)
+		{
+			Stats stats = {};
+			if (pAllocator == nullptr)
+				return stats;
+
+			const size_t count = GetBlockCount(pAllocator);
+			MemoryResource* pResource = pAllocator->pResource;
+			Block** pBlocks = static_cast<Block**>(pResource->Allocate(count * sizeof(Block*), alignof(Block*)));
+			BlockNode* pFree = pAllocator->FreeNodes.PopAll();
+			CountFreeNodes(pAllocator, pFree, pBlocks, count);
+			pResource->Deallocate(pBlocks, count * sizeof(Block*), alignof(Block*));
+			if (pFree)
+			{
+				BlockNode* pLast = pFree;
+				while (pLast->pNext.load(std::memory_order_relaxed) != nullptr)
+					pLast = pLast->pNext.load(std::memory_order_relaxed);
+				pAllocator->FreeNodes.PushChain(pFree, pLast);
+			}
+
+			size_t freeCount = 0;
+			size_t fragmented = 0;
+			for (Block* pBlock = pAllocator; pBlock != nullptr; pBlock = pBlock->pNext.load(std::memory_order_relaxed))
+			{
+				stats.BytesReserved += pBlock->Bytes;
+				freeCount += pBlock->FreeCount;
+				if (pBlock->FreeCount < pBlock->Capacity)
+					fragmented += pBlock->FreeCount;
+			}
+			stats.BlockCount = count;
+			//The headers of the nodes are counted as in use
+			stats.BytesInUse = (GetSize(pAllocator) - freeCount) * pAllocator->NodeSize;
+			stats.FreeListLength = freeCount;
+			stats.Fragmentation = freeCount > 0 ? (float)fragmented / freeCount : 0.0f;
+			return stats;
+		}
+
+	private:
+		static size_t GetBlockAlignment(const size_t alignment)
+		{
+			return alignment > alignof(Block) ? alignment : alignof(Block);
+		}
+
+		//The header of the first node follows the block, placed so the node after it is aligned
+		static size_t GetHeaderSize(const size_t alignment)
+		{
+			return ((sizeof(Block) + sizeof(BlockNode) + alignment - 1) & ~(alignment - 1)) - sizeof(BlockNode);
+		}
+
+		static BlockNode* GetNode(Block* pBlock, const size_t index)
+		{
+			char* pNodes = reinterpret_cast<char*>(pBlock) + GetHeaderSize(pBlock->Alignment);
+			return reinterpret_cast<BlockNode*>(pNodes + index * pBlock->NodeSize);
+		}
+
+		//Allocates a block with its nodes linked to each other, the last one links to nothing
+		static Block* AllocateBlock(size_t nodeSize, size_t alignment, size_t capacity, MemoryResource* pResource)
+		{
+			const size_t bytes = GetHeaderSize(alignment) + capacity * nodeSize;
+			Block* pBlock = new (pResource->Allocate(bytes, GetBlockAlignment(alignment))) Block();
+			pBlock->NodeSize = nodeSize;
+			pBlock->Alignment = alignment;
+			pBlock->Capacity = capacity;
+			pBlock->FreeCount = 0;
+			pBlock->TotalCapacity.store(capacity, std::memory_order_relaxed);
+			pBlock->pNext.store(nullptr, std::memory_order_relaxed);
+			pBlock->pResource = pResource;
+			pBlock->Bytes = bytes;
+
+			for (size_t i = 0; i < capacity - 1; ++i)
+				GetNode(pBlock, i)->pNext.store(GetNode(pBlock, i + 1), std::memory_order_relaxed);
+			GetNode(pBlock, capacity - 1)->pNext.store(nullptr, std::memory_order_relaxed);
+			return pBlock;
+		}
+
+		//Adds a block behind the first one, returns its first node to the caller and gives the others to the free stack
+		static BlockNode* Grow(Block* pAllocator, size_t capacity)
+		{
+			if (capacity == 0)
+				capacity = 1;
+			Block* pBlock = AllocateBlock(pAllocator->NodeSize, pAllocator->Alignment, capacity, pAllocator->pResource);
+			Block* pNext = pAllocator->pNext.load(std::memory_order_relaxed);
+			do
+			{
+				pBlock->pNext.store(pNext, std::memory_order_relaxed);
+			} while (!pAllocator->pNext.compare_exchange_weak(pNext, pBlock, std::memory_order_release, std::memory_order_relaxed));
+			pAllocator->TotalCapacity.fetch_add(capacity, std::memory_order_relaxed);
+
+			BlockNode* pNode = GetNode(pBlock, 0);
+			if (capacity > 1)
+				pAllocator->FreeNodes.PushChain(GetNode(pBlock, 1), GetNode(pBlock, capacity - 1));
+			return pNode;
+		}
+
+		static size_t GetBlockCount(const Block* pAllocator)
+		{
+			size_t count = 0;
+			for (; pAllocator != nullptr; pAllocator = pAllocator->pNext.load(std::memory_order_relaxed))
+				++count;
+			return count;
+		}
+
+		//Sorts the blocks on their address in the given array and sets the free count of every block
+		static void CountFreeNodes(Block* pAllocator, BlockNode* pFree, Block** pBlocks, const size_t count)
+		{
+			size_t sorted = 0;
+			for (Block* pBlock = pAllocator; pBlock != nullptr; pBlock = pBlock->pNext.load(std::memory_order_relaxed))
+			{
+				pBlock->FreeCount = 0;
+				size_t i = sorted++;
+				for (; i > 0 && (uintptr_t)pBlocks[i - 1] > (uintptr_t)pBlock; --i)
+					pBlocks[i] = pBlocks[i - 1];
+				pBlocks[i] = pBlock;
+			}
+			for (; pFree != nullptr; pFree = pFree->pNext.load(std::memory_order_relaxed))
+				++FindBlock(pBlocks, count, pFree)->FreeCount;
+		}
+
+		//The last block that starts before the node
+		static Block* FindBlock(Block** pBlocks, const size_t count, const void* pNode)
+		{
+			size_t low = 0;
+			size_t high = count;
+			while (high - low > 1)
+			{
+				const size_t middle = (low + high) >> 1;
+				if ((uintptr_t)pBlocks[middle] <= (uintptr_t)pNode)
+					low = middle;
+				else
+					high = middle;
+			}
+			return pBlocks[low];
+		}
+
+		//The first block is the allocator, it stays even when it is empty
+		static bool IsReleasable(const Block* pAllocator, const Block* pBlock)
+		{
+			return pBlock != pAllocator && pBlock->FreeCount == pBlock->Capacity;
+		}
+	};
+}
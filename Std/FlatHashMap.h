@@ -0,0 +1,609 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <new>
+#include <string.h>
+#include <functional>
+#include <initializer_list>
+#include "KeyValuePair.h"
+#include "Utility.h"
+#include "Hash.h"
+#include "Simd.h"
+
+namespace StlStd
+{
+	//Control byte of a slot, a full slot stores the lower 7 bits of the hash (0 - 127)
+	struct FlatControl
+	{
+		static const int8_t EMPTY = -128;
+		static const int8_t DELETED = -2;
+		//Placed after the last slot so the iterators know where to stop
+		static const int8_t SENTINEL = -1;
+
+		static bool IsFull(const int8_t control) { return control >= 0; }
+	};
+
+	//A group of control bytes that is probed at once
+	struct FlatGroup
+	{
+		static const size_t WIDTH = 16;
+
+		explicit FlatGroup(const int8_t* pControl)
+		{
+#ifdef STLSTD_SSE2
+			Control = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl));
+#else
+			pBytes = pControl;
+#endif
+		}
+
+		//Bitmask of the slots whose control byte equals the given hash bits
+		uint32_t Match(const int8_t h2) const
+		{
+#ifdef STLSTD_SSE2
+			return (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), Control));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < WIDTH; ++i)
+			{
+				if (pBytes[i] == h2)
+					mask |= 1u << i;
+			}
+			return mask;
+#endif
+		}
+
+		uint32_t MatchEmpty() const
+		{
+			return Match(FlatControl::EMPTY);
+		}
+
+		uint32_t MatchEmptyOrDeleted() const
+		{
+#ifdef STLSTD_SSE2
+			return (uint32_t)_mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(FlatControl::SENTINEL), Control));
+#else
+			uint32_t mask = 0;
+			for (size_t i = 0; i < WIDTH; ++i)
+			{
+				if (pBytes[i] < FlatControl::SENTINEL)
+					mask |= 1u << i;
+			}
+			return mask;
+#endif
+		}
+
+#ifdef STLSTD_SSE2
+		__m128i Control;
+#else
+		const int8_t* pBytes;
+#endif
+	};
+
+	template<typename K, typename V>
+	struct FlatHashIterator
+	{
+		FlatHashIterator(int8_t* pControl, KeyValuePair<K, V>* pSlot) :
+			pControl(pControl), pSlot(pSlot)
+		{}
+
+		FlatHashIterator(const FlatHashIterator& other) :
+			pControl(other.pControl), pSlot(other.pSlot)
+		{
+		}
+
+		FlatHashIterator& operator=(const FlatHashIterator& other)
+		{
+			pControl = other.pControl;
+			pSlot = other.pSlot;
+			return *this;
+		}
+
+		FlatHashIterator& operator++()
+		{
+			++pControl;
+			++pSlot;
+			SkipEmpty();
+			return *this;
+		}
+
+		FlatHashIterator operator++(int)
+		{
+			FlatHashIterator it = *this;
+			++(*this);
+			return it;
+		}
+
+		//Move forward until a full slot or the sentinel is reached
+		void SkipEmpty()
+		{
+			if (pControl == nullptr)
+				return;
+			while (*pControl < FlatControl::SENTINEL)
+			{
+				++pControl;
+				++pSlot;
+			}
+		}
+
+		bool operator==(const FlatHashIterator& other) const { return pControl == other.pControl; }
+		bool operator!=(const FlatHashIterator& other) const { return pControl != other.pControl; }
+
+		KeyValuePair<K, V>* operator->() const { return pSlot; }
+		KeyValuePair<K, V>& operator*() const { return *pSlot; }
+
+		int8_t* pControl;
+		KeyValuePair<K, V>* pSlot;
+	};
+
+	template<typename K, typename V>
+	struct FlatHashConstIterator
+	{
+		FlatHashConstIterator(int8_t* pControl, KeyValuePair<K, V>* pSlot) :
+			pControl(pControl), pSlot(pSlot)
+		{}
+
+		FlatHashConstIterator(const FlatHashConstIterator& other) :
+			pControl(other.pControl), pSlot(other.pSlot)
+		{
+		}
+
+		FlatHashConstIterator& operator=(const FlatHashConstIterator& other)
+		{
+			pControl = other.pControl;
+			pSlot = other.pSlot;
+			return *this;
+		}
+
+		FlatHashConstIterator& operator++()
+		{
+			++pControl;
+			++pSlot;
+			SkipEmpty();
+			return *this;
+		}
+
+		FlatHashConstIterator operator++(int)
+		{
+			FlatHashConstIterator it = *this;
+			++(*this);
+			return it;
+		}
+
+		//Move forward until a full slot or the sentinel is reached
+		void SkipEmpty()
+		{
+			if (pControl == nullptr)
+				return;
+			while (*pControl < FlatControl::SENTINEL)
+			{
+				++pControl;
+				++pSlot;
+			}
+		}
+
+		bool operator==(const FlatHashConstIterator& other) const { return pControl == other.pControl; }
+		bool operator!=(const FlatHashConstIterator& other) const { return pControl != other.pControl; }
+
+		const KeyValuePair<K, V>* operator->() const { return pSlot; }
+		const KeyValuePair<K, V>& operator*() const { return *pSlot; }
+
+		int8_t* pControl;
+		KeyValuePair<K, V>* pSlot;
+	};
+
+	//Open addressing hash map.
+	//The pairs are stored inline in one flat array next to an array of 1 byte control values.
+	//A lookup compares the 7 hash bits in the control bytes of a whole group (16 slots) at once
+	//and only touches the pairs of which the hash bits match.
+	//Unlike HashMap, pointers and iterators are invalidated when the table grows.
+	template<typename K, typename V, typename HashType = std::hash<K>, typename KeyEqual = StlStd::EqualTo<K>>
+	class FlatHashMap
+	{
+	public:
+		using Iterator = FlatHashIterator<K, V>;
+		using ConstIterator = FlatHashConstIterator<K, V>;
+		using Slot = KeyValuePair<K, V>;
+
+	public:
+		FlatHashMap() :
+			m_pControl(nullptr), m_pSlots(nullptr), m_Capacity(0), m_Size(0), m_GrowthLeft(0)
+		{
+			AllocateSlots(START_CAPACITY);
+		}
+
+		FlatHashMap(const std::initializer_list<KeyValuePair<K, V>>& list) :
+			m_pControl(nullptr), m_pSlots(nullptr), m_Capacity(0), m_Size(0), m_GrowthLeft(0)
+		{
+			AllocateSlots(CapacityFor(list.size()));
+			for (const KeyValuePair<K, V>* pPair = list.begin(); pPair != list.end(); ++pPair)
+			{
+				Insert(pPair->Key, pPair->Value);
+			}
+		}
+
+		FlatHashMap(const FlatHashMap& other) :
+			m_pControl(nullptr), m_pSlots(nullptr), m_Capacity(0), m_Size(0), m_GrowthLeft(0), m_Hasher(other.m_Hasher)
+		{
+			AllocateSlots(CapacityFor(other.m_Size));
+			Insert(other);
+		}
+
+		FlatHashMap(FlatHashMap&& other) :
+			m_pControl(other.m_pControl), m_pSlots(other.m_pSlots), m_Capacity(other.m_Capacity), m_Size(other.m_Size), m_GrowthLeft(other.m_GrowthLeft), m_Hasher(other.m_Hasher)
+		{
+			other.m_pControl = nullptr;
+			other.m_pSlots = nullptr;
+			other.m_Capacity = 0;
+			other.m_Size = 0;
+			other.m_GrowthLeft = 0;
+		}
+
+		~FlatHashMap()
+		{
+			if (m_pControl)
+			{
+				Clear();
+				FreeSlots(m_pControl, m_pSlots);
+				m_pControl = nullptr;
+				m_pSlots = nullptr;
+			}
+		}
+
+		FlatHashMap& operator=(const FlatHashMap& other)
+		{
+			//If not self
+			if (this != &other)
+			{
+				Clear();
+				Insert(other);
+			}
+			return *this;
+		}
+
+		FlatHashMap& operator=(FlatHashMap&& other)
+		{
+			//If not self
+			if (this != &other)
+				Swap(other);
+			return *this;
+		}
+
+		FlatHashMap& operator+=(const KeyValuePair<K, V>& pair)
+		{
+			Insert(pair);
+			return *this;
+		}
+
+		FlatHashMap& operator+=(const FlatHashMap& map)
+		{
+			//If not self
+			if (this != &map)
+				Insert(map);
+			return *this;
+		}
+
+		bool operator==(const FlatHashMap& other) const
+		{
+			if (m_Size != other.m_Size)
+				return false;
+
+			for (ConstIterator pIt = Begin(); pIt != End(); ++pIt)
+			{
+				ConstIterator pFound = other.Find(pIt->Key);
+				if (pFound == other.End() || pFound->Value != pIt->Value)
+					return false;
+			}
+			return true;
+		}
+
+		bool operator!=(const FlatHashMap& other) const
+		{
+			return !operator==(other);
+		}
+
+		void Insert(const FlatHashMap& map)
+		{
+			for (ConstIterator pIt = map.Begin(); pIt != map.End(); ++pIt)
+				Insert(pIt->Key, pIt->Value);
+		}
+
+		void Swap(FlatHashMap& other)
+		{
+			StlStd::Swap(m_pControl, other.m_pControl);
+			StlStd::Swap(m_pSlots, other.m_pSlots);
+			StlStd::Swap(m_Capacity, other.m_Capacity);
+			StlStd::Swap(m_Size, other.m_Size);
+			StlStd::Swap(m_GrowthLeft, other.m_GrowthLeft);
+		}
+
+		Iterator Insert(const KeyValuePair<K, V>& pair)
+		{
+			return Insert(pair.Key, pair.Value);
+		}
+
+		Iterator Insert(const K& key, const V& value)
+		{
+			size_t index = GetOrCreate_Internal(key);
+			m_pSlots[index].Value = value;
+			return Iterator(m_pControl + index, m_pSlots + index);
+		}
+
+		Iterator Erase(const K& key)
+		{
+			const size_t index = Find_Internal(key);
+			if (index == NPOS)
+				return End();
+			return EraseAt(index);
+		}
+
+		Iterator Erase(const Iterator& it)
+		{
+			return EraseAt((size_t)(it.pSlot - m_pSlots));
+		}
+
+		void Clear()
+		{
+			if (m_Capacity == 0)
+				return;
+			for (size_t i = 0; i < m_Capacity; ++i)
+			{
+				if (FlatControl::IsFull(m_pControl[i]))
+					m_pSlots[i].~Slot();
+			}
+			memset(m_pControl, FlatControl::EMPTY, m_Capacity);
+			m_Size = 0;
+			m_GrowthLeft = MaxElements(m_Capacity);
+		}
+
+		//Make sure the amount of elements fits without growing the table
+		void Reserve(const size_t size)
+		{
+			if (size > MaxElements(m_Capacity))
+				Rehash(CapacityFor(size));
+		}
+
+		Iterator Find(const K& key)
+		{
+			const size_t index = Find_Internal(key);
+			if (index == NPOS)
+				return End();
+			return Iterator(m_pControl + index, m_pSlots + index);
+		}
+
+		ConstIterator Find(const K& key) const
+		{
+			const size_t index = Find_Internal(key);
+			if (index == NPOS)
+				return End();
+			return ConstIterator(m_pControl + index, m_pSlots + index);
+		}
+
+		bool Contains(const K& key) const
+		{
+			return Find_Internal(key) != NPOS;
+		}
+
+		const V& operator[](const K& key) const
+		{
+			const size_t index = Find_Internal(key);
+			assert(index != NPOS);
+			return m_pSlots[index].Value;
+		}
+		V& operator[](const K& key)
+		{
+			//The table can be reallocated, so the index has to be known before the slots are accessed
+			const size_t index = GetOrCreate_Internal(key);
+			return m_pSlots[index].Value;
+		}
+
+		size_t Size() const { return m_Size; }
+		bool Empty() const { return m_Size == 0; }
+		//The amount of slots in the table
+		size_t BucketCount() const { return m_Capacity; }
+		constexpr float MaxLoadFactor() const { return (float)MAX_LOAD_NUMERATOR / MAX_LOAD_DENOMINATOR; }
+		float LoadFactor() const { return m_Capacity ? (float)m_Size / m_Capacity : 0.0f; }
+
+		//The amount of slots to start with, has to be a multiple of the group width
+		static const size_t START_CAPACITY = FlatGroup::WIDTH;
+
+		Iterator Begin() { Iterator it(m_pControl, m_pSlots); it.SkipEmpty(); return it; }
+		ConstIterator Begin() const { ConstIterator it(m_pControl, m_pSlots); it.SkipEmpty(); return it; }
+		Iterator End() { return Iterator(m_pControl + m_Capacity, m_pSlots + m_Capacity); }
+		ConstIterator End() const { return ConstIterator(m_pControl + m_Capacity, m_pSlots + m_Capacity); }
+
+		//Support range based for-loop
+		Iterator begin() { return Begin(); }
+		ConstIterator begin() const { return Begin(); }
+		Iterator end() { return End(); }
+		ConstIterator end() const { return End(); }
+
+	private:
+		static const size_t NPOS = ~(size_t)0;
+		//The table grows when it is 7/8 full
+		static const size_t MAX_LOAD_NUMERATOR = 7;
+		static const size_t MAX_LOAD_DENOMINATOR = 8;
+
+		//The hash is split in the group to start probing at (H1) and the 7 bits stored in the control byte (H2)
+		inline size_t Hash(const K& key) const
+		{
+			return HashMix(m_Hasher(key));
+		}
+
+		static inline size_t H1(const size_t hash) { return hash >> 7; }
+		static inline int8_t H2(const size_t hash) { return (int8_t)(hash & 0x7F); }
+
+		static inline size_t MaxElements(const size_t capacity)
+		{
+			return capacity / MAX_LOAD_DENOMINATOR * MAX_LOAD_NUMERATOR;
+		}
+
+		//The smallest power of two capacity that can hold the amount of elements
+		static size_t CapacityFor(const size_t size)
+		{
+			size_t capacity = START_CAPACITY;
+			while (MaxElements(capacity) < size)
+				capacity <<= 1;
+			return capacity;
+		}
+
+		//Probe the groups in triangular steps (+1, +2, +3, ...), this visits every group when the group count is a power of two
+		size_t Find_Internal(const K& key) const
+		{
+			if (m_Size == 0)
+				return NPOS;
+
+			const size_t hash = Hash(key);
+			const int8_t h2 = H2(hash);
+			const size_t groupMask = m_Capacity / FlatGroup::WIDTH - 1;
+			size_t group = H1(hash) & groupMask;
+			KeyEqual equal;
+			for (size_t step = 1; ; ++step)
+			{
+				const size_t offset = group * FlatGroup::WIDTH;
+				FlatGroup controls(m_pControl + offset);
+				for (uint32_t mask = controls.Match(h2); mask != 0; mask &= mask - 1)
+				{
+					const size_t index = offset + CountTrailingZeros(mask);
+					if (equal(m_pSlots[index].Key, key))
+						return index;
+				}
+				//A group with an empty slot ends the probe sequence
+				if (controls.MatchEmpty() != 0)
+					return NPOS;
+				group = (group + step) & groupMask;
+			}
+		}
+
+		//The first slot in the probe sequence that isn't full
+		size_t FindFreeSlot(const size_t hash) const
+		{
+			const size_t groupMask = m_Capacity / FlatGroup::WIDTH - 1;
+			size_t group = H1(hash) & groupMask;
+			for (size_t step = 1; ; ++step)
+			{
+				const size_t offset = group * FlatGroup::WIDTH;
+				const uint32_t mask = FlatGroup(m_pControl + offset).MatchEmptyOrDeleted();
+				if (mask != 0)
+					return offset + CountTrailingZeros(mask);
+				group = (group + step) & groupMask;
+			}
+		}
+
+		//Get the index of the slot with the key, a default constructed value is created if it doesn't exist
+		size_t GetOrCreate_Internal(const K& key)
+		{
+			if (m_Capacity == 0)
+				AllocateSlots(START_CAPACITY);
+
+			const size_t existing = Find_Internal(key);
+			if (existing != NPOS)
+				return existing;
+
+			const size_t hash = Hash(key);
+			size_t index = FindFreeSlot(hash);
+			//Reusing a deleted slot doesn't use up an empty one
+			if (m_GrowthLeft == 0 && m_pControl[index] == FlatControl::EMPTY)
+			{
+				//When more than half of the used slots are deleted, rehashing at the same capacity is enough
+				Rehash(m_Size * 2 < MaxElements(m_Capacity) ? m_Capacity : m_Capacity << 1);
+				index = FindFreeSlot(hash);
+			}
+
+			if (m_pControl[index] == FlatControl::EMPTY)
+				--m_GrowthLeft;
+			new(m_pSlots + index) Slot(key);
+			m_pControl[index] = H2(hash);
+			++m_Size;
+			return index;
+		}
+
+		Iterator EraseAt(const size_t index)
+		{
+			assert(index < m_Capacity && FlatControl::IsFull(m_pControl[index]));
+			m_pSlots[index].~Slot();
+			--m_Size;
+
+			//Every probe sequence that reached this group already stopped here if it has an empty slot,
+			//so the slot can become empty again. Otherwise a tombstone keeps the sequences going.
+			const size_t offset = index & ~(FlatGroup::WIDTH - 1);
+			if (FlatGroup(m_pControl + offset).MatchEmpty() != 0)
+			{
+				m_pControl[index] = FlatControl::EMPTY;
+				++m_GrowthLeft;
+			}
+			else
+			{
+				m_pControl[index] = FlatControl::DELETED;
+			}
+
+			Iterator it(m_pControl + index, m_pSlots + index);
+			it.SkipEmpty();
+			return it;
+		}
+
+		//Move all the elements to a new table, this also removes all the tombstones
+		void Rehash(const size_t capacity)
+		{
+			int8_t* pOldControl = m_pControl;
+			Slot* pOldSlots = m_pSlots;
+			const size_t oldCapacity = m_Capacity;
+
+			AllocateSlots(capacity);
+			for (size_t i = 0; i < oldCapacity; ++i)
+			{
+				if (!FlatControl::IsFull(pOldControl[i]))
+					continue;
+				const size_t hash = Hash(pOldSlots[i].Key);
+				const size_t index = FindFreeSlot(hash);
+				new(m_pSlots + index) Slot(Move(pOldSlots[i]));
+				m_pControl[index] = H2(hash);
+				pOldSlots[i].~Slot();
+			}
+			m_GrowthLeft -= m_Size;
+
+			if (pOldControl)
+				FreeSlots(pOldControl, pOldSlots);
+		}
+
+		///////////Allocations///////////
+
+		void AllocateSlots(const size_t capacity)
+		{
+			assert(capacity % FlatGroup::WIDTH == 0);
+			//One extra control byte for the sentinel
+			m_pControl = new int8_t[capacity + 1];
+			memset(m_pControl, FlatControl::EMPTY, capacity);
+			m_pControl[capacity] = FlatControl::SENTINEL;
+			m_pSlots = static_cast<Slot*>(::operator new(sizeof(Slot) * capacity));
+			m_Capacity = capacity;
+			m_GrowthLeft = MaxElements(capacity);
+		}
+
+		void FreeSlots(int8_t* pControl, Slot* pSlots)
+		{
+			delete[] pControl;
+			::operator delete(pSlots);
+		}
+
+	private:
+		//The control bytes, one for each slot and the sentinel
+		int8_t* m_pControl;
+		//The pairs, only the slots with a full control byte are constructed
+		Slot* m_pSlots;
+		//The amount of slots
+		size_t m_Capacity;
+		//The amount of elements in the map
+		size_t m_Size;
+		//The amount of empty slots that can still be used before the table has to grow
+		size_t m_GrowthLeft;
+		//The hash functor
+		HashType m_Hasher;
+	};
+
+	template<typename K, typename V, typename HashType, typename KeyEqual>
+	inline void Swap(FlatHashMap<K, V, HashType, KeyEqual>& a, FlatHashMap<K, V, HashType, KeyEqual>& b)
+	{
+		a.Swap(b);
+	}
+}
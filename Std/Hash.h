@@ -1,4 +1,6 @@
 #pragma once
+#include <stdint.h>
+#include "Simd.h"
 
 #ifdef _WIN64
 #define FNV_PRIME 1099511628211
@@ -31,6 +33,67 @@ namespace StlStd
 		}
 		return hash;
 	}
+
+	//Finalizer of MurmurHash3, spreads the entropy of a weak hash (eg. the identity hash of integers) over all the bits
+	inline size_t HashMix(const size_t hash)
+	{
+		uint64_t mixed = hash;
+		mixed ^= mixed >> 33;
+		mixed *= 0xff51afd7ed558ccdULL;
+		mixed ^= mixed >> 33;
+		mixed *= 0xc4ceb9fe1a85ec53ULL;
+		mixed ^= mixed >> 33;
+		return (size_t)mixed;
+	}
+
+	//Maps hashes on a power of two amount of buckets with fibonacci hashing.
+	//The hash is multiplied with 2^64 / golden ratio and the top bits of the product pick the bucket,
+	//those depend on all the bits of the hash so weak hashers (eg. the identity hash of integers) still spread well.
+	//This is a lot cheaper than the modulo of PrimeBucketPolicy.
+	struct PowerOfTwoBucketPolicy
+	{
+		//The smallest valid bucket count that is at least the given count
+		static size_t BucketCount(const size_t minCount)
+		{
+			size_t count = 1;
+			while (count < minCount)
+				count <<= 1;
+			return count;
+		}
+
+		static size_t Index(const size_t hash, const size_t bucketCount)
+		{
+			const uint64_t product = (uint64_t)hash * 11400714819323198485ULL;
+			//Shift in two steps so a single bucket doesn't shift by 64
+			return (size_t)((product >> (63 - FloorLog2(bucketCount))) >> 1);
+		}
+	};
+
+	//Maps hashes on a prime amount of buckets with a modulo.
+	//Slower than the mask, but all the bits of the hash are used without mixing which suits hashers with a bad distribution.
+	struct PrimeBucketPolicy
+	{
+		static size_t BucketCount(const size_t minCount)
+		{
+			static const size_t PRIMES[] = {
+				5ul, 11ul, 23ul, 53ul, 97ul, 193ul, 389ul, 769ul, 1543ul, 3079ul, 6151ul, 12289ul, 24593ul,
+				49157ul, 98317ul, 196613ul, 393241ul, 786433ul, 1572869ul, 3145739ul, 6291469ul, 12582917ul,
+				25165843ul, 50331653ul, 100663319ul, 201326611ul, 402653189ul, 805306457ul, 1610612741ul, 4294967291ul,
+			};
+			for (size_t i = 0; i < sizeof(PRIMES) / sizeof(PRIMES[0]); ++i)
+			{
+				if (PRIMES[i] >= minCount)
+					return PRIMES[i];
+			}
+			//Beyond the table an odd count is good enough
+			return minCount | 1;
+		}
+
+		static size_t Index(const size_t hash, const size_t bucketCount)
+		{
+			return hash % bucketCount;
+		}
+	};
 }
 
 #undef FNV_PRIME
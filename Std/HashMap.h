@@ -1,7 +1,10 @@
 #pragma once
 #include <assert.h>
+#include <functional>
 #include "BlockAllocator.h"
+#include "Hash.h"
 #include "KeyValuePair.h"
+#include "Pair.h"
 #include "Utility.h"
 
 namespace StlStd
@@ -19,6 +22,10 @@ namespace StlStd
 		HashNode(const K& key) :
 			Pair(key), pPrev(nullptr), pNext(nullptr), pDown(nullptr)
 		{}
+		template<typename KeyArg, typename... Args>
+		HashNode(InPlace inPlace, KeyArg&& key, Args&&... args) :
+			Pair(inPlace, Forward<KeyArg>(key), Forward<Args>(args)...), pPrev(nullptr), pNext(nullptr), pDown(nullptr)
+		{}
 
 		KeyValuePair<K, V> Pair;
 		//The previous node in the linked list
@@ -147,7 +154,10 @@ namespace StlStd
 		Node* pNode;
 	};
 
-	template<typename K, typename V, typename HashType = std::hash<K>, typename KeyEqual = StlStd::EqualTo<K>>
+	//BucketPolicy decides the amount of buckets and how a hash is mapped on a bucket, see PowerOfTwoBucketPolicy.
+	//The table is rehashed at once when it grows, unless incremental rehashing is enabled with SetIncrementalRehash.
+	//NodeAllocator allocates the nodes, BlockAllocator or ConcurrentBlockAllocator when the nodes are allocated and freed on several threads.
+	template<typename K, typename V, typename HashType = std::hash<K>, typename KeyEqual = StlStd::EqualTo<K>, typename BucketPolicy = PowerOfTwoBucketPolicy, typename NodeAllocator = BlockAllocator>
 	class HashMap
 	{
 	public:
@@ -155,20 +165,32 @@ namespace StlStd
 		using ConstIterator = HashConstIterator<K, V>;
 		using Node = HashNode<K, V>;
 
+	private:
+		//Enables the lookups with another key type when both functors are transparent
+		template<typename Key>
+		using EnableIfTransparent = EnableIfT<IsTransparent<HashType>::Value && IsTransparent<KeyEqual>::Value, Key>;
+
 	public:
 		HashMap() :
-			m_pTable(nullptr), m_Size(0)
+			HashMap(GetDefaultResource())
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node));
+		}
+
+		//The nodes and the table are allocated from the resource, which has to outlive the map
+		explicit HashMap(MemoryResource* pResource) :
+			m_Size(0), m_pTable(nullptr), m_pOldTable(nullptr), m_OldBucketCount(0), m_MigrateBucket(0), m_pNextTable(nullptr), m_NextCleared(0), m_RehashStep(0), m_MaxLoadFactor(0.75f), m_pResource(pResource)
+		{
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), 1, pResource, alignof(Node));
 			AllocateBuckets(START_BUCKETS);
 			m_pHead = ReserveNode();
 			m_pTail = m_pHead;
 		}
 
-		HashMap(const std::initializer_list<KeyValuePair<K, V>>& list) :
-			m_pTable(nullptr), m_Size(0)
+		HashMap(const std::initializer_list<KeyValuePair<K, V>>& list, MemoryResource* pResource = GetDefaultResource()) :
+			m_Size(0), m_pTable(nullptr), m_pOldTable(nullptr), m_OldBucketCount(0), m_MigrateBucket(0), m_pNextTable(nullptr), m_NextCleared(0), m_RehashStep(0), m_MaxLoadFactor(0.75f), m_pResource(pResource)
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node), list.size() + 1);
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), list.size() + 1, pResource, alignof(Node));
+			AllocateBuckets(StartBucketCount(list.size()));
 			m_pHead = ReserveNode();
 			m_pTail = m_pHead;
 			for (const KeyValuePair<K, V>* pPair = list.begin(); pPair != list.end(); ++pPair)
@@ -177,24 +199,50 @@ namespace StlStd
 			}
 		}
 
-		HashMap(const HashMap& other) :
-			m_pTable(nullptr), m_Size(0), m_BucketCount(other.m_BucketCount)
+		//Build the map from a range of key value pairs, the table and the nodes are sized once for the whole range.
+		//The iterators need to support subtraction to know the size of the range up front.
+		template<typename InputIterator>
+		HashMap(InputIterator first, InputIterator last, MemoryResource* pResource = GetDefaultResource()) :
+			m_Size(0), m_pTable(nullptr), m_pOldTable(nullptr), m_OldBucketCount(0), m_MigrateBucket(0), m_pNextTable(nullptr), m_NextCleared(0), m_RehashStep(0), m_MaxLoadFactor(0.75f), m_pResource(pResource)
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node), other.m_Size + 1);
-			AllocateBuckets(START_BUCKETS);
+			const size_t count = (size_t)(last - first);
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), count + 1, pResource, alignof(Node));
+			AllocateBuckets(StartBucketCount(count));
+			m_pHead = ReserveNode();
+			m_pTail = m_pHead;
+			for (; first != last; ++first)
+			{
+				Insert(first->Key, first->Value);
+			}
+		}
+
+		//The copy uses the default resource unless it is given one
+		HashMap(const HashMap& other, MemoryResource* pResource = GetDefaultResource()) :
+			m_BucketCount(other.m_BucketCount), m_Size(0), m_pTable(nullptr), m_pOldTable(nullptr), m_OldBucketCount(0), m_MigrateBucket(0), m_pNextTable(nullptr), m_NextCleared(0), m_RehashStep(other.m_RehashStep), m_MaxLoadFactor(other.m_MaxLoadFactor), m_pResource(pResource)
+		{
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), other.m_Size + 1, pResource, alignof(Node));
+			AllocateBuckets(StartBucketCount(other.m_Size));
 			m_pHead = ReserveNode();
 			m_pTail = m_pHead;
 			Insert(other);
 		}
 
 		HashMap(HashMap&& other) :
-			m_BucketCount(other.m_BucketCount), m_Size(other.m_Size), m_pHead(other.m_pHead), m_pTail(other.m_pTail), m_pTable(other.m_pTable), m_pBlock(other.m_pBlock), m_Hasher(other.m_Hasher)
+			m_BucketCount(other.m_BucketCount), m_Size(other.m_Size), m_pHead(other.m_pHead), m_pTail(other.m_pTail), m_pTable(other.m_pTable),
+			m_pOldTable(other.m_pOldTable), m_OldBucketCount(other.m_OldBucketCount), m_MigrateBucket(other.m_MigrateBucket),
+			m_pNextTable(other.m_pNextTable), m_NextCleared(other.m_NextCleared), m_RehashStep(other.m_RehashStep),
+			m_MaxLoadFactor(other.m_MaxLoadFactor), m_pBlock(other.m_pBlock), m_pResource(other.m_pResource), m_Hasher(other.m_Hasher)
 		{
 			other.m_BucketCount = 0;
 			other.m_Size = 0;
 			other.m_pHead = nullptr;
 			other.m_pTail = nullptr;
 			other.m_pTable = nullptr;
+			other.m_pOldTable = nullptr;
+			other.m_OldBucketCount = 0;
+			other.m_MigrateBucket = 0;
+			other.m_pNextTable = nullptr;
+			other.m_NextCleared = 0;
 			other.m_pBlock = nullptr;
 		}
 
@@ -205,10 +253,11 @@ namespace StlStd
 				Clear();
 				FreeNode(m_pHead);
 				m_pHead = nullptr;
-				delete[] m_pTable;
+				FreeTable(m_pTable, m_BucketCount);
 				m_pTable = nullptr;
+				FreeNextTable();
 
-				BlockAllocator::Uninitialize(m_pBlock);
+				NodeAllocator::Uninitialize(m_pBlock);
 			}
 		}
 
@@ -218,6 +267,8 @@ namespace StlStd
 			if (this != &other)
 			{
 				Clear();
+				m_MaxLoadFactor = other.m_MaxLoadFactor;
+				Reserve(other.m_Size);
 				Insert(other);
 			}
 			return *this;
@@ -288,60 +339,77 @@ namespace StlStd
 			StlStd::Swap(m_pHead, other.m_pHead);
 			StlStd::Swap(m_pTail, other.m_pTail);
 			StlStd::Swap(m_pTable, other.m_pTable);
+			StlStd::Swap(m_pOldTable, other.m_pOldTable);
+			StlStd::Swap(m_OldBucketCount, other.m_OldBucketCount);
+			StlStd::Swap(m_MigrateBucket, other.m_MigrateBucket);
+			StlStd::Swap(m_pNextTable, other.m_pNextTable);
+			StlStd::Swap(m_NextCleared, other.m_NextCleared);
+			StlStd::Swap(m_RehashStep, other.m_RehashStep);
+			StlStd::Swap(m_MaxLoadFactor, other.m_MaxLoadFactor);
 			StlStd::Swap(m_pBlock, other.m_pBlock);
+			StlStd::Swap(m_pResource, other.m_pResource);
 		}
 
 		Iterator Insert(const KeyValuePair<K, V>& pair)
 		{
-			Iterator pIt = GetOrCreate_Internal(pair.Key);
-			pIt.pNode->Pair.Value = pair.Value;
-			return pIt;
+			return Emplace_Internal(true, pair.Key, pair.Value).First;
+		}
+
+		Iterator Insert(KeyValuePair<K, V>&& pair)
+		{
+			return Emplace_Internal(true, Move(pair.Key), Move(pair.Value)).First;
 		}
 
 		Iterator Insert(const K& key, const V& value)
-		{	
-			Iterator pIt = GetOrCreate_Internal(key);
-			pIt.pNode->Pair.Value = value;
-			return pIt;
+		{
+			return Emplace_Internal(true, key, value).First;
+		}
+
+		Iterator Insert(K&& key, V&& value)
+		{
+			return Emplace_Internal(true, Move(key), Move(value)).First;
+		}
+
+		//Insert or replace the value of the key, the value is constructed from the arguments.
+		//A new element is constructed in place in its node, an existing value is assigned the value argument directly
+		//or a value constructed from the other arguments.
+		template<typename... Args>
+		Iterator Emplace(const K& key, Args&&... args)
+		{
+			return Emplace_Internal(true, key, Forward<Args>(args)...).First;
+		}
+
+		template<typename... Args>
+		Iterator Emplace(K&& key, Args&&... args)
+		{
+			return Emplace_Internal(true, Move(key), Forward<Args>(args)...).First;
+		}
+
+		//Only constructs the value in place when the key isn't in the map yet, the arguments are left untouched otherwise.
+		//The bool is true when the element is inserted.
+		template<typename... Args>
+		Pair<Iterator, bool> TryEmplace(const K& key, Args&&... args)
+		{
+			Pair<Node*, bool> result = Emplace_Internal(false, key, Forward<Args>(args)...);
+			return Pair<Iterator, bool>(Iterator(result.First), result.Second);
+		}
+
+		template<typename... Args>
+		Pair<Iterator, bool> TryEmplace(K&& key, Args&&... args)
+		{
+			Pair<Node*, bool> result = Emplace_Internal(false, Move(key), Forward<Args>(args)...);
+			return Pair<Iterator, bool>(Iterator(result.First), result.Second);
 		}
 
 		Iterator Erase(const K& key)
 		{
-			size_t hash = Hash(key);
-			Node* pNode = m_pTable[hash];
-			if (pNode == nullptr)
-				return Iterator(m_pTail);
-			Node* pUp = nullptr;
-			Node* pNext = pNode->pNext;
-			KeyEqual equal;
-			while (pNode != nullptr)
-			{
-				if (equal(key, pNode->Pair.Key))
-				{
-					if (pUp)
-					{
-						//Delete from the bucket
-						pUp->pDown = pNode->pDown;
-					}
-					//Delete from the linked list
-					Node* pPrev = pNode->pPrev;
-					if(pPrev)
-						pPrev->pNext = pNode->pNext;
-					if(pNode->pNext)
-						pNode->pNext->pPrev = pPrev;
-
-					//If it was the head, replace the head
-					if (pNode == m_pHead)
-						m_pHead = pNode->pNext;
-
-					FreeNode(pNode);
-					--m_Size;
-					break;
-				}
-				pUp = pNode;
-				pNode = pNode->pDown;
-			}
-			return Iterator(pNext);
+			return Erase_Internal(key);
+		}
+
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		Iterator Erase(const Key& key)
+		{
+			return Erase_Internal(key);
 		}
 
 		Iterator Erase(const Iterator& it)
@@ -359,50 +427,140 @@ namespace StlStd
 				pNode = pNext;
 			}
 			m_pHead = m_pTail;
+			if (m_pTail)
+				m_pTail->pPrev = nullptr;
 			m_Size = 0;
+
+			for (size_t i = 0; i < m_BucketCount; ++i)
+				m_pTable[i] = nullptr;
+			if (m_pOldTable)
+			{
+				FreeTable(m_pOldTable, m_OldBucketCount);
+				m_pOldTable = nullptr;
+				m_OldBucketCount = 0;
+			}
 		}
 
 		Iterator Find(const K& key)
 		{
-			const size_t hash = Hash(key);
-			Node* pNode = m_pTable[hash];
-			KeyEqual equal;
-			while (pNode)
-			{
-				if (equal(pNode->Pair.Key, key))
-					return Iterator(pNode);
-				pNode = pNode->pDown;
-			}
-			return Iterator(m_pTail);
+			Node* pNode = FindNode(key);
+			return Iterator(pNode ? pNode : m_pTail);
 		}
 
 		ConstIterator Find(const K& key) const
 		{
-			const size_t hash = Hash(key);
-			Node* pNode = m_pTable[hash];
-			KeyEqual equal;
-			while (pNode)
-			{
-				if (equal(pNode->Pair.Key, key))
-					return ConstIterator(pNode);
-				pNode = pNode->pDown;
-			}
-			return ConstIterator(m_pTail);
+			Node* pNode = FindNode(key);
+			return ConstIterator(pNode ? pNode : m_pTail);
 		}
 
 		bool Contains(const K& key) const
 		{
-			return Find(key) != m_pTail;
+			return FindNode(key) != nullptr;
+		}
+
+		//Lookups with another type than K (eg. a const char* or StringView for String keys) when the hash and equal functors are
+		//transparent, see String::Hash and EqualTo<>. The key is hashed and compared as is, no K is created.
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		Iterator Find(const Key& key)
+		{
+			Node* pNode = FindNode(key);
+			return Iterator(pNode ? pNode : m_pTail);
+		}
+
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		ConstIterator Find(const Key& key) const
+		{
+			Node* pNode = FindNode(key);
+			return ConstIterator(pNode ? pNode : m_pTail);
+		}
+
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		bool Contains(const Key& key) const
+		{
+			return FindNode(key) != nullptr;
 		}
 
 		const V& operator[](const K& key) const { return Get(key)->Value; }
-		V& operator[](const K& key) { return GetOrCreate_Internal(key)->Value; }
+		V& operator[](const K& key) { return Emplace_Internal(false, key).First->Pair.Value; }
 
 		size_t Size() const { return m_Size; }
 		size_t BucketCount() const { return m_BucketCount; }
-		constexpr float MaxLoadFactor() const { return 0.75f; }
+		MemoryResource* GetResource() const { return m_pResource; }
+		float MaxLoadFactor() const { return m_MaxLoadFactor; }
 		float LoadFactor() const { return (float)m_Size / m_BucketCount; }
 
+		//The table grows when the load factor reaches the max load factor, rehashes right away when it is already over it
+		void SetMaxLoadFactor(const float maxLoadFactor)
+		{
+			assert(maxLoadFactor > 0.0f);
+			m_MaxLoadFactor = maxLoadFactor;
+			if (m_pTable && m_Size >= m_BucketCount * m_MaxLoadFactor)
+				Rehash(0);
+		}
+
+		//Make room for the given amount of elements, the table and the nodes don't grow until there are more
+		void Reserve(const size_t size)
+		{
+			NodeAllocator::Reserve(m_pBlock, size + 1);
+			const size_t bucketCount = MinBucketCount(size);
+			if (m_pTable == nullptr || bucketCount > m_BucketCount)
+				Rehash(bucketCount);
+		}
+
+		//Shrinks the table to the elements there are, and gives the blocks of nodes that have no elements left back to the
+		//resource
+		void ShrinkToFit()
+		{
+			if (m_pTable == nullptr)
+				return;
+			const size_t bucketCount = StartBucketCount(m_Size);
+			if (BucketPolicy::BucketCount(bucketCount) < m_BucketCount)
+				Rehash(bucketCount);
+			NodeAllocator::Trim(m_pBlock);
+		}
+
+		//The memory of the nodes, see BlockAllocator::Stats, with the tables counted as reserved and in use.
+		//Not const, counting the free nodes writes to the blocks of the allocator like Trim does. With a
+		//ConcurrentBlockAllocator no other thread can allocate or free nodes of the map while it runs.
+		typename NodeAllocator::Stats MemoryStats()
+		{
+			typename NodeAllocator::Stats stats = NodeAllocator::GetStats(m_pBlock);
+			size_t tableBytes = (m_BucketCount + m_OldBucketCount) * sizeof(Node*);
+			if (m_pNextTable)
+				tableBytes += NextBucketCount() * sizeof(Node*);
+			stats.BytesReserved += tableBytes;
+			stats.BytesInUse += tableBytes;
+			return stats;
+		}
+
+		//Rebuild the table with at least the given amount of buckets, but never less than needed for the max load factor.
+		//Finishes an incremental rehash that is still going on.
+		void Rehash(const size_t bucketCount)
+		{
+			FinishMigration();
+			FreeNextTable();
+			const size_t minCount = MinBucketCount(m_Size);
+			AllocateBuckets(bucketCount > minCount ? bucketCount : minCount);
+			RelinkNodes();
+		}
+
+		//Spread the rehash when the table grows over the following mutations (inserts and erases),
+		//each of them moves the given amount of buckets from the old table to the new one.
+		//The old and new table are both searched until all buckets are moved. 0 rehashes the table at once.
+		//The step is raised when it is too small to move the whole old table before the new table fills up, so a grow
+		//never has to finish a migration at once. The next table is also cleared in small parts on the inserts before it
+		//is needed.
+		void SetIncrementalRehash(const size_t bucketsPerStep)
+		{
+			FinishMigration();
+			FreeNextTable();
+			m_RehashStep = bucketsPerStep;
+		}
+
+		//Whether there are still elements in the old table
+		bool IsRehashing() const { return m_pOldTable != nullptr; }
+
+		//While rehashing incrementally, the elements that are still in the old table aren't counted
 		size_t BucketSize(const size_t idx) const
 		{
 			assert(idx < m_BucketCount);
@@ -438,19 +596,59 @@ namespace StlStd
 		ConstIterator end() const { return ConstIterator(m_pTail); }
 
 	private:
-		Iterator GetOrCreate_Internal(const K& key)
+		template<typename Key>
+		Iterator Erase_Internal(const Key& key)
+		{
+			if (m_pTable == nullptr)
+				return Iterator(m_pTail);
+			if (m_pOldTable)
+				MigrateBuckets(MigrateStep());
+
+			const size_t hash = m_Hasher(key);
+			Node* pNode = UnlinkFromBucket(m_pTable, BucketPolicy::Index(hash, m_BucketCount), key);
+			if (pNode == nullptr && m_pOldTable)
+				pNode = UnlinkFromBucket(m_pOldTable, BucketPolicy::Index(hash, m_OldBucketCount), key);
+			if (pNode == nullptr)
+				return Iterator(m_pTail);
+
+			//Delete from the linked list
+			Node* pPrev = pNode->pPrev;
+			Node* pNext = pNode->pNext;
+			if(pPrev)
+				pPrev->pNext = pNext;
+			if(pNext)
+				pNext->pPrev = pPrev;
+
+			//If it was the head, replace the head
+			if (pNode == m_pHead)
+				m_pHead = pNext;
+
+			FreeNode(pNode);
+			--m_Size;
+			return Iterator(pNext);
+		}
+
+		//Find the node of the key or create it, the key and value of a new node are constructed in place from the arguments.
+		//When replace is set, the value of an existing node is replaced with a value constructed from the arguments.
+		template<typename KeyArg, typename... Args>
+		Pair<Node*, bool> Emplace_Internal(const bool replace, KeyArg&& key, Args&&... args)
 		{
 			if (m_pTable == nullptr)
 				AllocateBuckets(START_BUCKETS);
+			if (m_pOldTable)
+				MigrateBuckets(MigrateStep());
 
 			//If it exists, change that
-			Iterator pExists = Find(key);
-			if (pExists != m_pTail)
+			const size_t hash = m_Hasher(key);
+			Node* pExists = FindNode(key, hash);
+			if (pExists != nullptr)
 			{
-				return pExists;
+				if (replace)
+					AssignValue(pExists->Pair.Value, Forward<Args>(args)...);
+				return Pair<Node*, bool>(pExists, false);
 			}
 
-			Node* pNewNode = ReserveNode(key);
+			Node* pNewNode = ReserveNode(Forward<KeyArg>(key), Forward<Args>(args)...);
 
 			//Add node to linked listed
 			Node* pPrev = m_pTail->pPrev;
@@ -464,40 +662,221 @@ namespace StlStd
 			if (m_pTail == m_pHead)
 				m_pHead = pNewNode;
 
-			//Add node to right bucket
-			size_t hash = Hash(key);
-			pNewNode->pDown = m_pTable[hash];
-			m_pTable[hash] = pNewNode;
+			//Add node to right bucket, the key might be moved into the node already
+			const size_t bucket = BucketPolicy::Index(hash, m_BucketCount);
+			pNewNode->pDown = m_pTable[bucket];
+			m_pTable[bucket] = pNewNode;
 			++m_Size;
 
-			if (m_Size >= m_BucketCount * MaxLoadFactor())
+			if (m_Size >= m_BucketCount * m_MaxLoadFactor)
+				Grow();
+			else if (m_RehashStep > 0)
+				PrepareNextTable();
+
+			return Pair<Node*, bool>(pNewNode, true);
+		}
+
+		//Look in the table, and in the old table while it is being migrated
+		template<typename Key>
+		Node* FindNode(const Key& key) const
+		{
+			return FindNode(key, m_Hasher(key));
+		}
+
+		template<typename Key>
+		Node* FindNode(const Key& key, const size_t hash) const
+		{
+			if (m_pTable == nullptr)
+				return nullptr;
+
+			KeyEqual equal;
+			for (Node* pNode = m_pTable[BucketPolicy::Index(hash, m_BucketCount)]; pNode; pNode = pNode->pDown)
+			{
+				if (equal(pNode->Pair.Key, key))
+					return pNode;
+			}
+			if (m_pOldTable)
+			{
+				for (Node* pNode = m_pOldTable[BucketPolicy::Index(hash, m_OldBucketCount)]; pNode; pNode = pNode->pDown)
+				{
+					if (equal(pNode->Pair.Key, key))
+						return pNode;
+				}
+			}
+			return nullptr;
+		}
+
+		//Remove the node with the key from the bucket chain, returns nullptr when it isn't in there
+		template<typename Key>
+		Node* UnlinkFromBucket(Node** pTable, const size_t bucket, const Key& key)
+		{
+			Node* pNode = pTable[bucket];
+			Node* pUp = nullptr;
+			KeyEqual equal;
+			while (pNode != nullptr)
+			{
+				if (equal(pNode->Pair.Key, key))
+				{
+					if (pUp)
+						pUp->pDown = pNode->pDown;
+					else
+						pTable[bucket] = pNode->pDown;
+					return pNode;
+				}
+				pUp = pNode;
+				pNode = pNode->pDown;
+			}
+			return nullptr;
+		}
+
+		void Grow()
+		{
+			if (m_RehashStep == 0)
 			{
 				AllocateBuckets(m_BucketCount << 1);
-				Rehash();
+				RelinkNodes();
+				return;
 			}
 
-			return Iterator(pNewNode);
+			//Only one old table is kept alive
+			FinishMigration();
+			const size_t count = NextBucketCount();
+			if (m_pNextTable == nullptr)
+			{
+				m_pNextTable = AllocateTable(count);
+				m_NextCleared = 0;
+			}
+			ClearNextTable(count, count);
+
+			m_pOldTable = m_pTable;
+			m_OldBucketCount = m_BucketCount;
+			m_MigrateBucket = 0;
+			m_pTable = m_pNextTable;
+			m_BucketCount = count;
+			m_pNextTable = nullptr;
+			m_NextCleared = 0;
+		}
+
+		//Once the table is half way to growing, clear a part of the next table on every insert.
+		//The parts are sized so the next table is cleared by the time the table grows.
+		void PrepareNextTable()
+		{
+			const size_t growSize = (size_t)(m_BucketCount * m_MaxLoadFactor);
+			const size_t prepareSize = growSize / 2;
+			if (m_Size < prepareSize)
+				return;
+
+			const size_t count = NextBucketCount();
+			if (m_pNextTable == nullptr)
+			{
+				m_pNextTable = AllocateTable(count);
+				m_NextCleared = 0;
+			}
+			ClearNextTable(count, count / (growSize - prepareSize + 1) + 1);
+		}
+
+		void ClearNextTable(const size_t count, const size_t amount)
+		{
+			const size_t end = amount < count - m_NextCleared ? m_NextCleared + amount : count;
+			for (; m_NextCleared < end; ++m_NextCleared)
+				m_pNextTable[m_NextCleared] = nullptr;
+		}
+
+		void FreeNextTable()
+		{
+			if (m_pNextTable)
+			{
+				FreeTable(m_pNextTable, NextBucketCount());
+				m_pNextTable = nullptr;
+				m_NextCleared = 0;
+			}
+		}
+
+		//Move the nodes of the next buckets of the old table to the new table
+		void MigrateBuckets(const size_t bucketCount)
+		{
+			if (m_pOldTable == nullptr)
+				return;
+
+			const size_t end = bucketCount < m_OldBucketCount - m_MigrateBucket ? m_MigrateBucket + bucketCount : m_OldBucketCount;
+			for (; m_MigrateBucket < end; ++m_MigrateBucket)
+			{
+				Node* pNode = m_pOldTable[m_MigrateBucket];
+				while (pNode)
+				{
+					Node* pDown = pNode->pDown;
+					const size_t hash = Hash(pNode->Pair.Key);
+					pNode->pDown = m_pTable[hash];
+					m_pTable[hash] = pNode;
+					pNode = pDown;
+				}
+				m_pOldTable[m_MigrateBucket] = nullptr;
+			}
+
+			if (m_MigrateBucket == m_OldBucketCount)
+			{
+				FreeTable(m_pOldTable, m_OldBucketCount);
+				m_pOldTable = nullptr;
+				m_OldBucketCount = 0;
+			}
+		}
+
+		void FinishMigration()
+		{
+			MigrateBuckets(m_OldBucketCount);
 		}
 
-		//Hash a key using the hash functor
+		//The buckets to move per mutation: the requested step, but at least enough to empty the old table in the mutations
+		//before the table grows again. Erases also move buckets, so growing takes at least that many mutations.
+		size_t MigrateStep() const
+		{
+			const size_t oldGrowSize = (size_t)(m_OldBucketCount * m_MaxLoadFactor);
+			const size_t growSize = (size_t)(m_BucketCount * m_MaxLoadFactor);
+			//One less for the rounding of the load factor
+			const size_t mutations = growSize > oldGrowSize + 1 ? growSize - oldGrowSize - 1 : 1;
+			const size_t minStep = (m_OldBucketCount + mutations - 1) / mutations;
+			return m_RehashStep > minStep ? m_RehashStep : minStep;
+		}
+
+		//Hash a key using the hash functor and map it on a bucket
 		inline size_t Hash(const K& key) const
 		{
-			return m_Hasher(key) % m_BucketCount;
+			return BucketPolicy::Index(m_Hasher(key), m_BucketCount);
 		}
 
-		void AllocateBuckets(const size_t count)
+		void AllocateBuckets(const size_t minCount)
 		{
 			if (m_pTable)
-				delete[] m_pTable;
-			m_pTable = new Node*[count];
+				FreeTable(m_pTable, m_BucketCount);
+			const size_t count = BucketPolicy::BucketCount(minCount);
+			m_pTable = AllocateTable(count);
 			m_BucketCount = count;
 
 			for (size_t i = 0; i < count; ++i)
 				m_pTable[i] = nullptr;
 		}
 
+		//The amount of buckets of the table to grow into, the next table is allocated and freed with this size
+		size_t NextBucketCount() const
+		{
+			return BucketPolicy::BucketCount(m_BucketCount << 1);
+		}
+
+		//The least amount of buckets that holds the given amount of elements without growing
+		size_t MinBucketCount(const size_t size) const
+		{
+			return (size_t)(size / m_MaxLoadFactor) + 1;
+		}
+
+		//The amount of buckets a constructor starts with for the given amount of elements
+		size_t StartBucketCount(const size_t size) const
+		{
+			const size_t bucketCount = MinBucketCount(size);
+			return bucketCount > START_BUCKETS ? bucketCount : START_BUCKETS;
+		}
+
 		//Rehash all the elements and place them in the right bucket
-		void Rehash()
+		void RelinkNodes()
 		{
 			for (Iterator pCurrent = begin(); pCurrent != end(); ++pCurrent)
 			{
@@ -510,24 +889,35 @@ namespace StlStd
 
 		///////////Allocations///////////
 
+		Node** AllocateTable(const size_t count)
+		{
+			return static_cast<Node**>(m_pResource->Allocate(count * sizeof(Node*), alignof(Node*)));
+		}
+
+		void FreeTable(Node** pTable, const size_t count)
+		{
+			m_pResource->Deallocate(pTable, count * sizeof(Node*), alignof(Node*));
+		}
+
 		Node* ReserveNode()
 		{
-			Node* pNode = static_cast<Node*>(BlockAllocator::Alloc(m_pBlock));
+			Node* pNode = static_cast<Node*>(NodeAllocator::Alloc(m_pBlock));
 			new(pNode) Node();
 			return pNode;
 		}
 
-		Node* ReserveNode(const K& key)
+		template<typename KeyArg, typename... Args>
+		Node* ReserveNode(KeyArg&& key, Args&&... args)
 		{
-			Node* pNode = static_cast<Node*>(BlockAllocator::Alloc(m_pBlock));
-			new(pNode) Node(key);
+			Node* pNode = static_cast<Node*>(NodeAllocator::Alloc(m_pBlock));
+			new(pNode) Node(InPlace(), Forward<KeyArg>(key), Forward<Args>(args)...);
 			return pNode;
 		}
 
 		void FreeNode(Node* pNode)
 		{
 			(pNode)->~Node();
-			BlockAllocator::Free(m_pBlock, pNode);
+			NodeAllocator::Free(m_pBlock, pNode);
 		}
 
 	private:
@@ -541,14 +931,30 @@ namespace StlStd
 		Node* m_pTail;
 		//Array of pointers representing the table used for random access
 		Node** m_pTable;
+		//The previous table while its buckets are being moved to the new table
+		Node** m_pOldTable;
+		//The amount of buckets in the previous table
+		size_t m_OldBucketCount;
+		//The next bucket of the previous table to move
+		size_t m_MigrateBucket;
+		//The table to grow into, allocated and cleared ahead of time when rehashing incrementally
+		Node** m_pNextTable;
+		//The amount of buckets of the next table that are cleared
+		size_t m_NextCleared;
+		//The amount of buckets to move on each mutation, 0 rehashes at once
+		size_t m_RehashStep;
+		//The load factor at which the table grows
+		float m_MaxLoadFactor;
 		//The allocator block
-		BlockAllocator::Block* m_pBlock;
+		typename NodeAllocator::Block* m_pBlock;
+		//Where the nodes and the tables are allocated from
+		MemoryResource* m_pResource;
 		//The hash functor
 		HashType m_Hasher;
 	};
 
-	template<typename K, typename V, typename Hasher>
-	inline void Swap(HashMap<K, V, Hasher>& a, HashMap<K, V, Hasher>& b)
+	template<typename K, typename V, typename HashType, typename KeyEqual, typename BucketPolicy, typename NodeAllocator>
+	inline void Swap(HashMap<K, V, HashType, KeyEqual, BucketPolicy, NodeAllocator>& a, HashMap<K, V, HashType, KeyEqual, BucketPolicy, NodeAllocator>& b)
 	{
 		a.Swap(b);
 	}
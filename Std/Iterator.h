@@ -82,10 +82,23 @@ namespace StlStd
 		return b - a;
 	}
 
+	//The element an iterator points to as a pointer, the elements of the random access iterators are contiguous
+	template<typename T>
+	inline T* ToAddress(const RandomAccessIterator<T>& it)
+	{
+		return it.pPtr;
+	}
+
+	template<typename T>
+	inline T* ToAddress(T* pPtr)
+	{
+		return pPtr;
+	}
+
 	template<typename T>
 	struct RandomAccessConstIterator
 	{
-		RandomAccessConstIterator(T* pPtr) :
+		RandomAccessConstIterator(const T* pPtr) :
 			pPtr(pPtr)
 		{}
 
@@ -153,7 +166,7 @@ namespace StlStd
 		const T* operator->() const { return pPtr; }
 		const T& operator*() const { return *pPtr; }
 
-		T* pPtr;
+		const T* pPtr;
 	};
 
 	template<typename T>
@@ -161,4 +174,10 @@ namespace StlStd
 	{
 		return b - a;
 	}
+
+	template<typename T>
+	inline const T* ToAddress(const RandomAccessConstIterator<T>& it)
+	{
+		return it.pPtr;
+	}
 }
\ No newline at end of file
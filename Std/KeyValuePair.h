@@ -1,7 +1,13 @@
 #pragma once
+#include "Utility.h"
 
 namespace StlStd
 {
+	//Tag to construct the key and value of a pair in place from forwarded arguments
+	struct InPlace
+	{
+	};
+
 	template<typename K, typename V>
 	struct KeyValuePair
 	{
@@ -17,6 +23,16 @@ namespace StlStd
 			Key(other.Key), Value(other.Value)
 		{}
 
+		KeyValuePair(KeyValuePair&& other) :
+			Key(Move(other.Key)), Value(Move(other.Value))
+		{}
+
+		//The key is constructed from the first argument, the value from the rest
+		template<typename KeyArg, typename... Args>
+		KeyValuePair(InPlace, KeyArg&& key, Args&&... args) :
+			Key(Forward<KeyArg>(key)), Value(Forward<Args>(args)...)
+		{}
+
 		KeyValuePair& operator=(const KeyValuePair& other) = delete;
 
 		bool operator==(const KeyValuePair& other) const { return Key == other.Key && Value == other.Value; }
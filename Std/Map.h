@@ -1,11 +1,13 @@
 #pragma once
 #include "KeyValuePair.h"
+#include "Pair.h"
 #include "Utility.h"
 #include "BlockAllocator.h"
 
 namespace StlStd
 {
-	template<typename K, typename V, typename KeyCompare = StlStd::LessThan<K>>
+	//NodeAllocator allocates the nodes, BlockAllocator or ConcurrentBlockAllocator when the nodes are allocated and freed on several threads
+	template<typename K, typename V, typename KeyCompare = StlStd::LessThan<K>, typename NodeAllocator = BlockAllocator>
 	class Map
 	{
 	private:
@@ -32,8 +34,17 @@ namespace StlStd
 			Node(const K& key, const V& value) :
 				Pair(key, value)
 			{}
+
+			template<typename KeyArg, typename... Args>
+			Node(InPlace inPlace, KeyArg&& key, Args&&... args) :
+				Pair(inPlace, Forward<KeyArg>(key), Forward<Args>(args)...)
+			{}
 		};
 
+		//Enables the lookups with another key type when the compare functor is transparent
+		template<typename Key>
+		using EnableIfTransparent = EnableIfT<IsTransparent<KeyCompare>::Value, Key>;
+
 	public:
 		struct Iterator
 		{
@@ -148,18 +159,24 @@ namespace StlStd
 		};
 
 		Map() :
+			Map(GetDefaultResource())
+		{
+		}
+
+		//The nodes are allocated from the resource, which has to outlive the map
+		explicit Map(MemoryResource* pResource) :
 			m_pRoot(nullptr), m_pHead(nullptr), m_Size(0)
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node), 2);
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), 2, pResource, alignof(Node));
 			m_pNil = ReserveNode();
 			m_pNil->pParent = m_pNil->pLeft = m_pNil->pRight = m_pNil;
 			m_pNil->Color = BLACK;
 		}
 
-		Map(const std::initializer_list<KeyValuePair<K, V>>& list) :
+		Map(const std::initializer_list<KeyValuePair<K, V>>& list, MemoryResource* pResource = GetDefaultResource()) :
 			m_pRoot(nullptr), m_Size(0)
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node), list.size() + 2);
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), list.size() + 2, pResource, alignof(Node));
 			m_pNil = ReserveNode();
 			m_pNil->pParent = m_pNil->pLeft = m_pNil->pRight = m_pNil;
 			m_pNil->Color = BLACK;
@@ -169,10 +186,11 @@ namespace StlStd
 			}
 		}
 
-		Map(const Map& other) :
+		//The copy uses the default resource unless it is given one
+		Map(const Map& other, MemoryResource* pResource = GetDefaultResource()) :
 			m_pRoot(nullptr), m_Size(0)
 		{
-			m_pBlock = BlockAllocator::Initialize(sizeof(Node), other.m_Size + 2);
+			m_pBlock = NodeAllocator::Initialize(sizeof(Node), other.m_Size + 2, pResource, alignof(Node));
 			m_pNil = ReserveNode();
 			m_pNil->pParent = m_pNil->pLeft = m_pNil->pRight = m_pNil;
 			m_pNil->Color = BLACK;
@@ -201,7 +219,7 @@ namespace StlStd
 		{
 			Clear();
 			FreeNode(m_pNil);
-			BlockAllocator::Uninitialize(m_pBlock);
+			NodeAllocator::Uninitialize(m_pBlock);
 		}
 
 		void Swap(Map& other)
@@ -236,16 +254,65 @@ namespace StlStd
 			return Find_Internal(key) != nullptr;
 		}
 
+		//Lookup with another type than K (eg. a const char* or StringView for String keys) when the compare functor is
+		//transparent, see LessThan<>. The key is compared as is, no K is created.
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		bool Contains(const Key& key) const
+		{
+			return Find_Internal(key) != nullptr;
+		}
+
 		Iterator Insert(const K& key, const V& value)
 		{
 			return Iterator(Insert_Internal(key, value));
 		}
 
+		Iterator Insert(K&& key, V&& value)
+		{
+			return Iterator(Emplace_Internal(true, Move(key), Move(value)).First);
+		}
+
 		Iterator Insert(const KeyValuePair<K, V>& pair)
 		{
 			return Iterator(Insert_Internal(pair.Key, pair.Value));
 		}
 
+		Iterator Insert(KeyValuePair<K, V>&& pair)
+		{
+			return Iterator(Emplace_Internal(true, Move(pair.Key), Move(pair.Value)).First);
+		}
+
+		//Insert or replace the value of the key, the value is constructed from the arguments.
+		//A new element is constructed in place in its node, an existing value is assigned the value argument directly
+		//or a value constructed from the other arguments.
+		template<typename... Args>
+		Iterator Emplace(const K& key, Args&&... args)
+		{
+			return Iterator(Emplace_Internal(true, key, Forward<Args>(args)...).First);
+		}
+
+		template<typename... Args>
+		Iterator Emplace(K&& key, Args&&... args)
+		{
+			return Iterator(Emplace_Internal(true, Move(key), Forward<Args>(args)...).First);
+		}
+
+		//Only constructs the value in place when the key isn't in the map yet, the arguments are left untouched otherwise.
+		//The bool is true when the element is inserted.
+		template<typename... Args>
+		Pair<Iterator, bool> TryEmplace(const K& key, Args&&... args)
+		{
+			Pair<Node*, bool> result = Emplace_Internal(false, key, Forward<Args>(args)...);
+			return Pair<Iterator, bool>(Iterator(result.First), result.Second);
+		}
+
+		template<typename... Args>
+		Pair<Iterator, bool> TryEmplace(K&& key, Args&&... args)
+		{
+			Pair<Node*, bool> result = Emplace_Internal(false, Move(key), Forward<Args>(args)...);
+			return Pair<Iterator, bool>(Iterator(result.First), result.Second);
+		}
+
 		void Insert(const Map& other)
 		{
 			for (ConstIterator pIt = other.Begin(); pIt != other.End(); ++pIt)
@@ -254,13 +321,13 @@ namespace StlStd
 
 		Iterator Erase(const K& key)
 		{
-			Node* pNode = Find_Internal(key);
-			if (pNode == nullptr)
-				return Iterator(nullptr);
-			Iterator it = Erase_Internal(pNode);
-			if (m_Size == 0 && m_pRoot)
-				DeleteRoot();
-			return it;
+			return EraseKey_Internal(key);
+		}
+
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		Iterator Erase(const Key& key)
+		{
+			return EraseKey_Internal(key);
 		}
 
 		Iterator Find(const K& key)
@@ -275,6 +342,20 @@ namespace StlStd
 			return pNode ? ConstIterator(pNode) : End();
 		}
 
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		Iterator Find(const Key& key)
+		{
+			Node* pNode = Find_Internal(key);
+			return pNode ? Iterator(pNode) : End();
+		}
+
+		template<typename Key, typename = EnableIfTransparent<Key>>
+		ConstIterator Find(const Key& key) const
+		{
+			Node* pNode = Find_Internal(key);
+			return pNode ? ConstIterator(pNode) : End();
+		}
+
 		bool operator==(const Map& other) const
 		{
 			if (m_Size != other.m_Size)
@@ -313,10 +394,7 @@ namespace StlStd
 
 		V& operator[](const K& key)
 		{
-			Node* pNode = Find_Internal(key);
-			if (pNode == nullptr)
-				pNode = Insert_Internal(key, V());
-			return pNode->Pair.Value;
+			return Emplace_Internal(false, key).First->Pair.Value;
 		}
 
 		const V& operator[](const K& key) const
@@ -337,6 +415,21 @@ namespace StlStd
 		}
 
 		size_t Size() const { return m_Size; }
+		MemoryResource* GetResource() const { return m_pBlock->pResource; }
+
+		//Gives the blocks of nodes that have no elements left back to the resource, eg. after erasing most of the map
+		void ShrinkToFit()
+		{
+			NodeAllocator::Trim(m_pBlock);
+		}
+
+		//The memory of the nodes, see BlockAllocator::Stats.
+		//Not const, counting the free nodes writes to the blocks of the allocator like Trim does. With a
+		//ConcurrentBlockAllocator no other thread can allocate or free nodes of the map while it runs.
+		typename NodeAllocator::Stats MemoryStats()
+		{
+			return NodeAllocator::GetStats(m_pBlock);
+		}
 		bool IsEmpty() const { return m_Size == 0; }
 		static constexpr size_t MaxSize() { return ~(size_t)0; }
 
@@ -407,7 +500,20 @@ namespace StlStd
 				maxDepth = depth;
 		}
 
-		Node* Find_Internal(const K& key) const
+		template<typename Key>
+		Iterator EraseKey_Internal(const Key& key)
+		{
+			Node* pNode = Find_Internal(key);
+			if (pNode == nullptr)
+				return Iterator(nullptr);
+			Iterator it = Erase_Internal(pNode);
+			if (m_Size == 0 && m_pRoot)
+				DeleteRoot();
+			return it;
+		}
+
+		template<typename Key>
+		Node* Find_Internal(const Key& key) const
 		{
 			if (m_pRoot == nullptr)
 				return nullptr;
@@ -426,34 +532,46 @@ namespace StlStd
 			return nullptr;
 		}
 
-		Node* Insert_Internal(const K& key, const V& value) 
+		Node* Insert_Internal(const K& key, const V& value)
+		{
+			return Emplace_Internal(true, key, value).First;
+		}
+
+		//Find the node of the key or create it, the key and value of a new node are constructed in place from the arguments.
+		//When replace is set, the value of an existing node is replaced with a value constructed from the arguments.
+		template<typename KeyArg, typename... Args>
+		Pair<Node*, bool> Emplace_Internal(const bool replace, KeyArg&& key, Args&&... args)
 		{
 			if (m_pRoot == nullptr)
 				CreateRoot();
 
 			Node *pNewParent = m_pRoot;
 			Node *pNode = m_pRoot->pLeft;
+			bool left = true;
 
 			KeyCompare compare;
 			while (pNode != m_pNil)
 			{
 				pNewParent = pNode;
-				if (compare(key, pNode->Pair.Key))
+				left = compare(key, pNode->Pair.Key);
+				if (left)
 					pNode = pNode->pLeft;
 				else if (compare(pNode->Pair.Key, key))
 					pNode = pNode->pRight;
 				else 
 				{
-					pNode->Pair.Value = value;
-					return pNode;
+					if (replace)
+						AssignValue(pNode->Pair.Value, Forward<Args>(args)...);
+					return Pair<Node*, bool>(pNode, false);
 				}
 			}
-			Node *pNewNode = ReserveNode(key, value);
+			//The key might be moved into the node, the side is decided before
+			Node *pNewNode = ReserveNode(Forward<KeyArg>(key), Forward<Args>(args)...);
 			pNewNode->pParent = pNewParent;
 			pNewNode->pRight = m_pNil;
 			pNewNode->pLeft = m_pNil;
 
-			if (pNewParent == m_pRoot || compare(key, pNewParent->Pair.Key))
+			if (left)
 				pNewParent->pLeft = pNewNode;
 			else 
 				pNewParent->pRight = pNewNode;
@@ -468,7 +586,7 @@ namespace StlStd
 			++m_Size;
 			InsertFix(pNewNode);
 			m_pHead = MinNode();
-			return pNewNode;
+			return Pair<Node*, bool>(pNewNode, true);
 		}
 		
 		//Rebalance the tree after insertion
@@ -758,29 +876,23 @@ namespace StlStd
 
 		inline Node* ReserveNode()
 		{
-			Node* pNode = static_cast<Node*>(BlockAllocator::Alloc(m_pBlock));
+			Node* pNode = static_cast<Node*>(NodeAllocator::Alloc(m_pBlock));
 			new(pNode) Node(K());
 			return pNode;
 		}
 
-		inline Node* ReserveNode(const K& key)
-		{
-			Node* pNode = static_cast<Node*>(BlockAllocator::Alloc(m_pBlock));
-			new(pNode) Node(key);
-			return pNode;
-		}
-
-		inline Node* ReserveNode(const K& key, const V& value)
+		template<typename KeyArg, typename... Args>
+		inline Node* ReserveNode(KeyArg&& key, Args&&... args)
 		{
-			Node* pNode = static_cast<Node*>(BlockAllocator::Alloc(m_pBlock));
-			new(pNode) Node(key, value);
+			Node* pNode = static_cast<Node*>(NodeAllocator::Alloc(m_pBlock));
+			new(pNode) Node(InPlace(), Forward<KeyArg>(key), Forward<Args>(args)...);
 			return pNode;
 		}
 
 		inline void FreeNode(Node*& pNode)
 		{
 			(pNode)->~Node();
-			BlockAllocator::Free(m_pBlock, pNode);
+			NodeAllocator::Free(m_pBlock, pNode);
 			pNode = nullptr;
 		}
 
@@ -792,12 +904,12 @@ namespace StlStd
 		//The node with the smallest key
 		Node* m_pHead;
 		//The allocator
-		BlockAllocator::Block* m_pBlock;
+		typename NodeAllocator::Block* m_pBlock;
 		size_t m_Size;
 	};
 
-	template<typename K, typename V, typename KeyCompare>
-	inline void Swap(Map<K, V, KeyCompare>& a, Map<K, V, KeyCompare>& b)
+	template<typename K, typename V, typename KeyCompare, typename NodeAllocator>
+	inline void Swap(Map<K, V, KeyCompare, NodeAllocator>& a, Map<K, V, KeyCompare, NodeAllocator>& b)
 	{
 		a.Swap(b);
 	}
@@ -0,0 +1,250 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+#include <atomic>
+#include <assert.h>
+
+namespace StlStd
+{
+	//Where a container gets its memory from. The containers hold a pointer to a resource, which has to outlive them.
+	//Deallocate gets the same size and alignment as the Allocate call that returned the memory.
+	class MemoryResource
+	{
+	public:
+		static const size_t DEFAULT_ALIGNMENT = alignof(max_align_t);
+
+		virtual ~MemoryResource() {}
+
+		void* Allocate(const size_t size, const size_t alignment = DEFAULT_ALIGNMENT)
+		{
+			return DoAllocate(size, alignment);
+		}
+
+		void Deallocate(void* pPtr, const size_t size, const size_t alignment = DEFAULT_ALIGNMENT)
+		{
+			if (pPtr)
+				DoDeallocate(pPtr, size, alignment);
+		}
+
+		//Whether memory of one resource can be freed by the other
+		bool IsEqual(const MemoryResource& other) const
+		{
+			return this == &other || DoIsEqual(other);
+		}
+
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) = 0;
+		virtual void DoDeallocate(void* pPtr, size_t size, size_t alignment) = 0;
+		virtual bool DoIsEqual(const MemoryResource&) const { return false; }
+	};
+
+	//The global new and delete, what the containers used before there were resources. Use the single instance of
+	//GetNewDeleteResource so the resources compare equal.
+	//Over-aligned memory is allocated with room to align it, the pointer new returned is kept right in front of it.
+	class NewDeleteResource : public MemoryResource
+	{
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) override
+		{
+			if (alignment <= DEFAULT_ALIGNMENT)
+				return ::operator new(size);
+			char* pMemory = static_cast<char*>(::operator new(size + alignment));
+			const uintptr_t aligned = ((uintptr_t)pMemory + sizeof(void*) + alignment - 1) & ~(uintptr_t)(alignment - 1);
+			void** pAligned = reinterpret_cast<void**>(aligned);
+			pAligned[-1] = pMemory;
+			return pAligned;
+		}
+
+		virtual void DoDeallocate(void* pPtr, size_t, size_t alignment) override
+		{
+			if (alignment <= DEFAULT_ALIGNMENT)
+				::operator delete(pPtr);
+			else
+				::operator delete(static_cast<void**>(pPtr)[-1]);
+		}
+	};
+
+	inline MemoryResource* GetNewDeleteResource()
+	{
+		static NewDeleteResource resource;
+		return &resource;
+	}
+
+	inline std::atomic<MemoryResource*>& DefaultResourcePointer()
+	{
+		static std::atomic<MemoryResource*> pResource(GetNewDeleteResource());
+		return pResource;
+	}
+
+	//The resource of containers that aren't given one, new and delete unless it is replaced with SetDefaultResource
+	inline MemoryResource* GetDefaultResource()
+	{
+		return DefaultResourcePointer().load(std::memory_order_acquire);
+	}
+
+	//Returns the previous default resource, nullptr restores new and delete.
+	//Containers keep the resource they were created with, change it while no container is being created on other threads.
+	inline MemoryResource* SetDefaultResource(MemoryResource* pResource)
+	{
+		return DefaultResourcePointer().exchange(pResource ? pResource : GetNewDeleteResource(), std::memory_order_acq_rel);
+	}
+
+	//Arena that hands out memory by bumping a pointer, Deallocate does nothing and everything is freed at once on Release.
+	//Starts in the given buffer (eg. on the stack) if there is one, and continues in chunks from the upstream resource
+	//that double in size.
+	class MonotonicResource : public MemoryResource
+	{
+	private:
+		struct Chunk
+		{
+			Chunk* pNext;
+			size_t Size;
+		};
+
+	public:
+		explicit MonotonicResource(const size_t initialSize = 1024, MemoryResource* pUpstream = GetDefaultResource()) :
+			m_pUpstream(pUpstream), m_pChunks(nullptr), m_pInitialBuffer(nullptr), m_InitialSize(0),
+			m_pCurrent(nullptr), m_pEnd(nullptr), m_NextChunkSize(initialSize > 0 ? initialSize : 1)
+		{
+		}
+
+		MonotonicResource(void* pBuffer, const size_t size, MemoryResource* pUpstream = GetDefaultResource()) :
+			m_pUpstream(pUpstream), m_pChunks(nullptr), m_pInitialBuffer(static_cast<char*>(pBuffer)), m_InitialSize(size),
+			m_pCurrent(static_cast<char*>(pBuffer)), m_pEnd(static_cast<char*>(pBuffer) + size), m_NextChunkSize(size > 0 ? size * 2 : 1024)
+		{
+		}
+
+		MonotonicResource(const MonotonicResource& other) = delete;
+		MonotonicResource& operator=(const MonotonicResource& other) = delete;
+
+		~MonotonicResource()
+		{
+			Release();
+		}
+
+		//Frees all the chunks and starts over in the initial buffer, all the memory that was handed out becomes invalid
+		void Release()
+		{
+			while (m_pChunks)
+			{
+				Chunk* pNext = m_pChunks->pNext;
+				m_pUpstream->Deallocate(m_pChunks, m_pChunks->Size);
+				m_pChunks = pNext;
+			}
+			m_pCurrent = m_pInitialBuffer;
+			m_pEnd = m_pInitialBuffer ? m_pInitialBuffer + m_InitialSize : nullptr;
+		}
+
+		MemoryResource* GetUpstream() const { return m_pUpstream; }
+
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) override
+		{
+			char* pPtr = AlignUp(m_pCurrent, alignment);
+			if (m_pCurrent == nullptr || pPtr + size > m_pEnd)
+			{
+				AllocateChunk(size, alignment);
+				pPtr = AlignUp(m_pCurrent, alignment);
+			}
+			m_pCurrent = pPtr + size;
+			return pPtr;
+		}
+
+		virtual void DoDeallocate(void*, size_t, size_t) override
+		{
+		}
+
+	private:
+		static char* AlignUp(char* pPtr, const size_t alignment)
+		{
+			return reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(pPtr) + alignment - 1) & ~(uintptr_t)(alignment - 1));
+		}
+
+		void AllocateChunk(const size_t size, const size_t alignment)
+		{
+			const size_t minSize = sizeof(Chunk) + size + alignment;
+			while (m_NextChunkSize < minSize)
+				m_NextChunkSize *= 2;
+
+			Chunk* pChunk = static_cast<Chunk*>(m_pUpstream->Allocate(m_NextChunkSize));
+			pChunk->pNext = m_pChunks;
+			pChunk->Size = m_NextChunkSize;
+			m_pChunks = pChunk;
+			m_pCurrent = reinterpret_cast<char*>(pChunk + 1);
+			m_pEnd = reinterpret_cast<char*>(pChunk) + m_NextChunkSize;
+			m_NextChunkSize *= 2;
+		}
+
+		MemoryResource* m_pUpstream;
+		//The chunks from the upstream resource, the newest first
+		Chunk* m_pChunks;
+		char* m_pInitialBuffer;
+		size_t m_InitialSize;
+		//The free part of the current chunk
+		char* m_pCurrent;
+		char* m_pEnd;
+		size_t m_NextChunkSize;
+	};
+
+	//Passes the allocations on to the upstream resource and keeps count of them, eg. to find leaks or measure a container.
+	//The counters aren't atomic, use one resource per thread.
+	class CountingResource : public MemoryResource
+	{
+	public:
+		explicit CountingResource(MemoryResource* pUpstream = GetDefaultResource()) :
+			m_pUpstream(pUpstream)
+		{
+			Reset();
+		}
+
+		//Sets the counters to 0, the memory that is still in use is counted from 0 as well
+		void Reset()
+		{
+			m_AllocationCount = 0;
+			m_DeallocationCount = 0;
+			m_BytesAllocated = 0;
+			m_BytesInUse = 0;
+			m_PeakBytesInUse = 0;
+		}
+
+		//The amount of Allocate and Deallocate calls
+		size_t AllocationCount() const { return m_AllocationCount; }
+		size_t DeallocationCount() const { return m_DeallocationCount; }
+		//The amount of allocations that aren't freed yet
+		size_t LiveAllocations() const { return m_AllocationCount - m_DeallocationCount; }
+		//The total amount of bytes that was allocated
+		size_t BytesAllocated() const { return m_BytesAllocated; }
+		size_t BytesInUse() const { return m_BytesInUse; }
+		size_t PeakBytesInUse() const { return m_PeakBytesInUse; }
+
+		MemoryResource* GetUpstream() const { return m_pUpstream; }
+
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) override
+		{
+			void* pPtr = m_pUpstream->Allocate(size, alignment);
+			++m_AllocationCount;
+			m_BytesAllocated += size;
+			m_BytesInUse += size;
+			if (m_BytesInUse > m_PeakBytesInUse)
+				m_PeakBytesInUse = m_BytesInUse;
+			return pPtr;
+		}
+
+		virtual void DoDeallocate(void* pPtr, size_t size, size_t alignment) override
+		{
+			m_pUpstream->Deallocate(pPtr, size, alignment);
+			++m_DeallocationCount;
+			m_BytesInUse -= size;
+		}
+
+	private:
+		MemoryResource* m_pUpstream;
+		size_t m_AllocationCount;
+		size_t m_DeallocationCount;
+		size_t m_BytesAllocated;
+		size_t m_BytesInUse;
+		size_t m_PeakBytesInUse;
+	};
+}
@@ -0,0 +1,229 @@
+#pragma once
+#include <new>
+#include "MemoryResource.h"
+#include "Sorting.h"
+#include "TaskScheduler.h"
+
+namespace StlStd
+{
+	//Ranges up to this size are sorted by a single task, larger ranges are cut into about 8 pieces per thread so each
+	//merge level that is added for them has work for all the threads
+	const size_t PARALLEL_SORT_GRAIN = 1 << 15;
+	const size_t PARALLEL_SORT_PIECES_PER_THREAD = 8;
+	//Merges up to this size are done by a single task
+	const size_t PARALLEL_MERGE_GRAIN = 1 << 14;
+
+	//The first element that isn't smaller than the value
+	template<typename T, typename CompareFunctor>
+	T* LowerBound_Internal(T* pBegin, T* pEnd, const T& value, CompareFunctor& compare)
+	{
+		while (pBegin < pEnd)
+		{
+			T* pMiddle = pBegin + (pEnd - pBegin) / 2;
+			if (compare(*pMiddle, value))
+				pBegin = pMiddle + 1;
+			else
+				pEnd = pMiddle;
+		}
+		return pBegin;
+	}
+
+	//The first element that is larger than the value
+	template<typename T, typename CompareFunctor>
+	T* UpperBound_Internal(T* pBegin, T* pEnd, const T& value, CompareFunctor& compare)
+	{
+		while (pBegin < pEnd)
+		{
+			T* pMiddle = pBegin + (pEnd - pBegin) / 2;
+			if (compare(value, *pMiddle))
+				pEnd = pMiddle;
+			else
+				pBegin = pMiddle + 1;
+		}
+		return pBegin;
+	}
+
+	//Selects instead of branching, which side wins is as unpredictable as the partition of a quicksort
+	template<typename T, typename CompareFunctor>
+	void MergeBranchless_Internal(T*& pA, T* pAEnd, T*& pB, T* pBEnd, T*& pOut, CompareFunctor& compare, TrueType)
+	{
+		while (pA != pAEnd && pB != pBEnd)
+		{
+			const bool takeB = compare(*pB, *pA);
+			*pOut++ = takeB ? *pB : *pA;
+			pB += takeB;
+			pA += !takeB;
+		}
+	}
+
+	template<typename T, typename CompareFunctor>
+	void MergeBranchless_Internal(T*&, T*, T*&, T*, T*&, CompareFunctor&, FalseType)
+	{
+	}
+
+	template<typename T, typename CompareFunctor>
+	void Merge_Internal(T* pA, T* pAEnd, T* pB, T* pBEnd, T* pOut, CompareFunctor& compare)
+	{
+		MergeBranchless_Internal(pA, pAEnd, pB, pBEnd, pOut, compare, BoolConstant<IsBranchlessCompare<T, CompareFunctor>::Value>());
+		while (pA != pAEnd && pB != pBEnd)
+		{
+			if (compare(*pB, *pA))
+				*pOut++ = Move(*pB++);
+			else
+				*pOut++ = Move(*pA++);
+		}
+		while (pA != pAEnd)
+			*pOut++ = Move(*pA++);
+		while (pB != pBEnd)
+			*pOut++ = Move(*pB++);
+	}
+
+	//Merges [pA, pAEnd) and [pB, pBEnd) into pOut, the elements of the first range go first when equal. The middle
+	//element of the larger range splits it, a binary search finds where it splits the other one, and the two halves
+	//are merged in parallel.
+	template<typename T, typename CompareFunctor>
+	void ParallelMerge_Internal(T* pA, T* pAEnd, T* pB, T* pBEnd, T* pOut, CompareFunctor& compare, TaskScheduler& scheduler)
+	{
+		const size_t sizeA = pAEnd - pA;
+		const size_t sizeB = pBEnd - pB;
+		if (sizeA + sizeB <= PARALLEL_MERGE_GRAIN)
+		{
+			Merge_Internal(pA, pAEnd, pB, pBEnd, pOut, compare);
+			return;
+		}
+
+		T* pSplitA;
+		T* pSplitB;
+		if (sizeA >= sizeB)
+		{
+			pSplitA = pA + sizeA / 2;
+			pSplitB = LowerBound_Internal(pB, pBEnd, *pSplitA, compare);
+		}
+		else
+		{
+			pSplitB = pB + sizeB / 2;
+			pSplitA = UpperBound_Internal(pA, pAEnd, *pSplitB, compare);
+		}
+		T* pOutSplit = pOut + (pSplitA - pA) + (pSplitB - pB);
+
+		TaskGroup group(scheduler);
+		group.Run([pA, pSplitA, pB, pSplitB, pOut, &compare, &scheduler]()
+		{
+			ParallelMerge_Internal(pA, pSplitA, pB, pSplitB, pOut, compare, scheduler);
+		});
+		ParallelMerge_Internal(pSplitA, pAEnd, pSplitB, pBEnd, pOutSplit, compare, scheduler);
+		group.Wait();
+	}
+
+	template<typename T, typename CompareFunctor>
+	void SequentialSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare, TrueType)
+	{
+		StableSort(pBegin, pEnd, compare);
+	}
+
+	template<typename T, typename CompareFunctor>
+	void SequentialSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare, FalseType)
+	{
+		UnstableSort(pBegin, pEnd, compare);
+	}
+
+	//Sorts the elements of pData, the result ends up in pBuffer (of the same size) when toBuffer is set. The halves are
+	//sorted in parallel into the other array than the result, then merged in parallel into the result.
+	template<bool Stable, typename T, typename CompareFunctor>
+	void ParallelMergeSort_Internal(T* pData, T* pBuffer, const size_t size, const size_t grain, const bool toBuffer, CompareFunctor& compare, TaskScheduler& scheduler)
+	{
+		if (size <= grain)
+		{
+			SequentialSort_Internal(pData, pData + size, compare, BoolConstant<Stable>());
+			if (toBuffer)
+			{
+				for (size_t i = 0; i < size; ++i)
+					pBuffer[i] = Move(pData[i]);
+			}
+			return;
+		}
+
+		const size_t half = size / 2;
+		TaskGroup group(scheduler);
+		group.Run([pData, pBuffer, half, grain, toBuffer, &compare, &scheduler]()
+		{
+			ParallelMergeSort_Internal<Stable>(pData, pBuffer, half, grain, !toBuffer, compare, scheduler);
+		});
+		ParallelMergeSort_Internal<Stable>(pData + half, pBuffer + half, size - half, grain, !toBuffer, compare, scheduler);
+		group.Wait();
+
+		T* pFrom = toBuffer ? pData : pBuffer;
+		T* pTo = toBuffer ? pBuffer : pData;
+		ParallelMerge_Internal(pFrom, pFrom + half, pFrom + half, pFrom + size, pTo, compare, scheduler);
+	}
+
+	template<bool Stable, typename T, typename CompareFunctor>
+	void ParallelSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare, TaskScheduler& scheduler)
+	{
+		const size_t size = pEnd - pBegin;
+		if (size <= PARALLEL_SORT_GRAIN || scheduler.GetThreadCount() == 1)
+		{
+			SequentialSort_Internal(pBegin, pEnd, compare, BoolConstant<Stable>());
+			return;
+		}
+
+		MemoryResource* pResource = GetDefaultResource();
+		T* pBuffer;
+		try
+		{
+			pBuffer = static_cast<T*>(pResource->Allocate(size * sizeof(T), alignof(T)));
+		}
+		catch (const std::bad_alloc&)
+		{
+			pBuffer = nullptr;
+		}
+		if (!pBuffer)
+		{
+			//StableSort continues in place when it can't get a buffer either
+			SequentialSort_Internal(pBegin, pEnd, compare, BoolConstant<Stable>());
+			return;
+		}
+
+		//The elements move to the buffer first, after that both arrays hold objects and every step moves by assignment
+		ParallelFor(0, size, PARALLEL_SORT_GRAIN, [pBegin, pBuffer](size_t begin, size_t end)
+		{
+			for (size_t i = begin; i < end; ++i)
+				new (pBuffer + i) T(Move(pBegin[i]));
+		}, scheduler);
+		const size_t pieceSize = size / (scheduler.GetThreadCount() * PARALLEL_SORT_PIECES_PER_THREAD);
+		const size_t grain = pieceSize > PARALLEL_SORT_GRAIN ? pieceSize : PARALLEL_SORT_GRAIN;
+		ParallelMergeSort_Internal<Stable>(pBuffer, pBegin, size, grain, true, compare, scheduler);
+		for (size_t i = 0; i < size; ++i)
+			pBuffer[i].~T();
+		pResource->Deallocate(pBuffer, size * sizeof(T), alignof(T));
+	}
+
+	//Sorts on the threads of the scheduler: the halves of the range are sorted as tasks down to pieces of about 8 per
+	//thread, which are sorted with UnstableSort, and the sorted halves are merged in parallel.
+	//Takes a buffer of the same size as the range from the default resource, without one it sorts on the calling thread.
+	//The compare functor is called from several threads at once. Not stable.
+	template<typename Iterator, typename CompareFunctor>
+	void ParallelSort(Iterator begin, Iterator end, CompareFunctor compare, TaskScheduler& scheduler = TaskScheduler::GetDefault())
+	{
+		ParallelSort_Internal<false>(ToAddress(begin), ToAddress(end), compare, scheduler);
+	}
+
+	template<typename Iterator>
+	void ParallelSort(Iterator begin, Iterator end)
+	{
+		ParallelSort(begin, end, LessThan<>());
+	}
+
+	//ParallelSort with StableSort for the pieces, equal elements keep their order
+	template<typename Iterator, typename CompareFunctor>
+	void ParallelStableSort(Iterator begin, Iterator end, CompareFunctor compare, TaskScheduler& scheduler = TaskScheduler::GetDefault())
+	{
+		ParallelSort_Internal<true>(ToAddress(begin), ToAddress(end), compare, scheduler);
+	}
+
+	template<typename Iterator>
+	void ParallelStableSort(Iterator begin, Iterator end)
+	{
+		ParallelStableSort(begin, end, LessThan<>());
+	}
+}
@@ -0,0 +1,353 @@
+#pragma once
+#include <assert.h>
+#include "Iterator.h"
+#include "MemoryResource.h"
+#include "Utility.h"
+#include "Vector.h"
+
+namespace StlStd
+{
+	//Heap on a Vector with the convention of std::priority_queue and MakeHeap: no element comes after its parent in
+	//the order of the compare functor, so Top is the largest element with LessThan. GreaterThan keeps the smallest on
+	//top. Push and Pop are O(log n).
+	//Every node has Arity children. A 4-ary heap is half as deep as a binary one and the children of a node share a
+	//cache line for small elements: Pop compares more per level but misses the cache on fewer levels.
+	template<typename T, typename CompareFunctor = LessThan<T>, size_t Arity = 4>
+	class PriorityQueue
+	{
+		static_assert(Arity >= 2, "A heap node needs at least two children");
+
+	public:
+		explicit PriorityQueue(MemoryResource* pResource = GetDefaultResource()) :
+			m_Heap(*pResource), m_Compare()
+		{
+		}
+
+		explicit PriorityQueue(CompareFunctor compare, MemoryResource* pResource = GetDefaultResource()) :
+			m_Heap(*pResource), m_Compare(compare)
+		{
+		}
+
+		//Copies the elements of the range and orders them in O(n)
+		template<typename Iterator>
+		PriorityQueue(Iterator begin, Iterator end, CompareFunctor compare = CompareFunctor(), MemoryResource* pResource = GetDefaultResource()) :
+			m_Heap(*pResource), m_Compare(compare)
+		{
+			auto pBegin = ToAddress(begin);
+			const size_t size = ToAddress(end) - pBegin;
+			m_Heap.Reserve(size);
+			for (size_t i = 0; i < size; ++i)
+				m_Heap.Push(pBegin[i]);
+			//From the last node with children up
+			for (size_t i = size > 1 ? (size - 2) / Arity + 1 : 0; i-- > 0;)
+			{
+				T value = Move(m_Heap[i]);
+				SiftDown(i, Move(value));
+			}
+		}
+
+		void Push(const T& value)
+		{
+			m_Heap.Push(value);
+			SiftUp(m_Heap.Size() - 1);
+		}
+
+		void Push(T&& value)
+		{
+			m_Heap.Push(Move(value));
+			SiftUp(m_Heap.Size() - 1);
+		}
+
+		template<typename ...Args>
+		void Emplace(Args&&... args)
+		{
+			m_Heap.EmplaceBack(Forward<Args>(args)...);
+			SiftUp(m_Heap.Size() - 1);
+		}
+
+		const T& Top() const
+		{
+			assert(!m_Heap.Empty());
+			return m_Heap[0];
+		}
+
+		//Removes and returns the top element
+		T Pop()
+		{
+			assert(!m_Heap.Empty());
+			T top = Move(m_Heap[0]);
+			T last = m_Heap.Pop();
+			if (!m_Heap.Empty())
+				SiftDown(0, Move(last));
+			return top;
+		}
+
+		size_t Size() const { return m_Heap.Size(); }
+		bool Empty() const { return m_Heap.Empty(); }
+		MemoryResource* GetResource() const { return m_Heap.GetResource(); }
+
+		void Clear()
+		{
+			m_Heap.Clear();
+		}
+
+		void Reserve(const size_t size)
+		{
+			m_Heap.Reserve(size);
+		}
+
+	private:
+		//Whether a belongs above b, the compare functor puts the element that comes last on top
+		bool Above(const T& a, const T& b)
+		{
+			return m_Compare(b, a);
+		}
+
+		void SiftUp(size_t index)
+		{
+			T* pData = m_Heap.Data();
+			T value = Move(pData[index]);
+			while (index > 0)
+			{
+				const size_t parent = (index - 1) / Arity;
+				if (!Above(value, pData[parent]))
+					break;
+				pData[index] = Move(pData[parent]);
+				index = parent;
+			}
+			pData[index] = Move(value);
+		}
+
+		//Moves the hole at the index down to a leaf, always to the child that comes first, and sifts the value up from
+		//there (Floyd). The value mostly belongs near the bottom, which saves comparing it on every level on the way down.
+		void SiftDown(size_t index, T&& value)
+		{
+			T* pData = m_Heap.Data();
+			const size_t size = m_Heap.Size();
+			const size_t start = index;
+			while (true)
+			{
+				const size_t first = index * Arity + 1;
+				if (first >= size)
+					break;
+				const size_t last = size - first > Arity ? first + Arity : size;
+				size_t best = first;
+				for (size_t child = first + 1; child < last; ++child)
+				{
+					if (Above(pData[child], pData[best]))
+						best = child;
+				}
+				pData[index] = Move(pData[best]);
+				index = best;
+			}
+			while (index > start)
+			{
+				const size_t parent = (index - 1) / Arity;
+				if (!Above(value, pData[parent]))
+					break;
+				pData[index] = Move(pData[parent]);
+				index = parent;
+			}
+			pData[index] = Move(value);
+		}
+
+		Vector<T> m_Heap;
+		CompareFunctor m_Compare;
+	};
+
+	//PriorityQueue of ids with a priority each, the priority of an id that is in the queue can be changed. The ids index
+	//a table of their positions in the heap, so DecreaseKey, Update and Remove find the id in O(1) and move it in
+	//O(log n). Meant for dense ids like the nodes of a graph or the slots of a timer wheel, the table grows to the
+	//largest id that was pushed. The priorities are kept in the heap next to the ids, a compare reads no other memory.
+	//The compare functor orders the heap like in PriorityQueue, but the default is GreaterThan so the smallest priority is
+	//on top and DecreaseKey lowers it, as in a graph search. LessThan keeps the largest on top.
+	template<typename Priority, typename CompareFunctor = GreaterThan<Priority>, size_t Arity = 4>
+	class IndexedPriorityQueue
+	{
+		static_assert(Arity >= 2, "A heap node needs at least two children");
+
+	public:
+		static const size_t Npos = ~(size_t)0;
+
+		//The ids below the count take no allocations when they are pushed
+		explicit IndexedPriorityQueue(const size_t idCount = 0, CompareFunctor compare = CompareFunctor(), MemoryResource* pResource = GetDefaultResource()) :
+			m_Heap(*pResource), m_Positions(*pResource), m_Compare(compare)
+		{
+			m_Heap.Reserve(idCount);
+			m_Positions.Reserve(idCount);
+			for (size_t i = 0; i < idCount; ++i)
+				m_Positions.Push((size_t)Npos);
+		}
+
+		//The id can't be in the queue already
+		void Push(const size_t id, const Priority& priority)
+		{
+			assert(!Contains(id));
+			while (m_Positions.Size() <= id)
+				m_Positions.Push((size_t)Npos);
+			m_Heap.Push(Entry{ priority, id });
+			m_Positions[id] = m_Heap.Size() - 1;
+			SiftUp(m_Heap.Size() - 1);
+		}
+
+		//Moves the id towards the top, the new priority can't belong below the current one (can't be larger by default)
+		void DecreaseKey(const size_t id, const Priority& priority)
+		{
+			assert(Contains(id));
+			const size_t index = m_Positions[id];
+			assert(!Above(m_Heap[index].Value, priority));
+			m_Heap[index].Value = priority;
+			SiftUp(index);
+		}
+
+		//Changes the priority in either direction, pushes the id when it isn't in the queue
+		void Update(const size_t id, const Priority& priority)
+		{
+			if (!Contains(id))
+			{
+				Push(id, priority);
+				return;
+			}
+			const size_t index = m_Positions[id];
+			const bool earlier = Above(priority, m_Heap[index].Value);
+			m_Heap[index].Value = priority;
+			if (earlier)
+				SiftUp(index);
+			else
+				SiftDown(index);
+		}
+
+		//Returns false when the id wasn't in the queue
+		bool Remove(const size_t id)
+		{
+			if (!Contains(id))
+				return false;
+			const size_t index = m_Positions[id];
+			m_Positions[id] = Npos;
+			Entry last = m_Heap.Pop();
+			if (index < m_Heap.Size())
+			{
+				//The last entry takes the place, it can belong above or below it
+				const bool earlier = Above(last.Value, m_Heap[index].Value);
+				m_Heap[index] = Move(last);
+				m_Positions[m_Heap[index].Id] = index;
+				if (earlier)
+					SiftUp(index);
+				else
+					SiftDown(index);
+			}
+			return true;
+		}
+
+		size_t Top() const
+		{
+			assert(!m_Heap.Empty());
+			return m_Heap[0].Id;
+		}
+
+		const Priority& TopPriority() const
+		{
+			assert(!m_Heap.Empty());
+			return m_Heap[0].Value;
+		}
+
+		//Removes and returns the id on top
+		size_t Pop()
+		{
+			assert(!m_Heap.Empty());
+			const size_t id = m_Heap[0].Id;
+			m_Positions[id] = Npos;
+			Entry last = m_Heap.Pop();
+			if (!m_Heap.Empty())
+			{
+				m_Heap[0] = Move(last);
+				m_Positions[m_Heap[0].Id] = 0;
+				SiftDown(0);
+			}
+			return id;
+		}
+
+		bool Contains(const size_t id) const
+		{
+			return id < m_Positions.Size() && m_Positions[id] != Npos;
+		}
+
+		const Priority& GetPriority(const size_t id) const
+		{
+			assert(Contains(id));
+			return m_Heap[m_Positions[id]].Value;
+		}
+
+		size_t Size() const { return m_Heap.Size(); }
+		bool Empty() const { return m_Heap.Empty(); }
+
+		//Keeps the table of positions, only the ids that were in the queue are reset
+		void Clear()
+		{
+			for (size_t i = 0; i < m_Heap.Size(); ++i)
+				m_Positions[m_Heap[i].Id] = Npos;
+			m_Heap.Clear();
+		}
+
+	private:
+		struct Entry
+		{
+			Priority Value;
+			size_t Id;
+		};
+
+		//Whether a belongs above b, the compare functor puts the element that comes last on top
+		bool Above(const Priority& a, const Priority& b)
+		{
+			return m_Compare(b, a);
+		}
+
+		void SiftUp(size_t index)
+		{
+			Entry* pData = m_Heap.Data();
+			Entry entry = Move(pData[index]);
+			while (index > 0)
+			{
+				const size_t parent = (index - 1) / Arity;
+				if (!Above(entry.Value, pData[parent].Value))
+					break;
+				pData[index] = Move(pData[parent]);
+				m_Positions[pData[index].Id] = index;
+				index = parent;
+			}
+			m_Positions[entry.Id] = index;
+			pData[index] = Move(entry);
+		}
+
+		void SiftDown(size_t index)
+		{
+			Entry* pData = m_Heap.Data();
+			const size_t size = m_Heap.Size();
+			Entry entry = Move(pData[index]);
+			while (true)
+			{
+				const size_t first = index * Arity + 1;
+				if (first >= size)
+					break;
+				const size_t last = size - first > Arity ? first + Arity : size;
+				size_t best = first;
+				for (size_t child = first + 1; child < last; ++child)
+				{
+					if (Above(pData[child].Value, pData[best].Value))
+						best = child;
+				}
+				if (!Above(pData[best].Value, entry.Value))
+					break;
+				pData[index] = Move(pData[best]);
+				m_Positions[pData[index].Id] = index;
+				index = best;
+			}
+			m_Positions[entry.Id] = index;
+			pData[index] = Move(entry);
+		}
+
+		Vector<Entry> m_Heap;
+		Vector<size_t> m_Positions;
+		CompareFunctor m_Compare;
+	};
+}
@@ -0,0 +1,334 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include "MemoryResource.h"
+#include "Sorting.h"
+#include "String.h"
+#include "Utility.h"
+#include "Vector.h"
+
+namespace StlStd
+{
+	//Below this size the histograms cost more than they save, the range is sorted with StableSort
+	const size_t RADIX_SORT_MIN_SIZE = 256;
+	//String buckets below this size are sorted with an insertion sort
+	const size_t STRING_RADIX_SORT_INSERTION_THRESHOLD = 32;
+
+	template<size_t Bytes> struct RadixUnsigned;
+	template<> struct RadixUnsigned<1> { typedef uint8_t Type; };
+	template<> struct RadixUnsigned<2> { typedef uint16_t Type; };
+	template<> struct RadixUnsigned<4> { typedef uint32_t Type; };
+	template<> struct RadixUnsigned<8> { typedef uint64_t Type; };
+
+	//Maps a key to an unsigned integer with the same order, the radix sort orders on its bits.
+	//Signed integers get their sign bit flipped so the negative values come first.
+	template<typename T>
+	struct RadixKey
+	{
+		static_assert(IsArithmetic<T>::Value, "RadixSort takes integer and floating point keys");
+		typedef typename RadixUnsigned<sizeof(T)>::Type Type;
+
+		static Type Get(const T value)
+		{
+			const Type signBit = T(-1) < T(0) ? (Type)((Type)1 << (sizeof(T) * 8 - 1)) : 0;
+			return (Type)value ^ signBit;
+		}
+	};
+
+	//IEEE floats order like sign and magnitude integers: the negative values get all their bits flipped so the larger
+	//magnitudes come first, the positive values only their sign bit. -0.0 comes before 0.0, NaNs at the ends.
+	template<typename T, typename Bits>
+	inline Bits FloatRadixKey_Internal(const T value)
+	{
+		Bits bits;
+		memcpy(&bits, &value, sizeof(bits));
+		const Bits signBit = (Bits)1 << (sizeof(Bits) * 8 - 1);
+		return (bits & signBit) ? ~bits : bits | signBit;
+	}
+
+	template<>
+	struct RadixKey<float>
+	{
+		typedef uint32_t Type;
+		static Type Get(const float value) { return FloatRadixKey_Internal<float, uint32_t>(value); }
+	};
+
+	template<>
+	struct RadixKey<double>
+	{
+		typedef uint64_t Type;
+		static Type Get(const double value) { return FloatRadixKey_Internal<double, uint64_t>(value); }
+	};
+
+	//The key of the plain values is the value itself
+	struct RadixIdentity
+	{
+		template<typename T>
+		const T& operator()(const T& value) const { return value; }
+	};
+
+	//The digit size when none is given: 8 bits for keys up to 16 bits, 11 bits (3 passes for 32 bits) above that,
+	//2048 counters per pass still fit the L1 cache during the scatter
+	template<size_t KeyBytes>
+	struct RadixDefaultDigitBits
+	{
+		static const size_t Value = KeyBytes <= 2 ? 8 : 11;
+	};
+
+	//Orders the elements on their key for the fallback to StableSort
+	template<typename KeyExtractor>
+	struct RadixKeyLess_Internal
+	{
+		template<typename T>
+		bool operator()(const T& a, const T& b)
+		{
+			typedef typename RemoveReference<decltype(Key(a))>::Type KeyType;
+			typedef RadixKey<typename RemoveConst<KeyType>::Type> Radix;
+			return Radix::Get(Key(a)) < Radix::Get(Key(b));
+		}
+
+		KeyExtractor& Key;
+	};
+
+	//Least significant digit first: one pass over the elements counts the digits of every pass, then every pass scatters
+	//the elements to the buffer and back in the order of one digit. Each pass is stable, so the order of the earlier
+	//digits is kept among equal digits. Passes in which all the elements have the same digit are skipped.
+	template<size_t DigitBits, typename T, typename KeyExtractor>
+	void LsdRadixSort_Internal(T* pBegin, T* pEnd, KeyExtractor& key, MemoryResource* pResource)
+	{
+		static_assert(IsTriviallyCopyable<T>::Value, "RadixSort copies the elements as bytes");
+		typedef typename RemoveReference<decltype(key(*pBegin))>::Type KeyType;
+		typedef RadixKey<typename RemoveConst<KeyType>::Type> Radix;
+		typedef typename Radix::Type Unsigned;
+		const size_t digitBits = DigitBits > 0 ? DigitBits : RadixDefaultDigitBits<sizeof(Unsigned)>::Value;
+		static_assert(DigitBits == 0 || DigitBits == 8 || DigitBits == 11 || DigitBits == 16, "RadixSort takes 8, 11 or 16 bit digits");
+		const size_t bucketCount = (size_t)1 << digitBits;
+		const size_t mask = bucketCount - 1;
+		const size_t passCount = (sizeof(Unsigned) * 8 + digitBits - 1) / digitBits;
+
+		const size_t size = pEnd - pBegin;
+		RadixKeyLess_Internal<KeyExtractor> compare = { key };
+		if (size < RADIX_SORT_MIN_SIZE)
+		{
+			StableSort(pBegin, pEnd, compare, pResource);
+			return;
+		}
+
+		size_t* pCounts;
+		T* pBuffer;
+		const size_t countBytes = passCount * bucketCount * sizeof(size_t);
+		try
+		{
+			pCounts = static_cast<size_t*>(pResource ? pResource->Allocate(countBytes, alignof(size_t)) : nullptr);
+		}
+		catch (const std::bad_alloc&)
+		{
+			pCounts = nullptr;
+		}
+		try
+		{
+			pBuffer = static_cast<T*>(pCounts ? pResource->Allocate(size * sizeof(T), alignof(T)) : nullptr);
+		}
+		catch (const std::bad_alloc&)
+		{
+			pBuffer = nullptr;
+		}
+		if (!pBuffer)
+		{
+			//StableSort gives the same order, in place when it can't get a buffer either
+			if (pCounts)
+				pResource->Deallocate(pCounts, countBytes, alignof(size_t));
+			StableSort(pBegin, pEnd, compare, pResource);
+			return;
+		}
+
+		//Sorted input is noticed while counting, it would cost all the passes otherwise
+		memset(pCounts, 0, countBytes);
+		Unsigned previous = 0;
+		bool unsorted = false;
+		for (T* pCurrent = pBegin; pCurrent < pEnd; ++pCurrent)
+		{
+			const Unsigned value = Radix::Get(key(*pCurrent));
+			for (size_t pass = 0; pass < passCount; ++pass)
+				++pCounts[pass * bucketCount + ((value >> (pass * digitBits)) & mask)];
+			unsorted |= value < previous;
+			previous = value;
+		}
+
+		T* pFrom = pBegin;
+		T* pTo = pBuffer;
+		for (size_t pass = 0; unsorted && pass < passCount; ++pass)
+		{
+			const size_t shift = pass * digitBits;
+			size_t* pOffsets = pCounts + pass * bucketCount;
+			if (pOffsets[(Radix::Get(key(*pFrom)) >> shift) & mask] == size)
+				continue;
+
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < bucketCount; ++bucket)
+			{
+				const size_t count = pOffsets[bucket];
+				pOffsets[bucket] = offset;
+				offset += count;
+			}
+			for (T* pCurrent = pFrom; pCurrent < pFrom + size; ++pCurrent)
+				pTo[pOffsets[(Radix::Get(key(*pCurrent)) >> shift) & mask]++] = *pCurrent;
+			T* pTemp = pFrom;
+			pFrom = pTo;
+			pTo = pTemp;
+		}
+		if (pFrom != pBegin)
+			memcpy(pBegin, pFrom, size * sizeof(T));
+
+		pResource->Deallocate(pBuffer, size * sizeof(T), alignof(T));
+		pResource->Deallocate(pCounts, countBytes, alignof(size_t));
+	}
+
+	//The bucket of the string at the depth: 0 for strings that end before it, the byte + 1 otherwise
+	inline size_t StringRadixDigit_Internal(const String& string, const size_t depth)
+	{
+		return depth < string.Size() ? (size_t)(unsigned char)string[depth] + 1 : 0;
+	}
+
+	//Compares the strings from the depth on, the characters before it are the same
+	struct StringSuffixLess_Internal
+	{
+		bool operator()(const String& a, const String& b)
+		{
+			return StrCompare(a.Data() + Depth, a.Size() - Depth, b.Data() + Depth, b.Size() - Depth) < 0;
+		}
+
+		size_t Depth;
+	};
+
+	//Most significant byte first, in place (American flag sort): the strings are counted per byte at the depth and swapped
+	//into their bucket, then every bucket is sorted on the next byte. The buckets wait on a stack instead of recursing.
+	//The bytes are read once per level into a cache that the swapping goes by, and a bucket in which all the strings
+	//share the next byte skips the whole shared prefix at once.
+	inline void MsdRadixSort_Internal(String* pBegin, String* pEnd)
+	{
+		struct Bucket
+		{
+			String* pBegin;
+			String* pEnd;
+			size_t Depth;
+		};
+		const size_t BUCKET_COUNT = 257;
+		Vector<Bucket> buckets;
+		buckets.Push({ pBegin, pEnd, 0 });
+		Vector<uint16_t> digits;
+		digits.Resize(pEnd - pBegin);
+		size_t counts[BUCKET_COUNT];
+		size_t heads[BUCKET_COUNT];
+		size_t ends[BUCKET_COUNT];
+		while (!buckets.Empty())
+		{
+			const Bucket range = buckets.Pop();
+			const size_t size = range.pEnd - range.pBegin;
+			const size_t depth = range.Depth;
+			if (size < STRING_RADIX_SORT_INSERTION_THRESHOLD)
+			{
+				StringSuffixLess_Internal compare = { depth };
+				InsertionSort_Internal(range.pBegin, range.pEnd, compare);
+				continue;
+			}
+
+			uint16_t* pDigits = &digits[range.pBegin - pBegin];
+			memset(counts, 0, sizeof(counts));
+			for (size_t i = 0; i < size; ++i)
+			{
+				pDigits[i] = (uint16_t)StringRadixDigit_Internal(range.pBegin[i], depth);
+				++counts[pDigits[i]];
+			}
+
+			if (counts[pDigits[0]] == size)
+			{
+				//One bucket: they all end here and are equal, or they continue after their longest common prefix
+				if (pDigits[0] == 0)
+					continue;
+				const char* pFirst = range.pBegin->Data();
+				size_t common = range.pBegin->Size();
+				for (String* pCurrent = range.pBegin + 1; pCurrent < range.pEnd && common > depth + 1; ++pCurrent)
+				{
+					const size_t limit = pCurrent->Size() < common ? pCurrent->Size() : common;
+					const char* pData = pCurrent->Data();
+					size_t length = depth + 1;
+					while (length < limit && pData[length] == pFirst[length])
+						++length;
+					common = length;
+				}
+				buckets.Push({ range.pBegin, range.pEnd, common });
+				continue;
+			}
+
+			size_t offset = 0;
+			for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+			{
+				heads[bucket] = offset;
+				offset += counts[bucket];
+				ends[bucket] = offset;
+			}
+
+			//Every string is swapped straight to the head of its bucket until the one that belongs here comes back. The
+			//digits behind the heads aren't read again, so only the one that moves along is kept.
+			for (size_t bucket = 0; bucket < BUCKET_COUNT; ++bucket)
+			{
+				while (heads[bucket] < ends[bucket])
+				{
+					const size_t index = heads[bucket];
+					size_t digit = pDigits[index];
+					while (digit != bucket)
+					{
+						const size_t target = heads[digit]++;
+						const size_t next = pDigits[target];
+						range.pBegin[index].Swap(range.pBegin[target]);
+						digit = next;
+					}
+					++heads[bucket];
+				}
+			}
+
+			//The strings that ended are equal, the others continue on the next byte
+			String* pBucket = range.pBegin + counts[0];
+			for (size_t bucket = 1; bucket < BUCKET_COUNT; ++bucket)
+			{
+				if (counts[bucket] > 1)
+					buckets.Push({ pBucket, pBucket + counts[bucket], depth + 1 });
+				pBucket += counts[bucket];
+			}
+		}
+	}
+
+	template<size_t DigitBits, typename T>
+	void RadixSortValues_Internal(T* pBegin, T* pEnd)
+	{
+		RadixIdentity key;
+		LsdRadixSort_Internal<DigitBits>(pBegin, pEnd, key, GetDefaultResource());
+	}
+
+	template<size_t DigitBits>
+	void RadixSortValues_Internal(String* pBegin, String* pEnd)
+	{
+		static_assert(DigitBits == 0 || DigitBits == 8, "Strings are sorted on 8 bit digits");
+		MsdRadixSort_Internal(pBegin, pEnd);
+	}
+
+	//Stable radix sort of trivially copyable elements on the integer or floating point key the extractor returns for
+	//them (eg. a field of a struct), O(n) per digit of the key. DigitBits is 8, 11 or 16, 0 picks one for the key size.
+	//Takes a buffer of the size of the range and the digit counters from the resource, without them it falls back to
+	//StableSort on the key. Takes Vector and Array iterators or pointers.
+	template<size_t DigitBits = 0, typename Iterator, typename KeyExtractor>
+	void RadixSort(Iterator begin, Iterator end, KeyExtractor key, MemoryResource* pResource = GetDefaultResource())
+	{
+		LsdRadixSort_Internal<DigitBits>(ToAddress(begin), ToAddress(end), key, pResource);
+	}
+
+	//Sorts integers and floating point values least significant digit first, and Strings most significant byte first
+	//(in place, not stable, on the bytes as unsigned characters like operator<).
+	template<size_t DigitBits = 0, typename Iterator>
+	void RadixSort(Iterator begin, Iterator end)
+	{
+		RadixSortValues_Internal<DigitBits>(ToAddress(begin), ToAddress(end));
+	}
+}
@@ -0,0 +1,453 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "Utility.h"
+
+#if defined(_M_X64) || defined(_M_AMD64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define STLSTD_SSE2 1
+#include <emmintrin.h>
+#endif
+
+//MSVC compiles AVX2 intrinsics in any function, whether they run is checked at runtime. GCC and clang only when the
+//whole program is built for AVX2 (-mavx2 or -march with it).
+#if defined(STLSTD_SSE2) && (defined(__AVX2__) || (defined(_MSC_VER) && !defined(__clang__) && (defined(_M_X64) || defined(_M_AMD64))))
+#define STLSTD_AVX2 1
+#include <immintrin.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+//Aligned vector loads can read past the end of a buffer without leaving its page, which is safe but
+//the address sanitizer reports it as an overflow
+#if defined(__GNUC__) || defined(__clang__)
+#define STLSTD_NO_SANITIZE_ADDRESS __attribute__((no_sanitize_address))
+#elif defined(_MSC_VER) && defined(__SANITIZE_ADDRESS__)
+#define STLSTD_NO_SANITIZE_ADDRESS __declspec(no_sanitize_address)
+#else
+#define STLSTD_NO_SANITIZE_ADDRESS
+#endif
+
+namespace StlStd
+{
+	//Index of the lowest set bit, the value can't be 0
+	inline uint32_t CountTrailingZeros(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanForward(&index, value);
+		return (uint32_t)index;
+#else
+		return (uint32_t)__builtin_ctz(value);
+#endif
+	}
+
+	//Index of the highest set bit, the value can't be 0
+	inline uint32_t BitScanReverse(uint32_t value)
+	{
+#ifdef _MSC_VER
+		unsigned long index;
+		_BitScanReverse(&index, value);
+		return (uint32_t)index;
+#else
+		return 31 - (uint32_t)__builtin_clz(value);
+#endif
+	}
+
+	//Index of the highest set bit of a size (rounded down log2), the value can't be 0
+	inline uint32_t FloorLog2(size_t value)
+	{
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+		unsigned long index;
+		_BitScanReverse64(&index, value);
+		return (uint32_t)index;
+#elif defined(_MSC_VER)
+		return BitScanReverse((uint32_t)value);
+#else
+		return (uint32_t)(sizeof(unsigned long long) * 8 - 1) - (uint32_t)__builtin_clzll(value);
+#endif
+	}
+
+	//The instruction sets the SIMD algorithms pick their kernels from
+	enum class SimdLevel
+	{
+		None,
+		Sse2,
+		Avx2
+	};
+
+	//The widest level the build has kernels for and the CPU and the OS support
+	inline SimdLevel DetectSimdLevel()
+	{
+#if defined(STLSTD_AVX2) && defined(_MSC_VER) && !defined(__clang__)
+		int info[4];
+		__cpuid(info, 0);
+		if (info[0] >= 7)
+		{
+			//AVX2 needs the OS to save the YMM registers, OSXSAVE and XCR0 tell whether it does
+			__cpuid(info, 1);
+			const bool osSavesYmm = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+			__cpuidex(info, 7, 0);
+			if (osSavesYmm && (info[1] & (1 << 5)) != 0)
+				return SimdLevel::Avx2;
+		}
+		return SimdLevel::Sse2;
+#elif defined(STLSTD_AVX2)
+		return SimdLevel::Avx2;
+#elif defined(STLSTD_SSE2)
+		return SimdLevel::Sse2;
+#else
+		return SimdLevel::None;
+#endif
+	}
+
+	inline SimdLevel& SimdLevel_Internal()
+	{
+		static SimdLevel level = DetectSimdLevel();
+		return level;
+	}
+
+	//The level the SIMD algorithms use, DetectSimdLevel unless it was lowered
+	inline SimdLevel GetSimdLevel()
+	{
+		return SimdLevel_Internal();
+	}
+
+	//Limits the SIMD algorithms to a lower level, eg. to compare the kernels. Levels the CPU doesn't support are lowered
+	//to the ones it does. Not thread-safe, set it before other threads use the algorithms.
+	inline void SetSimdLevel(const SimdLevel level)
+	{
+		const SimdLevel supported = DetectSimdLevel();
+		SimdLevel_Internal() = level < supported ? level : supported;
+	}
+
+	template<size_t Size, bool Signed> struct SimdInteger_Internal;
+	template<> struct SimdInteger_Internal<1, true> { typedef int8_t Type; };
+	template<> struct SimdInteger_Internal<1, false> { typedef uint8_t Type; };
+	template<> struct SimdInteger_Internal<2, true> { typedef int16_t Type; };
+	template<> struct SimdInteger_Internal<2, false> { typedef uint16_t Type; };
+	template<> struct SimdInteger_Internal<4, true> { typedef int32_t Type; };
+	template<> struct SimdInteger_Internal<4, false> { typedef uint32_t Type; };
+	template<> struct SimdInteger_Internal<8, true> { typedef int64_t Type; };
+	template<> struct SimdInteger_Internal<8, false> { typedef uint64_t Type; };
+
+	//The fixed size type the SIMD kernels treat a built in type as (long is int32_t or int64_t, wchar_t uint16_t or
+	//int32_t, ...). Value is false for the types without kernels. MinMax is false for 64-bit integers, SSE2 and AVX2 have
+	//no packed minimum or maximum for them.
+	template<typename T, bool = IsArithmetic<T>::Value>
+	struct SimdElement
+	{
+		typedef void Type;
+		static const bool Value = false;
+		static const bool MinMax = false;
+	};
+	template<typename T>
+	struct SimdElement<T, true>
+	{
+		typedef typename SimdInteger_Internal<sizeof(T), (T(-1) < T(0))>::Type Type;
+		static const bool Value = true;
+		static const bool MinMax = sizeof(T) < 8;
+	};
+	template<>
+	struct SimdElement<bool, true> : SimdElement<void, false> {};
+	template<>
+	struct SimdElement<long double, true> : SimdElement<void, false> {};
+	template<>
+	struct SimdElement<float, true>
+	{
+		typedef float Type;
+		static const bool Value = true;
+		static const bool MinMax = true;
+	};
+	template<>
+	struct SimdElement<double, true>
+	{
+		typedef double Type;
+		static const bool Value = true;
+		static const bool MinMax = true;
+	};
+
+	//The operations the kernels are written with, per instruction set and element type:
+	//- Vec is the register type, it holds LANES elements
+	//- Load and Store don't need aligned addresses
+	//- Equal gives all bits set in the lanes that are equal (== for floats, so -0.0 equals 0.0 and NaN nothing)
+	//- Mask gives the top bit of every byte (integers) or lane (floats), lane i starts at bit i * MASK_STRIDE
+	//- Select takes the lanes of b where the mask is set and of a elsewhere
+	//- Unordered sets the NaN lanes, nothing for integers
+	struct SimdSse2 {};
+	struct SimdAvx2 {};
+	template<typename Isa, typename T> struct SimdOps;
+
+#ifdef STLSTD_SSE2
+	struct SimdSse2Integer_Internal
+	{
+		typedef __m128i Vec;
+		static Vec Load(const void* pData) { return _mm_loadu_si128(static_cast<const __m128i*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm_storeu_si128(static_cast<__m128i*>(pData), v); }
+		static Vec Zero() { return _mm_setzero_si128(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm_or_si128(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm_or_si128(_mm_andnot_si128(mask, a), _mm_and_si128(mask, b)); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm_movemask_epi8(mask); }
+		static Vec Unordered(const Vec) { return _mm_setzero_si128(); }
+	};
+
+	template<> struct SimdOps<SimdSse2, int8_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 16;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Broadcast(const int8_t value) { return _mm_set1_epi8(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi8(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return Select(_mm_cmpgt_epi8(a, b), a, b); }
+		static Vec Max(const Vec a, const Vec b) { return Select(_mm_cmpgt_epi8(a, b), b, a); }
+	};
+
+	template<> struct SimdOps<SimdSse2, uint8_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 16;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Broadcast(const uint8_t value) { return _mm_set1_epi8((char)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi8(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm_min_epu8(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm_max_epu8(a, b); }
+	};
+
+	template<> struct SimdOps<SimdSse2, int16_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 8;
+		static const size_t MASK_STRIDE = 2;
+		static Vec Broadcast(const int16_t value) { return _mm_set1_epi16(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi16(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm_min_epi16(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm_max_epi16(a, b); }
+	};
+
+	//The unsigned types flip the sign bit and compare signed
+	template<> struct SimdOps<SimdSse2, uint16_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 8;
+		static const size_t MASK_STRIDE = 2;
+		static Vec Broadcast(const uint16_t value) { return _mm_set1_epi16((short)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi16(a, b); }
+		static Vec Min(const Vec a, const Vec b)
+		{
+			const Vec sign = _mm_set1_epi16((short)0x8000);
+			return _mm_xor_si128(_mm_min_epi16(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)), sign);
+		}
+		static Vec Max(const Vec a, const Vec b)
+		{
+			const Vec sign = _mm_set1_epi16((short)0x8000);
+			return _mm_xor_si128(_mm_max_epi16(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign)), sign);
+		}
+	};
+
+	template<> struct SimdOps<SimdSse2, int32_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 4;
+		static Vec Broadcast(const int32_t value) { return _mm_set1_epi32(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi32(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return Select(_mm_cmpgt_epi32(a, b), a, b); }
+		static Vec Max(const Vec a, const Vec b) { return Select(_mm_cmpgt_epi32(a, b), b, a); }
+	};
+
+	template<> struct SimdOps<SimdSse2, uint32_t> : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 4;
+		static Vec Broadcast(const uint32_t value) { return _mm_set1_epi32((int)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_epi32(a, b); }
+		static Vec Greater(const Vec a, const Vec b)
+		{
+			const Vec sign = _mm_set1_epi32((int)0x80000000u);
+			return _mm_cmpgt_epi32(_mm_xor_si128(a, sign), _mm_xor_si128(b, sign));
+		}
+		static Vec Min(const Vec a, const Vec b) { return Select(Greater(a, b), a, b); }
+		static Vec Max(const Vec a, const Vec b) { return Select(Greater(a, b), b, a); }
+	};
+
+	//SSE2 compares 64-bit lanes as two halves that both have to be equal
+	struct SimdSse2Integer64_Internal : SimdSse2Integer_Internal
+	{
+		static const size_t LANES = 2;
+		static const size_t MASK_STRIDE = 8;
+		static Vec Equal(const Vec a, const Vec b)
+		{
+			const Vec halves = _mm_cmpeq_epi32(a, b);
+			return _mm_and_si128(halves, _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1)));
+		}
+	};
+
+	template<> struct SimdOps<SimdSse2, int64_t> : SimdSse2Integer64_Internal
+	{
+		static Vec Broadcast(const int64_t value) { return _mm_set1_epi64x(value); }
+	};
+
+	template<> struct SimdOps<SimdSse2, uint64_t> : SimdSse2Integer64_Internal
+	{
+		static Vec Broadcast(const uint64_t value) { return _mm_set1_epi64x((long long)value); }
+	};
+
+	template<> struct SimdOps<SimdSse2, float>
+	{
+		typedef __m128 Vec;
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Load(const void* pData) { return _mm_loadu_ps(static_cast<const float*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm_storeu_ps(static_cast<float*>(pData), v); }
+		static Vec Zero() { return _mm_setzero_ps(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm_or_ps(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm_or_ps(_mm_andnot_ps(mask, a), _mm_and_ps(mask, b)); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm_movemask_ps(mask); }
+		static Vec Unordered(const Vec v) { return _mm_cmpunord_ps(v, v); }
+		static Vec Broadcast(const float value) { return _mm_set1_ps(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_ps(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm_min_ps(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm_max_ps(a, b); }
+	};
+
+	template<> struct SimdOps<SimdSse2, double>
+	{
+		typedef __m128d Vec;
+		static const size_t LANES = 2;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Load(const void* pData) { return _mm_loadu_pd(static_cast<const double*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm_storeu_pd(static_cast<double*>(pData), v); }
+		static Vec Zero() { return _mm_setzero_pd(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm_or_pd(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm_or_pd(_mm_andnot_pd(mask, a), _mm_and_pd(mask, b)); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm_movemask_pd(mask); }
+		static Vec Unordered(const Vec v) { return _mm_cmpunord_pd(v, v); }
+		static Vec Broadcast(const double value) { return _mm_set1_pd(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm_cmpeq_pd(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm_min_pd(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm_max_pd(a, b); }
+	};
+#endif
+
+#ifdef STLSTD_AVX2
+	struct SimdAvx2Integer_Internal
+	{
+		typedef __m256i Vec;
+		static Vec Load(const void* pData) { return _mm256_loadu_si256(static_cast<const __m256i*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm256_storeu_si256(static_cast<__m256i*>(pData), v); }
+		static Vec Zero() { return _mm256_setzero_si256(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm256_or_si256(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm256_blendv_epi8(a, b, mask); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm256_movemask_epi8(mask); }
+		static Vec Unordered(const Vec) { return _mm256_setzero_si256(); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, int8_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 32;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Broadcast(const int8_t value) { return _mm256_set1_epi8(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi8(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epi8(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epi8(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, uint8_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 32;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Broadcast(const uint8_t value) { return _mm256_set1_epi8((char)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi8(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epu8(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epu8(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, int16_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 16;
+		static const size_t MASK_STRIDE = 2;
+		static Vec Broadcast(const int16_t value) { return _mm256_set1_epi16(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi16(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epi16(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epi16(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, uint16_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 16;
+		static const size_t MASK_STRIDE = 2;
+		static Vec Broadcast(const uint16_t value) { return _mm256_set1_epi16((short)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi16(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epu16(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epu16(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, int32_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 8;
+		static const size_t MASK_STRIDE = 4;
+		static Vec Broadcast(const int32_t value) { return _mm256_set1_epi32(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi32(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epi32(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epi32(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, uint32_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 8;
+		static const size_t MASK_STRIDE = 4;
+		static Vec Broadcast(const uint32_t value) { return _mm256_set1_epi32((int)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi32(a, b); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_epu32(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_epu32(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, int64_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 8;
+		static Vec Broadcast(const int64_t value) { return _mm256_set1_epi64x(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi64(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, uint64_t> : SimdAvx2Integer_Internal
+	{
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 8;
+		static Vec Broadcast(const uint64_t value) { return _mm256_set1_epi64x((long long)value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmpeq_epi64(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, float>
+	{
+		typedef __m256 Vec;
+		static const size_t LANES = 8;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Load(const void* pData) { return _mm256_loadu_ps(static_cast<const float*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm256_storeu_ps(static_cast<float*>(pData), v); }
+		static Vec Zero() { return _mm256_setzero_ps(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm256_or_ps(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm256_blendv_ps(a, b, mask); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm256_movemask_ps(mask); }
+		static Vec Unordered(const Vec v) { return _mm256_cmp_ps(v, v, _CMP_UNORD_Q); }
+		static Vec Broadcast(const float value) { return _mm256_set1_ps(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_ps(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_ps(a, b); }
+	};
+
+	template<> struct SimdOps<SimdAvx2, double>
+	{
+		typedef __m256d Vec;
+		static const size_t LANES = 4;
+		static const size_t MASK_STRIDE = 1;
+		static Vec Load(const void* pData) { return _mm256_loadu_pd(static_cast<const double*>(pData)); }
+		static void Store(void* pData, const Vec v) { _mm256_storeu_pd(static_cast<double*>(pData), v); }
+		static Vec Zero() { return _mm256_setzero_pd(); }
+		static Vec Or(const Vec a, const Vec b) { return _mm256_or_pd(a, b); }
+		static Vec Select(const Vec mask, const Vec a, const Vec b) { return _mm256_blendv_pd(a, b, mask); }
+		static uint32_t Mask(const Vec mask) { return (uint32_t)_mm256_movemask_pd(mask); }
+		static Vec Unordered(const Vec v) { return _mm256_cmp_pd(v, v, _CMP_UNORD_Q); }
+		static Vec Broadcast(const double value) { return _mm256_set1_pd(value); }
+		static Vec Equal(const Vec a, const Vec b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+		static Vec Min(const Vec a, const Vec b) { return _mm256_min_pd(a, b); }
+		static Vec Max(const Vec a, const Vec b) { return _mm256_max_pd(a, b); }
+	};
+#endif
+}
@@ -0,0 +1,273 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <mutex>
+#include <assert.h>
+#include "BlockAllocator.h"
+#include "MemoryResource.h"
+#include "TaggedStack.h"
+
+namespace StlStd
+{
+	//General purpose allocator for objects of up to MAX_SIZE bytes, shared by all threads.
+	//The sizes are rounded up to a size class. Every thread keeps a cache of free objects per size class, allocating and
+	//freeing from it takes no synchronization. The caches exchange batches of objects with a central lock-free list per
+	//size class when they run empty or hold too many. Only when the central list is empty as well, a lock is taken to
+	//get new objects from the BlockAllocator of the size class.
+	//Objects can be freed on another thread than the one that allocated them, they end up in the cache of that thread.
+	//The memory is kept for reuse and never given back, a cache is returned to the central lists when its thread exits.
+	class SmallObjectPool
+	{
+	public:
+		static const size_t MAX_SIZE = 1024;
+		static const size_t CLASS_COUNT = 21;
+		//The alignment of all the objects
+		static const size_t ALIGNMENT = 8;
+
+		//Sizes over MAX_SIZE aren't supported, use another allocator for those
+		static void* Allocate(const size_t size)
+		{
+			assert(size <= MAX_SIZE);
+			const size_t sizeClass = SizeClass(size);
+			FreeList& list = GetThreadCache().Lists[sizeClass];
+			if (list.pHead == nullptr)
+				Refill(list, sizeClass);
+			FreeObject* pObject = list.pHead;
+			list.pHead = pObject->pNext;
+			--list.Count;
+			return pObject;
+		}
+
+		//The size has to be the size the object was allocated with, or one of the same size class
+		static void Free(void* pPtr, const size_t size)
+		{
+			if (pPtr == nullptr)
+				return;
+			assert(size <= MAX_SIZE);
+			const size_t sizeClass = SizeClass(size);
+			FreeList& list = GetThreadCache().Lists[sizeClass];
+			FreeObject* pObject = static_cast<FreeObject*>(pPtr);
+			pObject->pNext = list.pHead;
+			list.pHead = pObject;
+			if (++list.Count > 2 * BatchCount(sizeClass))
+				ReleaseBatch(list, sizeClass);
+		}
+
+		//Gives all the objects in the cache of the calling thread back to the central lists
+		static void FlushThreadCache()
+		{
+			GetThreadCache().Flush();
+		}
+
+		//Sizes up to 128 bytes are rounded up to 16 bytes (8 for the smallest class), larger sizes to a quarter of their
+		//power of two, so at most 25% of an object is wasted.
+		static size_t SizeClass(const size_t size)
+		{
+			if (size <= 8)
+				return 0;
+			if (size <= 128)
+				return (size + 15) >> 4;
+			if (size <= 256)
+				return 9 + ((size - 129) >> 5);
+			if (size <= 512)
+				return 13 + ((size - 257) >> 6);
+			return 17 + ((size - 513) >> 7);
+		}
+
+		static size_t ClassSize(const size_t sizeClass)
+		{
+			static const uint16_t SIZES[CLASS_COUNT] = {
+				8, 16, 32, 48, 64, 80, 96, 112, 128,
+				160, 192, 224, 256,
+				320, 384, 448, 512,
+				640, 768, 896, 1024 };
+			assert(sizeClass < CLASS_COUNT);
+			return SIZES[sizeClass];
+		}
+
+		//The amount of objects that moves between a thread cache and the central list at once, about 4 KB worth
+		static size_t BatchCount(const size_t sizeClass)
+		{
+			const size_t count = 4096 / ClassSize(sizeClass);
+			return count < 4 ? 4 : (count > 64 ? 64 : count);
+		}
+
+	private:
+		struct FreeObject
+		{
+			FreeObject* pNext;
+		};
+
+		//A chain of objects on a central list, the batches themselves come from a BlockAllocator and are reused
+		struct Batch
+		{
+			std::atomic<Batch*> pNext;
+			FreeObject* pFirst;
+			size_t Count;
+		};
+
+		struct FreeList
+		{
+			FreeObject* pHead;
+			size_t Count;
+		};
+
+		struct CentralList
+		{
+			TaggedStack<Batch> Batches;
+			//Guards the BlockAllocator, which is only used when there are no batches left
+			std::mutex GrowLock;
+			BlockAllocator::Block* pBlock;
+		};
+
+		struct Central
+		{
+			Central() :
+				pBatchBlock(nullptr)
+			{
+				for (size_t i = 0; i < CLASS_COUNT; ++i)
+					Lists[i].pBlock = nullptr;
+			}
+
+			CentralList Lists[CLASS_COUNT];
+			TaggedStack<Batch> FreeBatches;
+			std::mutex BatchLock;
+			BlockAllocator::Block* pBatchBlock;
+		};
+
+		struct ThreadCache
+		{
+			ThreadCache()
+			{
+				for (size_t i = 0; i < CLASS_COUNT; ++i)
+				{
+					Lists[i].pHead = nullptr;
+					Lists[i].Count = 0;
+				}
+			}
+
+			~ThreadCache()
+			{
+				Flush();
+			}
+
+			void Flush()
+			{
+				for (size_t i = 0; i < CLASS_COUNT; ++i)
+				{
+					while (Lists[i].Count > 0)
+						ReleaseBatch(Lists[i], i);
+				}
+			}
+
+			FreeList Lists[CLASS_COUNT];
+		};
+
+		//The central lists live as long as the program, a thread cache can be flushed to them at any point of the exit
+		static Central& GetCentral()
+		{
+			static Central* pCentral = new Central();
+			return *pCentral;
+		}
+
+		static ThreadCache& GetThreadCache()
+		{
+			static thread_local ThreadCache cache;
+			return cache;
+		}
+
+		//Take a batch from the central list, or new objects when there is none
+		static void Refill(FreeList& list, const size_t sizeClass)
+		{
+			Central& central = GetCentral();
+			CentralList& centralList = central.Lists[sizeClass];
+			Batch* pBatch = centralList.Batches.Pop();
+			if (pBatch)
+			{
+				list.pHead = pBatch->pFirst;
+				list.Count = pBatch->Count;
+				central.FreeBatches.Push(pBatch);
+				return;
+			}
+
+			const size_t count = BatchCount(sizeClass);
+			std::lock_guard<std::mutex> lock(centralList.GrowLock);
+			//The pool makes its own allocations with new and delete, it can be the default resource itself
+			if (centralList.pBlock == nullptr)
+				centralList.pBlock = BlockAllocator::Initialize(ClassSize(sizeClass), count * 4, GetNewDeleteResource(), ALIGNMENT);
+			FreeObject* pHead = nullptr;
+			for (size_t i = 0; i < count; ++i)
+			{
+				FreeObject* pObject = static_cast<FreeObject*>(BlockAllocator::Alloc(centralList.pBlock));
+				pObject->pNext = pHead;
+				pHead = pObject;
+			}
+			list.pHead = pHead;
+			list.Count = count;
+		}
+
+		//Move a batch of objects from the front of the list to the central list, less when the list is shorter
+		static void ReleaseBatch(FreeList& list, const size_t sizeClass)
+		{
+			const size_t batchCount = BatchCount(sizeClass);
+			const size_t count = list.Count < batchCount ? list.Count : batchCount;
+			FreeObject* pFirst = list.pHead;
+			FreeObject* pLast = pFirst;
+			for (size_t i = 1; i < count; ++i)
+				pLast = pLast->pNext;
+			list.pHead = pLast->pNext;
+			list.Count -= count;
+			pLast->pNext = nullptr;
+
+			Central& central = GetCentral();
+			Batch* pBatch = central.FreeBatches.Pop();
+			if (pBatch == nullptr)
+				pBatch = NewBatch(central);
+			pBatch->pFirst = pFirst;
+			pBatch->Count = count;
+			central.Lists[sizeClass].Batches.Push(pBatch);
+		}
+
+		static Batch* NewBatch(Central& central)
+		{
+			std::lock_guard<std::mutex> lock(central.BatchLock);
+			if (central.pBatchBlock == nullptr)
+				central.pBatchBlock = BlockAllocator::Initialize(sizeof(Batch), 64, GetNewDeleteResource(), alignof(Batch));
+			Batch* pBatch = static_cast<Batch*>(BlockAllocator::Alloc(central.pBatchBlock));
+			new (pBatch) Batch();
+			return pBatch;
+		}
+	};
+
+	//Memory resource on the SmallObjectPool, larger or more aligned allocations go to the upstream resource.
+	//The resource itself holds no memory, all the instances share the pool.
+	class SmallObjectResource : public MemoryResource
+	{
+	public:
+		explicit SmallObjectResource(MemoryResource* pUpstream = GetNewDeleteResource()) :
+			m_pUpstream(pUpstream)
+		{
+		}
+
+		MemoryResource* GetUpstream() const { return m_pUpstream; }
+
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) override
+		{
+			if (size <= SmallObjectPool::MAX_SIZE && alignment <= SmallObjectPool::ALIGNMENT)
+				return SmallObjectPool::Allocate(size);
+			return m_pUpstream->Allocate(size, alignment);
+		}
+
+		virtual void DoDeallocate(void* pPtr, size_t size, size_t alignment) override
+		{
+			if (size <= SmallObjectPool::MAX_SIZE && alignment <= SmallObjectPool::ALIGNMENT)
+				SmallObjectPool::Free(pPtr, size);
+			else
+				m_pUpstream->Deallocate(pPtr, size, alignment);
+		}
+
+	private:
+		MemoryResource* m_pUpstream;
+	};
+}
@@ -1,7 +1,10 @@
 #pragma once
+#include <assert.h>
 #include "Algorithm.h"
 #include "Iterator.h"
+#include "MemoryResource.h"
 #include "Utility.h"
+#include "Vector.h"
 
 namespace StlStd
 {
@@ -44,7 +47,7 @@ namespace StlStd
 		{
 			T temp = *i;
 			RandomAccessIterator<T> j = i;
-			while (temp < *(j - 1) && j > pBegin)
+			while (j > pBegin && temp < *(j - 1))
 			{
 				*j = *(j - 1);
 				--j;
@@ -62,7 +65,7 @@ namespace StlStd
 		{
 			T temp = *i;
 			RandomAccessIterator<T> j = i;
-			while (compare(temp, *(j - 1)) && j > pBegin)
+			while (j > pBegin && compare(temp, *(j - 1)))
 			{
 				*j = *(j - 1);
 				--j;
@@ -97,6 +100,1566 @@ namespace StlStd
 		QuickSort(++elementAtCorrectPosition, end);
 	}
 
+#pragma region Sort
+
+	//Below this size a partition is sorted with an insertion sort
+	const size_t SORT_INSERTION_THRESHOLD = 24;
+	//Above this size the pivot is the median of three medians of three (Tukey's ninther), below it the median of three
+	const size_t SORT_NINTHER_THRESHOLD = 128;
+
+	//Orders the three elements
+	template<typename T, typename CompareFunctor>
+	inline void Sort3_Internal(T* pA, T* pB, T* pC, CompareFunctor& compare)
+	{
+		if (compare(*pB, *pA))
+			Swap(*pA, *pB);
+		if (compare(*pC, *pB))
+		{
+			Swap(*pB, *pC);
+			if (compare(*pB, *pA))
+				Swap(*pA, *pB);
+		}
+	}
+
+	template<typename T, typename CompareFunctor>
+	void InsertionSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		if (pBegin == pEnd)
+			return;
+		for (T* pCurrent = pBegin + 1; pCurrent < pEnd; ++pCurrent)
+		{
+			if (!compare(*pCurrent, *(pCurrent - 1)))
+				continue;
+			T value = Move(*pCurrent);
+			T* pHole = pCurrent;
+			do
+			{
+				*pHole = Move(*(pHole - 1));
+				--pHole;
+			} while (pHole != pBegin && compare(value, *(pHole - 1)));
+			*pHole = Move(value);
+		}
+	}
+
+	//Moves the element at the index down the max heap of the given size until its children are smaller
+	template<typename T, typename CompareFunctor>
+	void SiftDown_Internal(T* pBegin, size_t index, const size_t size, CompareFunctor& compare)
+	{
+		T value = Move(pBegin[index]);
+		size_t child = 2 * index + 1;
+		while (child < size)
+		{
+			if (child + 1 < size && compare(pBegin[child], pBegin[child + 1]))
+				++child;
+			if (!compare(value, pBegin[child]))
+				break;
+			pBegin[index] = Move(pBegin[child]);
+			index = child;
+			child = 2 * index + 1;
+		}
+		pBegin[index] = Move(value);
+	}
+
+	template<typename T, typename CompareFunctor>
+	void HeapSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		const size_t size = pEnd - pBegin;
+		for (size_t i = size / 2; i-- > 0;)
+			SiftDown_Internal(pBegin, i, size, compare);
+		for (size_t last = size; last-- > 1;)
+		{
+			Swap(pBegin[0], pBegin[last]);
+			SiftDown_Internal(pBegin, 0, last, compare);
+		}
+	}
+
+	//Moves the median of three, or of three medians of three (Tukey's ninther) for large ranges, to the front. The first
+	//and last elements end up at least and at most the pivot.
+	template<typename T, typename CompareFunctor>
+	inline void MovePivotToFront_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		const size_t size = pEnd - pBegin;
+		T* pMiddle = pBegin + size / 2;
+		if (size > SORT_NINTHER_THRESHOLD)
+		{
+			Sort3_Internal(pBegin, pMiddle, pEnd - 1, compare);
+			Sort3_Internal(pBegin + 1, pMiddle - 1, pEnd - 2, compare);
+			Sort3_Internal(pBegin + 2, pMiddle + 1, pEnd - 3, compare);
+			Sort3_Internal(pMiddle - 1, pMiddle, pMiddle + 1, compare);
+			Swap(*pBegin, *pMiddle);
+		}
+		else
+		{
+			Sort3_Internal(pMiddle, pBegin, pEnd - 1, compare);
+		}
+	}
+
+	//Moves the pivot to the front and partitions the other elements around it, the elements that are equal to the pivot
+	//can end up on both sides so partitions of equal elements are split in half. Returns the start of the right part.
+	template<typename T, typename CompareFunctor>
+	T* Partition_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		MovePivotToFront_Internal(pBegin, pEnd, compare);
+
+		//The scans need no bounds checks: the pivot stops the right scan and one of the last elements is at least as
+		//large as the pivot, which stops the left scan
+		T* pLeft = pBegin + 1;
+		T* pRight = pEnd;
+		while (true)
+		{
+			while (compare(*pLeft, *pBegin))
+				++pLeft;
+			--pRight;
+			while (compare(*pBegin, *pRight))
+				--pRight;
+			if (!(pLeft < pRight))
+				return pLeft;
+			Swap(*pLeft, *pRight);
+			++pLeft;
+		}
+	}
+
+	template<typename T, typename CompareFunctor>
+	void IntroSort_Internal(T* pBegin, T* pEnd, size_t depthLimit, CompareFunctor& compare)
+	{
+		while ((size_t)(pEnd - pBegin) > SORT_INSERTION_THRESHOLD)
+		{
+			if (depthLimit == 0)
+			{
+				HeapSort_Internal(pBegin, pEnd, compare);
+				return;
+			}
+			--depthLimit;
+
+			//Loop on the larger part so the recursion stays O(log n) deep
+			T* pCut = Partition_Internal(pBegin, pEnd, compare);
+			if (pCut - pBegin < pEnd - pCut)
+			{
+				IntroSort_Internal(pBegin, pCut, depthLimit, compare);
+				pBegin = pCut;
+			}
+			else
+			{
+				IntroSort_Internal(pCut, pEnd, depthLimit, compare);
+				pEnd = pCut;
+			}
+		}
+		InsertionSort_Internal(pBegin, pEnd, compare);
+	}
+
+	//Introsort: a quicksort with a median of three or ninther pivot, that switches to a heapsort when the partitions get
+	//too unbalanced and sorts small partitions with an insertion sort. O(n log n) in the worst case and not stable.
+	//Takes Vector and Array iterators or pointers.
+	template<typename Iterator, typename CompareFunctor>
+	void Sort(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		auto pEnd = ToAddress(end);
+		size_t depthLimit = 0;
+		for (size_t size = pEnd - pBegin; size > 1; size >>= 1)
+			depthLimit += 2;
+		IntroSort_Internal(pBegin, pEnd, depthLimit, compare);
+	}
+
+	template<typename Iterator>
+	void Sort(Iterator begin, Iterator end)
+	{
+		Sort(begin, end, LessThan<>());
+	}
+
+	//O(n log n) in the worst case and no extra memory, but slower than Sort on most inputs
+	template<typename Iterator, typename CompareFunctor>
+	void HeapSort(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		HeapSort_Internal(ToAddress(begin), ToAddress(end), compare);
+	}
+
+	template<typename Iterator>
+	void HeapSort(Iterator begin, Iterator end)
+	{
+		HeapSort(begin, end, LessThan<>());
+	}
+
+#pragma endregion Sort
+
+#pragma region UnstableSort
+
+	//Number of elements the branchless partition looks at from each side before it swaps the misplaced ones
+	const size_t SORT_PARTITION_BLOCK = 64;
+	//The partial insertion sort gives up after moving this many elements, the partition wasn't nearly sorted
+	const size_t SORT_PARTIAL_INSERTION_LIMIT = 8;
+
+	//The branchless partition compares every element of a block and only pays off when that's cheap,
+	//so it's used for the built in types with the default comparisons.
+	template<typename T, typename CompareFunctor>
+	struct IsBranchlessCompare : FalseType {};
+	template<typename T>
+	struct IsBranchlessCompare<T, LessThan<>> : IsArithmetic<T> {};
+	template<typename T>
+	struct IsBranchlessCompare<T, LessThan<T>> : IsArithmetic<T> {};
+	template<typename T>
+	struct IsBranchlessCompare<T, GreaterThan<>> : IsArithmetic<T> {};
+	template<typename T>
+	struct IsBranchlessCompare<T, GreaterThan<T>> : IsArithmetic<T> {};
+
+	//Insertion sort of a partition that isn't the leftmost one, the element before it is not larger than any element
+	//in it and stops the scan
+	template<typename T, typename CompareFunctor>
+	void UnguardedInsertionSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		for (T* pCurrent = pBegin + 1; pCurrent < pEnd; ++pCurrent)
+		{
+			if (!compare(*pCurrent, *(pCurrent - 1)))
+				continue;
+			T value = Move(*pCurrent);
+			T* pHole = pCurrent;
+			do
+			{
+				*pHole = Move(*(pHole - 1));
+				--pHole;
+			} while (compare(value, *(pHole - 1)));
+			*pHole = Move(value);
+		}
+	}
+
+	//Insertion sort that stops once it moved too many elements. Returns whether the range is sorted.
+	template<typename T, typename CompareFunctor>
+	bool PartialInsertionSort_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		if (pBegin == pEnd)
+			return true;
+		size_t moved = 0;
+		for (T* pCurrent = pBegin + 1; pCurrent < pEnd; ++pCurrent)
+		{
+			if (!compare(*pCurrent, *(pCurrent - 1)))
+				continue;
+			T value = Move(*pCurrent);
+			T* pHole = pCurrent;
+			do
+			{
+				*pHole = Move(*(pHole - 1));
+				--pHole;
+			} while (pHole != pBegin && compare(value, *(pHole - 1)));
+			*pHole = Move(value);
+			moved += pCurrent - pHole;
+			if (moved > SORT_PARTIAL_INSERTION_LIMIT)
+				return false;
+		}
+		return true;
+	}
+
+	//Moves the elements at the offsets from the left of pLeft with the ones at the offsets from the right of pRight.
+	//With a different count of misplaced elements on each side the elements go around in a cycle, which moves each of
+	//them once instead of swapping.
+	template<typename T>
+	inline void SwapOffsets_Internal(T* pLeft, T* pRight, const unsigned char* pLeftOffsets, const unsigned char* pRightOffsets, size_t count, bool useSwaps)
+	{
+		if (useSwaps)
+		{
+			for (size_t i = 0; i < count; ++i)
+				Swap(pLeft[pLeftOffsets[i]], *(pRight - pRightOffsets[i]));
+		}
+		else if (count > 0)
+		{
+			T* pL = pLeft + pLeftOffsets[0];
+			T* pR = pRight - pRightOffsets[0];
+			T value = Move(*pL);
+			*pL = Move(*pR);
+			for (size_t i = 1; i < count; ++i)
+			{
+				pL = pLeft + pLeftOffsets[i];
+				*pR = Move(*pL);
+				pR = pRight - pRightOffsets[i];
+				*pL = Move(*pR);
+			}
+			*pR = Move(value);
+		}
+	}
+
+	//Partitions around the pivot at the front, the elements equal to the pivot go to the right.
+	//Returns the final position of the pivot and sets alreadyPartitioned when no element had to be moved.
+	template<typename T, typename CompareFunctor>
+	T* PartitionRight_Internal(T* pBegin, T* pEnd, bool& alreadyPartitioned, CompareFunctor& compare)
+	{
+		T pivot = Move(*pBegin);
+		T* pFirst = pBegin;
+		T* pLast = pEnd;
+
+		//The median of three put an element at least as large as the pivot at the end, that stops the first scan.
+		//The second one only needs a bounds check when the first found nothing smaller.
+		while (compare(*++pFirst, pivot));
+		if (pFirst - 1 == pBegin)
+			while (pFirst < pLast && !compare(*--pLast, pivot));
+		else
+			while (!compare(*--pLast, pivot));
+
+		alreadyPartitioned = pFirst >= pLast;
+		while (pFirst < pLast)
+		{
+			Swap(*pFirst, *pLast);
+			while (compare(*++pFirst, pivot));
+			while (!compare(*--pLast, pivot));
+		}
+
+		T* pPivot = pFirst - 1;
+		*pBegin = Move(*pPivot);
+		*pPivot = Move(pivot);
+		return pPivot;
+	}
+
+	//Partitions [pFirst, pLast) around the pivot without a branch on the comparisons (BlockQuicksort). A block of
+	//elements from each side is compared first and the offsets of the misplaced ones are written down unconditionally,
+	//then the misplaced elements are swapped pairwise. The mispredicted branch per element becomes an add.
+	//Returns the start of the right part.
+	template<typename T, typename CompareFunctor>
+	T* PartitionBlocks_Internal(T* pFirst, T* pLast, const T& pivot, CompareFunctor& compare)
+	{
+		//Offsets from pFirst of the elements that belong on the right, and from pLast of the ones that belong on the left
+		alignas(64) unsigned char leftOffsets[SORT_PARTITION_BLOCK];
+		alignas(64) unsigned char rightOffsets[SORT_PARTITION_BLOCK];
+		unsigned char* pLeftOffsets = leftOffsets;
+		unsigned char* pRightOffsets = rightOffsets;
+		size_t leftCount = 0;
+		size_t rightCount = 0;
+		size_t leftStart = 0;
+		size_t rightStart = 0;
+
+		while ((size_t)(pLast - pFirst) > 2 * SORT_PARTITION_BLOCK)
+		{
+			if (leftCount == 0)
+			{
+				leftStart = 0;
+				T* pElement = pFirst;
+				for (size_t i = 0; i < SORT_PARTITION_BLOCK; ++i)
+				{
+					leftOffsets[leftCount] = (unsigned char)i;
+					leftCount += !compare(*pElement, pivot);
+					++pElement;
+				}
+			}
+			if (rightCount == 0)
+			{
+				rightStart = 0;
+				T* pElement = pLast;
+				for (size_t i = 0; i < SORT_PARTITION_BLOCK;)
+				{
+					rightOffsets[rightCount] = (unsigned char)++i;
+					rightCount += compare(*--pElement, pivot);
+				}
+			}
+
+			const size_t count = leftCount < rightCount ? leftCount : rightCount;
+			SwapOffsets_Internal(pFirst, pLast, pLeftOffsets + leftStart, pRightOffsets + rightStart, count, leftCount == rightCount);
+			leftCount -= count;
+			rightCount -= count;
+			leftStart += count;
+			rightStart += count;
+			if (leftCount == 0)
+				pFirst += SORT_PARTITION_BLOCK;
+			if (rightCount == 0)
+				pLast -= SORT_PARTITION_BLOCK;
+		}
+
+		//Less than two blocks are left, one side may still have a block with misplaced elements in it
+		size_t leftSize;
+		size_t rightSize;
+		const size_t unknown = (pLast - pFirst) - ((leftCount || rightCount) ? SORT_PARTITION_BLOCK : 0);
+		if (rightCount)
+		{
+			leftSize = unknown;
+			rightSize = SORT_PARTITION_BLOCK;
+		}
+		else if (leftCount)
+		{
+			leftSize = SORT_PARTITION_BLOCK;
+			rightSize = unknown;
+		}
+		else
+		{
+			leftSize = unknown / 2;
+			rightSize = unknown - leftSize;
+		}
+
+		if (unknown && leftCount == 0)
+		{
+			leftStart = 0;
+			T* pElement = pFirst;
+			for (size_t i = 0; i < leftSize; ++i)
+			{
+				leftOffsets[leftCount] = (unsigned char)i;
+				leftCount += !compare(*pElement, pivot);
+				++pElement;
+			}
+		}
+		if (unknown && rightCount == 0)
+		{
+			rightStart = 0;
+			T* pElement = pLast;
+			for (size_t i = 0; i < rightSize;)
+			{
+				rightOffsets[rightCount] = (unsigned char)++i;
+				rightCount += compare(*--pElement, pivot);
+			}
+		}
+
+		const size_t count = leftCount < rightCount ? leftCount : rightCount;
+		SwapOffsets_Internal(pFirst, pLast, pLeftOffsets + leftStart, pRightOffsets + rightStart, count, leftCount == rightCount);
+		leftCount -= count;
+		rightCount -= count;
+		leftStart += count;
+		rightStart += count;
+		if (leftCount == 0)
+			pFirst += leftSize;
+		if (rightCount == 0)
+			pLast -= rightSize;
+
+		//Only one side has misplaced elements left, they're moved to the other end of the unpartitioned range
+		if (leftCount)
+		{
+			pLeftOffsets += leftStart;
+			while (leftCount--)
+				Swap(pFirst[pLeftOffsets[leftCount]], *--pLast);
+			pFirst = pLast;
+		}
+		if (rightCount)
+		{
+			pRightOffsets += rightStart;
+			while (rightCount--)
+			{
+				Swap(*(pLast - pRightOffsets[rightCount]), *pFirst);
+				++pFirst;
+			}
+		}
+		return pFirst;
+	}
+
+	//Same result as PartitionRight_Internal, the elements between the first misplaced pair go through the branchless
+	//block partition
+	template<typename T, typename CompareFunctor>
+	T* PartitionRightBranchless_Internal(T* pBegin, T* pEnd, bool& alreadyPartitioned, CompareFunctor& compare)
+	{
+		T pivot = Move(*pBegin);
+		T* pFirst = pBegin;
+		T* pLast = pEnd;
+
+		while (compare(*++pFirst, pivot));
+		if (pFirst - 1 == pBegin)
+			while (pFirst < pLast && !compare(*--pLast, pivot));
+		else
+			while (!compare(*--pLast, pivot));
+
+		alreadyPartitioned = pFirst >= pLast;
+		if (!alreadyPartitioned)
+		{
+			Swap(*pFirst, *pLast);
+			pFirst = PartitionBlocks_Internal(pFirst + 1, pLast, pivot, compare);
+		}
+
+		T* pPivot = pFirst - 1;
+		*pBegin = Move(*pPivot);
+		*pPivot = Move(pivot);
+		return pPivot;
+	}
+
+	//Partitions around the pivot at the front with the elements equal to it on the left. Used when the pivot is equal to
+	//the element before the partition, every element on the left is then equal to it and is never looked at again.
+	template<typename T, typename CompareFunctor>
+	T* PartitionLeft_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		T pivot = Move(*pBegin);
+		T* pFirst = pBegin;
+		T* pLast = pEnd;
+
+		while (compare(pivot, *--pLast));
+		if (pLast + 1 == pEnd)
+			while (pFirst < pLast && !compare(pivot, *++pFirst));
+		else
+			while (!compare(pivot, *++pFirst));
+
+		while (pFirst < pLast)
+		{
+			Swap(*pFirst, *pLast);
+			while (compare(pivot, *--pLast));
+			while (!compare(pivot, *++pFirst));
+		}
+
+		T* pPivot = pLast;
+		*pBegin = Move(*pPivot);
+		*pPivot = Move(pivot);
+		return pPivot;
+	}
+
+	//Swaps a few elements of a partition that came out unbalanced to other places, so the next pivot is picked from
+	//different elements. Breaks up the patterns that make the median of three pick a bad pivot again and again.
+	template<typename T>
+	void BreakPatterns_Internal(T* pBegin, T* pEnd)
+	{
+		const size_t size = pEnd - pBegin;
+		if (size < SORT_INSERTION_THRESHOLD)
+			return;
+		const size_t quarter = size / 4;
+		Swap(pBegin[0], pBegin[quarter]);
+		Swap(*(pEnd - 1), *(pEnd - quarter));
+		if (size > SORT_NINTHER_THRESHOLD)
+		{
+			Swap(pBegin[1], pBegin[quarter + 1]);
+			Swap(pBegin[2], pBegin[quarter + 2]);
+			Swap(*(pEnd - 2), *(pEnd - quarter - 1));
+			Swap(*(pEnd - 3), *(pEnd - quarter - 2));
+		}
+	}
+
+	template<bool Branchless, typename T, typename CompareFunctor>
+	void PatternDefeatingSort_Internal(T* pBegin, T* pEnd, size_t badAllowed, bool leftmost, CompareFunctor& compare)
+	{
+		while (true)
+		{
+			const size_t size = pEnd - pBegin;
+			if (size < SORT_INSERTION_THRESHOLD)
+			{
+				if (leftmost)
+					InsertionSort_Internal(pBegin, pEnd, compare);
+				else
+					UnguardedInsertionSort_Internal(pBegin, pEnd, compare);
+				return;
+			}
+
+			MovePivotToFront_Internal(pBegin, pEnd, compare);
+
+			//The pivot equals the element before the partition (the previous pivot), so does everything smaller than
+			//or equal to it here. Putting those on the left finishes them, many equal elements take linear time.
+			if (!leftmost && !compare(*(pBegin - 1), *pBegin))
+			{
+				pBegin = PartitionLeft_Internal(pBegin, pEnd, compare) + 1;
+				continue;
+			}
+
+			bool alreadyPartitioned;
+			T* pPivot = Branchless ? PartitionRightBranchless_Internal(pBegin, pEnd, alreadyPartitioned, compare)
+				: PartitionRight_Internal(pBegin, pEnd, alreadyPartitioned, compare);
+
+			const size_t leftSize = pPivot - pBegin;
+			const size_t rightSize = pEnd - (pPivot + 1);
+			if (leftSize < size / 8 || rightSize < size / 8)
+			{
+				//Too many bad partitions, the input is adversarial. A heapsort keeps it O(n log n).
+				if (--badAllowed == 0)
+				{
+					HeapSort_Internal(pBegin, pEnd, compare);
+					return;
+				}
+				BreakPatterns_Internal(pBegin, pPivot);
+				BreakPatterns_Internal(pPivot + 1, pEnd);
+			}
+			else if (alreadyPartitioned && PartialInsertionSort_Internal(pBegin, pPivot, compare)
+				&& PartialInsertionSort_Internal(pPivot + 1, pEnd, compare))
+			{
+				//Nothing was out of place around a good pivot, the input is likely (nearly) sorted
+				return;
+			}
+
+			PatternDefeatingSort_Internal<Branchless>(pBegin, pPivot, badAllowed, leftmost, compare);
+			pBegin = pPivot + 1;
+			leftmost = false;
+		}
+	}
+
+	//Pattern-defeating quicksort (pdqsort). Sort with the following additions:
+	//- Sorted and reversed inputs, and runs of equal elements, take linear time
+	//- Patterns that produce bad pivots are broken up, a heapsort takes over when that keeps failing
+	//- Built in types compared with LessThan or GreaterThan are partitioned without branches
+	//Not stable. Takes Vector and Array iterators or pointers.
+	template<typename Iterator, typename CompareFunctor>
+	void UnstableSort(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		auto pEnd = ToAddress(end);
+		using T = typename RemoveReference<decltype(*pBegin)>::Type;
+		size_t badAllowed = 1;
+		for (size_t size = pEnd - pBegin; size > 1; size >>= 1)
+			++badAllowed;
+		PatternDefeatingSort_Internal<IsBranchlessCompare<T, CompareFunctor>::Value>(pBegin, pEnd, badAllowed, true, compare);
+	}
+
+	template<typename Iterator>
+	void UnstableSort(Iterator begin, Iterator end)
+	{
+		UnstableSort(begin, end, LessThan<>());
+	}
+
+#pragma endregion UnstableSort
+
+#pragma region StableSort
+
+	//Runs shorter than this are extended with an insertion sort, the actual minimum is between half of it and it
+	const size_t STABLE_SORT_MIN_MERGE = 64;
+	//How many elements in a row one run has to win before a merge starts galloping, it adapts while merging
+	const size_t STABLE_SORT_MIN_GALLOP = 7;
+	//The pending runs grow at least like the Fibonacci numbers, 85 of them hold more than 2^64 elements
+	const size_t STABLE_SORT_MAX_RUNS = 85;
+
+	template<typename T>
+	void Reverse_Internal(T* pBegin, T* pEnd)
+	{
+		while (pBegin < pEnd && pBegin < --pEnd)
+			Swap(*pBegin++, *pEnd);
+	}
+
+	//Swaps [pBegin, pMiddle) and [pMiddle, pEnd), returns where the first range starts now
+	template<typename T>
+	T* Rotate_Internal(T* pBegin, T* pMiddle, T* pEnd)
+	{
+		Reverse_Internal(pBegin, pMiddle);
+		Reverse_Internal(pMiddle, pEnd);
+		Reverse_Internal(pBegin, pEnd);
+		return pBegin + (pEnd - pMiddle);
+	}
+
+	//TimSort: finds the runs that are already sorted (reversing the descending ones), extends short runs with an insertion
+	//sort and merges the runs while keeping their lengths balanced. The merges skip the parts of the runs that
+	//are already in place and gallop (exponential search) through one run while it keeps winning.
+	//The buffer holds the smaller run of a merge, it grows as needed up to half the elements. When it can't be
+	//allocated the runs are merged in place by rotating, which is O(n log^2 n) instead of O(n log n).
+	template<typename T, typename CompareFunctor>
+	class TimSort_Internal
+	{
+	public:
+		TimSort_Internal(T* pBase, const size_t size, CompareFunctor& compare, MemoryResource* pResource) :
+			m_pBase(pBase), m_Size(size), m_Compare(compare), m_pResource(pResource), m_pBuffer(nullptr), m_BufferSize(0),
+			m_AllocationFailed(false), m_MinGallop(STABLE_SORT_MIN_GALLOP), m_RunCount(0)
+		{
+		}
+
+		TimSort_Internal(const TimSort_Internal& other) = delete;
+		TimSort_Internal& operator=(const TimSort_Internal& other) = delete;
+
+		~TimSort_Internal()
+		{
+			if (m_pBuffer)
+				m_pResource->Deallocate(m_pBuffer, m_BufferSize * sizeof(T), alignof(T));
+		}
+
+		void Sort()
+		{
+			if (m_Size < 2)
+				return;
+			T* pEnd = m_pBase + m_Size;
+			if (m_Size < STABLE_SORT_MIN_MERGE)
+			{
+				InsertionSort(m_pBase, m_pBase + CountRun(m_pBase, pEnd), pEnd);
+				return;
+			}
+
+			const size_t minRun = MinRunLength(m_Size);
+			for (T* pRun = m_pBase; pRun < pEnd;)
+			{
+				size_t runSize = CountRun(pRun, pEnd);
+				if (runSize < minRun)
+				{
+					const size_t remaining = pEnd - pRun;
+					const size_t forcedSize = remaining < minRun ? remaining : minRun;
+					InsertionSort(pRun, pRun + runSize, pRun + forcedSize);
+					runSize = forcedSize;
+				}
+				m_RunBases[m_RunCount] = pRun;
+				m_RunSizes[m_RunCount] = runSize;
+				++m_RunCount;
+				MergeCollapse();
+				pRun += runSize;
+			}
+			while (m_RunCount > 1)
+			{
+				size_t n = m_RunCount - 2;
+				if (n > 0 && m_RunSizes[n - 1] < m_RunSizes[n + 1])
+					--n;
+				MergeAt(n);
+			}
+		}
+
+	private:
+		//Returns the length of the run at the start, a strictly descending run is reversed. Descending runs with equal
+		//elements would lose their order when reversed.
+		size_t CountRun(T* pBegin, T* pEnd)
+		{
+			T* pRunEnd = pBegin + 1;
+			if (pRunEnd == pEnd)
+				return 1;
+			if (m_Compare(*pRunEnd, *pBegin))
+			{
+				++pRunEnd;
+				while (pRunEnd < pEnd && m_Compare(*pRunEnd, *(pRunEnd - 1)))
+					++pRunEnd;
+				Reverse_Internal(pBegin, pRunEnd);
+			}
+			else
+			{
+				++pRunEnd;
+				while (pRunEnd < pEnd && !m_Compare(*pRunEnd, *(pRunEnd - 1)))
+					++pRunEnd;
+			}
+			return pRunEnd - pBegin;
+		}
+
+		//[pBegin, pSorted) is sorted already, the other elements are inserted after the equal ones.
+		//The place is found with a binary search, except for the types that are cheap to compare (trivially copyable):
+		//scanning along with the moves is faster for those, the comparisons are predictable.
+		void InsertionSort(T* pBegin, T* pSorted, T* pEnd)
+		{
+			InsertionSort(pBegin, pSorted, pEnd, BoolConstant<IsTriviallyCopyable<T>::Value>());
+		}
+
+		void InsertionSort(T* pBegin, T* pSorted, T* pEnd, TrueType)
+		{
+			for (; pSorted < pEnd; ++pSorted)
+			{
+				if (!m_Compare(*pSorted, *(pSorted - 1)))
+					continue;
+				T value = Move(*pSorted);
+				T* pHole = pSorted;
+				do
+				{
+					*pHole = Move(*(pHole - 1));
+					--pHole;
+				} while (pHole != pBegin && m_Compare(value, *(pHole - 1)));
+				*pHole = Move(value);
+			}
+		}
+
+		void InsertionSort(T* pBegin, T* pSorted, T* pEnd, FalseType)
+		{
+			for (; pSorted < pEnd; ++pSorted)
+			{
+				T* pLow = pBegin;
+				T* pHigh = pSorted;
+				while (pLow < pHigh)
+				{
+					T* pMiddle = pLow + (pHigh - pLow) / 2;
+					if (m_Compare(*pSorted, *pMiddle))
+						pHigh = pMiddle;
+					else
+						pLow = pMiddle + 1;
+				}
+				if (pLow == pSorted)
+					continue;
+				T value = Move(*pSorted);
+				for (T* pHole = pSorted; pHole > pLow; --pHole)
+					*pHole = Move(*(pHole - 1));
+				*pLow = Move(value);
+			}
+		}
+
+		//Between half of the minimum and the minimum, picked so the amount of runs is a power of two or just below one
+		static size_t MinRunLength(size_t size)
+		{
+			size_t remainder = 0;
+			while (size >= STABLE_SORT_MIN_MERGE)
+			{
+				remainder |= size & 1;
+				size >>= 1;
+			}
+			return size + remainder;
+		}
+
+		//Where the key goes in the sorted range before the equal elements, searching outwards from the hint first
+		size_t GallopLeft(const T& key, const T* pBase, const size_t size, const size_t hint)
+		{
+			ptrdiff_t lastOffset = 0;
+			ptrdiff_t offset = 1;
+			if (m_Compare(pBase[hint], key))
+			{
+				const ptrdiff_t maxOffset = size - hint;
+				while (offset < maxOffset && m_Compare(pBase[hint + offset], key))
+				{
+					lastOffset = offset;
+					offset = (offset << 1) + 1;
+				}
+				if (offset > maxOffset)
+					offset = maxOffset;
+				lastOffset += hint;
+				offset += hint;
+			}
+			else
+			{
+				const ptrdiff_t maxOffset = hint + 1;
+				while (offset < maxOffset && !m_Compare(pBase[hint - offset], key))
+				{
+					lastOffset = offset;
+					offset = (offset << 1) + 1;
+				}
+				if (offset > maxOffset)
+					offset = maxOffset;
+				const ptrdiff_t temp = lastOffset;
+				lastOffset = hint - offset;
+				offset = hint - temp;
+			}
+
+			//pBase[lastOffset] < key <= pBase[offset], a binary search finds the spot in between
+			++lastOffset;
+			while (lastOffset < offset)
+			{
+				const ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+				if (m_Compare(pBase[middle], key))
+					lastOffset = middle + 1;
+				else
+					offset = middle;
+			}
+			return offset;
+		}
+
+		//Where the key goes in the sorted range after the equal elements
+		size_t GallopRight(const T& key, const T* pBase, const size_t size, const size_t hint)
+		{
+			ptrdiff_t lastOffset = 0;
+			ptrdiff_t offset = 1;
+			if (m_Compare(key, pBase[hint]))
+			{
+				const ptrdiff_t maxOffset = hint + 1;
+				while (offset < maxOffset && m_Compare(key, pBase[hint - offset]))
+				{
+					lastOffset = offset;
+					offset = (offset << 1) + 1;
+				}
+				if (offset > maxOffset)
+					offset = maxOffset;
+				const ptrdiff_t temp = lastOffset;
+				lastOffset = hint - offset;
+				offset = hint - temp;
+			}
+			else
+			{
+				const ptrdiff_t maxOffset = size - hint;
+				while (offset < maxOffset && !m_Compare(key, pBase[hint + offset]))
+				{
+					lastOffset = offset;
+					offset = (offset << 1) + 1;
+				}
+				if (offset > maxOffset)
+					offset = maxOffset;
+				lastOffset += hint;
+				offset += hint;
+			}
+
+			//pBase[lastOffset] <= key < pBase[offset]
+			++lastOffset;
+			while (lastOffset < offset)
+			{
+				const ptrdiff_t middle = lastOffset + (offset - lastOffset) / 2;
+				if (m_Compare(key, pBase[middle]))
+					offset = middle;
+				else
+					lastOffset = middle + 1;
+			}
+			return offset;
+		}
+
+		//Merges the runs on top of the stack until each run is longer than the two above it together, which keeps the
+		//merges balanced and the stack short. Checks the three runs below the top as well (the fix of the original bug).
+		void MergeCollapse()
+		{
+			while (m_RunCount > 1)
+			{
+				size_t n = m_RunCount - 2;
+				if ((n > 0 && m_RunSizes[n - 1] <= m_RunSizes[n] + m_RunSizes[n + 1])
+					|| (n > 1 && m_RunSizes[n - 2] <= m_RunSizes[n - 1] + m_RunSizes[n]))
+				{
+					if (m_RunSizes[n - 1] < m_RunSizes[n + 1])
+						--n;
+				}
+				else if (m_RunSizes[n] > m_RunSizes[n + 1])
+				{
+					break;
+				}
+				MergeAt(n);
+			}
+		}
+
+		//Merges the runs at the index and the one after it
+		void MergeAt(const size_t index)
+		{
+			T* pBase1 = m_RunBases[index];
+			size_t size1 = m_RunSizes[index];
+			T* pBase2 = m_RunBases[index + 1];
+			size_t size2 = m_RunSizes[index + 1];
+
+			m_RunSizes[index] = size1 + size2;
+			if (index == m_RunCount - 3)
+			{
+				m_RunBases[index + 1] = m_RunBases[index + 2];
+				m_RunSizes[index + 1] = m_RunSizes[index + 2];
+			}
+			--m_RunCount;
+			Merge(pBase1, size1, pBase2, size2);
+		}
+
+		//Merges two runs that are next to each other
+		void Merge(T* pBase1, size_t size1, T* pBase2, size_t size2)
+		{
+			if (size1 == 0 || size2 == 0)
+				return;
+
+			//The start of the first run that is smaller than the second run and the end of the second run that is larger
+			//than the first one are in place already
+			const size_t skipped = GallopRight(*pBase2, pBase1, size1, 0);
+			pBase1 += skipped;
+			size1 -= skipped;
+			if (size1 == 0)
+				return;
+			size2 = GallopLeft(pBase1[size1 - 1], pBase2, size2, size2 - 1);
+			if (size2 == 0)
+				return;
+
+			if (ReserveBuffer(size1 < size2 ? size1 : size2))
+			{
+				if (size1 <= size2)
+					MergeLow(pBase1, size1, pBase2, size2);
+				else
+					MergeHigh(pBase1, size1, pBase2, size2);
+				return;
+			}
+
+			//No buffer for the smaller run: the middle of the larger run is moved to where it goes in the other one,
+			//which leaves two independent merges of about half the size
+			if (size1 + size2 == 2)
+			{
+				if (m_Compare(*pBase2, *pBase1))
+					Swap(*pBase1, *pBase2);
+				return;
+			}
+			T* pCut1;
+			T* pCut2;
+			if (size1 > size2)
+			{
+				pCut1 = pBase1 + size1 / 2;
+				pCut2 = pBase2 + GallopLeft(*pCut1, pBase2, size2, 0);
+			}
+			else
+			{
+				pCut2 = pBase2 + size2 / 2;
+				pCut1 = pBase1 + GallopRight(*pCut2, pBase1, size1, 0);
+			}
+			T* pMiddle = Rotate_Internal(pCut1, pBase2, pCut2);
+			Merge(pBase1, pCut1 - pBase1, pCut1, pMiddle - pCut1);
+			Merge(pMiddle, pCut2 - pMiddle, pCut2, pBase2 + size2 - pCut2);
+		}
+
+		//Whether the buffer holds the amount of elements, it grows in powers of two up to half the elements.
+		//An allocation that fails is not tried again.
+		bool ReserveBuffer(const size_t size)
+		{
+			if (size <= m_BufferSize)
+				return true;
+			if (!m_pResource || m_AllocationFailed)
+				return false;
+
+			size_t newSize = 256;
+			while (newSize < size)
+				newSize *= 2;
+			if (newSize > m_Size / 2)
+				newSize = size > m_Size / 2 ? size : m_Size / 2;
+
+			//The old buffer is empty between merges, it goes first so there is one buffer at a time
+			const size_t oldSize = m_BufferSize;
+			m_pResource->Deallocate(m_pBuffer, m_BufferSize * sizeof(T), alignof(T));
+			m_pBuffer = AllocateBuffer(newSize);
+			if (m_pBuffer)
+			{
+				m_BufferSize = newSize;
+				return true;
+			}
+
+			//The buffer of the old size still takes the merges that fit
+			m_AllocationFailed = true;
+			m_pBuffer = oldSize > 0 ? AllocateBuffer(oldSize) : nullptr;
+			m_BufferSize = m_pBuffer ? oldSize : 0;
+			return false;
+		}
+
+		//nullptr when the resource runs out of memory, either way it does that
+		T* AllocateBuffer(const size_t size)
+		{
+			try
+			{
+				return static_cast<T*>(m_pResource->Allocate(size * sizeof(T), alignof(T)));
+			}
+			catch (const std::bad_alloc&)
+			{
+				return nullptr;
+			}
+		}
+
+		//Merges from the front with the first run in the buffer, it isn't larger than the second one.
+		//The first element of the second run goes first and the last element of the first run goes last (Merge).
+		void MergeLow(T* pBase1, size_t size1, T* pBase2, size_t size2)
+		{
+			const size_t bufferCount = size1;
+			for (size_t i = 0; i < size1; ++i)
+				new (m_pBuffer + i) T(Move(pBase1[i]));
+
+			T* pCursor1 = m_pBuffer;
+			T* pCursor2 = pBase2;
+			T* pDest = pBase1;
+			*pDest++ = Move(*pCursor2++);
+
+			size_t minGallop = m_MinGallop;
+			if (--size2 == 0 || size1 == 1)
+				goto Done;
+			while (true)
+			{
+				//One element at a time until one run wins often enough in a row
+				size_t count1 = 0;
+				size_t count2 = 0;
+				do
+				{
+					if (m_Compare(*pCursor2, *pCursor1))
+					{
+						*pDest++ = Move(*pCursor2++);
+						++count2;
+						count1 = 0;
+						if (--size2 == 0)
+							goto Done;
+					}
+					else
+					{
+						*pDest++ = Move(*pCursor1++);
+						++count1;
+						count2 = 0;
+						if (--size1 == 1)
+							goto Done;
+					}
+				} while ((count1 | count2) < minGallop);
+
+				//Galloping, the elements that win in a row are found with a search and moved at once
+				do
+				{
+					count1 = GallopRight(*pCursor2, pCursor1, size1, 0);
+					for (size_t i = 0; i < count1; ++i)
+						*pDest++ = Move(*pCursor1++);
+					size1 -= count1;
+					if (size1 <= 1)
+						goto Done;
+					*pDest++ = Move(*pCursor2++);
+					if (--size2 == 0)
+						goto Done;
+
+					count2 = GallopLeft(*pCursor1, pCursor2, size2, 0);
+					for (size_t i = 0; i < count2; ++i)
+						*pDest++ = Move(*pCursor2++);
+					size2 -= count2;
+					if (size2 == 0)
+						goto Done;
+					*pDest++ = Move(*pCursor1++);
+					if (--size1 == 1)
+						goto Done;
+					if (minGallop > 0)
+						--minGallop;
+				} while (count1 >= STABLE_SORT_MIN_GALLOP || count2 >= STABLE_SORT_MIN_GALLOP);
+				minGallop += 2;
+			}
+
+		Done:
+			m_MinGallop = minGallop < 1 ? 1 : minGallop;
+			if (size1 == 1 && size2 > 0)
+			{
+				//The rest of the second run goes before the last element of the first one
+				for (size_t i = 0; i < size2; ++i)
+					*pDest++ = Move(*pCursor2++);
+				*pDest = Move(*pCursor1);
+			}
+			else
+			{
+				for (size_t i = 0; i < size1; ++i)
+					*pDest++ = Move(*pCursor1++);
+			}
+			for (size_t i = 0; i < bufferCount; ++i)
+				m_pBuffer[i].~T();
+		}
+
+		//Merges from the back with the second run in the buffer, it is smaller than the first one
+		void MergeHigh(T* pBase1, size_t size1, T* pBase2, size_t size2)
+		{
+			const size_t bufferCount = size2;
+			for (size_t i = 0; i < size2; ++i)
+				new (m_pBuffer + i) T(Move(pBase2[i]));
+
+			T* pCursor1 = pBase1 + size1 - 1;
+			T* pCursor2 = m_pBuffer + size2 - 1;
+			T* pDest = pBase2 + size2 - 1;
+			*pDest-- = Move(*pCursor1--);
+
+			size_t minGallop = m_MinGallop;
+			if (--size1 == 0 || size2 == 1)
+				goto Done;
+			while (true)
+			{
+				size_t count1 = 0;
+				size_t count2 = 0;
+				do
+				{
+					if (m_Compare(*pCursor2, *pCursor1))
+					{
+						*pDest-- = Move(*pCursor1--);
+						++count1;
+						count2 = 0;
+						if (--size1 == 0)
+							goto Done;
+					}
+					else
+					{
+						*pDest-- = Move(*pCursor2--);
+						++count2;
+						count1 = 0;
+						if (--size2 == 1)
+							goto Done;
+					}
+				} while ((count1 | count2) < minGallop);
+
+				do
+				{
+					count1 = size1 - GallopRight(*pCursor2, pBase1, size1, size1 - 1);
+					for (size_t i = 0; i < count1; ++i)
+						*pDest-- = Move(*pCursor1--);
+					size1 -= count1;
+					if (size1 == 0)
+						goto Done;
+					*pDest-- = Move(*pCursor2--);
+					if (--size2 == 1)
+						goto Done;
+
+					count2 = size2 - GallopLeft(*pCursor1, m_pBuffer, size2, size2 - 1);
+					for (size_t i = 0; i < count2; ++i)
+						*pDest-- = Move(*pCursor2--);
+					size2 -= count2;
+					if (size2 <= 1)
+						goto Done;
+					*pDest-- = Move(*pCursor1--);
+					if (--size1 == 0)
+						goto Done;
+					if (minGallop > 0)
+						--minGallop;
+				} while (count1 >= STABLE_SORT_MIN_GALLOP || count2 >= STABLE_SORT_MIN_GALLOP);
+				minGallop += 2;
+			}
+
+		Done:
+			m_MinGallop = minGallop < 1 ? 1 : minGallop;
+			if (size2 == 1 && size1 > 0)
+			{
+				//The rest of the first run goes after the first element of the second one
+				for (size_t i = 0; i < size1; ++i)
+					*pDest-- = Move(*pCursor1--);
+				*pDest = Move(*pCursor2);
+			}
+			else
+			{
+				for (size_t i = 0; i < size2; ++i)
+					*pDest-- = Move(*pCursor2--);
+			}
+			for (size_t i = 0; i < bufferCount; ++i)
+				m_pBuffer[i].~T();
+		}
+
+		T* m_pBase;
+		size_t m_Size;
+		CompareFunctor& m_Compare;
+		MemoryResource* m_pResource;
+		T* m_pBuffer;
+		size_t m_BufferSize;
+		bool m_AllocationFailed;
+		size_t m_MinGallop;
+		size_t m_RunCount;
+		T* m_RunBases[STABLE_SORT_MAX_RUNS];
+		size_t m_RunSizes[STABLE_SORT_MAX_RUNS];
+	};
+
+	//Stable sort: equal elements keep their order. TimSort, O(n log n) and close to O(n) when the input consists of a
+	//few sorted or reversed runs. Takes a buffer of up to half the elements from the resource, without one (nullptr or
+	//when the allocation fails) it sorts in place in O(n log^2 n).
+	//Takes Vector and Array iterators or pointers.
+	template<typename Iterator, typename CompareFunctor>
+	void StableSort(Iterator begin, Iterator end, CompareFunctor compare, MemoryResource* pResource = GetDefaultResource())
+	{
+		auto pBegin = ToAddress(begin);
+		using T = typename RemoveReference<decltype(*pBegin)>::Type;
+		TimSort_Internal<T, CompareFunctor> sort(pBegin, ToAddress(end) - pBegin, compare, pResource);
+		sort.Sort();
+	}
+
+	template<typename Iterator>
+	void StableSort(Iterator begin, Iterator end)
+	{
+		StableSort(begin, end, LessThan<>());
+	}
+
+#pragma endregion StableSort
+
+#pragma region Selection
+
+	//PartialSort keeps a heap of the first k elements up to this fraction of the range (1 / 64), above it selecting the
+	//k-th element and sorting the ones before it is faster
+	const size_t PARTIAL_SORT_HEAP_SHIFT = 6;
+
+	//Moves the element at the index up the max heap until its parent is larger
+	template<typename T, typename CompareFunctor>
+	void SiftUp_Internal(T* pBegin, size_t index, CompareFunctor& compare)
+	{
+		T value = Move(pBegin[index]);
+		while (index > 0)
+		{
+			const size_t parent = (index - 1) / 2;
+			if (!compare(pBegin[parent], value))
+				break;
+			pBegin[index] = Move(pBegin[parent]);
+			index = parent;
+		}
+		pBegin[index] = Move(value);
+	}
+
+	//Leaves the middle - begin first elements as a max heap in the front, the largest of them at begin. O(n log k).
+	template<typename T, typename CompareFunctor>
+	void HeapSelect_Internal(T* pBegin, T* pMiddle, T* pEnd, CompareFunctor& compare)
+	{
+		const size_t size = pMiddle - pBegin;
+		for (size_t i = size / 2; i-- > 0;)
+			SiftDown_Internal(pBegin, i, size, compare);
+		for (T* pCurrent = pMiddle; pCurrent < pEnd; ++pCurrent)
+		{
+			if (compare(*pCurrent, *pBegin))
+			{
+				Swap(*pCurrent, *pBegin);
+				SiftDown_Internal(pBegin, 0, size, compare);
+			}
+		}
+	}
+
+	//Sorts a max heap in place
+	template<typename T, typename CompareFunctor>
+	void SortHeap_Internal(T* pBegin, T* pEnd, CompareFunctor& compare)
+	{
+		for (size_t last = pEnd - pBegin; last-- > 1;)
+		{
+			Swap(pBegin[0], pBegin[last]);
+			SiftDown_Internal(pBegin, 0, last, compare);
+		}
+	}
+
+	//Quickselect with the partitions of UnstableSort: only the part that holds the nth position is continued with.
+	//Runs of equal elements are finished in one partition, and after too many bad partitions a heap select takes over.
+	template<bool Branchless, typename T, typename CompareFunctor>
+	void PatternDefeatingSelect_Internal(T* pBegin, T* pNth, T* pEnd, CompareFunctor& compare)
+	{
+		size_t badAllowed = 1;
+		for (size_t size = pEnd - pBegin; size > 1; size >>= 1)
+			++badAllowed;
+		bool leftmost = true;
+		while (true)
+		{
+			const size_t size = pEnd - pBegin;
+			if (size < SORT_INSERTION_THRESHOLD)
+			{
+				InsertionSort_Internal(pBegin, pEnd, compare);
+				return;
+			}
+
+			MovePivotToFront_Internal(pBegin, pEnd, compare);
+			if (!leftmost && !compare(*(pBegin - 1), *pBegin))
+			{
+				//Everything up to the pivot equals it
+				T* pPivot = PartitionLeft_Internal(pBegin, pEnd, compare);
+				if (pNth <= pPivot)
+					return;
+				pBegin = pPivot + 1;
+				continue;
+			}
+
+			bool alreadyPartitioned;
+			T* pPivot = Branchless ? PartitionRightBranchless_Internal(pBegin, pEnd, alreadyPartitioned, compare)
+				: PartitionRight_Internal(pBegin, pEnd, alreadyPartitioned, compare);
+			if (pPivot == pNth)
+				return;
+
+			const size_t leftSize = pPivot - pBegin;
+			const size_t rightSize = pEnd - (pPivot + 1);
+			if (leftSize < size / 8 || rightSize < size / 8)
+			{
+				if (--badAllowed == 0)
+				{
+					T* pFirst = pNth < pPivot ? pBegin : pPivot + 1;
+					T* pLast = pNth < pPivot ? pPivot : pEnd;
+					HeapSelect_Internal(pFirst, pNth + 1, pLast, compare);
+					Swap(*pFirst, *pNth);
+					return;
+				}
+				BreakPatterns_Internal(pBegin, pPivot);
+				BreakPatterns_Internal(pPivot + 1, pEnd);
+			}
+
+			if (pNth < pPivot)
+			{
+				pEnd = pPivot;
+			}
+			else
+			{
+				pBegin = pPivot + 1;
+				leftmost = false;
+			}
+		}
+	}
+
+	//Puts the element that belongs at nth in sorted order there, with no element after it that comes before it and no
+	//element before it that comes after it. O(n) on average, a heap select bounds the worst case to O(n log n).
+	//Takes Vector and Array iterators or pointers.
+	template<typename Iterator, typename CompareFunctor>
+	void NthElement(Iterator begin, Iterator nth, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		auto pNth = ToAddress(nth);
+		auto pEnd = ToAddress(end);
+		if (pNth == pEnd)
+			return;
+		using T = typename RemoveReference<decltype(*pBegin)>::Type;
+		PatternDefeatingSelect_Internal<IsBranchlessCompare<T, CompareFunctor>::Value>(pBegin, pNth, pEnd, compare);
+	}
+
+	template<typename Iterator>
+	void NthElement(Iterator begin, Iterator nth, Iterator end)
+	{
+		NthElement(begin, nth, end, LessThan<>());
+	}
+
+	//Sorts the middle - begin first elements of the range into [begin, middle), the order of the others is unspecified.
+	//O(n log k) with a heap of the first k elements for small k, O(n + k log k) with NthElement for larger ones.
+	template<typename Iterator, typename CompareFunctor>
+	void PartialSort(Iterator begin, Iterator middle, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		auto pMiddle = ToAddress(middle);
+		auto pEnd = ToAddress(end);
+		if (pMiddle == pBegin)
+			return;
+		if ((size_t)(pMiddle - pBegin) <= (size_t)(pEnd - pBegin) >> PARTIAL_SORT_HEAP_SHIFT)
+		{
+			HeapSelect_Internal(pBegin, pMiddle, pEnd, compare);
+			SortHeap_Internal(pBegin, pMiddle, compare);
+			return;
+		}
+		if (pMiddle < pEnd)
+			NthElement(pBegin, pMiddle - 1, pEnd, compare);
+		UnstableSort(pBegin, pMiddle, compare);
+	}
+
+	template<typename Iterator>
+	void PartialSort(Iterator begin, Iterator middle, Iterator end)
+	{
+		PartialSort(begin, middle, end, LessThan<>());
+	}
+
+	//Copies the first elements of the input in sorted order to the output, as many as fit. The input is left unchanged.
+	//Returns the end of the elements that were copied. O(n log k) for k output elements.
+	template<typename InputIterator, typename OutputIterator, typename CompareFunctor>
+	OutputIterator PartialSortCopy(InputIterator inBegin, InputIterator inEnd, OutputIterator outBegin, OutputIterator outEnd, CompareFunctor compare)
+	{
+		auto pIn = ToAddress(inBegin);
+		auto pInEnd = ToAddress(inEnd);
+		auto pOut = ToAddress(outBegin);
+		const size_t inSize = pInEnd - pIn;
+		const size_t outSize = ToAddress(outEnd) - pOut;
+		const size_t size = inSize < outSize ? inSize : outSize;
+		if (size == 0)
+			return outBegin;
+
+		for (size_t i = 0; i < size; ++i)
+			pOut[i] = pIn[i];
+		for (size_t i = size / 2; i-- > 0;)
+			SiftDown_Internal(pOut, i, size, compare);
+		for (pIn += size; pIn < pInEnd; ++pIn)
+		{
+			if (compare(*pIn, *pOut))
+			{
+				pOut[0] = *pIn;
+				SiftDown_Internal(pOut, 0, size, compare);
+			}
+		}
+		SortHeap_Internal(pOut, pOut + size, compare);
+		return outBegin + size;
+	}
+
+	template<typename InputIterator, typename OutputIterator>
+	OutputIterator PartialSortCopy(InputIterator inBegin, InputIterator inEnd, OutputIterator outBegin, OutputIterator outEnd)
+	{
+		return PartialSortCopy(inBegin, inEnd, outBegin, outEnd, LessThan<>());
+	}
+
+	//Keeps the first k of a stream of values in the order of the compare functor, pass GreaterThan for the k largest.
+	//The values are kept in a max heap of k elements: a value that doesn't come before the last one kept is dropped with
+	//a single compare, the others replace it in O(log k).
+	template<typename T, typename CompareFunctor = LessThan<T>>
+	class TopK
+	{
+	public:
+		explicit TopK(const size_t k, CompareFunctor compare = CompareFunctor(), MemoryResource* pResource = GetDefaultResource()) :
+			m_Heap(*pResource), m_K(k), m_Compare(compare)
+		{
+			m_Heap.Reserve(k);
+		}
+
+		void Push(const T& value)
+		{
+			if (m_Heap.Size() < m_K)
+			{
+				m_Heap.Push(value);
+				SiftUp_Internal(m_Heap.Data(), m_Heap.Size() - 1, m_Compare);
+			}
+			else if (m_K > 0 && m_Compare(value, m_Heap[0]))
+			{
+				m_Heap[0] = value;
+				SiftDown_Internal(m_Heap.Data(), 0, m_Heap.Size(), m_Compare);
+			}
+		}
+
+		void Push(T&& value)
+		{
+			if (m_Heap.Size() < m_K)
+			{
+				m_Heap.Push(Move(value));
+				SiftUp_Internal(m_Heap.Data(), m_Heap.Size() - 1, m_Compare);
+			}
+			else if (m_K > 0 && m_Compare(value, m_Heap[0]))
+			{
+				m_Heap[0] = Move(value);
+				SiftDown_Internal(m_Heap.Data(), 0, m_Heap.Size(), m_Compare);
+			}
+		}
+
+		template<typename Iterator>
+		void Push(Iterator begin, Iterator end)
+		{
+			for (auto pCurrent = ToAddress(begin); pCurrent < ToAddress(end); ++pCurrent)
+				Push(*pCurrent);
+		}
+
+		//The last of the values kept, once k values are kept only values that come before it are taken
+		const T& Bound() const
+		{
+			assert(!m_Heap.Empty());
+			return m_Heap[0];
+		}
+
+		size_t Size() const { return m_Heap.Size(); }
+		size_t GetK() const { return m_K; }
+		bool Empty() const { return m_Heap.Empty(); }
+		bool IsFull() const { return m_Heap.Size() == m_K; }
+
+		void Clear()
+		{
+			m_Heap.Clear();
+		}
+
+		//The values kept, in order. Leaves the accumulator empty.
+		Vector<T> Extract()
+		{
+			SortHeap_Internal(m_Heap.Data(), m_Heap.Data() + m_Heap.Size(), m_Compare);
+			Vector<T> values = Move(m_Heap);
+			m_Heap = Vector<T>(*values.GetResource());
+			return values;
+		}
+
+	private:
+		Vector<T> m_Heap;
+		size_t m_K;
+		CompareFunctor m_Compare;
+	};
+
+#pragma endregion Selection
+
+#pragma region Heap
+
+	//The heap algorithms keep a max heap: every element is at least its children in the order of the compare functor,
+	//the largest element is at begin. Take Vector and Array iterators or pointers.
+
+	//Orders the range as a heap in O(n)
+	template<typename Iterator, typename CompareFunctor>
+	void MakeHeap(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		const size_t size = ToAddress(end) - pBegin;
+		for (size_t i = size / 2; i-- > 0;)
+			SiftDown_Internal(pBegin, i, size, compare);
+	}
+
+	template<typename Iterator>
+	void MakeHeap(Iterator begin, Iterator end)
+	{
+		MakeHeap(begin, end, LessThan<>());
+	}
+
+	//Adds the last element of the range to the heap in front of it, O(log n)
+	template<typename Iterator, typename CompareFunctor>
+	void PushHeap(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		const size_t size = ToAddress(end) - pBegin;
+		if (size > 1)
+			SiftUp_Internal(pBegin, size - 1, compare);
+	}
+
+	template<typename Iterator>
+	void PushHeap(Iterator begin, Iterator end)
+	{
+		PushHeap(begin, end, LessThan<>());
+	}
+
+	//Moves the largest element to the end of the range and makes the rest a heap again, O(log n)
+	template<typename Iterator, typename CompareFunctor>
+	void PopHeap(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		const size_t size = ToAddress(end) - pBegin;
+		if (size < 2)
+			return;
+		Swap(pBegin[0], pBegin[size - 1]);
+		SiftDown_Internal(pBegin, 0, size - 1, compare);
+	}
+
+	template<typename Iterator>
+	void PopHeap(Iterator begin, Iterator end)
+	{
+		PopHeap(begin, end, LessThan<>());
+	}
+
+	//Sorts a heap in O(n log n)
+	template<typename Iterator, typename CompareFunctor>
+	void SortHeap(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		SortHeap_Internal(ToAddress(begin), ToAddress(end), compare);
+	}
+
+	template<typename Iterator>
+	void SortHeap(Iterator begin, Iterator end)
+	{
+		SortHeap(begin, end, LessThan<>());
+	}
+
+	template<typename Iterator, typename CompareFunctor>
+	bool IsHeap(Iterator begin, Iterator end, CompareFunctor compare)
+	{
+		auto pBegin = ToAddress(begin);
+		const size_t size = ToAddress(end) - pBegin;
+		for (size_t i = 1; i < size; ++i)
+		{
+			if (compare(pBegin[(i - 1) / 2], pBegin[i]))
+				return false;
+		}
+		return true;
+	}
+
+	template<typename Iterator>
+	bool IsHeap(Iterator begin, Iterator end)
+	{
+		return IsHeap(begin, end, LessThan<>());
+	}
+
+#pragma endregion Heap
+
 	template<typename T>
 	bool IsSorted(RandomAccessIterator<T> pBegin, RandomAccessIterator<T> pEnd)
 	{
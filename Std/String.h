@@ -1,113 +1,140 @@
 #pragma once
 #include <assert.h>
+#include <stdio.h>
 #include <iostream>
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Utility.h"
 #include "Hash.h"
+#include "StringView.h"
+#include "MemoryResource.h"
 
 namespace StlStd
 {
-	inline size_t StrLen(const char* pData)
-	{
-		const char* pCurrent = pData;
-		for (; *pCurrent; ++pCurrent)
-		{
-		}
-		return pCurrent - pData;
-	}
-
-	inline size_t StrLen(const wchar_t* pData)
+	//Short strings are stored inline in the object (small string optimization), longer ones on the heap.
+	//The object is three words either way, the last byte tells the layouts apart, see IsLarge.
+	//A heap buffer is preceded by the memory resource it came from. Local strings belong to the default resource,
+	//a string that is given another resource always uses the heap layout to remember it.
+	class String
 	{
-		const wchar_t* pCurrent = pData;
-		for (; *pCurrent; ++pCurrent)
+	private:
+		struct HeapData
 		{
-		}
-		return pCurrent - pData;
-	}
+			char* pBuffer;
+			size_t Size;
+			//The highest bit flags the heap layout, see LARGE_FLAG
+			size_t Capacity;
+		};
 
-	class String
-	{
 	public:
 		using Iterator = RandomAccessIterator<char>;
 		using ConstIterator = RandomAccessConstIterator<char>;
+
+		//The amount of characters that fit in the object without a heap allocation
+		static const size_t LOCAL_CAPACITY = sizeof(HeapData) - 1;
+
 	public:
-		String() :
-			m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
-		{}
+		String()
+		{
+			InitializeLocal();
+		}
 
-		String(const size_t size, const char value = '\0') :
-			m_pBuffer(new char[size + 1]), m_Size(size), m_Capacity(size)
+		String(const size_t size, const char value = '\0')
 		{
-			memset(m_pBuffer, value, m_Size);
-			m_pBuffer[size] = '\0';
+			Initialize(size);
+			memset(Data(), value, size);
 		}
 
-		String(const char* pData) :
-			m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
+		String(const char* pData)
 		{
-			Append(pData);
+			const size_t size = pData ? StrLen(pData) : 0;
+			Initialize(size);
+			if (size > 0)
+				memcpy(Data(), pData, size);
+		}
+
+		//The characters are allocated from the resource, which has to outlive the string
+		explicit String(MemoryResource* pResource)
+		{
+			Initialize(0, pResource);
+		}
+
+		String(const char* pData, MemoryResource* pResource)
+		{
+			const size_t size = pData ? StrLen(pData) : 0;
+			Initialize(size, pResource);
+			if (size > 0)
+				memcpy(Data(), pData, size);
 		}
 
-		explicit String(const wchar_t* pData) :
-			m_pBuffer(nullptr), m_Size(0)
+		explicit String(const wchar_t* pData)
 		{
+			InitializeLocal();
 			Append(pData);
 		}
 
+		explicit String(const StringView& view) :
+			String(view.Begin(), view.End())
+		{
+		}
+
 		explicit String(const char* pBegin, const char* pEnd)
 		{
 			if (pBegin == nullptr || pEnd == nullptr)
 			{
-				m_pBuffer = nullptr;
-				m_Capacity = 0;
-				m_Size = 0;
+				InitializeLocal();
 			}
 			else
 			{
-				m_Size = pEnd - pBegin;
-				m_Capacity = m_Size;
-				m_pBuffer = new char[m_Size + 1];
-				memcpy(m_pBuffer, pBegin, m_Size);
-				m_pBuffer[m_Size] = '\0';
+				const size_t size = pEnd - pBegin;
+				Initialize(size);
+				memcpy(Data(), pBegin, size);
 			}
 		}
 
-		//Move semantics
-		String(String&& other) :
-			m_pBuffer(other.m_pBuffer), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+		//Move semantics, a local string is copied and a heap buffer is taken over along with its resource
+		String(String&& other)
 		{
-			other.m_pBuffer = nullptr;
-			other.m_Size = 0;
-			other.m_Capacity = 0;
+			memcpy(m_Local, other.m_Local, sizeof(m_Local));
+			other.InitializeLocal();
 		}
 
-		//Deep copy
-		String(const String& other) :
-			m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
+		//Deep copy, the copy uses the default resource unless it is given one
+		String(const String& other, MemoryResource* pResource = GetDefaultResource())
 		{
-			Append(other.Data());
+			Initialize(other.Size(), pResource);
+			memcpy(Data(), other.Data(), other.Size());
 		}
 
 		String& operator=(const String& other)
 		{
-			if(other.m_pBuffer != m_pBuffer)
-				Append(other.Data());
+			if (this != &other)
+			{
+				Clear();
+				Append(other.Data(), other.Size());
+			}
 			return *this;
 		}
 
-		~String()
+		String& operator=(String&& other)
 		{
-			if (m_pBuffer)
+			if (this != &other)
 			{
-				delete[] m_pBuffer;
-				m_pBuffer = nullptr;
+				FreeBuffer();
+				memcpy(m_Local, other.m_Local, sizeof(m_Local));
+				other.InitializeLocal();
 			}
+			return *this;
+		}
+
+		~String()
+		{
+			FreeBuffer();
 		}
 
 		String& operator+(const String& other)
 		{
-			Append(other.Data());
+			Append(other.Data(), other.Size());
 			return *this;
 		}
 
@@ -119,7 +146,7 @@ namespace StlStd
 
 		String& operator+=(const String& other)
 		{
-			Append(other.Data());
+			Append(other.Data(), other.Size());
 			return *this;
 		}
 
@@ -129,17 +156,16 @@ namespace StlStd
 			return *this;
 		}
 
+		String& operator+=(const char value)
+		{
+			Push(value);
+			return *this;
+		}
+
 		bool operator==(const String& other) const
 		{
-			size_t len = Length();
-			if (len != other.m_Size)
-				return false;
-			for (size_t i = 0; i < len; ++i)
-			{
-				if (m_pBuffer[i] != other.m_pBuffer[i])
-					return false;
-			}
-			return true;
+			const size_t size = Size();
+			return size == other.Size() && StrEqual(Data(), other.Data(), size);
 		}
 
 		bool operator!=(const String& other) const
@@ -149,15 +175,8 @@ namespace StlStd
 
 		bool operator==(const char* pData) const
 		{
-			size_t len = Length();
-			if (len != StrLen(pData))
-				return false;
-			for (size_t i = 0; i < len; ++i)
-			{
-				if (m_pBuffer[i] != pData[i])
-					return false;
-			}
-			return true;
+			const size_t size = Size();
+			return size == StrLen(pData) && StrEqual(Data(), pData, size);
 		}
 
 		bool operator!=(const char* pData) const
@@ -167,12 +186,13 @@ namespace StlStd
 
 		bool operator==(const wchar_t* pData) const
 		{
-			size_t len = Length();
-			if (len != StrLen(pData))
+			const size_t size = Size();
+			if (size != StrLen(pData))
 				return false;
-			for (size_t i = 0; i < len; ++i)
+			const char* pBuffer = Data();
+			for (size_t i = 0; i < size; ++i)
 			{
-				if (m_pBuffer[i] != (wchar_t)pData[i])
+				if (pBuffer[i] != (wchar_t)pData[i])
 					return false;
 			}
 			return true;
@@ -183,326 +203,354 @@ namespace StlStd
 			return !operator==(pData);
 		}
 
-		const char& operator[](const size_t index) const { return m_pBuffer[index]; }
-		char& operator[](const size_t index) { return m_pBuffer[index]; }
+		bool operator==(const StringView& view) const
+		{
+			return Size() == view.Size() && StrEqual(Data(), view.Data(), view.Size());
+		}
 
-		const char& At(const size_t index) const { assert(index < m_Size); return m_pBuffer[index]; }
-		char& At(const size_t index) { assert(index < m_Size); return m_pBuffer[index]; }
+		bool operator!=(const StringView& view) const
+		{
+			return !operator==(view);
+		}
+
+		bool operator<(const String& other) const
+		{
+			return StrCompare(Data(), Size(), other.Data(), other.Size()) < 0;
+		}
+
+		bool operator<(const char* pData) const
+		{
+			return StrCompare(Data(), Size(), pData, StrLen(pData)) < 0;
+		}
+
+		bool operator<(const StringView& view) const
+		{
+			return StrCompare(Data(), Size(), view.Data(), view.Size()) < 0;
+		}
+
+		const char& operator[](const size_t index) const { return Data()[index]; }
+		char& operator[](const size_t index) { return Data()[index]; }
+
+		const char& At(const size_t index) const { assert(index < Size()); return Data()[index]; }
+		char& At(const size_t index) { assert(index < Size()); return Data()[index]; }
 
 		void Clear()
 		{
-			m_Size = 0;
+			SetSize(0);
 		}
 
+		//Sets the size and fits the capacity to it, new characters are 0
 		void Resize(const size_t size)
 		{
-			size_t copyWidth = 0;
-			if (m_pBuffer)
-			{
-				char* pNewBuffer = new char[size + 1];
-				copyWidth = size > m_Size ? m_Size : size;
-				memcpy(pNewBuffer, m_pBuffer, copyWidth);
-				delete[] m_pBuffer;
-				m_pBuffer = pNewBuffer;
-			}
-			else
-			{
-				m_pBuffer = new char[size + 1];
-			}
-			memset(m_pBuffer + copyWidth, 0, (size - copyWidth));
-			m_Size = size;
-			m_Capacity = size;
-			m_pBuffer[m_Size] = '\0';
+			const size_t oldSize = Size();
+			const size_t copyWidth = size > oldSize ? oldSize : size;
+			if (size != Capacity())
+				Reallocate(size, copyWidth);
+			memset(Data() + copyWidth, 0, (size - copyWidth));
+			SetSize(size);
 		}
 
 		void Reserve(const size_t size)
 		{
-			if (size <= m_Capacity)
+			if (size <= Capacity())
 				return;
-
-			if (m_pBuffer != nullptr)
-			{
-				char* pNewBuffer = new char[size + 1];
-				size_t copyWidth = size > m_Size ? m_Size : size;
-				memcpy(pNewBuffer, m_pBuffer, copyWidth);
-				delete[] m_pBuffer;
-				m_pBuffer = pNewBuffer;
-			}
-			else
-			{
-				m_pBuffer = new char[size + 1];
-			}
-			m_Capacity = size;
-			m_pBuffer[m_Size] = '\0';
+			Reallocate(size, Size());
 		}
 
 		void ShrinkToFit()
 		{
-			Resize(m_Size);
+			Resize(Size());
 		}
 
 		void Push(const char value)
 		{
-			if (m_Size >= m_Capacity)
+			const size_t size = Size();
+			if (size >= Capacity())
 			{
-				Reserve(CalculateGrowth(m_Size));
+				Reserve(CalculateGrowth(size + 1));
 			}
-			*(m_pBuffer + m_Size) = value;
-			++m_Size;
-			m_pBuffer[m_Size] = '\0';
+			Data()[size] = value;
+			SetSize(size + 1);
 		}
 
 		char Pop()
 		{
-			assert(m_Size > 0);
+			assert(Size() > 0);
 			char value = Back();
-			--m_Size;
-			m_pBuffer[m_Size] = '\0';
+			SetSize(Size() - 1);
 			return value;
 		}
 
+		//Swaps the objects as they are, local strings included, a heap buffer keeps its address
 		void Swap(String& other)
 		{
-			StlStd::Swap(m_pBuffer, other.m_pBuffer);
-			StlStd::Swap(m_Size, other.m_Size);
-			StlStd::Swap(m_Capacity, other.m_Capacity);
+			char temp[sizeof(m_Local)];
+			memcpy(temp, m_Local, sizeof(m_Local));
+			memcpy(m_Local, other.m_Local, sizeof(m_Local));
+			memcpy(other.m_Local, temp, sizeof(m_Local));
 		}
 
+		//Appends the value amount times
 		void Assign(const size_t amount, const char value)
 		{
-			if (m_Size + amount > m_Capacity)
-				Reserve(m_Size + amount);
-			for (size_t i = 0; i < amount; ++i)
-			{
-				memcpy(m_pBuffer + m_Size + i, &value, sizeof(char));
-			}
-			m_Size += amount;
-			m_pBuffer[m_Size] = '\0';
+			Append(amount, value);
 		}
 
 		void EraseAt(const size_t index)
 		{
-			assert(index < m_Size);
-			for (size_t i = index; i < m_Size - 1; ++i)
-				m_pBuffer[i] = m_pBuffer[i + 1];
-			--m_Size;
-			m_pBuffer[m_Size] = '\0';
+			const size_t size = Size();
+			assert(index < size);
+			char* pBuffer = Data();
+			for (size_t i = index; i < size - 1; ++i)
+				pBuffer[i] = pBuffer[i + 1];
+			SetSize(size - 1);
 		}
 
 		void Insert(const size_t index, const char value)
 		{
-			assert(index <= m_Size);
-			if (m_Size == m_Capacity)
-				Reserve(m_Size + 1);
+			const size_t size = Size();
+			assert(index <= size);
+			if (size == Capacity())
+				Reserve(CalculateGrowth(size + 1));
 
-			for (size_t i = m_Size; i > index; --i)
-				m_pBuffer[i] = m_pBuffer[i - 1];
-			m_pBuffer[index] = value;
-			++m_Size;
-			m_pBuffer[m_Size] = '\0';
+			char* pBuffer = Data();
+			for (size_t i = size; i > index; --i)
+				pBuffer[i] = pBuffer[i - 1];
+			pBuffer[index] = value;
+			SetSize(size + 1);
 		}
 
 		void Insert(const size_t index, const char* pData)
 		{
-			size_t len = StrLen(pData);
-			assert(index <= m_Size);
-			if (m_Size == m_Capacity)
-				Reserve(m_Size + len);
+			const size_t len = StrLen(pData);
+			const size_t size = Size();
+			assert(index <= size);
+			if (size + len > Capacity())
+			{
+				//The data can be a part of this string, it is copied before the old buffer is freed
+				const size_t capacity = CalculateGrowth(size + len);
+				char* pNewBuffer = AllocateBuffer(capacity, GetResource());
+				memcpy(pNewBuffer, Data(), index);
+				memcpy(pNewBuffer + index, pData, len);
+				memcpy(pNewBuffer + index + len, Data() + index, size - index);
+				SetHeapBuffer(pNewBuffer, size + len, capacity);
+				return;
+			}
 
-			for (size_t i = m_Size + len; i > index; --i)
-				m_pBuffer[i] = m_pBuffer[i - len];
-			memcpy(m_pBuffer + index, pData, len);
-			m_Size += len;
+			char* pBuffer = Data();
+			memmove(pBuffer + index + len, pBuffer + index, size - index);
+			if (pData >= pBuffer && pData < pBuffer + size)
+			{
+				//The data is a part of this string, the characters of it from the index on have moved up by len
+				const size_t before = pData < pBuffer + index ? Min((size_t)(pBuffer + index - pData), len) : 0;
+				memcpy(pBuffer + index, pData, before);
+				memcpy(pBuffer + index + before, pData + before + len, len - before);
+			}
+			else
+			{
+				memcpy(pBuffer + index, pData, len);
+			}
+			SetSize(size + len);
 		}
 
-		void Append(const char* pData)
+		//Appends reuse the spare capacity and grow the buffer geometrically, building a string from many appends is
+		//amortized O(1) per character. A String doubles as a builder with the number, character run and formatted appends.
+		String& Append(const char* pData)
 		{
 			if (pData)
+				Append(pData, StrLen(pData));
+			return *this;
+		}
+
+		String& Append(const char* pData, const size_t dataSize)
+		{
+			const size_t size = Size();
+			if (size + dataSize > Capacity())
 			{
-				const size_t dataSize = StrLen(pData);
-				char* pNewBuffer = new char[m_Size + dataSize + 1];
-				memcpy(pNewBuffer + m_Size, pData, dataSize);
-				if (m_pBuffer)
-				{
-					memcpy(pNewBuffer, m_pBuffer, m_Size);
-					delete[] m_pBuffer;
-				}
-				m_Size += dataSize;
-				m_Capacity = m_Size;
-				m_pBuffer = pNewBuffer;
-				m_pBuffer[m_Size] = '\0';
+				//The data can be a part of this string, it is copied before the old buffer is freed
+				const size_t capacity = CalculateGrowth(size + dataSize);
+				char* pNewBuffer = AllocateBuffer(capacity, GetResource());
+				memcpy(pNewBuffer, Data(), size);
+				memcpy(pNewBuffer + size, pData, dataSize);
+				SetHeapBuffer(pNewBuffer, size + dataSize, capacity);
+				return *this;
 			}
+			memmove(Data() + size, pData, dataSize);
+			SetSize(size + dataSize);
+			return *this;
+		}
+
+		String& Append(const StringView& view)
+		{
+			return Append(view.Data(), view.Size());
 		}
 
-		void Append(const wchar_t* pData)
+		String& Append(const wchar_t* pData)
 		{
 			const size_t dataSize = StrLen(pData);
-			char* pNewBuffer = new char[m_Size + dataSize + 1];
+			const size_t size = Size();
+			if (size + dataSize > Capacity())
+				Reallocate(CalculateGrowth(size + dataSize), size);
+			char* pBuffer = Data();
 			for (size_t i = 0; i < dataSize; ++i)
 			{
-				pNewBuffer[i + m_Size] = (char)pData[i];
+				pBuffer[i + size] = (char)pData[i];
 			}
-			if (m_pBuffer)
+			SetSize(size + dataSize);
+			return *this;
+		}
+
+		String& Append(const char value)
+		{
+			Push(value);
+			return *this;
+		}
+
+		//Appends a run of the same character
+		String& Append(const size_t count, const char value)
+		{
+			const size_t size = Size();
+			if (size + count > Capacity())
+				Reallocate(CalculateGrowth(size + count), size);
+			memset(Data() + size, value, count);
+			SetSize(size + count);
+			return *this;
+		}
+
+		String& AppendNumber(const int value) { return AppendNumber((long long)value); }
+		String& AppendNumber(const unsigned int value) { return AppendInteger(value, false); }
+		String& AppendNumber(const long value) { return AppendNumber((long long)value); }
+		String& AppendNumber(const unsigned long value) { return AppendInteger(value, false); }
+		//Negated as unsigned, the lowest value has no positive counterpart
+		String& AppendNumber(const long long value) { return AppendInteger(value < 0 ? 0ull - (unsigned long long)value : (unsigned long long)value, value < 0); }
+		String& AppendNumber(const unsigned long long value) { return AppendInteger(value, false); }
+		String& AppendNumber(const double value, const int precision = 6) { return AppendFormat("%.*f", precision, value); }
+
+		//Appends printf formatted text, it is printed in the spare capacity directly when it fits
+		template<typename ...Args>
+		String& AppendFormat(const char* format, Args... args)
+		{
+			const size_t size = Size();
+			const size_t spare = Capacity() - size;
+			//The null terminator of a full local buffer ends up in its last byte, where it belongs
+			const int length = std::snprintf(Data() + size, spare + 1, format, args...);
+			assert(length >= 0);
+			if ((size_t)length > spare)
 			{
-				memcpy(pNewBuffer, m_pBuffer, m_Size);
-				delete[] m_pBuffer;
+				Reallocate(CalculateGrowth(size + length), size);
+				std::snprintf(Data() + size, (size_t)length + 1, format, args...);
 			}
-			m_Size += dataSize;
-			m_Capacity = m_Size;
-			m_pBuffer = pNewBuffer;
-			m_pBuffer[m_Size] = '\0';
+			SetSize(size + length);
+			return *this;
+		}
+
+		//View on the characters of the string, it is invalidated when the string is changed
+		StringView View() const
+		{
+			return StringView(Data(), Size());
 		}
 
-		String Substring(const unsigned int from, const size_t length = String::Npos)
+		//Substring without copy, the length is clamped to the end of the string
+		StringView SubView(const size_t from, const size_t length = String::Npos) const
 		{
+			return View().Substring(from, length);
+		}
+
+		String Substring(const unsigned int from, const size_t length = String::Npos) const
+		{
+			const char* pBuffer = Data();
 			if (length == String::Npos)
 			{
-				assert(from <= m_Size);
-				return String(m_pBuffer + from, m_pBuffer + m_Size);
+				assert(from <= Size());
+				return String(pBuffer + from, pBuffer + Size());
 			}
 			else
 			{
-				assert(length + from <= m_Size);
-				return String(m_pBuffer + from, m_pBuffer + from + length);
+				assert(length + from <= Size());
+				return String(pBuffer + from, pBuffer + from + length);
 			}
 		}
 
 		size_t Find(const char c) const
 		{
-			if (m_Size > 0)
-			{
-				for (size_t i = 0; i < m_Size; ++i)
-				{
-					if (m_pBuffer[i] == c)
-						return i;
-				}
-			}
-			return String::Npos;
+			return StrFindChar(Data(), Size(), c);
 		}
 
 		size_t RFind(const char c) const
 		{
-			if (m_Size > 0)
-			{
-				for (size_t i = m_Size - 1; i != String::Npos; --i)
-				{
-					if (m_pBuffer[i] == c)
-						return i;
-				}
-			}
-			return String::Npos;
+			return StrRFindChar(Data(), Size(), c);
 		}
 
 		size_t Find(const wchar_t c) const
 		{
-			if (m_Size > 0)
-			{
-				for (size_t i = 0; i < m_Size; ++i)
-				{
-					if (m_pBuffer[i] == (char)c)
-						return i;
-				}
-			}
-			return String::Npos;
+			return Find((char)c);
 		}
 
 		size_t RFind(const wchar_t c) const
 		{
-			if (m_Size > 0)
-			{
-				for (size_t i = m_Size - 1; i != String::Npos; --i)
-				{
-					if (m_pBuffer[i] == (char)c)
-						return i;
-				}
-			}
-			return String::Npos;
+			return RFind((char)c);
 		}
 
 		size_t Find(const String& str) const
 		{
-			return Find(str.Data());
+			return Find(str.Data(), str.Size());
 		}
 
 		size_t RFind(const String& str) const
 		{
-			return RFind(str.Data());
+			return RFind(str.Data(), str.Size());
 		}
 
 		size_t Find(const char* c) const
 		{
-			if (m_Size == 0)
-				return String::Npos;
+			return Find(c, StrLen(c));
+		}
 
-			size_t len = StrLen(c);
-			if (len == 0)
-				return String::Npos;
+		size_t Find(const StringView& view) const
+		{
+			return Find(view.Data(), view.Size());
+		}
 
-			for (size_t i = 0; i < m_Size - len; ++i)
-			{
-				if (m_pBuffer[i] == c[0])
-				{
-					bool match = true;
-					for (size_t j = 1; j < len; ++j)
-					{
-						if (m_pBuffer[i + j] != c[j])
-						{
-							match = false;
-							break;
-						}
-					}
-					if (match)
-						return (int)i;
-				}
-			}
-			return String::Npos;
+		size_t RFind(const StringView& view) const
+		{
+			return RFind(view.Data(), view.Size());
 		}
 
 		size_t RFind(const char* c) const
 		{
-			if (m_Size == 0)
-				return String::Npos;
+			return RFind(c, StrLen(c));
+		}
 
-			size_t len = StrLen(c);
-			if (len == 0)
-				return String::Npos;
+		//An empty string is never found
+		size_t Find(const char* pData, const size_t dataSize) const
+		{
+			return dataSize == 0 ? String::Npos : StrFind(Data(), Size(), pData, dataSize);
+		}
 
-			for (size_t i = m_Size - 1; i >= len - 1; --i)
-			{
-				if (m_pBuffer[i] == c[len - 1])
-				{
-					bool match = true;
-					for (int j = (int)len - 1; j >= 0; --j)
-					{
-						if (m_pBuffer[i - len + j + 1] != c[j])
-						{
-							match = false;
-							break;
-						}
-					}
-					if (match)
-						return i - len + 1;
-				}
-			}
-			return String::Npos;
+		size_t RFind(const char* pData, const size_t dataSize) const
+		{
+			return dataSize == 0 ? String::Npos : StrRFind(Data(), Size(), pData, dataSize);
 		}
 
 		size_t GetHash() const
 		{
-			return FNV1aHash(m_pBuffer, m_Size);
+			return FNV1aHash(Data(), Size());
 		}
+		//Transparent, a const char* or a StringView hashes the same as a String with the same characters
 		struct Hash
 		{
+			using IsTransparent = void;
 			size_t operator()(const String& other) const { return other.GetHash(); }
+			size_t operator()(const StringView& view) const { return view.GetHash(); }
+			size_t operator()(const char* pData) const { return FNV1aHash(pData, StrLen(pData)); }
 		};
 
 		template<typename ...Args>
 		static String Printf(const char* format, Args... args)
 		{
-			auto size = std::snprintf(nullptr, 0, format, args...);
-			String output(size + 1, '\0');
-			sprintf_s(&output[0], output.Size(), format, args...);
-			return Move(output);
+			String output;
+			output.AppendFormat(format, args...);
+			return output;
 		}
 
 		friend std::ostream& operator<<(std::ostream& os, const String& string)
@@ -511,44 +559,171 @@ namespace StlStd
 			return os;
 		}
 
-		const char* C_Str() const { return m_pBuffer; }
-		const char* Data() const { return m_pBuffer; }
-		char* Data() { return m_pBuffer; }
+		const char* C_Str() const { return Data(); }
+		const char* Data() const { return IsLarge() ? m_Heap.pBuffer : m_Local; }
+		char* Data() { return IsLarge() ? m_Heap.pBuffer : m_Local; }
 
-		operator bool() const { return m_Size > 0; }
-		bool Empty() const { return m_Size == 0; }
-		size_t Size() const { return m_Size; }
-		size_t Length() const { return m_pBuffer ? StrLen(m_pBuffer) : 0; }
-		size_t Capacity() const { return m_Capacity; }
+		operator bool() const { return Size() > 0; }
+		bool Empty() const { return Size() == 0; }
+		size_t Size() const { return IsLarge() ? m_Heap.Size : LOCAL_CAPACITY - (size_t)m_Local[LOCAL_CAPACITY]; }
+		size_t Length() const { return Size(); }
+		size_t Capacity() const { return IsLarge() ? m_Heap.Capacity & ~LARGE_FLAG : LOCAL_CAPACITY; }
 
-		char& Front() { assert(m_pBuffer); return *m_pBuffer; }
-		const char& Front() const { assert(m_pBuffer); return *m_pBuffer; }
-		char& Back() { assert(m_Size > 0); return *(m_pBuffer + m_Size - 1); }
-		const char& Back() const { assert(m_Size > 0); return *(m_pBuffer + m_Size - 1); }
+		//Whether the characters are on the heap, short strings are stored in the object
+		bool IsLarge() const { return (m_Local[LOCAL_CAPACITY] & 0x80) != 0; }
+
+		//The resource the heap buffer came from, the default resource for a local string
+		MemoryResource* GetResource() const
+		{
+			return IsLarge() ? *reinterpret_cast<MemoryResource* const*>(m_Heap.pBuffer - sizeof(MemoryResource*)) : GetDefaultResource();
+		}
+
+		char& Front() { assert(Size() > 0); return *Data(); }
+		const char& Front() const { assert(Size() > 0); return *Data(); }
+		char& Back() { assert(Size() > 0); return *(Data() + Size() - 1); }
+		const char& Back() const { assert(Size() > 0); return *(Data() + Size() - 1); }
 		
-		Iterator begin() { return Iterator(m_pBuffer); }
-		Iterator end() { return Iterator(m_pBuffer + m_Size); }
-		ConstIterator begin() const { return ConstIterator(m_pBuffer); }
-		ConstIterator end() const { return ConstIterator(m_pBuffer + m_Size); }
-
-		Iterator Begin() { return Iterator(m_pBuffer); }
-		Iterator End() { return Iterator(m_pBuffer + m_Size); }
-		ConstIterator Begin() const { return ConstIterator(m_pBuffer); }
-		ConstIterator End() const { return ConstIterator(m_pBuffer + m_Size); }
+		Iterator begin() { return Iterator(Data()); }
+		Iterator end() { return Iterator(Data() + Size()); }
+		ConstIterator begin() const { return ConstIterator(Data()); }
+		ConstIterator end() const { return ConstIterator(Data() + Size()); }
+
+		Iterator Begin() { return Iterator(Data()); }
+		Iterator End() { return Iterator(Data() + Size()); }
+		ConstIterator Begin() const { return ConstIterator(Data()); }
+		ConstIterator End() const { return ConstIterator(Data() + Size()); }
 		
 		constexpr static size_t MaxSize() { return Npos; }
 		static const size_t Npos = ~(size_t)0;
 
 	private:
-		size_t CalculateGrowth(const size_t oldSize)
+		//Grow by half of the capacity, or to the size that is needed when that is more
+		size_t CalculateGrowth(const size_t minCapacity) const
 		{
-			size_t newSize = (size_t)floor(oldSize * 1.5);
-			return newSize == m_Capacity ? newSize + 1 : newSize;
+			const size_t capacity = Capacity();
+			const size_t growth = capacity + (capacity >> 1);
+			return growth < minCapacity ? minCapacity : growth;
 		}
 
-		char* m_pBuffer;
-		size_t m_Size;
-		size_t m_Capacity;
+		String& AppendInteger(unsigned long long value, const bool negative)
+		{
+			//Enough for the 20 digits of the highest value and a sign
+			char digits[21];
+			char* pEnd = digits + sizeof(digits);
+			char* pDigit = pEnd;
+			do
+			{
+				*--pDigit = (char)('0' + value % 10);
+				value /= 10;
+			} while (value != 0);
+			if (negative)
+				*--pDigit = '-';
+			return Append(pDigit, (size_t)(pEnd - pDigit));
+		}
+
+		void InitializeLocal()
+		{
+			m_Local[0] = '\0';
+			m_Local[LOCAL_CAPACITY] = (char)LOCAL_CAPACITY;
+		}
+
+		//Start with the given size and a capacity that fits it, the characters aren't set
+		void Initialize(const size_t size, MemoryResource* pResource = GetDefaultResource())
+		{
+			if (size <= LOCAL_CAPACITY && pResource == GetDefaultResource())
+			{
+				m_Local[LOCAL_CAPACITY] = (char)(LOCAL_CAPACITY - size);
+				m_Local[size] = '\0';
+			}
+			else
+			{
+				m_Heap.pBuffer = AllocateBuffer(size, pResource);
+				m_Heap.Size = size;
+				m_Heap.Capacity = size | LARGE_FLAG;
+				m_Heap.pBuffer[size] = '\0';
+			}
+		}
+
+		//Sets the size and the null terminator, in the local layout the size is stored as the amount of characters left.
+		//A full local buffer stores 0, which doubles as its null terminator.
+		void SetSize(const size_t size)
+		{
+			if (IsLarge())
+			{
+				m_Heap.Size = size;
+				m_Heap.pBuffer[size] = '\0';
+			}
+			else
+			{
+				m_Local[LOCAL_CAPACITY] = (char)(LOCAL_CAPACITY - size);
+				m_Local[size] = '\0';
+			}
+		}
+
+		//Move the first characters to a buffer with the given capacity, the local buffer when they fit.
+		//The size is set to the amount of characters that is kept.
+		void Reallocate(const size_t capacity, const size_t keep)
+		{
+			assert(keep <= capacity);
+			MemoryResource* pResource = GetResource();
+			if (capacity <= LOCAL_CAPACITY && pResource == GetDefaultResource())
+			{
+				if (IsLarge())
+				{
+					char* pBuffer = m_Heap.pBuffer;
+					const size_t oldCapacity = Capacity();
+					memcpy(m_Local, pBuffer, keep);
+					DeallocateBuffer(pBuffer, oldCapacity);
+					m_Local[LOCAL_CAPACITY] = (char)LOCAL_CAPACITY;
+				}
+				SetSize(keep);
+				return;
+			}
+			char* pNewBuffer = AllocateBuffer(capacity, pResource);
+			memcpy(pNewBuffer, Data(), keep);
+			SetHeapBuffer(pNewBuffer, keep, capacity);
+		}
+
+		//Takes over the buffer, which holds capacity + 1 characters
+		void SetHeapBuffer(char* pBuffer, const size_t size, const size_t capacity)
+		{
+			FreeBuffer();
+			m_Heap.pBuffer = pBuffer;
+			m_Heap.Size = size;
+			m_Heap.Capacity = capacity | LARGE_FLAG;
+			pBuffer[size] = '\0';
+		}
+
+		void FreeBuffer()
+		{
+			if (IsLarge())
+				DeallocateBuffer(m_Heap.pBuffer, Capacity());
+		}
+
+		//Room for capacity characters and the null terminator, after the resource
+		static char* AllocateBuffer(const size_t capacity, MemoryResource* pResource)
+		{
+			void* pMemory = pResource->Allocate(sizeof(MemoryResource*) + capacity + 1, alignof(MemoryResource*));
+			*static_cast<MemoryResource**>(pMemory) = pResource;
+			return static_cast<char*>(pMemory) + sizeof(MemoryResource*);
+		}
+
+		static void DeallocateBuffer(char* pBuffer, const size_t capacity)
+		{
+			char* pMemory = pBuffer - sizeof(MemoryResource*);
+			MemoryResource* pResource = *reinterpret_cast<MemoryResource**>(pMemory);
+			pResource->Deallocate(pMemory, sizeof(MemoryResource*) + capacity + 1, alignof(MemoryResource*));
+		}
+
+		//Set in the capacity of the heap layout, it ends up in the last byte of the object on little endian platforms
+		static const size_t LARGE_FLAG = (size_t)1 << (sizeof(size_t) * 8 - 1);
+
+		union
+		{
+			HeapData m_Heap;
+			//Local layout: the characters, and the amount of characters left in the last byte
+			char m_Local[sizeof(HeapData)];
+		};
 	};
 
 	template<>
@@ -556,4 +731,12 @@ namespace StlStd
 	{
 		a.Swap(b);
 	}
+
+	inline bool operator==(const char* pData, const String& string) { return string == pData; }
+	inline bool operator!=(const char* pData, const String& string) { return string != pData; }
+	inline bool operator<(const char* pData, const String& string) { return StrCompare(pData, StrLen(pData), string.Data(), string.Size()) < 0; }
+
+	inline bool operator==(const StringView& view, const String& string) { return string == view; }
+	inline bool operator!=(const StringView& view, const String& string) { return string != view; }
+	inline bool operator<(const StringView& view, const String& string) { return StrCompare(view.Data(), view.Size(), string.Data(), string.Size()) < 0; }
 }
\ No newline at end of file
@@ -0,0 +1,218 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include "Simd.h"
+
+//Search engine behind String and StringView, the searches work on character ranges and return STR_NPOS when nothing is found.
+//Single characters are compared 16 at a time.
+//Needles use a first and last character filter: 16 positions are tested at once and only the positions where both
+//the first and the last character of the needle match are compared in full, which rejects almost every position in text.
+//When the filter lets too many positions through, long needles switch to Boyer-Moore-Horspool for the rest of the data,
+//a mismatch then skips up to the length of the needle.
+namespace StlStd
+{
+	static const size_t STR_NPOS = ~(size_t)0;
+	//Needles from this length can switch to Boyer-Moore-Horspool
+	static const size_t STR_LONG_NEEDLE = 32;
+
+	inline size_t StrFindChar(const char* pData, const size_t size, const char c)
+	{
+		size_t i = 0;
+#ifdef STLSTD_SSE2
+		const __m128i pattern = _mm_set1_epi8(c);
+		for (; i + 16 <= size; i += 16)
+		{
+			const __m128i block = _mm_loadu_si128((const __m128i*)(pData + i));
+			const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+			if (mask != 0)
+				return i + CountTrailingZeros(mask);
+		}
+#endif
+		for (; i < size; ++i)
+		{
+			if (pData[i] == c)
+				return i;
+		}
+		return STR_NPOS;
+	}
+
+	inline size_t StrRFindChar(const char* pData, size_t size, const char c)
+	{
+#ifdef STLSTD_SSE2
+		const __m128i pattern = _mm_set1_epi8(c);
+		for (; size >= 16; size -= 16)
+		{
+			const __m128i block = _mm_loadu_si128((const __m128i*)(pData + size - 16));
+			const uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, pattern));
+			if (mask != 0)
+				return size - 16 + BitScanReverse(mask);
+		}
+#endif
+		while (size > 0)
+		{
+			--size;
+			if (pData[size] == c)
+				return size;
+		}
+		return STR_NPOS;
+	}
+
+	//Needle of at least 2 characters
+	inline size_t StrFindHorspool(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		if (needleSize > size)
+			return STR_NPOS;
+
+		//Shift of the window for the character under its last position
+		size_t skip[256];
+		for (size_t i = 0; i < 256; ++i)
+			skip[i] = needleSize;
+		for (size_t i = 0; i < needleSize - 1; ++i)
+			skip[(unsigned char)pNeedle[i]] = needleSize - 1 - i;
+
+		const char last = pNeedle[needleSize - 1];
+		for (size_t i = 0; i <= size - needleSize; i += skip[(unsigned char)pData[i + needleSize - 1]])
+		{
+			if (pData[i + needleSize - 1] == last && memcmp(pData + i, pNeedle, needleSize - 1) == 0)
+				return i;
+		}
+		return STR_NPOS;
+	}
+
+	//Needle of at least 2 characters
+	inline size_t StrRFindHorspool(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		if (needleSize > size)
+			return STR_NPOS;
+
+		//Shift of the window for the character under its first position
+		size_t skip[256];
+		for (size_t i = 0; i < 256; ++i)
+			skip[i] = needleSize;
+		for (size_t i = needleSize - 1; i > 0; --i)
+			skip[(unsigned char)pNeedle[i]] = i;
+
+		const char first = pNeedle[0];
+		size_t i = size - needleSize;
+		for (;;)
+		{
+			if (pData[i] == first && memcmp(pData + i + 1, pNeedle + 1, needleSize - 1) == 0)
+				return i;
+			const size_t shift = skip[(unsigned char)pData[i]];
+			if (i < shift)
+				return STR_NPOS;
+			i -= shift;
+		}
+	}
+
+	//More than one full compare every 8 positions, a 16 positions head start covers the matches close to the start
+	inline bool StrFilterSaturated(const size_t needleSize, const size_t candidates, const size_t positions)
+	{
+		return needleSize >= STR_LONG_NEEDLE && candidates > (positions >> 3) + 16;
+	}
+
+	//Needle of at least 2 characters, not longer than the data
+	inline size_t StrFindFiltered(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		const size_t lastStart = size - needleSize;
+		const char first = pNeedle[0];
+		const char last = pNeedle[needleSize - 1];
+		size_t i = 0;
+#ifdef STLSTD_SSE2
+		const __m128i firstPattern = _mm_set1_epi8(first);
+		const __m128i lastPattern = _mm_set1_epi8(last);
+		size_t candidates = 0;
+		//The blocks test the starts i to i + 15, the last block reads up to the last character of the data
+		for (; i + 15 <= lastStart; i += 16)
+		{
+			if (StrFilterSaturated(needleSize, candidates, i))
+			{
+				const size_t found = StrFindHorspool(pData + i, size - i, pNeedle, needleSize);
+				return found == STR_NPOS ? STR_NPOS : i + found;
+			}
+
+			const __m128i firstBlock = _mm_loadu_si128((const __m128i*)(pData + i));
+			const __m128i lastBlock = _mm_loadu_si128((const __m128i*)(pData + i + needleSize - 1));
+			uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstPattern), _mm_cmpeq_epi8(lastBlock, lastPattern)));
+			while (mask != 0)
+			{
+				const size_t start = i + CountTrailingZeros(mask);
+				++candidates;
+				if (memcmp(pData + start + 1, pNeedle + 1, needleSize - 2) == 0)
+					return start;
+				mask &= mask - 1;
+			}
+		}
+#endif
+		for (; i <= lastStart; ++i)
+		{
+			if (pData[i] == first && pData[i + needleSize - 1] == last && memcmp(pData + i + 1, pNeedle + 1, needleSize - 2) == 0)
+				return i;
+		}
+		return STR_NPOS;
+	}
+
+	//Needle of at least 2 characters, not longer than the data
+	inline size_t StrRFindFiltered(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		//Number of starts left to test, from the back
+		size_t starts = size - needleSize + 1;
+		const char first = pNeedle[0];
+		const char last = pNeedle[needleSize - 1];
+#ifdef STLSTD_SSE2
+		const __m128i firstPattern = _mm_set1_epi8(first);
+		const __m128i lastPattern = _mm_set1_epi8(last);
+		size_t candidates = 0;
+		for (; starts >= 16; starts -= 16)
+		{
+			//The starts left are the beginning of the data up to the last start plus the needle
+			if (StrFilterSaturated(needleSize, candidates, size - needleSize + 1 - starts))
+				return StrRFindHorspool(pData, starts - 1 + needleSize, pNeedle, needleSize);
+
+			const size_t i = starts - 16;
+			const __m128i firstBlock = _mm_loadu_si128((const __m128i*)(pData + i));
+			const __m128i lastBlock = _mm_loadu_si128((const __m128i*)(pData + i + needleSize - 1));
+			uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(firstBlock, firstPattern), _mm_cmpeq_epi8(lastBlock, lastPattern)));
+			while (mask != 0)
+			{
+				const uint32_t bit = BitScanReverse(mask);
+				++candidates;
+				if (memcmp(pData + i + bit + 1, pNeedle + 1, needleSize - 2) == 0)
+					return i + bit;
+				mask &= ~(1u << bit);
+			}
+		}
+#endif
+		while (starts > 0)
+		{
+			const size_t i = --starts;
+			if (pData[i] == first && pData[i + needleSize - 1] == last && memcmp(pData + i + 1, pNeedle + 1, needleSize - 2) == 0)
+				return i;
+		}
+		return STR_NPOS;
+	}
+
+	//First position of the needle in the data, an empty needle is found at 0
+	inline size_t StrFind(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		if (needleSize == 0)
+			return 0;
+		if (needleSize > size)
+			return STR_NPOS;
+		if (needleSize == 1)
+			return StrFindChar(pData, size, pNeedle[0]);
+		return StrFindFiltered(pData, size, pNeedle, needleSize);
+	}
+
+	//Last position of the needle in the data, an empty needle is found at the end
+	inline size_t StrRFind(const char* pData, const size_t size, const char* pNeedle, const size_t needleSize)
+	{
+		if (needleSize == 0)
+			return size;
+		if (needleSize > size)
+			return STR_NPOS;
+		if (needleSize == 1)
+			return StrRFindChar(pData, size, pNeedle[0]);
+		return StrRFindFiltered(pData, size, pNeedle, needleSize);
+	}
+}
@@ -0,0 +1,204 @@
+#pragma once
+#include <assert.h>
+#include <stdint.h>
+#include <string.h>
+#include "Hash.h"
+#include "Simd.h"
+#include "StringSearch.h"
+#include "Vector.h"
+
+namespace StlStd
+{
+	STLSTD_NO_SANITIZE_ADDRESS inline size_t StrLen(const char* pData)
+	{
+#ifdef STLSTD_SSE2
+		//Looks for the terminator 16 characters at a time, the loads are aligned so they never cross into the next page
+		const char* pBlock = (const char*)((uintptr_t)pData & ~(uintptr_t)15);
+		const __m128i zero = _mm_setzero_si128();
+		//The characters before the start in the first block are shifted out
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)pBlock), zero)) >> (pData - pBlock);
+		if (mask != 0)
+			return CountTrailingZeros(mask);
+		for (;;)
+		{
+			pBlock += 16;
+			mask = (uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_load_si128((const __m128i*)pBlock), zero));
+			if (mask != 0)
+				return (size_t)(pBlock - pData) + CountTrailingZeros(mask);
+		}
+#else
+		const char* pCurrent = pData;
+		for (; *pCurrent; ++pCurrent)
+		{
+		}
+		return pCurrent - pData;
+#endif
+	}
+
+	inline size_t StrLen(const wchar_t* pData)
+	{
+		const wchar_t* pCurrent = pData;
+		for (; *pCurrent; ++pCurrent)
+		{
+		}
+		return pCurrent - pData;
+	}
+
+	//Equality of two character ranges of the same size
+	inline bool StrEqual(const char* pA, const char* pB, const size_t size)
+	{
+		return size == 0 || memcmp(pA, pB, size) == 0;
+	}
+
+	//Lexicographical compare of two character ranges, < 0 when a comes first, 0 when equal, > 0 when b comes first
+	inline int StrCompare(const char* pA, const size_t aSize, const char* pB, const size_t bSize)
+	{
+		const size_t size = aSize < bSize ? aSize : bSize;
+		const int result = size > 0 ? memcmp(pA, pB, size) : 0;
+		if (result != 0)
+			return result;
+		return aSize < bSize ? -1 : (aSize > bSize ? 1 : 0);
+	}
+
+	//Non-owning view on a range of characters, it is not null terminated.
+	//The characters have to outlive the view.
+	class StringView
+	{
+	public:
+		StringView() :
+			m_pData(nullptr), m_Size(0)
+		{}
+
+		StringView(const char* pData) :
+			m_pData(pData), m_Size(pData ? StrLen(pData) : 0)
+		{}
+
+		StringView(const char* pData, const size_t size) :
+			m_pData(pData), m_Size(size)
+		{}
+
+		bool operator==(const StringView& other) const
+		{
+			return m_Size == other.m_Size && StrEqual(m_pData, other.m_pData, m_Size);
+		}
+
+		bool operator!=(const StringView& other) const
+		{
+			return !operator==(other);
+		}
+
+		//The character arrays would be ambiguous between a StringView and a String
+		bool operator==(const char* pData) const { return operator==(StringView(pData)); }
+		bool operator!=(const char* pData) const { return !operator==(StringView(pData)); }
+		bool operator<(const char* pData) const { return Compare(StringView(pData)) < 0; }
+
+		bool operator<(const StringView& other) const { return Compare(other) < 0; }
+		bool operator<=(const StringView& other) const { return Compare(other) <= 0; }
+		bool operator>(const StringView& other) const { return Compare(other) > 0; }
+		bool operator>=(const StringView& other) const { return Compare(other) >= 0; }
+
+		//< 0 when this view comes first, 0 when equal, > 0 when the other view comes first
+		int Compare(const StringView& other) const
+		{
+			return StrCompare(m_pData, m_Size, other.m_pData, other.m_Size);
+		}
+
+		const char& operator[](const size_t index) const { assert(index < m_Size); return m_pData[index]; }
+
+		size_t Find(const char c) const
+		{
+			return StrFindChar(m_pData, m_Size, c);
+		}
+
+		size_t RFind(const char c) const
+		{
+			return StrRFindChar(m_pData, m_Size, c);
+		}
+
+		//An empty view is never found, like in a String
+		size_t Find(const StringView& view) const
+		{
+			return view.m_Size == 0 ? Npos : StrFind(m_pData, m_Size, view.m_pData, view.m_Size);
+		}
+
+		size_t RFind(const StringView& view) const
+		{
+			return view.m_Size == 0 ? Npos : StrRFind(m_pData, m_Size, view.m_pData, view.m_Size);
+		}
+
+		bool StartsWith(const StringView& view) const
+		{
+			return view.m_Size <= m_Size && StrEqual(m_pData, view.m_pData, view.m_Size);
+		}
+
+		bool EndsWith(const StringView& view) const
+		{
+			return view.m_Size <= m_Size && StrEqual(m_pData + m_Size - view.m_Size, view.m_pData, view.m_Size);
+		}
+
+		//View on the same characters, the length is clamped to the end of the view
+		StringView Substring(const size_t from, const size_t length = Npos) const
+		{
+			assert(from <= m_Size);
+			const size_t rest = m_Size - from;
+			return StringView(m_pData + from, length < rest ? length : rest);
+		}
+
+		//The parts between the delimiters, empty parts are kept. The parts are views on the same characters.
+		Vector<StringView> Split(const char delimiter) const
+		{
+			return Split(StringView(&delimiter, 1));
+		}
+
+		Vector<StringView> Split(const StringView& delimiter) const
+		{
+			assert(!delimiter.Empty());
+			Vector<StringView> parts;
+			size_t from = 0;
+			for (;;)
+			{
+				const StringView rest = Substring(from);
+				const size_t found = rest.Find(delimiter);
+				if (found == Npos)
+				{
+					parts.Push(rest);
+					return parts;
+				}
+				parts.Push(rest.Substring(0, found));
+				from += found + delimiter.m_Size;
+			}
+		}
+
+		//Same hash as a String with the same characters
+		size_t GetHash() const
+		{
+			return FNV1aHash(m_pData, m_Size);
+		}
+		struct Hash
+		{
+			size_t operator()(const StringView& view) const { return view.GetHash(); }
+		};
+
+		const char* Data() const { return m_pData; }
+		bool Empty() const { return m_Size == 0; }
+		size_t Size() const { return m_Size; }
+		size_t Length() const { return m_Size; }
+
+		const char& Front() const { assert(m_Size > 0); return *m_pData; }
+		const char& Back() const { assert(m_Size > 0); return m_pData[m_Size - 1]; }
+
+		const char* Begin() const { return m_pData; }
+		const char* End() const { return m_pData + m_Size; }
+		const char* begin() const { return m_pData; }
+		const char* end() const { return m_pData + m_Size; }
+
+		static const size_t Npos = STR_NPOS;
+
+	private:
+		const char* m_pData;
+		size_t m_Size;
+	};
+
+	inline bool operator==(const char* pData, const StringView& view) { return view == pData; }
+	inline bool operator!=(const char* pData, const StringView& view) { return view != pData; }
+}
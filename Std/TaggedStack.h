@@ -0,0 +1,95 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+
+namespace StlStd
+{
+	//Lock-free stack of intrusive nodes (Treiber stack), the node type needs an std::atomic<Node*> pNext.
+	//The head pointer carries a tag that counts the changes, a node that is popped and pushed again in between the load
+	//and the compare exchange of another thread changes the tag and makes that exchange fail (the ABA problem).
+	//Pop reads the next pointer of a node that another thread can pop at the same time, so the nodes of the stack must
+	//stay readable as long as the stack is in use, eg. by never giving their memory back while it lives.
+	template<typename Node>
+	class TaggedStack
+	{
+	public:
+		TaggedStack() :
+			m_Head(0)
+		{
+		}
+
+		TaggedStack(const TaggedStack& other) = delete;
+		TaggedStack& operator=(const TaggedStack& other) = delete;
+
+		void Push(Node* pNode)
+		{
+			PushChain(pNode, pNode);
+		}
+
+		//Pushes the nodes from pFirst up to pLast at once, they have to be linked already
+		void PushChain(Node* pFirst, Node* pLast)
+		{
+			uint64_t head = m_Head.load(std::memory_order_relaxed);
+			uint64_t newHead;
+			do
+			{
+				pLast->pNext.store(GetPointer(head), std::memory_order_relaxed);
+				newHead = Pack(pFirst, GetTag(head) + 1);
+			} while (!m_Head.compare_exchange_weak(head, newHead, std::memory_order_release, std::memory_order_relaxed));
+		}
+
+		//Returns nullptr when the stack is empty
+		Node* Pop()
+		{
+			uint64_t head = m_Head.load(std::memory_order_acquire);
+			uint64_t newHead;
+			Node* pNode;
+			do
+			{
+				pNode = GetPointer(head);
+				if (pNode == nullptr)
+					return nullptr;
+				newHead = Pack(pNode->pNext.load(std::memory_order_relaxed), GetTag(head) + 1);
+			} while (!m_Head.compare_exchange_weak(head, newHead, std::memory_order_acquire, std::memory_order_acquire));
+			return pNode;
+		}
+
+		//Takes all the nodes at once, still linked, returns nullptr when the stack is empty
+		Node* PopAll()
+		{
+			uint64_t head = m_Head.load(std::memory_order_relaxed);
+			while (!m_Head.compare_exchange_weak(head, Pack(nullptr, GetTag(head) + 1), std::memory_order_acquire, std::memory_order_relaxed))
+			{
+			}
+			return GetPointer(head);
+		}
+
+		bool Empty() const
+		{
+			return GetPointer(m_Head.load(std::memory_order_relaxed)) == nullptr;
+		}
+
+	private:
+		//64 bit platforms use 48 bits of the address space, the other 16 hold the tag.
+		//32 bit platforms use the upper half of the 64 bit head for the tag.
+		static const uint32_t TAG_SHIFT = sizeof(void*) == 8 ? 48 : 32;
+		static const uint64_t POINTER_MASK = ((uint64_t)1 << TAG_SHIFT) - 1;
+
+		static uint64_t Pack(Node* pNode, const uint64_t tag)
+		{
+			return ((uint64_t)(uintptr_t)pNode & POINTER_MASK) | (tag << TAG_SHIFT);
+		}
+
+		static Node* GetPointer(const uint64_t head)
+		{
+			return reinterpret_cast<Node*>((uintptr_t)(head & POINTER_MASK));
+		}
+
+		static uint64_t GetTag(const uint64_t head)
+		{
+			return head >> TAG_SHIFT;
+		}
+
+		std::atomic<uint64_t> m_Head;
+	};
+}
@@ -0,0 +1,333 @@
+#pragma once
+#include <stddef.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <assert.h>
+#include "SmallObjectPool.h"
+#include "Utility.h"
+
+namespace StlStd
+{
+	//Runs tasks on a fixed set of threads with work stealing. Every thread has a queue of tasks: the tasks a thread
+	//spawns go to the back of its own queue and it takes them from there again (the newest first, their data is still in
+	//its cache). A thread without tasks steals from the front of the other queues, the oldest tasks, which tend to be the
+	//largest pieces of work of a divide and conquer algorithm.
+	//Tasks are grouped in a TaskGroup. A thread that waits for a group runs queued tasks in the meantime, so tasks can
+	//spawn tasks and wait for them without blocking a thread. Threads that aren't part of the scheduler share one queue.
+	class TaskScheduler
+	{
+	public:
+		//0 takes one thread per hardware thread. The thread that waits for a group is one of them, so one thread less
+		//is started.
+		explicit TaskScheduler(size_t threadCount = 0) :
+			m_QueuedCount(0), m_SleepingCount(0), m_Stop(false)
+		{
+			if (threadCount == 0)
+				threadCount = std::thread::hardware_concurrency();
+			m_ThreadCount = threadCount > 0 ? threadCount : 1;
+			m_pQueues = new Queue[m_ThreadCount];
+			m_pThreads = new std::thread[m_ThreadCount - 1];
+			for (size_t i = 1; i < m_ThreadCount; ++i)
+				m_pThreads[i - 1] = std::thread([this, i]() { WorkerLoop(i); });
+		}
+
+		TaskScheduler(const TaskScheduler& other) = delete;
+		TaskScheduler& operator=(const TaskScheduler& other) = delete;
+
+		//All the groups have to be waited for
+		~TaskScheduler()
+		{
+			{
+				std::lock_guard<std::mutex> lock(m_SleepLock);
+				m_Stop = true;
+			}
+			m_WakeUp.notify_all();
+			for (size_t i = 0; i + 1 < m_ThreadCount; ++i)
+				m_pThreads[i].join();
+			delete[] m_pThreads;
+			delete[] m_pQueues;
+		}
+
+		size_t GetThreadCount() const { return m_ThreadCount; }
+
+		//One thread per hardware thread, started on first use and shared by everything that doesn't pass a scheduler
+		static TaskScheduler& GetDefault()
+		{
+			static TaskScheduler scheduler;
+			return scheduler;
+		}
+
+	private:
+		friend class TaskGroup;
+
+		//The functor is stored right behind it, pPending is the counter of its group
+		struct Task
+		{
+			void (*pRun)(Task* pTask);
+			std::atomic<size_t>* pPending;
+		};
+
+		template<typename Functor>
+		struct FunctorTask : Task
+		{
+			FunctorTask(std::atomic<size_t>* pPending, Functor&& function) :
+				Function(Move(function))
+			{
+				this->pRun = &RunFunctor<Functor>;
+				this->pPending = pPending;
+			}
+
+			Functor Function;
+		};
+
+		//Ring buffer of tasks, the owner uses the back and thieves the front. The padding keeps the queues of two
+		//threads off the same cache line.
+		struct Queue
+		{
+			Queue() :
+				pTasks(nullptr), Capacity(0), Head(0), Count(0)
+			{
+			}
+
+			~Queue()
+			{
+				delete[] pTasks;
+			}
+
+			void PushBack(Task* pTask)
+			{
+				if (Count == Capacity)
+				{
+					const size_t newCapacity = Capacity > 0 ? Capacity * 2 : 64;
+					Task** pNewTasks = new Task*[newCapacity];
+					for (size_t i = 0; i < Count; ++i)
+						pNewTasks[i] = pTasks[(Head + i) & (Capacity - 1)];
+					delete[] pTasks;
+					pTasks = pNewTasks;
+					Capacity = newCapacity;
+					Head = 0;
+				}
+				pTasks[(Head + Count) & (Capacity - 1)] = pTask;
+				++Count;
+			}
+
+			Task* PopBack()
+			{
+				if (Count == 0)
+					return nullptr;
+				--Count;
+				return pTasks[(Head + Count) & (Capacity - 1)];
+			}
+
+			Task* PopFront()
+			{
+				if (Count == 0)
+					return nullptr;
+				Task* pTask = pTasks[Head];
+				Head = (Head + 1) & (Capacity - 1);
+				--Count;
+				return pTask;
+			}
+
+			std::mutex Lock;
+			Task** pTasks;
+			size_t Capacity;
+			size_t Head;
+			size_t Count;
+			char Padding[64];
+		};
+
+		//The scheduler the thread works for and the index of its queue
+		struct ThreadState
+		{
+			TaskScheduler* pScheduler;
+			size_t Index;
+		};
+
+		static ThreadState& GetThreadState()
+		{
+			static thread_local ThreadState state = { nullptr, 0 };
+			return state;
+		}
+
+		//The tasks come from the SmallObjectPool, they are allocated and freed on different threads all the time
+		template<typename TaskType>
+		static constexpr bool IsPooled()
+		{
+			return sizeof(TaskType) <= SmallObjectPool::MAX_SIZE && alignof(TaskType) <= SmallObjectPool::ALIGNMENT;
+		}
+
+		template<typename Functor>
+		static Task* NewTask(std::atomic<size_t>* pPending, Functor&& functor)
+		{
+			using TaskType = FunctorTask<Functor>;
+			void* pMemory = IsPooled<TaskType>() ? SmallObjectPool::Allocate(sizeof(TaskType)) : ::operator new(sizeof(TaskType));
+			return new (pMemory) TaskType(pPending, Move(functor));
+		}
+
+		static void FreeTask(void* pMemory, const size_t size, TrueType)
+		{
+			SmallObjectPool::Free(pMemory, size);
+		}
+
+		static void FreeTask(void* pMemory, size_t, FalseType)
+		{
+			::operator delete(pMemory);
+		}
+
+		template<typename Functor>
+		static void RunFunctor(Task* pTask)
+		{
+			using TaskType = FunctorTask<Functor>;
+			TaskType* pFunctorTask = static_cast<TaskType*>(pTask);
+			std::atomic<size_t>* pPending = pFunctorTask->pPending;
+			pFunctorTask->Function();
+			pFunctorTask->~TaskType();
+			FreeTask(pFunctorTask, sizeof(TaskType), BoolConstant<IsPooled<TaskType>()>());
+			//Releases what the task wrote to the thread that waits for the group
+			pPending->fetch_sub(1, std::memory_order_release);
+		}
+
+		//Threads of other schedulers and threads that aren't part of one use the first queue
+		size_t GetQueueIndex() const
+		{
+			const ThreadState& state = GetThreadState();
+			return state.pScheduler == this ? state.Index : 0;
+		}
+
+		void Push(Task* pTask)
+		{
+			//Counted before it is queued, a thread that sees the count and finds no task yet just looks again
+			m_QueuedCount.fetch_add(1);
+			Queue& queue = m_pQueues[GetQueueIndex()];
+			{
+				std::lock_guard<std::mutex> lock(queue.Lock);
+				queue.PushBack(pTask);
+			}
+			if (m_SleepingCount.load() > 0)
+			{
+				std::lock_guard<std::mutex> lock(m_SleepLock);
+				m_WakeUp.notify_one();
+			}
+		}
+
+		//Runs a task of the own queue, or one stolen from another queue. Returns false when there was none.
+		bool TryRunTask(const size_t index)
+		{
+			Task* pTask;
+			{
+				std::lock_guard<std::mutex> lock(m_pQueues[index].Lock);
+				pTask = m_pQueues[index].PopBack();
+			}
+			for (size_t i = 1; pTask == nullptr && i < m_ThreadCount; ++i)
+			{
+				Queue& victim = m_pQueues[(index + i) % m_ThreadCount];
+				std::lock_guard<std::mutex> lock(victim.Lock);
+				pTask = victim.PopFront();
+			}
+			if (pTask == nullptr)
+				return false;
+			m_QueuedCount.fetch_sub(1, std::memory_order_relaxed);
+			pTask->pRun(pTask);
+			return true;
+		}
+
+		void WaitFor(const std::atomic<size_t>& pending)
+		{
+			const size_t index = GetQueueIndex();
+			while (pending.load(std::memory_order_acquire) > 0)
+			{
+				if (!TryRunTask(index))
+					std::this_thread::yield();
+			}
+		}
+
+		void WorkerLoop(const size_t index)
+		{
+			GetThreadState() = { this, index };
+			while (true)
+			{
+				if (TryRunTask(index))
+					continue;
+
+				//Sleep until a task is queued. The sleeping count is raised before the queued count is checked, and
+				//Push checks it after raising the queued count, so one of them sees the other.
+				std::unique_lock<std::mutex> lock(m_SleepLock);
+				m_SleepingCount.fetch_add(1);
+				m_WakeUp.wait(lock, [this]() { return m_Stop || m_QueuedCount.load() > 0; });
+				m_SleepingCount.fetch_sub(1);
+				if (m_Stop)
+					return;
+			}
+		}
+
+		size_t m_ThreadCount;
+		Queue* m_pQueues;
+		std::thread* m_pThreads;
+		std::atomic<size_t> m_QueuedCount;
+		std::atomic<size_t> m_SleepingCount;
+		std::mutex m_SleepLock;
+		std::condition_variable m_WakeUp;
+		bool m_Stop;
+	};
+
+	//Tasks that are waited for together. The functors can run on any thread of the scheduler, including the one that
+	//waits, and can spawn and wait for groups of their own.
+	class TaskGroup
+	{
+	public:
+		explicit TaskGroup(TaskScheduler& scheduler = TaskScheduler::GetDefault()) :
+			m_Scheduler(scheduler), m_Pending(0)
+		{
+		}
+
+		TaskGroup(const TaskGroup& other) = delete;
+		TaskGroup& operator=(const TaskGroup& other) = delete;
+
+		~TaskGroup()
+		{
+			Wait();
+		}
+
+		template<typename Functor>
+		void Run(Functor functor)
+		{
+			m_Pending.fetch_add(1, std::memory_order_relaxed);
+			m_Scheduler.Push(TaskScheduler::NewTask(&m_Pending, Move(functor)));
+		}
+
+		//Runs queued tasks, of this group or any other, until all the tasks of the group are done
+		void Wait()
+		{
+			m_Scheduler.WaitFor(m_Pending);
+		}
+
+		TaskScheduler& GetScheduler() const { return m_Scheduler; }
+
+	private:
+		TaskScheduler& m_Scheduler;
+		std::atomic<size_t> m_Pending;
+	};
+
+	//Calls the functor with (begin, end) for pieces of the range of at most grain indices, in parallel. The range is split
+	//in halves as tasks, so idle threads steal the large halves first.
+	template<typename Functor>
+	void ParallelFor(const size_t begin, const size_t end, const size_t grain, Functor functor, TaskScheduler& scheduler = TaskScheduler::GetDefault())
+	{
+		assert(grain > 0);
+		if (end - begin <= grain || scheduler.GetThreadCount() == 1)
+		{
+			for (size_t pieceBegin = begin; pieceBegin < end; pieceBegin += grain)
+				functor(pieceBegin, end - pieceBegin > grain ? pieceBegin + grain : end);
+			return;
+		}
+		const size_t middle = begin + (end - begin) / 2;
+		TaskGroup group(scheduler);
+		group.Run([middle, end, grain, &functor, &scheduler]() { ParallelFor(middle, end, grain, functor, scheduler); });
+		ParallelFor(begin, middle, grain, functor, scheduler);
+		group.Wait();
+	}
+}
@@ -2,20 +2,6 @@
 
 namespace StlStd
 {
-	template<typename T>
-	inline void Swap(T& first, T& second)
-	{
-		T temp = first;
-		first = second;
-		second = temp;
-	}
-
-	template <class T>
-	inline void IteratorSwap(T pFirst, T pSecond)
-	{
-		Swap(*pFirst, *pSecond);
-	}
-
 	template<class T>
 	struct RemoveReference
 	{
@@ -44,6 +30,21 @@ namespace StlStd
 		return static_cast<typename RemoveReference<T>::Type&&>(arg);
 	}
 
+	//Moves instead of copies when the type can be moved
+	template<typename T>
+	inline void Swap(T& first, T& second)
+	{
+		T temp = Move(first);
+		first = Move(second);
+		second = Move(temp);
+	}
+
+	template <class T>
+	inline void IteratorSwap(T pFirst, T pSecond)
+	{
+		Swap(*pFirst, *pSecond);
+	}
+
 	template <class T>
 	inline T&& Forward(typename RemoveReference<T>::Type& t)
 	{
@@ -56,22 +57,157 @@ namespace StlStd
 		return static_cast<T&&>(t);
 	}
 
-	template<typename T>
+	template<typename T = void>
 	struct LessThan
 	{
 		constexpr bool operator()(const T& a, const T& b) { return a < b; }
 	};
-	template<typename T>
+	template<typename T = void>
 	struct GreaterThan
 	{
 		constexpr bool operator()(const T& a, const T& b) { return a > b; }
 	};
-	template<typename T>
+	template<typename T = void>
 	struct EqualTo
 	{
 		constexpr bool operator()(const T& a, const T& b) { return a == b; }
 	};
 
+	//Transparent versions, they compare any two types that have the operator (eg. String and const char*).
+	//Containers use them to look up a key without converting it to the key type first.
+	template<>
+	struct LessThan<void>
+	{
+		using IsTransparent = void;
+		template<typename A, typename B>
+		constexpr bool operator()(const A& a, const B& b) const { return a < b; }
+	};
+	template<>
+	struct GreaterThan<void>
+	{
+		using IsTransparent = void;
+		template<typename A, typename B>
+		constexpr bool operator()(const A& a, const B& b) const { return a > b; }
+	};
+	template<>
+	struct EqualTo<void>
+	{
+		using IsTransparent = void;
+		template<typename A, typename B>
+		constexpr bool operator()(const A& a, const B& b) const { return a == b; }
+	};
+
+	template<bool Condition, typename T = void>
+	struct EnableIf
+	{
+	};
+	template<typename T>
+	struct EnableIf<true, T>
+	{
+		typedef T Type;
+	};
+	template<bool Condition, typename T = void>
+	using EnableIfT = typename EnableIf<Condition, T>::Type;
+
+	//Goes through a struct so unused parameters still fail the substitution on older compilers
+	template<typename...>
+	struct MakeVoid
+	{
+		typedef void Type;
+	};
+	template<typename... T>
+	using VoidT = typename MakeVoid<T...>::Type;
+
+	//Whether a hash or compare functor has the IsTransparent tag
+	template<typename T, typename = void>
+	struct IsTransparent
+	{
+		static const bool Value = false;
+	};
+	template<typename T>
+	struct IsTransparent<T, VoidT<typename T::IsTransparent>>
+	{
+		static const bool Value = true;
+	};
+
+	template<bool Condition>
+	struct BoolConstant
+	{
+		static const bool Value = Condition;
+	};
+	typedef BoolConstant<true> TrueType;
+	typedef BoolConstant<false> FalseType;
+
+	//Whether the objects can be copied as bytes, this also means they have nothing to destroy.
+	//Containers pick their copy and move implementations with it, it goes through the compiler intrinsic.
+	template<typename T>
+	struct IsTriviallyCopyable : BoolConstant<__is_trivially_copyable(T)>
+	{
+	};
+
+	//Whether the type is a built in integer or floating point type, comparing those is a single instruction.
+	//Const versions aren't matched.
+	template<typename T> struct IsArithmetic : FalseType {};
+	template<> struct IsArithmetic<bool> : TrueType {};
+	template<> struct IsArithmetic<char> : TrueType {};
+	template<> struct IsArithmetic<signed char> : TrueType {};
+	template<> struct IsArithmetic<unsigned char> : TrueType {};
+	template<> struct IsArithmetic<wchar_t> : TrueType {};
+	template<> struct IsArithmetic<char16_t> : TrueType {};
+	template<> struct IsArithmetic<char32_t> : TrueType {};
+	template<> struct IsArithmetic<short> : TrueType {};
+	template<> struct IsArithmetic<unsigned short> : TrueType {};
+	template<> struct IsArithmetic<int> : TrueType {};
+	template<> struct IsArithmetic<unsigned int> : TrueType {};
+	template<> struct IsArithmetic<long> : TrueType {};
+	template<> struct IsArithmetic<unsigned long> : TrueType {};
+	template<> struct IsArithmetic<long long> : TrueType {};
+	template<> struct IsArithmetic<unsigned long long> : TrueType {};
+	template<> struct IsArithmetic<float> : TrueType {};
+	template<> struct IsArithmetic<double> : TrueType {};
+	template<> struct IsArithmetic<long double> : TrueType {};
+
+	template<class T>
+	struct RemoveConst
+	{
+		typedef T Type;
+	};
+	template<class T>
+	struct RemoveConst<const T>
+	{
+		typedef T Type;
+	};
+
+	template<typename A, typename B> struct IsSame : FalseType {};
+	template<typename T> struct IsSame<T, T> : TrueType {};
+
+	//Whether the arguments are a single value of the type, which can be assigned without constructing another
+	template<typename T, typename... Args> struct IsSingleArgumentOf : FalseType {};
+	template<typename T, typename Arg>
+	struct IsSingleArgumentOf<T, Arg> : IsSame<typename RemoveConst<typename RemoveReference<Arg>::Type>::Type, T>
+	{
+	};
+
+	template<typename T, typename Arg>
+	inline void AssignValue_Internal(T& destination, TrueType, Arg&& arg)
+	{
+		destination = Forward<Arg>(arg);
+	}
+
+	template<typename T, typename... Args>
+	inline void AssignValue_Internal(T& destination, FalseType, Args&&... args)
+	{
+		destination = T(Forward<Args>(args)...);
+	}
+
+	//Replace the value with the arguments, a value of the type is copied or moved straight in
+	//and anything else constructs a value that is moved in.
+	template<typename T, typename... Args>
+	inline void AssignValue(T& destination, Args&&... args)
+	{
+		AssignValue_Internal(destination, IsSingleArgumentOf<T, Args...>(), Forward<Args>(args)...);
+	}
+
 	template< class T> 
 	struct AddConst
 	{ 
@@ -1,12 +1,18 @@
 #pragma once
 #include <initializer_list>
+#include <new>
 #include <assert.h>
+#include <string.h>
 #include "Iterator.h"
 #include "Algorithm.h"
 #include "Utility.h"
+#include "MemoryResource.h"
 
 namespace StlStd
 {
+	//The buffer is raw memory, only the first Size() items are constructed.
+	//Trivially copyable items are copied and moved as bytes, the others are copy or move constructed in place.
+	//The buffer comes from the memory resource of the vector, the default resource unless one is given.
 	template<typename T>
 	class Vector
 	{
@@ -16,75 +22,97 @@ namespace StlStd
 
 	public:
 		Vector() :
-			m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
+			m_pResource(GetDefaultResource()), m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
 		{}
+
+		//Taken by reference so a literal 0 or NULL still picks the size constructor
+		explicit Vector(MemoryResource& resource) :
+			m_pResource(&resource), m_pBuffer(nullptr), m_Size(0), m_Capacity(0)
+		{}
+
 		Vector(const size_t size) :
-			m_pBuffer(new T[size]), m_Size(size), m_Capacity(size)
+			m_pResource(GetDefaultResource()), m_pBuffer(Allocate(size)), m_Size(size), m_Capacity(size)
 		{
-			memset(m_pBuffer, 0, sizeof(T) * size);
+			for (size_t i = 0; i < size; ++i)
+				new (m_pBuffer + i) T();
 		}
 
 		Vector(const size_t size, const T& value) :
-			m_pBuffer(new T[size]), m_Size(size), m_Capacity(size)
+			m_pResource(GetDefaultResource()), m_pBuffer(Allocate(size)), m_Size(size), m_Capacity(size)
 		{
 			for (size_t i = 0; i < size; ++i)
-				m_pBuffer[i] = value;
+				new (m_pBuffer + i) T(value);
 		}
 
-		Vector(T* pData, const size_t size) :
-			m_pBuffer(new T[size]), m_Size(size), m_Capacity(size)
+		Vector(const T* pData, const size_t size) :
+			m_pResource(GetDefaultResource()), m_pBuffer(Allocate(size)), m_Size(size), m_Capacity(size)
 		{
-			memcpy(m_pBuffer, pData, sizeof(T) * size);
+			CopyConstruct(m_pBuffer, pData, size, IsTriviallyCopyable<T>());
 		}
 
-		Vector(std::initializer_list<T> list) :
-			m_pBuffer(new T[list.size()]), m_Size(list.size()), m_Capacity(list.size())
+		Vector(std::initializer_list<T> list, MemoryResource* pResource = GetDefaultResource()) :
+			m_pResource(pResource), m_pBuffer(Allocate(list.size())), m_Size(list.size()), m_Capacity(list.size())
 		{
-			memcpy(m_pBuffer, list.begin(), sizeof(T) * list.size());
+			CopyConstruct(m_pBuffer, list.begin(), list.size(), IsTriviallyCopyable<T>());
 		}
 
-		//Move semantics
+		//Move semantics, the resource comes along with the buffer
 		Vector(Vector<T>&& other) :
-			m_pBuffer(other.m_pBuffer), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+			m_pResource(other.m_pResource), m_pBuffer(other.m_pBuffer), m_Size(other.m_Size), m_Capacity(other.m_Capacity)
 		{
 			other.m_Size = 0;
 			other.m_Capacity = 0;
 			other.m_pBuffer = nullptr;
 		}
 
-		//Deep copy
-		Vector(const Vector<T>& other) :
-			m_Size(other.m_Size), m_Capacity(other.m_Capacity)
+		//Deep copy, the copy uses the default resource unless it is given one
+		Vector(const Vector<T>& other, MemoryResource* pResource = GetDefaultResource()) :
+			m_pResource(pResource), m_pBuffer(Allocate(other.m_Size)), m_Size(other.m_Size), m_Capacity(other.m_Size)
 		{
-			m_pBuffer = new T[other.m_Size];
-			memcpy(m_pBuffer, other.m_pBuffer, sizeof(T) * other.m_Size);
+			CopyConstruct(m_pBuffer, other.m_pBuffer, other.m_Size, IsTriviallyCopyable<T>());
 		}
 
 		~Vector()
 		{
-			if (m_pBuffer)
-			{
-				delete[] m_pBuffer;
-				m_pBuffer = nullptr;
-			}
+			Destroy(m_pBuffer, m_Size, IsTriviallyCopyable<T>());
+			Deallocate(m_pBuffer, m_Capacity);
+			m_pBuffer = nullptr;
 		}
 
-		//Deep copy
+		//Deep copy, the capacity follows the other vector
 		Vector& operator=(const Vector<T>& other)
 		{
-			if (m_pBuffer && m_Capacity != other.m_Capacity)
-			{
-				delete[] m_pBuffer;
-				m_pBuffer = nullptr;
-			}
-			if (m_pBuffer == nullptr && other.m_Capacity > 0)
+			if (this == &other)
+				return *this;
+
+			Destroy(m_pBuffer, m_Size, IsTriviallyCopyable<T>());
+			m_Size = 0;
+			if (m_Capacity != other.m_Capacity)
 			{
-				m_pBuffer = new T[other.m_Size];
+				Deallocate(m_pBuffer, m_Capacity);
+				m_pBuffer = Allocate(other.m_Capacity);
+				m_Capacity = other.m_Capacity;
 			}
-			m_Capacity = other.m_Capacity;
+			CopyConstruct(m_pBuffer, other.m_pBuffer, other.m_Size, IsTriviallyCopyable<T>());
+			m_Size = other.m_Size;
+			return *this;
+		}
 
+		//Move semantics, the resource comes along with the buffer
+		Vector& operator=(Vector<T>&& other)
+		{
+			if (this == &other)
+				return *this;
+
+			Destroy(m_pBuffer, m_Size, IsTriviallyCopyable<T>());
+			Deallocate(m_pBuffer, m_Capacity);
+			m_pResource = other.m_pResource;
+			m_pBuffer = other.m_pBuffer;
 			m_Size = other.m_Size;
-			memcpy(m_pBuffer, other.m_pBuffer, sizeof(T) * other.m_Size);
+			m_Capacity = other.m_Capacity;
+			other.m_pBuffer = nullptr;
+			other.m_Size = 0;
+			other.m_Capacity = 0;
 			return *this;
 		}
 
@@ -132,87 +160,84 @@ namespace StlStd
 			return m_pBuffer[index];
 		}
 
-		//Keeps the items in memory but reset the size
+		//Destroys the items but keeps the memory
 		void Clear()
 		{
+			Destroy(m_pBuffer, m_Size, IsTriviallyCopyable<T>());
 			m_Size = 0;
 		}
 
+		//The capacity becomes the size, the new items are value initialized
 		void Resize(const size_t size)
 		{
-			size_t copyWidth = 0;
-			if (m_pBuffer)
+			if (size < m_Size)
 			{
-				T* pNewBuffer = new T[size];
-				copyWidth = size > m_Size ? m_Size : size;
-				memcpy(pNewBuffer, m_pBuffer, sizeof(T) * copyWidth);
-				delete[] m_pBuffer;
-				m_pBuffer = pNewBuffer;
+				Destroy(m_pBuffer + size, m_Size - size, IsTriviallyCopyable<T>());
+				m_Size = size;
 			}
-			else
-			{
-				m_pBuffer = new T[size];
-			}
-			memset(m_pBuffer + copyWidth, 0, (size - copyWidth) * sizeof(T));
+			if (size != m_Capacity)
+				Reallocate(size);
+			for (size_t i = m_Size; i < size; ++i)
+				new (m_pBuffer + i) T();
 			m_Size = size;
-			m_Capacity = size;
 		}
 
 		void Reserve(const size_t size)
 		{
 			if (size <= m_Capacity)
 				return;
-
-			if (m_pBuffer != nullptr)
-			{
-				T* pNewBuffer = new T[size];
-				size_t copyWidth = size > m_Size ? m_Size : size;
-				memcpy(pNewBuffer, m_pBuffer, sizeof(T) * copyWidth);
-				delete[] m_pBuffer;
-				m_pBuffer = pNewBuffer;
-			}
-			else
-			{
-				m_pBuffer = new T[size];
-			}
-			m_Capacity = size;
+			Reallocate(size);
 		}
 
 		void ShrinkToFit()
 		{
-			Resize(m_Size);
+			if (m_Size != m_Capacity)
+				Reallocate(m_Size);
 		}
 
 		void Push(const T& value)
 		{
-			if (m_Size >= m_Capacity)
-			{
-				Reserve(CalculateGrowth(m_Size));
-			}
-			*(m_pBuffer + m_Size) = value;
-			++m_Size;
+			EmplaceBack(value);
 		}
 
 		void Push(T&& value)
 		{
-			if (m_Size >= m_Capacity)
+			EmplaceBack(Move(value));
+		}
+
+		//Constructs the item in place at the end, the arguments can refer to items of the vector
+		template<typename ...Args>
+		T& EmplaceBack(Args&&... args)
+		{
+			if (m_Size < m_Capacity)
 			{
-				Reserve(CalculateGrowth(m_Size));
+				new (m_pBuffer + m_Size) T(Forward<Args>(args)...);
+				return m_pBuffer[m_Size++];
 			}
-			*(m_pBuffer + m_Size) = Move(value);
-			++m_Size;
+
+			//The new item is constructed before the old ones are moved, the arguments are still valid
+			const size_t capacity = CalculateGrowth(m_Size);
+			T* pNewBuffer = Allocate(capacity);
+			new (pNewBuffer + m_Size) T(Forward<Args>(args)...);
+			Relocate(pNewBuffer, m_pBuffer, m_Size, IsTriviallyCopyable<T>());
+			Deallocate(m_pBuffer, m_Capacity);
+			m_pBuffer = pNewBuffer;
+			m_Capacity = capacity;
+			return m_pBuffer[m_Size++];
 		}
 
 		T Pop()
 		{
 			assert(m_Size > 0);
-			RandomAccessIterator<T> pValue = End() - 1;
+			T value = Move(m_pBuffer[m_Size - 1]);
+			Destroy(m_pBuffer + m_Size - 1, 1, IsTriviallyCopyable<T>());
 			--m_Size;
-			return *pValue;
+			return value;
 		}
 
 		void Swap(Vector<T>& other)
 		{
+			StlStd::Swap(m_pResource, other.m_pResource);
 			StlStd::Swap(m_pBuffer, other.m_pBuffer);
 			StlStd::Swap(m_Size, other.m_Size);
 			StlStd::Swap(m_Capacity, other.m_Capacity);
@@ -223,24 +248,24 @@ namespace StlStd
 			if (m_Size + amount > m_Capacity)
 				Reserve(m_Size + amount);
 			for (size_t i = 0; i < amount; ++i)
-			{
-				memcpy(&m_pBuffer[m_Size + i], &value, sizeof(T));
-			}
+				new (m_pBuffer + m_Size + i) T(value);
 			m_Size += amount;
 		}
 
 		void SwapEraseAt(const size_t index)
 		{
 			assert(index < m_Size);
-			StlStd::Swap(m_pBuffer[index], Back());
+			if (index != m_Size - 1)
+				m_pBuffer[index] = Move(m_pBuffer[m_Size - 1]);
+			Destroy(m_pBuffer + m_Size - 1, 1, IsTriviallyCopyable<T>());
 			--m_Size;
 		}
 
 		Iterator EraseAt(const size_t index)
 		{
 			assert(index < m_Size);
-			for (size_t i = index; i < m_Size - 1; ++i)
-				m_pBuffer[i] = Move(m_pBuffer[i + 1]);
+			MoveAssign(m_pBuffer + index, m_pBuffer + index + 1, m_Size - index - 1, IsTriviallyCopyable<T>());
+			Destroy(m_pBuffer + m_Size - 1, 1, IsTriviallyCopyable<T>());
 			--m_Size;
 			return Iterator(m_pBuffer + index);
 		}
@@ -248,12 +273,20 @@ namespace StlStd
 		Iterator Insert(const size_t index, const T& value)
 		{
 			assert(index <= m_Size);
+			if (index == m_Size)
+			{
+				EmplaceBack(value);
+				return Iterator(m_pBuffer + index);
+			}
+
+			//The value can be an item of the vector, it is copied before the items are shifted
+			T copy(value);
 			if (m_Size == m_Capacity)
-				Reserve(m_Size + 1);
+				Reserve(CalculateGrowth(m_Size));
 
-			for (size_t i = m_Size; i > index; --i)
-				m_pBuffer[i] = Move(m_pBuffer[i - 1]);
-			m_pBuffer[index] = value;
+			new (m_pBuffer + m_Size) T(Move(m_pBuffer[m_Size - 1]));
+			MoveAssign(m_pBuffer + index + 1, m_pBuffer + index, m_Size - index - 1, IsTriviallyCopyable<T>());
+			m_pBuffer[index] = Move(copy);
 			++m_Size;
 			return Iterator(m_pBuffer + index);
 		}
@@ -278,6 +311,7 @@ namespace StlStd
 		T* Data() { return m_pBuffer; }
 		size_t Size() const { return m_Size; }
 		size_t Capacity() const { return m_Capacity; }
+		MemoryResource* GetResource() const { return m_pResource; }
 		bool Empty() const { return m_Size == 0; }
 
 		Iterator begin() { return Iterator(m_pBuffer); }
@@ -301,10 +335,91 @@ namespace StlStd
 	private:
 		size_t CalculateGrowth(const size_t oldSize)
 		{
-			size_t newSize = (size_t)floor(oldSize * 1.5);
-			return newSize == m_Capacity ? newSize + 1 : newSize;
+			const size_t newSize = oldSize + oldSize / 2;
+			return newSize <= m_Capacity ? m_Capacity + 1 : newSize;
+		}
+
+		//Moves the items to a new buffer of the capacity, it has to fit the items
+		void Reallocate(const size_t capacity)
+		{
+			assert(capacity >= m_Size);
+			T* pNewBuffer = Allocate(capacity);
+			Relocate(pNewBuffer, m_pBuffer, m_Size, IsTriviallyCopyable<T>());
+			Deallocate(m_pBuffer, m_Capacity);
+			m_pBuffer = pNewBuffer;
+			m_Capacity = capacity;
+		}
+
+		T* Allocate(const size_t capacity)
+		{
+			return capacity > 0 ? static_cast<T*>(m_pResource->Allocate(capacity * sizeof(T), alignof(T))) : nullptr;
+		}
+
+		void Deallocate(T* pBuffer, const size_t capacity)
+		{
+			m_pResource->Deallocate(pBuffer, capacity * sizeof(T), alignof(T));
+		}
+
+		static void CopyConstruct(T* pDestination, const T* pSource, const size_t count, TrueType)
+		{
+			if (count > 0)
+				memcpy(pDestination, pSource, count * sizeof(T));
+		}
+
+		static void CopyConstruct(T* pDestination, const T* pSource, const size_t count, FalseType)
+		{
+			for (size_t i = 0; i < count; ++i)
+				new (pDestination + i) T(pSource[i]);
+		}
+
+		//Moves the items to uninitialized memory and destroys the old ones
+		static void Relocate(T* pDestination, T* pSource, const size_t count, TrueType)
+		{
+			if (count > 0)
+				memcpy(pDestination, pSource, count * sizeof(T));
+		}
+
+		static void Relocate(T* pDestination, T* pSource, const size_t count, FalseType)
+		{
+			for (size_t i = 0; i < count; ++i)
+			{
+				new (pDestination + i) T(Move(pSource[i]));
+				pSource[i].~T();
+			}
+		}
+
+		//Moves the items over constructed ones, the ranges can overlap
+		static void MoveAssign(T* pDestination, T* pSource, const size_t count, TrueType)
+		{
+			if (count > 0)
+				memmove(pDestination, pSource, count * sizeof(T));
+		}
+
+		static void MoveAssign(T* pDestination, T* pSource, const size_t count, FalseType)
+		{
+			if (pDestination < pSource)
+			{
+				for (size_t i = 0; i < count; ++i)
+					pDestination[i] = Move(pSource[i]);
+			}
+			else
+			{
+				for (size_t i = count; i > 0; --i)
+					pDestination[i - 1] = Move(pSource[i - 1]);
+			}
+		}
+
+		static void Destroy(T*, const size_t, TrueType)
+		{
+		}
+
+		static void Destroy(T* pBegin, const size_t count, FalseType)
+		{
+			for (size_t i = 0; i < count; ++i)
+				pBegin[i].~T();
 		}
 
+		MemoryResource* m_pResource;
 		T * m_pBuffer;
 		size_t m_Size;
 		size_t m_Capacity;
@@ -315,4 +430,4 @@ namespace StlStd
 	{
 		a.Swap(b);
 	}
-}
\ No newline at end of file
+}
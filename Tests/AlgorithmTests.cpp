@@ -1,6 +1,11 @@
 #include "../catch.hpp"
 #include "../Std/Vector.h"
 #include "../Std/Algorithm.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
 
 using namespace StlStd;
 
@@ -229,4 +234,147 @@ TEST_CASE("Algorithm - Min", "[Algorithm]")
 		Vector<int>::ConstIterator i = MinElement(v1.Begin(), v1.End(), [](int x, int y) { return x < y; });
 		REQUIRE(*i == 1);
 	}
-}
\ No newline at end of file
+}
+
+namespace
+{
+	//Runs the test with every SIMD level the CPU supports, the scalar loops included
+	template<typename Test>
+	void ForEachSimdLevel(Test test)
+	{
+		const SimdLevel levels[] = { SimdLevel::None, SimdLevel::Sse2, SimdLevel::Avx2 };
+		for (const SimdLevel level : levels)
+		{
+			if (level > DetectSimdLevel())
+				break;
+			SetSimdLevel(level);
+			test();
+		}
+		SetSimdLevel(DetectSimdLevel());
+	}
+
+	//Few distinct values, so every range has duplicates of its minimum and maximum
+	template<typename T>
+	Vector<T> MakeSimdInput(const size_t size)
+	{
+		Vector<T> values;
+		for (size_t i = 0; i < size; ++i)
+			values.Push((T)(rand() % 61 - (T(-1) < T(0) ? 30 : 0)));
+		return values;
+	}
+
+	//Compares the algorithms to the standard ones on every start and end offset of short ranges and on ranges longer
+	//than a block of the min and max kernels
+	template<typename T>
+	void CheckSimdAlgorithms()
+	{
+		const size_t sizes[] = { 0, 1, 3, 15, 16, 17, 33, 64, 100, 4095, 4096, 4097, 20000 };
+		for (const size_t size : sizes)
+		{
+			const Vector<T> input = MakeSimdInput<T>(size);
+			const size_t offsets = size < 100 ? 5 : 1;
+			for (size_t begin = 0; begin < offsets && begin <= size; ++begin)
+			{
+				for (size_t end = size; end + offsets > size && end >= begin; --end)
+				{
+					const T* pBegin = input.Data() + begin;
+					const T* pEnd = input.Data() + end;
+					RandomAccessConstIterator<T> first(pBegin);
+					RandomAccessConstIterator<T> last(pEnd);
+					REQUIRE(ToAddress(MinElement(first, last)) == (begin == end ? pEnd : std::min_element(pBegin, pEnd)));
+					REQUIRE(ToAddress(MaxElement(first, last)) == (begin == end ? pEnd : std::max_element(pBegin, pEnd)));
+					const T values[] = { (T)0, (T)7, (T)30, (T)100 };
+					for (const T value : values)
+						REQUIRE(ToAddress(Find(first, last, value)) == std::find(pBegin, pEnd, value));
+
+					Vector<T> replaced = input;
+					Replace(replaced.Begin() + begin, replaced.Begin() + end, (T)7, (T)99);
+					Vector<T> expected = input;
+					std::replace(expected.Data() + begin, expected.Data() + end, (T)7, (T)99);
+					REQUIRE(std::equal(expected.Data(), expected.Data() + size, replaced.Data()));
+
+					Vector<T> filled = input;
+					Fill(filled.Begin() + begin, filled.Begin() + end, (T)42);
+					expected = input;
+					std::fill(expected.Data() + begin, expected.Data() + end, (T)42);
+					REQUIRE(std::equal(expected.Data(), expected.Data() + size, filled.Data()));
+					if (end == 0)
+						break;
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE("Algorithm - SIMD", "[Algorithm]")
+{
+	SECTION("Against the standard algorithms")
+	{
+		srand(25);
+		ForEachSimdLevel([]()
+		{
+			CheckSimdAlgorithms<int8_t>();
+			CheckSimdAlgorithms<uint8_t>();
+			CheckSimdAlgorithms<char>();
+			CheckSimdAlgorithms<int16_t>();
+			CheckSimdAlgorithms<uint16_t>();
+			CheckSimdAlgorithms<int32_t>();
+			CheckSimdAlgorithms<uint32_t>();
+			CheckSimdAlgorithms<long>();
+			CheckSimdAlgorithms<int64_t>();
+			CheckSimdAlgorithms<uint64_t>();
+			CheckSimdAlgorithms<float>();
+			CheckSimdAlgorithms<double>();
+		});
+	}
+
+	SECTION("Extremes")
+	{
+		ForEachSimdLevel([]()
+		{
+			Vector<uint32_t> values(1000, 5u);
+			values[700] = 0xFFFFFFFFu;
+			values[900] = 0xFFFFFFFFu;
+			values[300] = 0;
+			REQUIRE(MaxElement(values.Begin(), values.End()) - values.Begin() == 700);
+			REQUIRE(MinElement(values.Begin(), values.End()) - values.Begin() == 300);
+			Vector<int8_t> bytes(100, (int8_t)0);
+			bytes[50] = -128;
+			bytes[60] = 127;
+			REQUIRE(MinElement(bytes.Begin(), bytes.End()) - bytes.Begin() == 50);
+			REQUIRE(MaxElement(bytes.Begin(), bytes.End()) - bytes.Begin() == 60);
+		});
+	}
+	SECTION("Negative zero equals zero")
+	{
+		ForEachSimdLevel([]()
+		{
+			Vector<double> values(100, 1.0);
+			values[10] = 0.0;
+			values[20] = -0.0;
+			REQUIRE(MinElement(values.Begin(), values.End()) - values.Begin() == 10);
+			REQUIRE(Find(values.Begin(), values.End(), -0.0) - values.Begin() == 10);
+			Replace(values.Begin(), values.End(), 0.0, 2.0);
+			REQUIRE(values[10] == 2.0);
+			REQUIRE(values[20] == 2.0);
+		});
+	}
+	SECTION("NaN")
+	{
+		ForEachSimdLevel([]()
+		{
+			Vector<float> values(100, 1.0f);
+			values[0] = std::numeric_limits<float>::quiet_NaN();
+			values[40] = 3.0f;
+			values[60] = -3.0f;
+			//Like the scalar loop, nothing compares less than or greater than the NaN in front
+			REQUIRE(MinElement(values.Begin(), values.End()) - values.Begin() == 0);
+			REQUIRE(MaxElement(values.Begin(), values.End()) - values.Begin() == 0);
+			values[0] = 1.0f;
+			values[50] = std::numeric_limits<float>::quiet_NaN();
+			REQUIRE(MinElement(values.Begin(), values.End()) - values.Begin() == 60);
+			REQUIRE(MaxElement(values.Begin(), values.End()) - values.Begin() == 40);
+			REQUIRE(Find(values.Begin(), values.End(), std::numeric_limits<float>::quiet_NaN()) == values.End());
+		});
+	}
+}
@@ -0,0 +1,230 @@
+#include "../catch.hpp"
+#include "../Std/BlockAllocator.h"
+#include "../Std/ConcurrentBlockAllocator.h"
+#include "../Std/Map.h"
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	struct alignas(64) CacheLine
+	{
+		int Value;
+	};
+}
+
+TEST_CASE("BlockAllocator - Alloc and Free", "[BlockAllocator]")
+{
+	CountingResource counter;
+	BlockAllocator::Block* pBlock = BlockAllocator::Initialize(24, 4, &counter, 8);
+	REQUIRE(BlockAllocator::GetSize(pBlock) == 4);
+
+	SECTION("No header between the nodes")
+	{
+		char* pFirst = static_cast<char*>(BlockAllocator::Alloc(pBlock));
+		char* pSecond = static_cast<char*>(BlockAllocator::Alloc(pBlock));
+		REQUIRE(pSecond - pFirst == 24);
+	}
+	SECTION("Freed nodes are reused first")
+	{
+		void* pFirst = BlockAllocator::Alloc(pBlock);
+		void* pSecond = BlockAllocator::Alloc(pBlock);
+		BlockAllocator::Free(pBlock, pFirst);
+		BlockAllocator::Free(pBlock, pSecond);
+		REQUIRE(BlockAllocator::Alloc(pBlock) == pSecond);
+		REQUIRE(BlockAllocator::Alloc(pBlock) == pFirst);
+	}
+	SECTION("Nodes fit a link")
+	{
+		BlockAllocator::Block* pSmall = BlockAllocator::Initialize(1, 2, &counter, 1);
+		char* pFirst = static_cast<char*>(BlockAllocator::Alloc(pSmall));
+		char* pSecond = static_cast<char*>(BlockAllocator::Alloc(pSmall));
+		REQUIRE(pSecond - pFirst == sizeof(void*));
+		BlockAllocator::Free(pSmall, pFirst);
+		BlockAllocator::Uninitialize(pSmall);
+	}
+	SECTION("Reserve")
+	{
+		BlockAllocator::Alloc(pBlock);
+		BlockAllocator::Reserve(pBlock, 100);
+		REQUIRE(BlockAllocator::GetSize(pBlock) == 100);
+		REQUIRE(counter.AllocationCount() == 2);
+		//The nodes the first block never handed out are used before the reserved ones
+		for (int i = 0; i < 99; ++i)
+			BlockAllocator::Alloc(pBlock);
+		REQUIRE(counter.AllocationCount() == 2);
+	}
+	BlockAllocator::Uninitialize(pBlock);
+	REQUIRE(counter.LiveAllocations() == 0);
+}
+
+TEST_CASE("BlockAllocator - Growth", "[BlockAllocator]")
+{
+	CountingResource counter;
+	BlockAllocator::Block* pBlock = BlockAllocator::Initialize(32, 1, &counter);
+
+	SECTION("Geometric")
+	{
+		//16 nodes at least, then as many as there are, up to 64k nodes at once
+		for (int i = 0; i < 1000000; ++i)
+			BlockAllocator::Alloc(pBlock);
+		REQUIRE(counter.AllocationCount() < 32);
+		REQUIRE(BlockAllocator::GetSize(pBlock) >= 1000000);
+		REQUIRE(BlockAllocator::GetSize(pBlock) < 1000000 + BlockAllocator::DEFAULT_MAX_BLOCK);
+	}
+	SECTION("Block sizes")
+	{
+		BlockAllocator::SetBlockSizes(pBlock, 100, 200);
+		BlockAllocator::Alloc(pBlock);
+		BlockAllocator::Alloc(pBlock);
+		REQUIRE(BlockAllocator::GetSize(pBlock) == 101);
+		for (int i = 0; i < 100; ++i)
+			BlockAllocator::Alloc(pBlock);
+		REQUIRE(BlockAllocator::GetSize(pBlock) == 202);
+		for (int i = 0; i < 101; ++i)
+			BlockAllocator::Alloc(pBlock);
+		REQUIRE(BlockAllocator::GetSize(pBlock) == 402);
+		REQUIRE(counter.AllocationCount() == 4);
+	}
+	BlockAllocator::Uninitialize(pBlock);
+	REQUIRE(counter.LiveAllocations() == 0);
+}
+
+TEST_CASE("BlockAllocator - Alignment", "[BlockAllocator]")
+{
+	SECTION("BlockAllocator")
+	{
+		BlockAllocator::Block* pBlock = BlockAllocator::Initialize(sizeof(CacheLine), 3, GetDefaultResource(), alignof(CacheLine));
+		for (int i = 0; i < 100; ++i)
+		{
+			CacheLine* pNode = static_cast<CacheLine*>(BlockAllocator::Alloc(pBlock));
+			REQUIRE((uintptr_t)pNode % alignof(CacheLine) == 0);
+		}
+		BlockAllocator::Uninitialize(pBlock);
+	}
+	SECTION("ConcurrentBlockAllocator")
+	{
+		ConcurrentBlockAllocator::Block* pBlock = ConcurrentBlockAllocator::Initialize(sizeof(CacheLine), 3, GetDefaultResource(), alignof(CacheLine));
+		for (int i = 0; i < 100; ++i)
+		{
+			CacheLine* pNode = static_cast<CacheLine*>(ConcurrentBlockAllocator::Alloc(pBlock));
+			REQUIRE((uintptr_t)pNode % alignof(CacheLine) == 0);
+		}
+		ConcurrentBlockAllocator::Uninitialize(pBlock);
+	}
+	SECTION("Map")
+	{
+		Map<int, CacheLine> map;
+		for (int i = 0; i < 100; ++i)
+		{
+			map.Insert(i, CacheLine());
+			REQUIRE((uintptr_t)&map.Find(i)->Value % alignof(CacheLine) == 0);
+		}
+	}
+}
+
+TEST_CASE("BlockAllocator - Trim", "[BlockAllocator]")
+{
+	CountingResource counter;
+	BlockAllocator::Block* pBlock = BlockAllocator::Initialize(32, 16, &counter, 8);
+	std::vector<void*> nodes;
+	for (int i = 0; i < 10000; ++i)
+		nodes.push_back(BlockAllocator::Alloc(pBlock));
+	const size_t peakBytes = counter.BytesInUse();
+
+	SECTION("Empty blocks are given back")
+	{
+		//Keep every node of the first 100, the blocks after those are empty
+		for (size_t i = 100; i < nodes.size(); ++i)
+			BlockAllocator::Free(pBlock, nodes[i]);
+		const size_t released = BlockAllocator::Trim(pBlock);
+		REQUIRE(released > 0);
+		REQUIRE(counter.BytesInUse() == peakBytes - released);
+		REQUIRE(BlockAllocator::GetSize(pBlock) < 200);
+
+		//The nodes that are left are still handed out, and the allocator grows again
+		for (size_t i = 100; i < nodes.size(); ++i)
+			nodes[i] = BlockAllocator::Alloc(pBlock);
+		REQUIRE(BlockAllocator::GetSize(pBlock) >= nodes.size());
+		REQUIRE(BlockAllocator::Trim(pBlock) == 0);
+	}
+	SECTION("Blocks with nodes in use stay")
+	{
+		for (size_t i = 0; i < nodes.size(); ++i)
+		{
+			if (i % 16 != 0)
+				BlockAllocator::Free(pBlock, nodes[i]);
+		}
+		REQUIRE(BlockAllocator::Trim(pBlock) == 0);
+		REQUIRE(counter.BytesInUse() == peakBytes);
+	}
+	SECTION("Everything free")
+	{
+		for (void* pNode : nodes)
+			BlockAllocator::Free(pBlock, pNode);
+		BlockAllocator::Trim(pBlock);
+		REQUIRE(counter.LiveAllocations() == 1);
+		REQUIRE(BlockAllocator::GetSize(pBlock) == 16);
+		for (int i = 0; i < 20; ++i)
+			BlockAllocator::Alloc(pBlock);
+		REQUIRE(counter.LiveAllocations() == 2);
+	}
+	BlockAllocator::Uninitialize(pBlock);
+	REQUIRE(counter.LiveAllocations() == 0);
+}
+
+TEST_CASE("BlockAllocator - Stats", "[BlockAllocator]")
+{
+	CountingResource counter;
+	BlockAllocator::Block* pBlock = BlockAllocator::Initialize(32, 100, &counter, 8);
+	BlockAllocator::Stats stats = BlockAllocator::GetStats(pBlock);
+	REQUIRE(stats.BlockCount == 1);
+	REQUIRE(stats.BytesReserved == counter.BytesInUse());
+	REQUIRE(stats.BytesInUse == 0);
+	REQUIRE(stats.FreeListLength == 0);
+	REQUIRE(stats.Fragmentation == 0.0f);
+
+	std::vector<void*> nodes;
+	for (int i = 0; i < 150; ++i)
+		nodes.push_back(BlockAllocator::Alloc(pBlock));
+	for (int i = 0; i < 50; ++i)
+		BlockAllocator::Free(pBlock, nodes[i]);
+	stats = BlockAllocator::GetStats(pBlock);
+	REQUIRE(stats.BlockCount == 2);
+	REQUIRE(stats.BytesReserved == counter.BytesInUse());
+	REQUIRE(stats.BytesInUse == 100 * 32);
+	REQUIRE(stats.FreeListLength == 50);
+	//The free nodes of the first block and the ones the second block never handed out, all next to nodes in use
+	REQUIRE(stats.Fragmentation == 1.0f);
+
+	for (int i = 50; i < 100; ++i)
+		BlockAllocator::Free(pBlock, nodes[i]);
+	stats = BlockAllocator::GetStats(pBlock);
+	REQUIRE(stats.BytesInUse == 50 * 32);
+	REQUIRE(stats.Fragmentation < 1.0f);
+	BlockAllocator::Uninitialize(pBlock);
+}
+
+TEST_CASE("BlockAllocator - Concurrent Trim and Stats", "[BlockAllocator]")
+{
+	CountingResource counter;
+	ConcurrentBlockAllocator::Block* pBlock = ConcurrentBlockAllocator::Initialize(32, 16, &counter, 8);
+	std::vector<void*> nodes;
+	for (int i = 0; i < 1000; ++i)
+		nodes.push_back(ConcurrentBlockAllocator::Alloc(pBlock));
+	for (size_t i = 16; i < nodes.size(); ++i)
+		ConcurrentBlockAllocator::Free(pBlock, nodes[i]);
+
+	ConcurrentBlockAllocator::Stats stats = ConcurrentBlockAllocator::GetStats(pBlock);
+	REQUIRE(stats.BytesReserved == counter.BytesInUse());
+	REQUIRE(stats.FreeListLength == ConcurrentBlockAllocator::GetSize(pBlock) - 16);
+	REQUIRE(stats.Fragmentation == 0.0f);
+
+	REQUIRE(ConcurrentBlockAllocator::Trim(pBlock) > 0);
+	REQUIRE(counter.LiveAllocations() == 1);
+	REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) == 16);
+	stats = ConcurrentBlockAllocator::GetStats(pBlock);
+	REQUIRE(stats.BlockCount == 1);
+	REQUIRE(stats.FreeListLength == 0);
+	ConcurrentBlockAllocator::Uninitialize(pBlock);
+}
@@ -0,0 +1,159 @@
+#include "../catch.hpp"
+#include "../Std/ConcurrentBlockAllocator.h"
+#include "../Std/Map.h"
+#include "../Std/HashMap.h"
+#include <thread>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	struct Payload
+	{
+		int Owner;
+		int Round;
+		char Data[20];
+	};
+}
+
+TEST_CASE("ConcurrentBlockAllocator - Alloc and Free", "[ConcurrentBlockAllocator]")
+{
+	CountingResource counter;
+	ConcurrentBlockAllocator::Block* pBlock = ConcurrentBlockAllocator::Initialize(sizeof(Payload), 4, &counter);
+	REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) == 4);
+	REQUIRE(counter.AllocationCount() == 1);
+
+	std::vector<Payload*> nodes;
+	for (int i = 0; i < 100; ++i)
+	{
+		Payload* pNode = static_cast<Payload*>(ConcurrentBlockAllocator::Alloc(pBlock));
+		REQUIRE((uintptr_t)pNode % alignof(void*) == 0);
+		pNode->Owner = i;
+		nodes.push_back(pNode);
+	}
+	REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) >= 100);
+	for (int i = 0; i < 100; ++i)
+		REQUIRE(nodes[i]->Owner == i);
+
+	//Freed nodes are handed out again before the allocator grows
+	const size_t blocks = counter.AllocationCount();
+	for (Payload* pNode : nodes)
+		ConcurrentBlockAllocator::Free(pBlock, pNode);
+	for (int i = 0; i < 100; ++i)
+		nodes[i] = static_cast<Payload*>(ConcurrentBlockAllocator::Alloc(pBlock));
+	REQUIRE(counter.AllocationCount() == blocks);
+
+	ConcurrentBlockAllocator::Reserve(pBlock, 500);
+	REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) == 500);
+	REQUIRE(counter.AllocationCount() == blocks + 1);
+
+	ConcurrentBlockAllocator::Uninitialize(pBlock);
+	REQUIRE(counter.LiveAllocations() == 0);
+}
+
+TEST_CASE("ConcurrentBlockAllocator - Threads", "[ConcurrentBlockAllocator]")
+{
+	const int threadCount = 8;
+	const int rounds = 200;
+	const int nodeCount = 64;
+	ConcurrentBlockAllocator::Block* pBlock = ConcurrentBlockAllocator::Initialize(sizeof(Payload), 1);
+
+	SECTION("Allocate and free on every thread")
+	{
+		//A node is never handed to two threads at once, the data a thread writes stays untouched until it frees the node
+		std::atomic<int> errors(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, pBlock, &errors]()
+			{
+				Payload* nodes[nodeCount];
+				for (int round = 0; round < rounds; ++round)
+				{
+					const int count = 1 + (round * 7 + t) % nodeCount;
+					for (int i = 0; i < count; ++i)
+					{
+						nodes[i] = static_cast<Payload*>(ConcurrentBlockAllocator::Alloc(pBlock));
+						nodes[i]->Owner = t;
+						nodes[i]->Round = round;
+					}
+					std::this_thread::yield();
+					for (int i = 0; i < count; ++i)
+					{
+						if (nodes[i]->Owner != t || nodes[i]->Round != round)
+							++errors;
+						ConcurrentBlockAllocator::Free(pBlock, nodes[i]);
+					}
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		REQUIRE(errors == 0);
+		REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) >= nodeCount);
+	}
+	SECTION("Free on another thread")
+	{
+		std::vector<std::vector<void*>> nodes(threadCount);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, pBlock, &nodes]()
+			{
+				for (int i = 0; i < rounds; ++i)
+					nodes[t].push_back(ConcurrentBlockAllocator::Alloc(pBlock));
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		threads.clear();
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, pBlock, &nodes]()
+			{
+				for (void* pNode : nodes[(t + 1) % threadCount])
+					ConcurrentBlockAllocator::Free(pBlock, pNode);
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		//Every node is free again, taking all of them doesn't grow the allocator
+		const size_t size = ConcurrentBlockAllocator::GetSize(pBlock);
+		REQUIRE(size >= (size_t)(threadCount * rounds));
+		for (size_t i = 0; i < size; ++i)
+			ConcurrentBlockAllocator::Alloc(pBlock);
+		REQUIRE(ConcurrentBlockAllocator::GetSize(pBlock) == size);
+	}
+	ConcurrentBlockAllocator::Uninitialize(pBlock);
+}
+
+TEST_CASE("ConcurrentBlockAllocator - Containers", "[ConcurrentBlockAllocator]")
+{
+	CountingResource counter;
+	{
+		Map<int, int, LessThan<int>, ConcurrentBlockAllocator> map(&counter);
+		HashMap<int, int, std::hash<int>, EqualTo<int>, PowerOfTwoBucketPolicy, ConcurrentBlockAllocator> hashMap(&counter);
+		hashMap.Reserve(100);
+		for (int i = 0; i < 1000; ++i)
+		{
+			map.Insert(i, i * 2);
+			hashMap.Insert(i, i * 3);
+		}
+		for (int i = 0; i < 1000; i += 2)
+		{
+			map.Erase(i);
+			hashMap.Erase(i);
+		}
+		REQUIRE(map.Size() == 500);
+		REQUIRE(hashMap.Size() == 500);
+		REQUIRE(map.Find(999)->Value == 1998);
+		REQUIRE(hashMap.Find(999)->Value == 2997);
+		REQUIRE(map.GetResource() == &counter);
+
+		Map<int, int, LessThan<int>, ConcurrentBlockAllocator> copy(map);
+		REQUIRE(copy.Size() == 500);
+		REQUIRE(copy.Find(501)->Value == 1002);
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+//Counts the constructions, copies and moves of the values, shared by the tests of the maps.
+//The counters are static members of a template so the header can define them.
+template<typename Tag = void>
+struct CountedValueCounters
+{
+	static int Constructions;
+	static int Copies;
+	static int Moves;
+
+	static void Reset()
+	{
+		Constructions = 0;
+		Copies = 0;
+		Moves = 0;
+	}
+};
+template<typename Tag> int CountedValueCounters<Tag>::Constructions = 0;
+template<typename Tag> int CountedValueCounters<Tag>::Copies = 0;
+template<typename Tag> int CountedValueCounters<Tag>::Moves = 0;
+
+struct CountedValue : CountedValueCounters<>
+{
+	int A;
+	int B;
+
+	CountedValue() :
+		A(0), B(0)
+	{
+		++Constructions;
+	}
+
+	CountedValue(const int a, const int b) :
+		A(a), B(b)
+	{
+		++Constructions;
+	}
+
+	CountedValue(const CountedValue& other) :
+		A(other.A), B(other.B)
+	{
+		++Copies;
+	}
+
+	CountedValue(CountedValue&& other) :
+		A(other.A), B(other.B)
+	{
+		++Moves;
+	}
+
+	CountedValue& operator=(const CountedValue& other)
+	{
+		A = other.A;
+		B = other.B;
+		++Copies;
+		return *this;
+	}
+
+	CountedValue& operator=(CountedValue&& other)
+	{
+		A = other.A;
+		B = other.B;
+		++Moves;
+		return *this;
+	}
+};
@@ -0,0 +1,204 @@
+#include "../catch.hpp"
+#include "../Std/FlatHashMap.h"
+#include <string>
+using namespace StlStd;
+using namespace std;
+
+TEST_CASE("FlatHashMap - Constructor", "[FlatHashMap]")
+{
+	SECTION("Empty")
+	{
+		FlatHashMap<string, double> map;
+		REQUIRE(map.Size() == 0);
+		REQUIRE(map.Empty());
+		REQUIRE(map.BucketCount() == FlatHashMap<string, double>::START_CAPACITY);
+		REQUIRE(map.Begin() == map.End());
+		REQUIRE(map.begin() == map.Begin());
+		REQUIRE(map.end() == map.End());
+	}
+	SECTION("Initializer list constructor - Non-empty")
+	{
+		using P = KeyValuePair<string, double>;
+		FlatHashMap<string, double> map = { P("Hello", 1.23), P("World", 2.46) };
+		REQUIRE(map.Size() == 2);
+		REQUIRE(map.Begin() != map.End());
+		REQUIRE(map["Hello"] == 1.23);
+		REQUIRE(map["World"] == 2.46);
+	}
+	SECTION("Copy")
+	{
+		using P = KeyValuePair<string, double>;
+		FlatHashMap<string, double> map = { P("Hello", 1.23), P("World", 2.46) };
+		FlatHashMap<string, double> map2(map);
+		REQUIRE(map.Size() == 2);
+		REQUIRE(map2.Size() == 2);
+		REQUIRE(map == map2);
+	}
+	SECTION("Move")
+	{
+		using P = KeyValuePair<string, double>;
+		FlatHashMap<string, double> map = { P("Hello", 1.23), P("World", 2.46) };
+		FlatHashMap<string, double> map2(Move(map));
+		REQUIRE(map.Size() == 0);
+		REQUIRE(map.Begin() == map.End());
+		REQUIRE(map.Find("Hello") == map.End());
+		REQUIRE(map2.Size() == 2);
+		REQUIRE(map2["World"] == 2.46);
+
+		map["Foo"] = 1.0;
+		REQUIRE(map.Size() == 1);
+		REQUIRE(map["Foo"] == 1.0);
+	}
+}
+
+TEST_CASE("FlatHashMap - Assignment", "[FlatHashMap]")
+{
+	SECTION("From non-empty to non-empty")
+	{
+		using P = KeyValuePair<string, double>;
+		FlatHashMap<string, double> map = { P("Hello", 1.23), P("World", 2.46) };
+		FlatHashMap<string, double> map2 = { P("CPP", 4.87), P("Foo", 1.23), P("Bar", 2.46) };
+		REQUIRE(map2.Size() == 3);
+		map2 = map;
+		REQUIRE(map2.Size() == 2);
+		REQUIRE(map.Size() == 2);
+		REQUIRE(!map2.Contains("CPP"));
+		REQUIRE(map2 == map);
+	}
+}
+
+TEST_CASE("FlatHashMap - Insert & Find", "[FlatHashMap]")
+{
+	SECTION("Strings")
+	{
+		FlatHashMap<string, double> map;
+		map.Insert(KeyValuePair<string, double>("Hello", 1.0));
+		REQUIRE(map.Size() == 1);
+		REQUIRE(map.Find("Hello") != map.End());
+		REQUIRE(map.Find("Hello")->Value == 1.0);
+		map.Insert("World", 5.0);
+		REQUIRE(map.Size() == 2);
+		map.Insert("Hello", 5.0);
+		REQUIRE(map.Size() == 2);
+		REQUIRE(map["Hello"] == 5.0);
+		REQUIRE(map.Find("Poo") == map.End());
+		REQUIRE(!map.Contains("Poo"));
+	}
+	SECTION("Grow")
+	{
+		const int count = 10000;
+		FlatHashMap<int, int> map;
+		for (int i = 0; i < count; ++i)
+			map.Insert(i, i * 2);
+		REQUIRE(map.Size() == (size_t)count);
+		REQUIRE(map.LoadFactor() <= map.MaxLoadFactor());
+		for (int i = 0; i < count; ++i)
+		{
+			REQUIRE(map.Contains(i));
+			REQUIRE(map[i] == i * 2);
+		}
+		REQUIRE(!map.Contains(count));
+		REQUIRE(!map.Contains(-1));
+	}
+	SECTION("Reserve")
+	{
+		FlatHashMap<int, int> map;
+		map.Reserve(1000);
+		const size_t buckets = map.BucketCount();
+		REQUIRE(buckets * map.MaxLoadFactor() >= 1000);
+		for (int i = 0; i < 1000; ++i)
+			map[i] = i;
+		REQUIRE(map.BucketCount() == buckets);
+	}
+}
+
+TEST_CASE("FlatHashMap - Erase", "[FlatHashMap]")
+{
+	SECTION("Strings")
+	{
+		using P = KeyValuePair<string, double>;
+		FlatHashMap<string, double> map = {
+			P("Hello", 1.23),
+			P("World", 2.46),
+			P("Lorem", 6.89),
+			P("Ipsum", 4.87),
+		};
+		map.Erase("Hello");
+		REQUIRE(map.Size() == 3);
+		REQUIRE(!map.Contains("Hello"));
+
+		FlatHashMap<string, double>::Iterator it = map.Erase("Foo");
+		REQUIRE(map.Size() == 3);
+		REQUIRE(it == map.End());
+
+		map.Erase("World");
+		map.Erase("Ipsum");
+		map.Erase(map.Find("Lorem"));
+		REQUIRE(map.Size() == 0);
+		REQUIRE(map.Begin() == map.End());
+	}
+	SECTION("Insert after erase")
+	{
+		const int count = 5000;
+		FlatHashMap<int, int> map;
+		for (int round = 0; round < 4; ++round)
+		{
+			for (int i = 0; i < count; ++i)
+				map[i + round * count] = i;
+			for (int i = 0; i < count; i += 2)
+				map.Erase(i + round * count);
+		}
+		REQUIRE(map.Size() == (size_t)(count * 2));
+		for (int round = 0; round < 4; ++round)
+		{
+			for (int i = 0; i < count; ++i)
+				REQUIRE(map.Contains(i + round * count) == (i % 2 == 1));
+		}
+	}
+	SECTION("Erase while iterating")
+	{
+		FlatHashMap<int, int> map;
+		for (int i = 0; i < 100; ++i)
+			map[i] = i;
+		FlatHashMap<int, int>::Iterator it = map.Begin();
+		while (it != map.End())
+		{
+			if (it->Key % 3 == 0)
+				it = map.Erase(it);
+			else
+				++it;
+		}
+		REQUIRE(map.Size() == 66);
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(map.Contains(i) == (i % 3 != 0));
+	}
+}
+
+TEST_CASE("FlatHashMap - Iteration", "[FlatHashMap]")
+{
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 1000; ++i)
+		map[i] = i;
+	int sum = 0;
+	size_t count = 0;
+	for (const KeyValuePair<int, int>& pair : map)
+	{
+		sum += pair.Value;
+		++count;
+	}
+	REQUIRE(count == 1000);
+	REQUIRE(sum == 999 * 1000 / 2);
+}
+
+TEST_CASE("FlatHashMap - Clear", "[FlatHashMap]")
+{
+	FlatHashMap<string, double> map;
+	map["Hello"] = 1.0;
+	map["World"] = 2.0;
+	map.Clear();
+	REQUIRE(map.Size() == 0);
+	REQUIRE(map.Begin() == map.End());
+	REQUIRE(!map.Contains("Hello"));
+	map["Hello"] = 3.0;
+	REQUIRE(map["Hello"] == 3.0);
+}
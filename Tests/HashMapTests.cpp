@@ -1,7 +1,10 @@
 #include "../catch.hpp"
 #include "../Std/HashMap.h"
+#include "../Std/String.h"
+#include "CountedValue.h"
 #include <string>
 #include <iostream>
+#include <vector>
 using namespace StlStd;
 using namespace std;
 
@@ -324,4 +327,465 @@ TEST_CASE("HashMap - Clear", "[HashMap]")
 		map.Clear();
 		REQUIRE(map.Size() == 0);
 	}
+	SECTION("Reuse after clear")
+	{
+		using P = KeyValuePair<string, double>;
+		HashMap<string, double> map = { P("Hello", 1.23), P("World", 2.46) };
+		map.Clear();
+		REQUIRE(map.Size() == 0);
+		REQUIRE(map.Begin() == map.End());
+		REQUIRE(!map.Contains("Hello"));
+		map["Foo"] = 1.0;
+		map["Hello"] = 2.0;
+		REQUIRE(map.Size() == 2);
+		REQUIRE(map["Foo"] == 1.0);
+		REQUIRE(map["Hello"] == 2.0);
+		REQUIRE(!map.Contains("World"));
+	}
+}
+
+namespace
+{
+	//std::hash<int> is the identity with GCC and clang but not with MSVC
+	struct IdentityHash
+	{
+		size_t operator()(const int value) const { return (size_t)value; }
+	};
+}
+
+TEST_CASE("HashMap - Bucket policy", "[HashMap]")
+{
+	SECTION("Power of two")
+	{
+		HashMap<int, int> map;
+		for (int i = 0; i < 1000; ++i)
+			map[i] = i;
+		REQUIRE(map.Size() == 1000);
+		REQUIRE((map.BucketCount() & (map.BucketCount() - 1)) == 0);
+		for (int i = 0; i < 1000; ++i)
+		{
+			REQUIRE(map.Contains(i));
+			REQUIRE(map.Bucket(i) < map.BucketCount());
+		}
+		REQUIRE(!map.Contains(1000));
+	}
+	SECTION("Prime")
+	{
+		HashMap<int, int, std::hash<int>, EqualTo<int>, PrimeBucketPolicy> map;
+		REQUIRE(map.BucketCount() == PrimeBucketPolicy::BucketCount(HashMap<int, int>::START_BUCKETS));
+		for (int i = 0; i < 1000; ++i)
+			map[i] = i;
+		REQUIRE(map.Size() == 1000);
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(map[i] == i);
+		REQUIRE(!map.Contains(1000));
+	}
+	SECTION("Erase from the same bucket")
+	{
+		//Every key lands in one bucket, so the erased nodes are at the front, middle and back of the chain
+		HashMap<int, int, IdentityHash, EqualTo<int>, PrimeBucketPolicy> map;
+		const int buckets = (int)map.BucketCount();
+		for (int i = 0; i < 5; ++i)
+			map[i * buckets] = i;
+		map.Erase(4 * buckets);
+		map.Erase(2 * buckets);
+		map.Erase(0);
+		REQUIRE(map.Size() == 2);
+		REQUIRE(map.BucketSize(0) == 2);
+		REQUIRE(!map.Contains(0));
+		REQUIRE(map.Contains(buckets));
+		REQUIRE(!map.Contains(2 * buckets));
+		REQUIRE(map.Contains(3 * buckets));
+		REQUIRE(!map.Contains(4 * buckets));
+	}
+}
+
+TEST_CASE("HashMap - Incremental rehash", "[HashMap]")
+{
+	SECTION("Insert")
+	{
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(2);
+		bool rehashed = false;
+		for (int i = 0; i < 5000; ++i)
+		{
+			map[i] = i;
+			rehashed |= map.IsRehashing();
+			//Elements in both the old and the new table are found
+			REQUIRE(map.Contains(i / 2));
+			REQUIRE(map.Contains(i));
+		}
+		REQUIRE(rehashed);
+		REQUIRE(map.Size() == 5000);
+		for (int i = 0; i < 5000; ++i)
+			REQUIRE(map[i] == i);
+		REQUIRE(!map.Contains(5000));
+
+		size_t count = 0;
+		for (const KeyValuePair<int, int>& pair : map)
+			count += pair.Key == pair.Value;
+		REQUIRE(count == 5000);
+	}
+	SECTION("The old table is empty before the next grow")
+	{
+		//A step of 1 can't move the old table before the new one fills up, it is raised
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(1);
+		size_t grows = 0;
+		for (int i = 0; i < 5000; ++i)
+		{
+			const size_t bucketCount = map.BucketCount();
+			const bool wasRehashing = map.IsRehashing();
+			map[i] = i;
+			if (map.BucketCount() != bucketCount)
+			{
+				++grows;
+				REQUIRE(!wasRehashing);
+			}
+		}
+		REQUIRE(grows > 5);
+		for (int i = 0; i < 5000; ++i)
+			REQUIRE(map[i] == i);
+	}
+	SECTION("Erase while rehashing")
+	{
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(2);
+		int i = 0;
+		while (!map.IsRehashing())
+		{
+			map[i] = i;
+			++i;
+		}
+		const int count = i;
+		//Erase from the back, these are the elements that are most likely still in the old table
+		for (int j = count - 1; j >= 0; j -= 2)
+			map.Erase(j);
+		for (int j = 0; j < count; ++j)
+			REQUIRE(map.Contains(j) == (j % 2 != (count - 1) % 2));
+		REQUIRE(map.Size() == (size_t)(count / 2));
+	}
+	SECTION("Clear and disable while rehashing")
+	{
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(1);
+		int i = 0;
+		while (!map.IsRehashing())
+		{
+			map[i] = i;
+			++i;
+		}
+		HashMap<int, int> copy(map);
+		map.SetIncrementalRehash(0);
+		REQUIRE(!map.IsRehashing());
+		for (int j = 0; j < i; ++j)
+			REQUIRE(map.Contains(j));
+
+		copy.Clear();
+		REQUIRE(!copy.IsRehashing());
+		REQUIRE(copy.Size() == 0);
+		copy[1] = 2;
+		REQUIRE(copy[1] == 2);
+	}
+}
+
+TEST_CASE("HashMap - Reserve & Rehash", "[HashMap]")
+{
+	SECTION("Reserve")
+	{
+		HashMap<int, int> map;
+		map.Reserve(1000);
+		const size_t buckets = map.BucketCount();
+		REQUIRE(buckets * map.MaxLoadFactor() > 1000);
+		for (int i = 0; i < 1000; ++i)
+			map[i] = i;
+		REQUIRE(map.BucketCount() == buckets);
+		REQUIRE(map.Size() == 1000);
+
+		//Reserving less doesn't shrink the table
+		map.Reserve(10);
+		REQUIRE(map.BucketCount() == buckets);
+	}
+	SECTION("Rehash")
+	{
+		HashMap<int, int> map;
+		for (int i = 0; i < 100; ++i)
+			map[i] = i;
+		map.Rehash(1024);
+		REQUIRE(map.BucketCount() == 1024);
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(map[i] == i);
+
+		//Too few buckets for the elements are rounded up
+		map.Rehash(1);
+		REQUIRE(map.LoadFactor() < map.MaxLoadFactor());
+		REQUIRE(map.Size() == 100);
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(map.Contains(i));
+	}
+	SECTION("Rehash while rehashing incrementally")
+	{
+		HashMap<int, int> map;
+		map.SetIncrementalRehash(1);
+		int i = 0;
+		while (!map.IsRehashing())
+		{
+			map[i] = i;
+			++i;
+		}
+		map.Rehash(256);
+		REQUIRE(!map.IsRehashing());
+		REQUIRE(map.BucketCount() == 256);
+		for (int j = 0; j < i; ++j)
+			REQUIRE(map[j] == j);
+		for (int j = i; j < 1000; ++j)
+			map[j] = j;
+		REQUIRE(map.Size() == 1000);
+	}
+	SECTION("Max load factor")
+	{
+		HashMap<int, int> map;
+		for (int i = 0; i < 100; ++i)
+			map[i] = i;
+		map.SetMaxLoadFactor(0.25f);
+		REQUIRE(map.MaxLoadFactor() == 0.25f);
+		REQUIRE(map.LoadFactor() < 0.25f);
+		for (int i = 100; i < 1000; ++i)
+		{
+			map[i] = i;
+			REQUIRE(map.LoadFactor() < 0.25f);
+		}
+
+		HashMap<int, int> copy(map);
+		REQUIRE(copy.MaxLoadFactor() == 0.25f);
+		REQUIRE(copy.LoadFactor() < 0.25f);
+	}
+	SECTION("Range constructor")
+	{
+		using P = KeyValuePair<int, int>;
+		const size_t count = 1000;
+		vector<P> pairs;
+		for (size_t i = 0; i < count; ++i)
+			pairs.push_back(P((int)i, (int)i * 2));
+
+		HashMap<int, int> map(pairs.begin(), pairs.end());
+		REQUIRE(map.Size() == count);
+		REQUIRE(map.LoadFactor() < map.MaxLoadFactor());
+		//Sized once, a table that grew would be twice the size needed
+		REQUIRE(map.BucketCount() == PowerOfTwoBucketPolicy::BucketCount((size_t)(count / map.MaxLoadFactor()) + 1));
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(map[(int)i] == (int)i * 2);
+
+		HashMap<int, int> fromPointers(pairs.data(), pairs.data() + 4);
+		REQUIRE(fromPointers.Size() == 4);
+		REQUIRE(fromPointers.BucketCount() == HashMap<int, int>::START_BUCKETS);
+	}
+}
+
+namespace
+{
+	//Counts how often a key is created from an int, a lookup that converts the int first creates one
+	struct CountedKey
+	{
+		static int Conversions;
+		int Value;
+
+		//The tail node of the map holds a default key
+		CountedKey() :
+			Value(0)
+		{}
+
+		CountedKey(const int value) :
+			Value(value)
+		{
+			++Conversions;
+		}
+
+		bool operator==(const CountedKey& other) const { return Value == other.Value; }
+		bool operator==(const int value) const { return Value == value; }
+	};
+	int CountedKey::Conversions = 0;
+
+	struct CountedKeyHash
+	{
+		using IsTransparent = void;
+		size_t operator()(const CountedKey& key) const { return std::hash<int>()(key.Value); }
+		size_t operator()(const int value) const { return std::hash<int>()(value); }
+	};
+}
+
+TEST_CASE("HashMap - Transparent lookup", "[HashMap]")
+{
+	SECTION("Strings")
+	{
+		HashMap<String, int, String::Hash, EqualTo<>> map;
+		map["Hello"] = 1;
+		map["World"] = 2;
+		REQUIRE(map.Find("Hello")->Value == 1);
+		REQUIRE(map.Find(StringView("World Wide", 5))->Value == 2);
+		REQUIRE(map.Find("Foo") == map.End());
+		REQUIRE(map.Contains("World"));
+		REQUIRE(!map.Contains(StringView("Hello World")));
+
+		const HashMap<String, int, String::Hash, EqualTo<>>& constMap = map;
+		REQUIRE(constMap.Find("Hello")->Value == 1);
+
+		REQUIRE(map.Erase("Foo") == map.End());
+		map.Erase(StringView("Hello"));
+		REQUIRE(map.Size() == 1);
+		REQUIRE(!map.Contains("Hello"));
+		REQUIRE(map.Contains(String("World")));
+	}
+	SECTION("No key is created")
+	{
+		HashMap<CountedKey, int, CountedKeyHash, EqualTo<>> map;
+		for (int i = 0; i < 100; ++i)
+			map.Insert(CountedKey(i), i);
+
+		CountedKey::Conversions = 0;
+		for (int i = 0; i < 200; ++i)
+			REQUIRE(map.Contains(i) == (i < 100));
+		REQUIRE(map.Find(5)->Value == 5);
+		map.Erase(5);
+		REQUIRE(!map.Contains(5));
+		REQUIRE(CountedKey::Conversions == 0);
+
+		//Without transparent functors the int is converted to a key first
+		HashMap<CountedKey, int, CountedKeyHash> opaque;
+		opaque.Insert(CountedKey(1), 1);
+		CountedKey::Conversions = 0;
+		REQUIRE(opaque.Contains(1));
+		REQUIRE(CountedKey::Conversions == 1);
+	}
+}
+
+TEST_CASE("HashMap - Emplace", "[HashMap]")
+{
+	using P = KeyValuePair<int, CountedValue>;
+	HashMap<int, CountedValue> map;
+	CountedValue::Reset();
+
+	SECTION("Emplace")
+	{
+		HashMap<int, CountedValue>::Iterator it = map.Emplace(1, 2, 3);
+		REQUIRE(it->Key == 1);
+		REQUIRE(it->Value.A == 2);
+		REQUIRE(it->Value.B == 3);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+
+		//An existing value is replaced by moving a new one in
+		map.Emplace(1, 4, 5);
+		REQUIRE(map[1].A == 4);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 1);
+	}
+	SECTION("Replace an existing value")
+	{
+		map.Insert(1, CountedValue(2, 3));
+		CountedValue::Reset();
+
+		//A value argument is assigned straight into the existing slot
+		const CountedValue value(4, 5);
+		map.Insert(1, value);
+		REQUIRE(map[1].A == 4);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 1);
+		REQUIRE(CountedValue::Moves == 0);
+
+		map.Insert(1, CountedValue(6, 7));
+		REQUIRE(map[1].A == 6);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Copies == 1);
+		REQUIRE(CountedValue::Moves == 1);
+		REQUIRE(map.Size() == 1);
+	}
+	SECTION("TryEmplace")
+	{
+		Pair<HashMap<int, CountedValue>::Iterator, bool> result = map.TryEmplace(1, 2, 3);
+		REQUIRE(result.Second);
+		REQUIRE(result.First->Value.A == 2);
+		REQUIRE(CountedValue::Constructions == 1);
+
+		result = map.TryEmplace(1, 4, 5);
+		REQUIRE(!result.Second);
+		REQUIRE(result.First->Value.A == 2);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+	}
+	SECTION("Insert rvalue")
+	{
+		map.Insert(1, CountedValue(2, 3));
+		REQUIRE(map[1].B == 3);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Moves == 1);
+
+		map.Insert(P(InPlace(), 2, 4, 5));
+		REQUIRE(map[2].B == 5);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Moves == 2);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(map.Size() == 2);
+	}
+	SECTION("Operator[]")
+	{
+		map[1].A = 7;
+		REQUIRE(map[1].A == 7);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+	}
+	SECTION("Many")
+	{
+		for (int i = 0; i < 1000; ++i)
+			map.Emplace(i + 10, i, i);
+		REQUIRE(CountedValue::Constructions == 1000);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(map.Find(i + 10)->Value.A == i);
+	}
+}
+
+TEST_CASE("HashMap - Emplace String", "[HashMap]")
+{
+	HashMap<String, String, String::Hash> map;
+	String key("A key that is long enough to be allocated");
+	String value("A value that is long enough to be allocated");
+	const char* pKey = key.Data();
+	const char* pValue = value.Data();
+	map.Insert(Move(key), Move(value));
+	REQUIRE(map.Find("A key that is long enough to be allocated")->Key.Data() == pKey);
+	REQUIRE(map["A key that is long enough to be allocated"].Data() == pValue);
+
+	map.Emplace("Hello", "World");
+	REQUIRE(map["Hello"] == "World");
+	REQUIRE(map.Size() == 2);
+}
+
+TEST_CASE("HashMap - ShrinkToFit", "[HashMap]")
+{
+	CountingResource counter;
+	HashMap<int, int> map(&counter);
+	for (int i = 0; i < 10000; ++i)
+		map.Insert(i, i);
+	const size_t peakBytes = counter.BytesInUse();
+	const size_t peakBuckets = map.BucketCount();
+	REQUIRE(map.MemoryStats().BytesReserved == peakBytes);
+
+	for (int i = 100; i < 10000; ++i)
+		map.Erase(i);
+	map.ShrinkToFit();
+	REQUIRE(map.BucketCount() < peakBuckets);
+	REQUIRE(counter.BytesInUse() < peakBytes / 10);
+	REQUIRE(map.MemoryStats().BytesReserved == counter.BytesInUse());
+	for (int i = 0; i < 100; ++i)
+		REQUIRE(map[i] == i);
+	for (int i = 100; i < 1000; ++i)
+		map.Insert(i, i);
+	REQUIRE(map.Size() == 1000);
+	REQUIRE(map.Find(999)->Value == 999);
 }
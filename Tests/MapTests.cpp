@@ -1,5 +1,7 @@
 #include "../catch.hpp"
 #include "../Std/Map.h"
+#include "../Std/String.h"
+#include "CountedValue.h"
 
 using namespace StlStd;
 using namespace std;
@@ -438,3 +440,156 @@ TEST_CASE("Map - Clear", "[HashMap]")
 		REQUIRE(map.Size() == 0);
 	}
 }
+
+TEST_CASE("Map - Transparent lookup", "[Map]")
+{
+	Map<String, int, LessThan<>> map;
+	map["Banana"] = 2;
+	map["Apple"] = 1;
+	map["Cherry"] = 3;
+	REQUIRE(map.Find("Apple")->Value == 1);
+	REQUIRE(map.Find(StringView("Cherry Pie", 6))->Value == 3);
+	REQUIRE(map.Find("Apples") == map.End());
+	REQUIRE(map.Contains("Banana"));
+	REQUIRE(!map.Contains(StringView("Ban")));
+
+	const Map<String, int, LessThan<>>& constMap = map;
+	REQUIRE(constMap.Find("Banana")->Value == 2);
+
+	map.Erase("Banana");
+	map.Erase(StringView("Apple"));
+	REQUIRE(map.Size() == 1);
+	REQUIRE(!map.Contains("Apple"));
+	REQUIRE(map.Contains(String("Cherry")));
+}
+
+TEST_CASE("Map - Emplace", "[Map]")
+{
+	using P = KeyValuePair<int, CountedValue>;
+	Map<int, CountedValue> map;
+	//The first insert creates the root node
+	map.Emplace(0, 0, 0);
+	CountedValue::Reset();
+
+	SECTION("Emplace")
+	{
+		Map<int, CountedValue>::Iterator it = map.Emplace(1, 2, 3);
+		REQUIRE(it->Key == 1);
+		REQUIRE(it->Value.A == 2);
+		REQUIRE(it->Value.B == 3);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+
+		//An existing value is replaced by moving a new one in
+		map.Emplace(1, 4, 5);
+		REQUIRE(map[1].A == 4);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 1);
+	}
+	SECTION("Replace an existing value")
+	{
+		map.Insert(1, CountedValue(2, 3));
+		CountedValue::Reset();
+
+		//A value argument is assigned straight into the existing slot
+		const CountedValue value(4, 5);
+		map.Insert(1, value);
+		REQUIRE(map[1].A == 4);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 1);
+		REQUIRE(CountedValue::Moves == 0);
+
+		map.Insert(1, CountedValue(6, 7));
+		REQUIRE(map[1].A == 6);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Copies == 1);
+		REQUIRE(CountedValue::Moves == 1);
+		REQUIRE(map.Size() == 2);
+	}
+	SECTION("TryEmplace")
+	{
+		Pair<Map<int, CountedValue>::Iterator, bool> result = map.TryEmplace(1, 2, 3);
+		REQUIRE(result.Second);
+		REQUIRE(result.First->Value.A == 2);
+		REQUIRE(CountedValue::Constructions == 1);
+
+		result = map.TryEmplace(1, 4, 5);
+		REQUIRE(!result.Second);
+		REQUIRE(result.First->Value.A == 2);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+	}
+	SECTION("Insert rvalue")
+	{
+		map.Insert(1, CountedValue(2, 3));
+		REQUIRE(map[1].B == 3);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Moves == 1);
+
+		map.Insert(P(InPlace(), 2, 4, 5));
+		REQUIRE(map[2].B == 5);
+		REQUIRE(CountedValue::Constructions == 2);
+		REQUIRE(CountedValue::Moves == 2);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(map.Size() == 3);
+	}
+	SECTION("Operator[]")
+	{
+		map[1].A = 7;
+		REQUIRE(map[1].A == 7);
+		REQUIRE(CountedValue::Constructions == 1);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+	}
+	SECTION("Many")
+	{
+		for (int i = 0; i < 1000; ++i)
+			map.Emplace(i + 10, i, i);
+		REQUIRE(CountedValue::Constructions == 1000);
+		REQUIRE(CountedValue::Copies == 0);
+		REQUIRE(CountedValue::Moves == 0);
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(map.Find(i + 10)->Value.A == i);
+	}
+}
+
+TEST_CASE("Map - Emplace String", "[Map]")
+{
+	Map<String, String> map;
+	String key("A key that is long enough to be allocated");
+	String value("A value that is long enough to be allocated");
+	const char* pKey = key.Data();
+	const char* pValue = value.Data();
+	map.Insert(Move(key), Move(value));
+	REQUIRE(map.Find("A key that is long enough to be allocated")->Key.Data() == pKey);
+	REQUIRE(map["A key that is long enough to be allocated"].Data() == pValue);
+
+	map.Emplace("Hello", "World");
+	REQUIRE(map["Hello"] == "World");
+	REQUIRE(map.Size() == 2);
+}
+
+TEST_CASE("Map - ShrinkToFit", "[Map]")
+{
+	CountingResource counter;
+	Map<int, int> map(&counter);
+	for (int i = 0; i < 10000; ++i)
+		map.Insert(i, i);
+	const size_t peakBytes = counter.BytesInUse();
+	REQUIRE(map.MemoryStats().BytesReserved == peakBytes);
+
+	for (int i = 100; i < 10000; ++i)
+		map.Erase(i);
+	map.ShrinkToFit();
+	REQUIRE(counter.BytesInUse() < peakBytes / 10);
+	BlockAllocator::Stats stats = map.MemoryStats();
+	REQUIRE(stats.BytesReserved == counter.BytesInUse());
+	REQUIRE(stats.BytesInUse < stats.BytesReserved);
+	for (int i = 0; i < 100; ++i)
+		REQUIRE(map[i] == i);
+	map.Insert(20000, 1);
+	REQUIRE(map.Size() == 101);
+}
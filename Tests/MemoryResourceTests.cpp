@@ -0,0 +1,240 @@
+#include "../catch.hpp"
+#include "../Std/MemoryResource.h"
+#include "../Std/Vector.h"
+#include "../Std/String.h"
+#include "../Std/Map.h"
+#include "../Std/HashMap.h"
+using namespace StlStd;
+
+#pragma region Resources
+
+TEST_CASE("MemoryResource - Default", "[MemoryResource]")
+{
+	REQUIRE(GetDefaultResource() == GetNewDeleteResource());
+	CountingResource counter;
+	MemoryResource* pPrevious = SetDefaultResource(&counter);
+	REQUIRE(pPrevious == GetNewDeleteResource());
+	REQUIRE(GetDefaultResource() == &counter);
+	{
+		Vector<int> v;
+		v.Push(1);
+		REQUIRE(v.GetResource() == &counter);
+		REQUIRE(counter.AllocationCount() == 1);
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+	SetDefaultResource(nullptr);
+	REQUIRE(GetDefaultResource() == GetNewDeleteResource());
+}
+
+TEST_CASE("MemoryResource - Monotonic", "[MemoryResource]")
+{
+	SECTION("Alignment")
+	{
+		MonotonicResource arena(64);
+		char* pChar = static_cast<char*>(arena.Allocate(1, 1));
+		double* pDouble = static_cast<double*>(arena.Allocate(sizeof(double), alignof(double)));
+		REQUIRE((uintptr_t)pDouble % alignof(double) == 0);
+		REQUIRE((char*)pDouble > pChar);
+		void* pAligned = arena.Allocate(8, 32);
+		REQUIRE((uintptr_t)pAligned % 32 == 0);
+	}
+	SECTION("Chunks from upstream")
+	{
+		CountingResource counter;
+		{
+			MonotonicResource arena(128, &counter);
+			for (int i = 0; i < 100; ++i)
+				arena.Allocate(16);
+			//Chunks of 128, 256, 512 and 1024 bytes hold the 1600 bytes and the chunk headers
+			REQUIRE(counter.AllocationCount() == 4);
+			void* pLarge = arena.Allocate(10000);
+			REQUIRE(pLarge != nullptr);
+			REQUIRE(counter.AllocationCount() == 5);
+			arena.Release();
+			REQUIRE(counter.LiveAllocations() == 0);
+			arena.Allocate(16);
+			REQUIRE(counter.LiveAllocations() == 1);
+		}
+		REQUIRE(counter.LiveAllocations() == 0);
+		REQUIRE(counter.BytesInUse() == 0);
+	}
+	SECTION("Initial buffer")
+	{
+		CountingResource counter;
+		char buffer[256];
+		MonotonicResource arena(buffer, sizeof(buffer), &counter);
+		char* pFirst = static_cast<char*>(arena.Allocate(100, 1));
+		REQUIRE(pFirst == buffer);
+		arena.Allocate(100, 1);
+		REQUIRE(counter.AllocationCount() == 0);
+		arena.Allocate(100, 1);
+		REQUIRE(counter.AllocationCount() == 1);
+		arena.Release();
+		REQUIRE(counter.LiveAllocations() == 0);
+		REQUIRE(arena.Allocate(1, 1) == buffer);
+	}
+}
+
+TEST_CASE("MemoryResource - Counting", "[MemoryResource]")
+{
+	CountingResource counter;
+	void* pA = counter.Allocate(100);
+	void* pB = counter.Allocate(50);
+	REQUIRE(counter.AllocationCount() == 2);
+	REQUIRE(counter.BytesInUse() == 150);
+	counter.Deallocate(pA, 100);
+	REQUIRE(counter.BytesInUse() == 50);
+	REQUIRE(counter.PeakBytesInUse() == 150);
+	REQUIRE(counter.BytesAllocated() == 150);
+	REQUIRE(counter.LiveAllocations() == 1);
+	counter.Deallocate(pB, 50);
+	REQUIRE(counter.DeallocationCount() == 2);
+	REQUIRE(counter.BytesInUse() == 0);
+}
+
+#pragma endregion Resources
+
+#pragma region Containers
+
+TEST_CASE("MemoryResource - Vector", "[MemoryResource]")
+{
+	CountingResource counter;
+	{
+		Vector<String> v(counter);
+		for (int i = 0; i < 100; ++i)
+			v.Push(String::Printf("Item %d", i));
+		REQUIRE(counter.LiveAllocations() == 1);
+		REQUIRE(counter.BytesInUse() == v.Capacity() * sizeof(String));
+
+		Vector<String> copy(v);
+		REQUIRE(copy.GetResource() == GetDefaultResource());
+		Vector<String> arenaCopy(v, &counter);
+		REQUIRE(counter.LiveAllocations() == 2);
+
+		Vector<String> moved(Move(v));
+		REQUIRE(moved.GetResource() == &counter);
+		moved.ShrinkToFit();
+		REQUIRE(moved[99] == "Item 99");
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+	REQUIRE(counter.BytesInUse() == 0);
+}
+
+TEST_CASE("MemoryResource - String", "[MemoryResource]")
+{
+	CountingResource counter;
+	SECTION("Short strings")
+	{
+		String s("Hello", &counter);
+		REQUIRE(s.IsLarge());
+		REQUIRE(s.GetResource() == &counter);
+		REQUIRE(counter.LiveAllocations() == 1);
+		s.ShrinkToFit();
+		REQUIRE(s.GetResource() == &counter);
+		REQUIRE(s == "Hello");
+
+		String local("Hello");
+		REQUIRE(!local.IsLarge());
+		REQUIRE(local.GetResource() == GetDefaultResource());
+	}
+	SECTION("Growth stays in the resource")
+	{
+		String s(&counter);
+		for (int i = 0; i < 100; ++i)
+			s.AppendNumber(i);
+		REQUIRE(s.GetResource() == &counter);
+		REQUIRE(counter.LiveAllocations() == 1);
+		REQUIRE(counter.AllocationCount() > 1);
+
+		String copy(s);
+		REQUIRE(copy.GetResource() == GetDefaultResource());
+		REQUIRE(copy == s);
+
+		String moved(Move(s));
+		REQUIRE(moved.GetResource() == &counter);
+		REQUIRE(counter.LiveAllocations() == 1);
+		s = "Assigned";
+		REQUIRE(s.GetResource() == GetDefaultResource());
+	}
+	SECTION("Default strings")
+	{
+		MemoryResource* pPrevious = SetDefaultResource(&counter);
+		{
+			String local("Short");
+			String large("A string that doesn't fit in the object");
+			REQUIRE(counter.LiveAllocations() == 1);
+			REQUIRE(large.GetResource() == &counter);
+			SetDefaultResource(pPrevious);
+			//The buffer goes back to the resource it came from
+			large.Append(" and grows");
+			REQUIRE(large.GetResource() == &counter);
+		}
+		SetDefaultResource(pPrevious);
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+	REQUIRE(counter.BytesInUse() == 0);
+}
+
+TEST_CASE("MemoryResource - Map", "[MemoryResource]")
+{
+	CountingResource counter;
+	{
+		Map<int, String> map(&counter);
+		REQUIRE(map.GetResource() == &counter);
+		for (int i = 0; i < 1000; ++i)
+			map.Insert(i, String::Printf("%d", i));
+		REQUIRE(counter.LiveAllocations() > 0);
+		REQUIRE(map.Find(500)->Value == "500");
+
+		Map<int, int> list({ { 1, 2 }, { 3, 4 } }, &counter);
+		REQUIRE(list.GetResource() == &counter);
+		REQUIRE(list.Size() == 2);
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+	REQUIRE(counter.BytesInUse() == 0);
+}
+
+TEST_CASE("MemoryResource - HashMap", "[MemoryResource]")
+{
+	CountingResource counter;
+	SECTION("Nodes and table")
+	{
+		HashMap<int, int> map(&counter);
+		REQUIRE(map.GetResource() == &counter);
+		for (int i = 0; i < 1000; ++i)
+			map.Insert(i, i * 2);
+		REQUIRE(map.Find(999)->Value == 1998);
+		const size_t inUse = counter.BytesInUse();
+		map.Clear();
+		REQUIRE(counter.BytesInUse() == inUse);
+
+		HashMap<int, int> copy(map, &counter);
+		REQUIRE(copy.GetResource() == &counter);
+	}
+	SECTION("Incremental rehash")
+	{
+		HashMap<int, int> map(&counter);
+		map.SetIncrementalRehash(2);
+		for (int i = 0; i < 1000; ++i)
+			map.Insert(i, i);
+		map.Rehash(0);
+		for (int i = 0; i < 1000; ++i)
+			REQUIRE(map.Contains(i));
+	}
+	SECTION("Arena")
+	{
+		MonotonicResource arena(4096, &counter);
+		{
+			HashMap<String, int, String::Hash> map(&arena);
+			map.Reserve(100);
+			for (int i = 0; i < 100; ++i)
+				map.Insert(String::Printf("%d", i), i);
+			REQUIRE(map["42"] == 42);
+		}
+		REQUIRE(counter.LiveAllocations() > 0);
+	}
+	REQUIRE(counter.LiveAllocations() == 0);
+	REQUIRE(counter.BytesInUse() == 0);
+}
+
+#pragma endregion Containers
@@ -0,0 +1,82 @@
+#include "../catch.hpp"
+#include "../Std/ParallelSort.h"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include "SortShapes.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	struct Record
+	{
+		int Key;
+		int Order;
+	};
+}
+
+TEST_CASE("ParallelSort - Shapes", "[ParallelSort]")
+{
+	TaskScheduler scheduler(4);
+	for (Vector<uint64_t>& values : MakeSortShapes<uint64_t>(300000, 42))
+	{
+		const std::vector<uint64_t> expected = StdSorted(values);
+
+		Vector<uint64_t> stable = values;
+		ParallelStableSort(stable.Begin(), stable.End(), LessThan<>(), scheduler);
+		ParallelSort(values.Begin(), values.End(), LessThan<>(), scheduler);
+		REQUIRE(Equals(values, expected));
+		REQUIRE(Equals(stable, expected));
+	}
+}
+
+TEST_CASE("ParallelSort - Stable", "[ParallelSort]")
+{
+	TaskScheduler scheduler(3);
+	Vector<Record> records;
+	srand(7);
+	for (int i = 0; i < 200000; ++i)
+		records.Push(Record{ rand() % 1000, i });
+	ParallelStableSort(records.Begin(), records.End(), [](const Record& a, const Record& b) { return a.Key < b.Key; }, scheduler);
+	//Equal keys keep the order they were pushed in
+	REQUIRE(IsSorted(records.Begin(), records.End(), [](const Record& a, const Record& b)
+	{
+		return a.Key < b.Key || (a.Key == b.Key && a.Order < b.Order);
+	}));
+}
+
+TEST_CASE("ParallelSort - Default scheduler and small ranges", "[ParallelSort]")
+{
+	Vector<int> values;
+	ParallelSort(values.Begin(), values.End());
+	for (int i = 0; i < 100000; ++i)
+		values.Push((i * 7919) % 100000);
+	ParallelSort(values.Begin(), values.End());
+	REQUIRE(IsSorted(values.Begin(), values.End()));
+	REQUIRE(values[0] == 0);
+	REQUIRE(values[99999] == 99999);
+	ParallelStableSort(values.Begin(), values.End(), GreaterThan<>());
+	REQUIRE(values[0] == 99999);
+
+	int small[] = { 3, 1, 2 };
+	ParallelSort(small, small + 3);
+	REQUIRE(small[0] == 1);
+	REQUIRE(small[2] == 3);
+}
+
+TEST_CASE("ParallelSort - Strings", "[ParallelSort]")
+{
+	//The elements are moved between the range and the buffer, nothing is copied or leaked
+	TaskScheduler scheduler(4);
+	Vector<String> strings;
+	for (int i = 0; i < 100000; ++i)
+		strings.Push(String::Printf("A string that doesn't fit in the object %d", (i * 31) % 100000));
+	ParallelSort(strings.Begin(), strings.End(), LessThan<>(), scheduler);
+	REQUIRE(IsSorted(strings.Begin(), strings.End()));
+	REQUIRE(strings[0] == "A string that doesn't fit in the object 0");
+	ParallelStableSort(strings.Begin(), strings.End(), GreaterThan<>(), scheduler);
+	REQUIRE(IsSorted(strings.Begin(), strings.End(), GreaterThan<>()));
+}
@@ -0,0 +1,251 @@
+#include "../catch.hpp"
+#include "../Std/PriorityQueue.h"
+#include "../Std/Sorting.h"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include <stdlib.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	//Pushes the values, pops them all and checks they come out sorted
+	template<typename Queue>
+	void CheckOrder(Queue& queue, std::vector<int> values)
+	{
+		for (int value : values)
+			queue.Push(value);
+		REQUIRE(queue.Size() == values.size());
+		std::sort(values.begin(), values.end());
+		for (int value : values)
+		{
+			REQUIRE(queue.Top() == value);
+			REQUIRE(queue.Pop() == value);
+		}
+		REQUIRE(queue.Empty());
+	}
+}
+
+TEST_CASE("PriorityQueue - Order", "[PriorityQueue]")
+{
+	srand(21);
+	std::vector<int> values;
+	for (int i = 0; i < 5000; ++i)
+		values.push_back(rand() % 1000);
+
+	SECTION("Binary")
+	{
+		PriorityQueue<int, GreaterThan<int>, 2> queue;
+		CheckOrder(queue, values);
+	}
+	SECTION("4-ary")
+	{
+		PriorityQueue<int, GreaterThan<int>> queue;
+		CheckOrder(queue, values);
+	}
+	SECTION("8-ary")
+	{
+		PriorityQueue<int, GreaterThan<int>, 8> queue;
+		CheckOrder(queue, values);
+	}
+	SECTION("Largest first")
+	{
+		//The default LessThan keeps the largest on top, like MakeHeap and std::priority_queue
+		PriorityQueue<int> queue;
+		for (int value : values)
+			queue.Push(value);
+		std::vector<int> heap = values;
+		MakeHeap(heap.data(), heap.data() + heap.size());
+		REQUIRE(queue.Top() == heap[0]);
+		std::sort(values.begin(), values.end(), std::greater<int>());
+		for (int value : values)
+			REQUIRE(queue.Pop() == value);
+	}
+	SECTION("Interleaved")
+	{
+		PriorityQueue<int, GreaterThan<int>> queue;
+		std::vector<int> reference;
+		for (int value : values)
+		{
+			queue.Push(value);
+			reference.push_back(value);
+			if (value % 3 == 0)
+			{
+				std::vector<int>::iterator smallest = std::min_element(reference.begin(), reference.end());
+				REQUIRE(queue.Pop() == *smallest);
+				reference.erase(smallest);
+			}
+		}
+		REQUIRE(queue.Size() == reference.size());
+	}
+	SECTION("From a range")
+	{
+		const size_t sizes[] = { 0, 1, 2, 3, 4, 5, 6, 17, values.size() };
+		for (size_t size : sizes)
+		{
+			PriorityQueue<int, GreaterThan<int>> queue(values.data(), values.data() + size);
+			std::vector<int> expected(values.begin(), values.begin() + size);
+			std::sort(expected.begin(), expected.end());
+			for (int value : expected)
+				REQUIRE(queue.Pop() == value);
+		}
+	}
+}
+
+TEST_CASE("PriorityQueue - Elements", "[PriorityQueue]")
+{
+	SECTION("Moves strings")
+	{
+		PriorityQueue<String> queue;
+		for (int i = 0; i < 100; ++i)
+			queue.Emplace(String::Printf("A string that doesn't fit in the object %03d", (i * 37) % 100));
+		for (int i = 99; i >= 0; --i)
+			REQUIRE(queue.Pop() == String::Printf("A string that doesn't fit in the object %03d", i));
+	}
+	SECTION("Memory comes from the resource")
+	{
+		CountingResource counter;
+		{
+			PriorityQueue<int> queue(&counter);
+			for (int i = 0; i < 100; ++i)
+				queue.Push(i);
+			REQUIRE(counter.LiveAllocations() == 1);
+			queue.Clear();
+			REQUIRE(queue.Empty());
+		}
+		REQUIRE(counter.LiveAllocations() == 0);
+	}
+	SECTION("Compare functor with state")
+	{
+		std::vector<int> weights = { 5, 1, 4, 2, 3 };
+		auto byWeight = [&weights](int a, int b) { return weights[a] < weights[b]; };
+		PriorityQueue<int, decltype(byWeight)> queue(byWeight);
+		for (int i = 0; i < 5; ++i)
+			queue.Push(i);
+		//The heaviest comes out first
+		REQUIRE(queue.Pop() == 0);
+		REQUIRE(queue.Pop() == 2);
+		REQUIRE(queue.Pop() == 4);
+	}
+}
+
+TEST_CASE("PriorityQueue - Indexed", "[PriorityQueue]")
+{
+	SECTION("DecreaseKey, Update and Remove")
+	{
+		IndexedPriorityQueue<double> queue(10);
+		for (size_t id = 0; id < 10; ++id)
+			queue.Push(id, 100.0 + id);
+		REQUIRE(queue.Top() == 0);
+		queue.DecreaseKey(7, 1.0);
+		REQUIRE(queue.Top() == 7);
+		REQUIRE(queue.TopPriority() == 1.0);
+		queue.Update(7, 200.0);
+		REQUIRE(queue.Top() == 0);
+		queue.Update(3, 0.5);
+		REQUIRE(queue.Top() == 3);
+		REQUIRE(queue.Remove(3));
+		REQUIRE(!queue.Remove(3));
+		REQUIRE(!queue.Contains(3));
+		REQUIRE(queue.GetPriority(7) == 200.0);
+
+		const size_t expected[] = { 0, 1, 2, 4, 5, 6, 8, 9, 7 };
+		for (size_t id : expected)
+			REQUIRE(queue.Pop() == id);
+		REQUIRE(queue.Empty());
+	}
+	SECTION("Largest first")
+	{
+		//With LessThan DecreaseKey takes a larger priority
+		IndexedPriorityQueue<int, LessThan<int>> queue(4);
+		for (size_t id = 0; id < 4; ++id)
+			queue.Push(id, (int)id);
+		REQUIRE(queue.Top() == 3);
+		queue.DecreaseKey(1, 10);
+		REQUIRE(queue.Top() == 1);
+		const size_t expected[] = { 1, 3, 2, 0 };
+		for (size_t id : expected)
+			REQUIRE(queue.Pop() == id);
+	}
+	SECTION("Against a reference")
+	{
+		srand(22);
+		const size_t idCount = 2000;
+		IndexedPriorityQueue<int, GreaterThan<int>, 2> queue;
+		std::vector<int> reference(idCount, std::numeric_limits<int>::max());
+		for (int step = 0; step < 50000; ++step)
+		{
+			const size_t id = rand() % idCount;
+			const int priority = rand() % 100000;
+			switch (rand() % 4)
+			{
+			case 0:
+				queue.Update(id, priority);
+				reference[id] = priority;
+				break;
+			case 1:
+				if (queue.Contains(id) && priority < queue.GetPriority(id))
+				{
+					queue.DecreaseKey(id, priority);
+					reference[id] = priority;
+				}
+				break;
+			case 2:
+				REQUIRE(queue.Remove(id) == (reference[id] != std::numeric_limits<int>::max()));
+				reference[id] = std::numeric_limits<int>::max();
+				break;
+			default:
+				if (!queue.Empty())
+				{
+					const int smallest = *std::min_element(reference.begin(), reference.end());
+					REQUIRE(queue.TopPriority() == smallest);
+					const size_t top = queue.Pop();
+					REQUIRE(reference[top] == smallest);
+					reference[top] = std::numeric_limits<int>::max();
+				}
+			}
+		}
+		size_t count = 0;
+		for (int priority : reference)
+			count += priority != std::numeric_limits<int>::max() ? 1 : 0;
+		REQUIRE(queue.Size() == count);
+		queue.Clear();
+		REQUIRE(queue.Empty());
+		for (size_t id = 0; id < idCount; ++id)
+			REQUIRE(!queue.Contains(id));
+	}
+	SECTION("Dijkstra on a grid")
+	{
+		//Every cell costs its weight to enter, the shortest path goes around the expensive wall
+		const size_t width = 30;
+		std::vector<int> weights(width * width, 1);
+		for (size_t y = 0; y + 1 < width; ++y)
+			weights[y * width + width / 2] = 1000;
+		std::vector<int> distances(width * width, std::numeric_limits<int>::max());
+		IndexedPriorityQueue<int> queue(width * width);
+		distances[0] = 0;
+		queue.Push(0, 0);
+		while (!queue.Empty())
+		{
+			const size_t cell = queue.Pop();
+			const size_t x = cell % width;
+			const size_t y = cell / width;
+			const size_t neighbors[] = { x > 0 ? cell - 1 : cell, x + 1 < width ? cell + 1 : cell, y > 0 ? cell - width : cell, y + 1 < width ? cell + width : cell };
+			for (size_t neighbor : neighbors)
+			{
+				const int distance = distances[cell] + weights[neighbor];
+				if (neighbor == cell || distance >= distances[neighbor])
+					continue;
+				if (queue.Contains(neighbor))
+					queue.DecreaseKey(neighbor, distance);
+				else
+					queue.Push(neighbor, distance);
+				distances[neighbor] = distance;
+			}
+		}
+		//Down the left side, through the gap in the last row, and back up
+		REQUIRE(distances[width - 1] == (int)(2 * (width - 1) + width - 1));
+	}
+}
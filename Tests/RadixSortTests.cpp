@@ -0,0 +1,203 @@
+#include "../catch.hpp"
+#include "../Std/Array.h"
+#include "../Std/RadixSort.h"
+#include "../Std/String.h"
+#include "../Std/Vector.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	struct Record
+	{
+		int64_t Key;
+		size_t Order;
+	};
+
+	uint64_t Random64()
+	{
+		return ((uint64_t)rand() << 60) ^ ((uint64_t)rand() << 45) ^ ((uint64_t)rand() << 30) ^ ((uint64_t)rand() << 15) ^ (uint64_t)rand();
+	}
+
+	//Sorts the values with every digit size and compares to std::sort
+	template<typename T>
+	void CheckRadixSort(const std::vector<T>& input)
+	{
+		std::vector<T> expected = input;
+		std::sort(expected.begin(), expected.end());
+		Vector<T> values8, values11, values16, valuesDefault;
+		for (const T& value : input)
+		{
+			values8.Push(value);
+			values11.Push(value);
+			values16.Push(value);
+			valuesDefault.Push(value);
+		}
+		RadixSort<8>(values8.Begin(), values8.End());
+		RadixSort<11>(values11.Begin(), values11.End());
+		RadixSort<16>(values16.Begin(), values16.End());
+		RadixSort(valuesDefault.Begin(), valuesDefault.End());
+		REQUIRE(std::equal(expected.begin(), expected.end(), values8.Data()));
+		REQUIRE(std::equal(expected.begin(), expected.end(), values11.Data()));
+		REQUIRE(std::equal(expected.begin(), expected.end(), values16.Data()));
+		REQUIRE(std::equal(expected.begin(), expected.end(), valuesDefault.Data()));
+	}
+}
+
+TEST_CASE("RadixSort - Integers", "[RadixSort]")
+{
+	srand(11);
+	const size_t sizes[] = { 0, 1, 2, 100, 255, 256, 1000, 100000 };
+	for (const size_t size : sizes)
+	{
+		std::vector<uint32_t> u32;
+		std::vector<int32_t> i32;
+		std::vector<uint64_t> u64;
+		std::vector<int64_t> i64;
+		std::vector<int16_t> i16;
+		std::vector<uint8_t> u8;
+		for (size_t i = 0; i < size; ++i)
+		{
+			const uint64_t random = Random64();
+			u32.push_back((uint32_t)random);
+			i32.push_back((int32_t)random);
+			u64.push_back(random);
+			i64.push_back((int64_t)random);
+			i16.push_back((int16_t)random);
+			u8.push_back((uint8_t)random);
+		}
+		CheckRadixSort(u32);
+		CheckRadixSort(i32);
+		CheckRadixSort(u64);
+		CheckRadixSort(i64);
+		CheckRadixSort(i16);
+		CheckRadixSort(u8);
+	}
+
+	SECTION("Extremes and few unique values")
+	{
+		std::vector<int64_t> values;
+		for (int i = 0; i < 1000; ++i)
+		{
+			values.push_back(std::numeric_limits<int64_t>::min() + i % 3);
+			values.push_back(std::numeric_limits<int64_t>::max() - i % 3);
+			values.push_back(i % 5 - 2);
+		}
+		CheckRadixSort(values);
+	}
+}
+
+TEST_CASE("RadixSort - Floating point", "[RadixSort]")
+{
+	srand(12);
+	std::vector<float> floats;
+	std::vector<double> doubles;
+	for (int i = 0; i < 50000; ++i)
+	{
+		const double value = ((double)rand() - RAND_MAX / 2) * (rand() % 2 ? 1e-3 : 1e6);
+		floats.push_back((float)value);
+		doubles.push_back(value);
+	}
+	floats.push_back(std::numeric_limits<float>::infinity());
+	floats.push_back(-std::numeric_limits<float>::infinity());
+	floats.push_back(std::numeric_limits<float>::denorm_min());
+	floats.push_back(-std::numeric_limits<float>::max());
+	doubles.push_back(std::numeric_limits<double>::infinity());
+	doubles.push_back(-std::numeric_limits<double>::infinity());
+	doubles.push_back(-std::numeric_limits<double>::denorm_min());
+	doubles.push_back(std::numeric_limits<double>::max());
+	CheckRadixSort(floats);
+	CheckRadixSort(doubles);
+
+	SECTION("Negative zero comes first")
+	{
+		Vector<double> zeros;
+		for (int i = 0; i < 300; ++i)
+			zeros.Push(i % 2 ? 0.0 : -0.0);
+		RadixSort(zeros.Begin(), zeros.End());
+		REQUIRE(std::signbit(zeros[149]));
+		REQUIRE(!std::signbit(zeros[150]));
+	}
+}
+
+TEST_CASE("RadixSort - Key extractor", "[RadixSort]")
+{
+	srand(13);
+	Vector<Record> records;
+	for (size_t i = 0; i < 20000; ++i)
+		records.Push(Record{ (int64_t)(rand() % 2000) - 1000, i });
+	auto key = [](const Record& record) { return record.Key; };
+	//Equal keys keep the order they were pushed in
+	auto byKeyAndOrder = [](const Record& a, const Record& b) { return a.Key < b.Key || (a.Key == b.Key && a.Order < b.Order); };
+
+	SECTION("Stable")
+	{
+		RadixSort(records.Begin(), records.End(), key);
+		REQUIRE(IsSorted(records.Begin(), records.End(), byKeyAndOrder));
+	}
+	SECTION("Field by reference")
+	{
+		RadixSort<16>(records.Begin(), records.End(), [](const Record& record) -> const int64_t& { return record.Key; });
+		REQUIRE(IsSorted(records.Begin(), records.End(), [](const Record& a, const Record& b) { return a.Key < b.Key; }));
+	}
+	SECTION("Buffers come from the resource")
+	{
+		CountingResource counter;
+		RadixSort(records.Begin(), records.End(), key, &counter);
+		REQUIRE(counter.AllocationCount() == 2);
+		REQUIRE(counter.LiveAllocations() == 0);
+	}
+	SECTION("Falls back to StableSort without a buffer")
+	{
+		RadixSort(records.Begin(), records.End(), key, nullptr);
+		REQUIRE(IsSorted(records.Begin(), records.End(), byKeyAndOrder));
+	}
+}
+
+TEST_CASE("RadixSort - Array", "[RadixSort]")
+{
+	Array<uint32_t, 1000> values;
+	for (size_t i = 0; i < values.Size(); ++i)
+		values[i] = (uint32_t)((i * 2654435761u) % 100003);
+	RadixSort(values.Begin(), values.End());
+	REQUIRE(IsSorted(values.Begin(), values.End()));
+}
+
+TEST_CASE("RadixSort - Strings", "[RadixSort]")
+{
+	srand(14);
+	std::vector<std::string> input;
+	for (int i = 0; i < 20000; ++i)
+	{
+		//Shared prefixes, empty strings, bytes above 127 and embedded zeros
+		std::string string = i % 3 == 0 ? "prefix/shared/" : "";
+		const int length = rand() % 12;
+		for (int c = 0; c < length; ++c)
+			string.push_back((char)(i % 7 == 0 ? rand() % 256 : 'a' + rand() % 4));
+		input.push_back(string);
+	}
+	input.push_back(std::string(5000, 'x'));
+	input.push_back(std::string(5000, 'x') + "y");
+	for (int i = 0; i < 100; ++i)
+		input.push_back(std::string(i, 'z'));
+
+	Vector<String> strings;
+	for (const std::string& string : input)
+		strings.Push(String(string.data(), string.data() + string.size()));
+	RadixSort(strings.Begin(), strings.End());
+	std::sort(input.begin(), input.end(), [](const std::string& a, const std::string& b)
+	{
+		return StrCompare(a.data(), a.size(), b.data(), b.size()) < 0;
+	});
+	REQUIRE(strings.Size() == input.size());
+	REQUIRE(std::equal(input.begin(), input.end(), strings.Data(), [](const std::string& a, const String& b)
+	{
+		return String(a.data(), a.data() + a.size()) == b;
+	}));
+}
@@ -0,0 +1,247 @@
+#include "../catch.hpp"
+#include "../Std/SmallObjectPool.h"
+#include "../Std/TaggedStack.h"
+#include "../Std/Vector.h"
+#include "../Std/Map.h"
+#include "../Std/HashMap.h"
+#include "../Std/String.h"
+#include <thread>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	struct StackNode
+	{
+		std::atomic<StackNode*> pNext;
+		int Value;
+	};
+}
+
+TEST_CASE("TaggedStack - Push and Pop", "[TaggedStack]")
+{
+	TaggedStack<StackNode> stack;
+	StackNode nodes[4];
+	REQUIRE(stack.Empty());
+	REQUIRE(stack.Pop() == nullptr);
+	for (int i = 0; i < 3; ++i)
+	{
+		nodes[i].Value = i;
+		stack.Push(&nodes[i]);
+	}
+	REQUIRE(!stack.Empty());
+	REQUIRE(stack.Pop()->Value == 2);
+	REQUIRE(stack.Pop()->Value == 1);
+
+	nodes[3].Value = 3;
+	nodes[3].pNext = &nodes[1];
+	nodes[1].Value = 4;
+	stack.PushChain(&nodes[3], &nodes[1]);
+	REQUIRE(stack.Pop()->Value == 3);
+	StackNode* pAll = stack.PopAll();
+	REQUIRE(stack.Empty());
+	REQUIRE(pAll->Value == 4);
+	REQUIRE(pAll->pNext.load()->Value == 0);
+	REQUIRE(pAll->pNext.load()->pNext.load() == nullptr);
+}
+
+TEST_CASE("TaggedStack - Threads", "[TaggedStack]")
+{
+	const int threadCount = 4;
+	const int nodeCount = 1000;
+	TaggedStack<StackNode> stack;
+	std::vector<StackNode> nodes(threadCount * nodeCount);
+	for (size_t i = 0; i < nodes.size(); ++i)
+	{
+		nodes[i].Value = 0;
+		stack.Push(&nodes[i]);
+	}
+
+	//Every thread pops and pushes the nodes many times, a node is never held by two threads at once
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; ++t)
+	{
+		threads.emplace_back([&stack]()
+		{
+			StackNode* held[16];
+			for (int round = 0; round < 2000; ++round)
+			{
+				int count = 0;
+				while (count < 16)
+				{
+					StackNode* pNode = stack.Pop();
+					if (pNode == nullptr)
+						break;
+					++pNode->Value;
+					held[count++] = pNode;
+				}
+				for (int i = 0; i < count; ++i)
+					stack.Push(held[i]);
+			}
+		});
+	}
+	for (std::thread& thread : threads)
+		thread.join();
+
+	size_t count = 0;
+	while (stack.Pop() != nullptr)
+		++count;
+	REQUIRE(count == nodes.size());
+}
+
+TEST_CASE("SmallObjectPool - Size classes", "[SmallObjectPool]")
+{
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(0)) == 8);
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(8)) == 8);
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(9)) == 16);
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(128)) == 128);
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(129)) == 160);
+	REQUIRE(SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(513)) == 640);
+	REQUIRE(SmallObjectPool::SizeClass(1024) == SmallObjectPool::CLASS_COUNT - 1);
+	for (size_t size = 1; size <= SmallObjectPool::MAX_SIZE; ++size)
+	{
+		const size_t classSize = SmallObjectPool::ClassSize(SmallObjectPool::SizeClass(size));
+		REQUIRE(classSize >= size);
+		REQUIRE(classSize % SmallObjectPool::ALIGNMENT == 0);
+		//Less than 16 bytes are wasted on the small sizes, and less than a quarter of the object on the larger ones
+		if (size <= 128)
+			REQUIRE(classSize - size < 16);
+		else
+			REQUIRE((classSize - size) * 4 < classSize);
+	}
+}
+
+TEST_CASE("SmallObjectPool - Allocate", "[SmallObjectPool]")
+{
+	SECTION("Objects don't overlap")
+	{
+		const size_t count = 1000;
+		std::vector<char*> objects;
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t size = 1 + (i * 37) % SmallObjectPool::MAX_SIZE;
+			char* pObject = static_cast<char*>(SmallObjectPool::Allocate(size));
+			REQUIRE((uintptr_t)pObject % SmallObjectPool::ALIGNMENT == 0);
+			memset(pObject, (int)(i & 0xFF), size);
+			objects.push_back(pObject);
+		}
+		for (size_t i = 0; i < count; ++i)
+		{
+			const size_t size = 1 + (i * 37) % SmallObjectPool::MAX_SIZE;
+			REQUIRE(objects[i][0] == (char)(i & 0xFF));
+			REQUIRE(objects[i][size - 1] == (char)(i & 0xFF));
+			SmallObjectPool::Free(objects[i], size);
+		}
+	}
+	SECTION("Reuse")
+	{
+		void* pFirst = SmallObjectPool::Allocate(40);
+		SmallObjectPool::Free(pFirst, 40);
+		void* pSecond = SmallObjectPool::Allocate(48);
+		REQUIRE(pSecond == pFirst);
+		SmallObjectPool::Free(pSecond, 48);
+	}
+	SmallObjectPool::FlushThreadCache();
+}
+
+TEST_CASE("SmallObjectPool - Threads", "[SmallObjectPool]")
+{
+	const int threadCount = 4;
+	const size_t count = 20000;
+
+	SECTION("Allocate and free on every thread")
+	{
+		std::vector<std::thread> threads;
+		std::atomic<int> errors(0);
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, &errors]()
+			{
+				std::vector<int*> objects;
+				for (size_t i = 0; i < count; ++i)
+				{
+					const size_t size = 4 + (i % 64) * 4;
+					int* pObject = static_cast<int*>(SmallObjectPool::Allocate(size));
+					*pObject = t;
+					objects.push_back(pObject);
+					if (i % 3 == 0)
+					{
+						int* pOld = objects[i / 2];
+						if (pOld && *pOld != t)
+							++errors;
+					}
+				}
+				for (size_t i = 0; i < count; ++i)
+				{
+					if (*objects[i] != t)
+						++errors;
+					SmallObjectPool::Free(objects[i], 4 + (i % 64) * 4);
+				}
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		REQUIRE(errors == 0);
+	}
+	SECTION("Free on another thread")
+	{
+		//Each thread allocates its objects and frees the ones of the previous thread
+		std::vector<std::vector<void*>> objects(threadCount);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, &objects]()
+			{
+				for (size_t i = 0; i < count; ++i)
+					objects[t].push_back(SmallObjectPool::Allocate(24));
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		threads.clear();
+		for (int t = 0; t < threadCount; ++t)
+		{
+			threads.emplace_back([t, &objects]()
+			{
+				const std::vector<void*>& previous = objects[(t + threadCount - 1) % threadCount];
+				for (void* pObject : previous)
+					SmallObjectPool::Free(pObject, 24);
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+
+		//The objects are back in the central lists and are handed out again
+		void* pObject = SmallObjectPool::Allocate(24);
+		REQUIRE(pObject != nullptr);
+		SmallObjectPool::Free(pObject, 24);
+	}
+	SmallObjectPool::FlushThreadCache();
+}
+
+TEST_CASE("SmallObjectPool - Resource", "[SmallObjectPool]")
+{
+	CountingResource upstream;
+	SmallObjectResource resource(&upstream);
+	{
+		Map<int, String> map(&resource);
+		HashMap<int, int> hashMap(&resource);
+		Vector<int> vector(resource);
+		for (int i = 0; i < 1000; ++i)
+		{
+			map.Insert(i, String::Printf("%d", i));
+			hashMap.Insert(i, i);
+			vector.Push(i);
+		}
+		REQUIRE(map.Find(999)->Value == "999");
+		REQUIRE(hashMap.Find(999)->Value == 999);
+
+		void* pLarge = resource.Allocate(SmallObjectPool::MAX_SIZE + 1, 8);
+		void* pAligned = resource.Allocate(16, 16);
+		REQUIRE(upstream.LiveAllocations() > 0);
+		resource.Deallocate(pLarge, SmallObjectPool::MAX_SIZE + 1, 8);
+		resource.Deallocate(pAligned, 16, 16);
+	}
+	REQUIRE(upstream.LiveAllocations() == 0);
+	SmallObjectPool::FlushThreadCache();
+}
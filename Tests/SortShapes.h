@@ -0,0 +1,50 @@
+#pragma once
+#include "../Std/Vector.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+
+//The inputs the sorts are tested on: random values, the presorted patterns that adaptive sorts and pivot choices get
+//wrong, and many duplicates. The random values take up to 62 bits, they are cut to the element type.
+template<typename T>
+StlStd::Vector<StlStd::Vector<T>> MakeSortShapes(const size_t count, const unsigned seed)
+{
+	StlStd::Vector<T> random, sorted, reversed, fewUnique, organPipe, sawtooth, allEqual;
+	srand(seed);
+	for (size_t i = 0; i < count; ++i)
+	{
+		random.Push((T)(((uint64_t)rand() << 31) ^ (uint64_t)rand()));
+		sorted.Push((T)i);
+		reversed.Push((T)(count - i));
+		fewUnique.Push((T)(rand() % 4));
+		organPipe.Push((T)(i < count / 2 ? i : count - i));
+		sawtooth.Push((T)(i % 1000));
+		allEqual.Push((T)7);
+	}
+	StlStd::Vector<StlStd::Vector<T>> shapes;
+	shapes.Push(StlStd::Move(random));
+	shapes.Push(StlStd::Move(sorted));
+	shapes.Push(StlStd::Move(reversed));
+	shapes.Push(StlStd::Move(fewUnique));
+	shapes.Push(StlStd::Move(organPipe));
+	shapes.Push(StlStd::Move(sawtooth));
+	shapes.Push(StlStd::Move(allEqual));
+	return shapes;
+}
+
+//The values sorted by std::sort, to compare the results to
+template<typename T>
+std::vector<T> StdSorted(const StlStd::Vector<T>& values)
+{
+	std::vector<T> expected(values.Data(), values.Data() + values.Size());
+	std::sort(expected.begin(), expected.end());
+	return expected;
+}
+
+//Whether the values are the expected ones, so a test checks a whole result in one assertion
+template<typename T>
+bool Equals(const StlStd::Vector<T>& values, const std::vector<T>& expected)
+{
+	return values.Size() == expected.size() && std::equal(expected.begin(), expected.end(), values.Data());
+}
@@ -1,9 +1,83 @@
 #include "../catch.hpp"
 #include "../Std/Vector.h"
 #include "../Std/Sorting.h"
+#include "../Std/Array.h"
+#include "../Std/String.h"
+#include "SortShapes.h"
+#include <algorithm>
+#include <string.h>
+#include <vector>
 
 using namespace StlStd;
 
+namespace
+{
+	struct Record
+	{
+		int Key;
+		int Order;
+	};
+
+	//Throws on allocations above the limit, like running out of memory
+	class LimitedResource : public MemoryResource
+	{
+	public:
+		explicit LimitedResource(const size_t limit) : m_Limit(limit), m_Failures(0) {}
+
+		size_t Failures() const { return m_Failures; }
+
+	protected:
+		virtual void* DoAllocate(size_t size, size_t alignment) override
+		{
+			if (size > m_Limit)
+			{
+				++m_Failures;
+				throw std::bad_alloc();
+			}
+			return GetNewDeleteResource()->Allocate(size, alignment);
+		}
+
+		virtual void DoDeallocate(void* pPtr, size_t size, size_t alignment) override
+		{
+			GetNewDeleteResource()->Deallocate(pPtr, size, alignment);
+		}
+
+	private:
+		size_t m_Limit;
+		size_t m_Failures;
+	};
+
+	//Records with few distinct keys, the order they were made in is kept in Order
+	Vector<Record> MakeRecords(const size_t count, const char* pShape)
+	{
+		Vector<Record> records;
+		for (size_t i = 0; i < count; ++i)
+		{
+			int key = rand() % 100;
+			if (strcmp(pShape, "sorted") == 0)
+				key = (int)(i * 100 / count);
+			else if (strcmp(pShape, "reversed") == 0)
+				key = (int)((count - i) * 100 / count);
+			else if (strcmp(pShape, "two runs") == 0)
+				key = (int)(i < count / 2 ? i : i - count / 2) % 1000;
+			records.Push(Record{ key, (int)i });
+		}
+		return records;
+	}
+
+	bool IsStablySorted(const Vector<Record>& records)
+	{
+		for (size_t i = 1; i < records.Size(); ++i)
+		{
+			if (records[i - 1].Key > records[i].Key)
+				return false;
+			if (records[i - 1].Key == records[i].Key && records[i - 1].Order > records[i].Order)
+				return false;
+		}
+		return true;
+	}
+}
+
 TEST_CASE("Sorting - BubbleSort", "[Sorting]")
 {
 	SECTION("No predicate")
@@ -111,4 +185,445 @@ TEST_CASE("Sorting - IsSorted", "[Sorting]")
 		InsertionSort(v1.Begin(), v1.End());
 		REQUIRE(IsSorted(v1.Begin(), v1.End()));
 	}
-}
\ No newline at end of file
+}
+
+TEST_CASE("Sorting - Sort", "[Sorting]")
+{
+	SECTION("Shapes")
+	{
+		for (Vector<int>& values : MakeSortShapes<int>(5000, 42))
+		{
+			const std::vector<int> expected = StdSorted(values);
+			Sort(values.Begin(), values.End());
+			REQUIRE(Equals(values, expected));
+		}
+	}
+	SECTION("Predicate")
+	{
+		Vector<int> v1;
+		for (int i = 0; i < 1000; ++i)
+			v1.Push((i * 7919) % 1000);
+		Sort(v1.Begin(), v1.End(), [](int a, int b) { return a > b; });
+		REQUIRE(IsSorted(v1.Begin(), v1.End(), [](int a, int b) { return a > b; }));
+		REQUIRE(v1[0] == 999);
+	}
+	SECTION("Array and pointers")
+	{
+		Array<int, 100> array;
+		for (int i = 0; i < 100; ++i)
+			array[i] = 100 - i;
+		Sort(array.Begin(), array.End());
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(array[i] == i + 1);
+
+		double values[] = { 3.5, -1.0, 2.25, 0.0, 10.0 };
+		Sort(values, values + 5);
+		REQUIRE(values[0] == -1.0);
+		REQUIRE(values[4] == 10.0);
+	}
+	SECTION("Strings")
+	{
+		Vector<String> strings;
+		for (int i = 0; i < 500; ++i)
+			strings.Push(String::Printf("A string that doesn't fit in the object %d", (i * 31) % 500));
+		Sort(strings.Begin(), strings.End());
+		REQUIRE(IsSorted(strings.Begin(), strings.End()));
+		REQUIRE(strings[0] == "A string that doesn't fit in the object 0");
+	}
+	SECTION("Small and empty")
+	{
+		Vector<int> v1;
+		REQUIRE_NOTHROW(Sort(v1.Begin(), v1.End()));
+		v1.Push(2);
+		Sort(v1.Begin(), v1.End());
+		REQUIRE(v1[0] == 2);
+		v1.Push(1);
+		Sort(v1.Begin(), v1.End());
+		REQUIRE(v1[0] == 1);
+	}
+}
+
+TEST_CASE("Sorting - HeapSort", "[Sorting]")
+{
+	Vector<int> v1;
+	for (int i = 0; i < 1000; ++i)
+		v1.Push((i * 7919) % 1000);
+	HeapSort(v1.Begin(), v1.End());
+	for (int i = 0; i < 1000; ++i)
+		REQUIRE(v1[i] == i);
+	HeapSort(v1.Begin(), v1.End(), [](int a, int b) { return a > b; });
+	REQUIRE(v1[0] == 999);
+	REQUIRE(IsSorted(v1.Begin(), v1.End(), [](int a, int b) { return a > b; }));
+}
+
+TEST_CASE("Sorting - UnstableSort", "[Sorting]")
+{
+	SECTION("Shapes")
+	{
+		for (Vector<int>& values : MakeSortShapes<int>(20000, 42))
+		{
+			const std::vector<int> expected = StdSorted(values);
+
+			//The lambda takes the partition with branches, LessThan the branchless one
+			Vector<int> copy = values;
+			UnstableSort(copy.Begin(), copy.End(), [](int a, int b) { return a < b; });
+			UnstableSort(values.Begin(), values.End());
+			REQUIRE(Equals(values, expected));
+			REQUIRE(Equals(copy, expected));
+		}
+	}
+	SECTION("Linear on sorted and reversed input")
+	{
+		const int count = 100000;
+		size_t comparisons = 0;
+		auto counting = [&comparisons](int a, int b) { ++comparisons; return a < b; };
+		Vector<int> v1;
+		for (int i = 0; i < count; ++i)
+			v1.Push(i);
+		UnstableSort(v1.Begin(), v1.End(), counting);
+		REQUIRE(comparisons < 3 * (size_t)count);
+
+		comparisons = 0;
+		for (int i = 0; i < count; ++i)
+			v1[i] = count - i;
+		UnstableSort(v1.Begin(), v1.End(), counting);
+		REQUIRE(comparisons < 4 * (size_t)count);
+		for (int i = 0; i < count; ++i)
+			REQUIRE(v1[i] == i + 1);
+	}
+	SECTION("Adversarial input")
+	{
+		//McIlroy's adversary: the values are decided while sorting, so every pivot turns out to be a bad one.
+		//Without the pattern breaking and the heapsort this would take a quadratic number of comparisons.
+		const int count = 20000;
+		const int gas = count;
+		std::vector<int> values(count, gas);
+		int frozen = 0;
+		int candidate = 0;
+		size_t comparisons = 0;
+		auto adversary = [&](int x, int y)
+		{
+			++comparisons;
+			if (values[x] == gas && values[y] == gas)
+				values[x == candidate ? x : y] = frozen++;
+			if (values[x] == gas)
+				candidate = x;
+			else if (values[y] == gas)
+				candidate = y;
+			return values[x] < values[y];
+		};
+		Vector<int> indices;
+		for (int i = 0; i < count; ++i)
+			indices.Push(i);
+		UnstableSort(indices.Begin(), indices.End(), adversary);
+		REQUIRE(comparisons < 50 * (size_t)count);
+		for (int i = 1; i < count; ++i)
+			REQUIRE(values[indices[i - 1]] <= values[indices[i]]);
+	}
+	SECTION("Floats and GreaterThan")
+	{
+		Vector<float> v1;
+		for (int i = 0; i < 10000; ++i)
+			v1.Push((float)((i * 7919) % 10000) * 0.5f - 100.0f);
+		UnstableSort(v1.Begin(), v1.End(), GreaterThan<>());
+		REQUIRE(IsSorted(v1.Begin(), v1.End(), GreaterThan<float>()));
+		REQUIRE(v1[0] == 4899.5f);
+	}
+	SECTION("Strings")
+	{
+		Vector<String> strings;
+		for (int i = 0; i < 500; ++i)
+			strings.Push(String::Printf("A string that doesn't fit in the object %d", (i * 31) % 500));
+		UnstableSort(strings.Begin(), strings.End());
+		REQUIRE(IsSorted(strings.Begin(), strings.End()));
+		REQUIRE(strings[0] == "A string that doesn't fit in the object 0");
+	}
+	SECTION("Small and empty")
+	{
+		int values[] = { 3, 1, 2 };
+		UnstableSort(values, values);
+		UnstableSort(values, values + 1);
+		REQUIRE(values[0] == 3);
+		UnstableSort(values, values + 3);
+		REQUIRE(values[0] == 1);
+		REQUIRE(values[2] == 3);
+	}
+}
+
+TEST_CASE("Sorting - StableSort", "[Sorting]")
+{
+	auto byKey = [](const Record& a, const Record& b) { return a.Key < b.Key; };
+	const char* shapes[] = { "random", "sorted", "reversed", "two runs" };
+	srand(42);
+
+	SECTION("Shapes")
+	{
+		for (const char* pShape : shapes)
+		{
+			for (size_t count : { (size_t)0, (size_t)1, (size_t)50, (size_t)1000, (size_t)30000 })
+			{
+				Vector<Record> records = MakeRecords(count, pShape);
+				StableSort(records.Begin(), records.End(), byKey);
+				REQUIRE(records.Size() == count);
+				REQUIRE(IsStablySorted(records));
+			}
+		}
+	}
+	SECTION("In place")
+	{
+		//Without a buffer, with one that can't grow past 4k and one that can't be allocated at all
+		LimitedResource limited(4096);
+		LimitedResource failing(0);
+		MemoryResource* resources[] = { nullptr, &limited, &failing };
+		for (MemoryResource* pResource : resources)
+		{
+			for (const char* pShape : shapes)
+			{
+				Vector<Record> records = MakeRecords(30000, pShape);
+				StableSort(records.Begin(), records.End(), byKey, pResource);
+				REQUIRE(IsStablySorted(records));
+			}
+		}
+		REQUIRE(limited.Failures() > 0);
+		REQUIRE(failing.Failures() > 0);
+	}
+	SECTION("Buffer")
+	{
+		//At most half the elements, and nothing for runs that are merged already
+		CountingResource counter;
+		Vector<Record> records = MakeRecords(30000, "random");
+		StableSort(records.Begin(), records.End(), byKey, &counter);
+		REQUIRE(counter.PeakBytesInUse() <= 15000 * sizeof(Record));
+		REQUIRE(counter.LiveAllocations() == 0);
+
+		counter.Reset();
+		StableSort(records.Begin(), records.End(), byKey, &counter);
+		REQUIRE(counter.AllocationCount() == 0);
+	}
+	SECTION("Close to linear on runs")
+	{
+		const size_t count = 100000;
+		size_t comparisons = 0;
+		auto counting = [&comparisons](int a, int b) { ++comparisons; return a < b; };
+		Vector<int> v1;
+		for (size_t i = 0; i < count; ++i)
+			v1.Push((int)i);
+		StableSort(v1.Begin(), v1.End(), counting);
+		REQUIRE(comparisons < count);
+
+		//Two sorted halves that interleave, the merge gallops over the long stretches
+		comparisons = 0;
+		for (size_t i = 0; i < count; ++i)
+			v1[i] = (int)(i < count / 2 ? i : i - count / 2) / 1000 * 1000;
+		StableSort(v1.Begin(), v1.End(), counting);
+		REQUIRE(comparisons < 2 * count);
+		REQUIRE(IsSorted(v1.Begin(), v1.End()));
+
+		//A few elements out of place
+		comparisons = 0;
+		for (size_t i = 0; i < count; ++i)
+			v1[i] = (int)i;
+		for (size_t i = 0; i < count; i += 10000)
+			Swap(v1[i], v1[count - 1 - i]);
+		StableSort(v1.Begin(), v1.End(), counting);
+		REQUIRE(comparisons < 3 * count);
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(v1[i] == (int)i);
+	}
+	SECTION("Strings")
+	{
+		Vector<String> strings;
+		for (int i = 0; i < 500; ++i)
+			strings.Push(String::Printf("A string that doesn't fit in the object %d", (i * 31) % 500));
+		StableSort(strings.Begin(), strings.End());
+		REQUIRE(IsSorted(strings.Begin(), strings.End()));
+		StableSort(strings.Begin(), strings.End(), GreaterThan<>(), nullptr);
+		REQUIRE(IsSorted(strings.Begin(), strings.End(), GreaterThan<>()));
+	}
+}
+
+TEST_CASE("Sorting - NthElement", "[Sorting]")
+{
+	SECTION("Shapes")
+	{
+		const size_t count = 10000;
+		const size_t positions[] = { 0, 1, 17, count / 2, count - 2, count - 1 };
+		for (const Vector<int>& input : MakeSortShapes<int>(count, 5))
+		{
+			const std::vector<int> expected = StdSorted(input);
+			for (size_t nth : positions)
+			{
+				Vector<int> values = input;
+				NthElement(values.Begin(), values.Begin() + nth, values.End());
+				int* pNth = values.Data() + nth;
+				REQUIRE(*pNth == expected[nth]);
+				//Nothing before it is larger and nothing after it smaller
+				REQUIRE(std::all_of(values.Data(), pNth, [pNth](int value) { return value <= *pNth; }));
+				REQUIRE(std::all_of(pNth + 1, values.Data() + count, [pNth](int value) { return value >= *pNth; }));
+			}
+		}
+	}
+	SECTION("Linear number of comparisons")
+	{
+		const size_t count = 100000;
+		size_t comparisons = 0;
+		Vector<int> values;
+		srand(6);
+		for (size_t i = 0; i < count; ++i)
+			values.Push(rand());
+		NthElement(values.Begin(), values.Begin() + count / 2, values.End(), [&comparisons](int a, int b) { ++comparisons; return a < b; });
+		REQUIRE(comparisons < 6 * count);
+	}
+	SECTION("Small ranges and the end")
+	{
+		Vector<int> values = { 3, 1, 2 };
+		NthElement(values.Begin(), values.End(), values.End());
+		NthElement(values.Begin(), values.Begin() + 1, values.End(), GreaterThan<>());
+		REQUIRE(values[1] == 2);
+		Vector<int> empty;
+		NthElement(empty.Begin(), empty.Begin(), empty.End());
+	}
+}
+
+TEST_CASE("Sorting - PartialSort", "[Sorting]")
+{
+	const size_t count = 20000;
+	Vector<int> input;
+	srand(8);
+	for (size_t i = 0; i < count; ++i)
+		input.Push(rand() % 5000);
+	std::vector<int> expected(input.begin().pPtr, input.end().pPtr);
+	std::sort(expected.begin(), expected.end());
+
+	SECTION("PartialSort")
+	{
+		//The small ones use the heap, the large ones NthElement
+		const size_t sizes[] = { 0, 1, 10, 300, 5000, count };
+		for (size_t k : sizes)
+		{
+			Vector<int> values = input;
+			PartialSort(values.Begin(), values.Begin() + k, values.End());
+			for (size_t i = 0; i < k; ++i)
+				REQUIRE(values[i] == expected[i]);
+			std::vector<int> rest(values.begin().pPtr + k, values.end().pPtr);
+			std::sort(rest.begin(), rest.end());
+			REQUIRE(std::equal(rest.begin(), rest.end(), expected.begin() + k));
+		}
+	}
+	SECTION("PartialSort with a compare functor")
+	{
+		Vector<int> values = input;
+		PartialSort(values.Begin(), values.Begin() + 100, values.End(), GreaterThan<>());
+		for (size_t i = 0; i < 100; ++i)
+			REQUIRE(values[i] == expected[count - 1 - i]);
+	}
+	SECTION("PartialSortCopy")
+	{
+		const Vector<int>& constInput = input;
+		Vector<int> top(50);
+		RandomAccessIterator<int> pEnd = PartialSortCopy(constInput.Begin(), constInput.End(), top.Begin(), top.End());
+		REQUIRE(pEnd == top.End());
+		for (size_t i = 0; i < 50; ++i)
+			REQUIRE(top[i] == expected[i]);
+
+		//A larger output only takes as many elements as there are
+		Vector<int> all(count + 10, -1);
+		pEnd = PartialSortCopy(input.Begin(), input.End(), all.Begin(), all.End(), GreaterThan<>());
+		REQUIRE(pEnd == all.Begin() + count);
+		for (size_t i = 0; i < count; ++i)
+			REQUIRE(all[i] == expected[count - 1 - i]);
+		REQUIRE(all[count] == -1);
+	}
+}
+
+TEST_CASE("Sorting - TopK", "[Sorting]")
+{
+	SECTION("Largest scores")
+	{
+		srand(9);
+		std::vector<double> scores;
+		TopK<double, GreaterThan<double>> top(100);
+		for (int i = 0; i < 100000; ++i)
+		{
+			scores.push_back((double)rand() / RAND_MAX);
+			top.Push(scores.back());
+		}
+		REQUIRE(top.IsFull());
+		std::sort(scores.begin(), scores.end(), std::greater<double>());
+		REQUIRE(top.Bound() == scores[99]);
+		Vector<double> values = top.Extract();
+		REQUIRE(top.Empty());
+		REQUIRE(values.Size() == 100);
+		for (size_t i = 0; i < 100; ++i)
+			REQUIRE(values[i] == scores[i]);
+	}
+	SECTION("Fewer values than k")
+	{
+		TopK<int> top(10);
+		int values[] = { 5, 3, 9, 1 };
+		top.Push(values, values + 4);
+		REQUIRE(top.Size() == 4);
+		REQUIRE(!top.IsFull());
+		Vector<int> smallest = top.Extract();
+		REQUIRE(smallest == Vector<int>({ 1, 3, 5, 9 }));
+	}
+	SECTION("Moves the values and takes a compare functor")
+	{
+		auto byLength = [](const String& a, const String& b) { return a.Size() > b.Size(); };
+		TopK<String, decltype(byLength)> longest(3, byLength);
+		for (int i = 0; i < 200; ++i)
+			longest.Push(String((size_t)((i * 37) % 200), 'x'));
+		Vector<String> strings = longest.Extract();
+		REQUIRE(strings.Size() == 3);
+		REQUIRE(strings[0].Size() == 199);
+		REQUIRE(strings[2].Size() == 197);
+	}
+	SECTION("k of 0 keeps nothing")
+	{
+		TopK<int> top(0);
+		top.Push(1);
+		REQUIRE(top.Empty());
+	}
+}
+
+TEST_CASE("Sorting - Heap algorithms", "[Sorting]")
+{
+	srand(10);
+	Vector<int> values;
+	for (int i = 0; i < 1000; ++i)
+		values.Push(rand() % 500);
+
+	SECTION("MakeHeap and SortHeap")
+	{
+		MakeHeap(values.Begin(), values.End());
+		REQUIRE(IsHeap(values.Begin(), values.End()));
+		REQUIRE(values[0] == *MaxElement(values.Begin(), values.End()));
+		SortHeap(values.Begin(), values.End());
+		REQUIRE(IsSorted(values.Begin(), values.End()));
+	}
+	SECTION("PushHeap and PopHeap")
+	{
+		Vector<int> heap;
+		for (size_t i = 0; i < values.Size(); ++i)
+		{
+			heap.Push(values[i]);
+			PushHeap(heap.Begin(), heap.End(), GreaterThan<>());
+			REQUIRE(IsHeap(heap.Begin(), heap.End(), GreaterThan<>()));
+		}
+		std::vector<int> expected(values.begin().pPtr, values.end().pPtr);
+		std::sort(expected.begin(), expected.end());
+		for (size_t i = 0; i < expected.size(); ++i)
+		{
+			PopHeap(heap.Begin(), heap.End(), GreaterThan<>());
+			REQUIRE(heap.Pop() == expected[i]);
+			REQUIRE(IsHeap(heap.Begin(), heap.End(), GreaterThan<>()));
+		}
+	}
+	SECTION("IsHeap")
+	{
+		int notHeap[] = { 5, 3, 6 };
+		REQUIRE(!IsHeap(notHeap, notHeap + 3));
+		REQUIRE(IsHeap(notHeap, notHeap + 2));
+		REQUIRE(IsHeap(notHeap, notHeap));
+	}
+}
@@ -0,0 +1,134 @@
+#include "../catch.hpp"
+#include "../Std/StringSearch.h"
+#include <string>
+using namespace StlStd;
+
+namespace
+{
+	//Text of a small alphabet, most positions partially match the needles
+	std::string RandomText(const size_t size, uint32_t seed)
+	{
+		std::string text(size, 'a');
+		for (size_t i = 0; i < size; ++i)
+		{
+			seed = seed * 1664525u + 1013904223u;
+			text[i] = (char)('a' + (seed >> 16) % 3);
+		}
+		return text;
+	}
+}
+
+TEST_CASE("StringSearch - Char", "[StringSearch]")
+{
+	SECTION("Empty")
+	{
+		REQUIRE(StrFindChar("", 0, 'a') == STR_NPOS);
+		REQUIRE(StrRFindChar("", 0, 'a') == STR_NPOS);
+	}
+	SECTION("Every position")
+	{
+		for (size_t size = 1; size < 70; ++size)
+		{
+			for (size_t position = 0; position < size; ++position)
+			{
+				std::string text(size, 'a');
+				text[position] = 'b';
+				REQUIRE(StrFindChar(text.data(), size, 'b') == position);
+				REQUIRE(StrRFindChar(text.data(), size, 'b') == position);
+			}
+			REQUIRE(StrFindChar(std::string(size, 'a').data(), size, 'b') == STR_NPOS);
+			REQUIRE(StrRFindChar(std::string(size, 'a').data(), size, 'b') == STR_NPOS);
+		}
+	}
+	SECTION("First and last")
+	{
+		const std::string text = "x.........................x.........................x";
+		REQUIRE(StrFindChar(text.data(), text.size(), 'x') == 0);
+		REQUIRE(StrRFindChar(text.data(), text.size(), 'x') == text.size() - 1);
+	}
+	SECTION("High characters")
+	{
+		const std::string text = "abc\xE9" "def\xFF";
+		REQUIRE(StrFindChar(text.data(), text.size(), '\xE9') == 3);
+		REQUIRE(StrRFindChar(text.data(), text.size(), '\xFF') == 7);
+	}
+}
+
+TEST_CASE("StringSearch - Substring", "[StringSearch]")
+{
+	SECTION("Empty needle")
+	{
+		REQUIRE(StrFind("abc", 3, "", 0) == 0);
+		REQUIRE(StrRFind("abc", 3, "", 0) == 3);
+	}
+	SECTION("Needle longer than the data")
+	{
+		REQUIRE(StrFind("abc", 3, "abcd", 4) == STR_NPOS);
+		REQUIRE(StrRFind("abc", 3, "abcd", 4) == STR_NPOS);
+	}
+	SECTION("Whole data")
+	{
+		REQUIRE(StrFind("abc", 3, "abc", 3) == 0);
+		REQUIRE(StrRFind("abc", 3, "abc", 3) == 0);
+	}
+	SECTION("Same as std::string")
+	{
+		const std::string text = RandomText(300, 7);
+		for (size_t needleSize = 1; needleSize <= STR_LONG_NEEDLE + 8; ++needleSize)
+		{
+			for (size_t start = 0; start + needleSize <= text.size(); start += 7)
+			{
+				const std::string needle = text.substr(start, needleSize);
+				REQUIRE(StrFind(text.data(), text.size(), needle.data(), needleSize) == text.find(needle));
+				REQUIRE(StrRFind(text.data(), text.size(), needle.data(), needleSize) == text.rfind(needle));
+				if (needleSize > 1)
+				{
+					REQUIRE(StrFindHorspool(text.data(), text.size(), needle.data(), needleSize) == text.find(needle));
+					REQUIRE(StrRFindHorspool(text.data(), text.size(), needle.data(), needleSize) == text.rfind(needle));
+				}
+			}
+			const std::string missing(needleSize, 'd');
+			REQUIRE(StrFind(text.data(), text.size(), missing.data(), needleSize) == STR_NPOS);
+			REQUIRE(StrRFind(text.data(), text.size(), missing.data(), needleSize) == STR_NPOS);
+		}
+	}
+	SECTION("Every data size")
+	{
+		//Matches at the first and last positions and on the edges of the 16 character blocks
+		for (size_t needleSize = 2; needleSize <= STR_LONG_NEEDLE + 2; needleSize += 3)
+		{
+			for (size_t size = needleSize; size < needleSize + 40; ++size)
+			{
+				std::string text(size, 'a');
+				text[size - 1] = 'b';
+				const std::string needle = std::string(needleSize - 1, 'a') + "b";
+				REQUIRE(StrFind(text.data(), size, needle.data(), needleSize) == size - needleSize);
+				REQUIRE(StrRFind(text.data(), size, needle.data(), needleSize) == size - needleSize);
+
+				const std::string first = "b" + std::string(needleSize - 1, 'a');
+				std::string reversed(size, 'a');
+				reversed[0] = 'b';
+				REQUIRE(StrFind(reversed.data(), size, first.data(), needleSize) == 0);
+				REQUIRE(StrRFind(reversed.data(), size, first.data(), needleSize) == 0);
+			}
+		}
+	}
+}
+
+TEST_CASE("StringSearch - Saturated filter", "[StringSearch]")
+{
+	//The first and the last character of the needle are everywhere, long needles switch to Boyer-Moore-Horspool
+	const std::string needle = "a" + std::string("bcdefghijklmnopqrstuvwxyz0123456789") + "a";
+	REQUIRE(needle.size() >= STR_LONG_NEEDLE);
+	for (size_t position = 0; position < 3000; position += 331)
+	{
+		std::string text(3000, 'a');
+		text.replace(position, needle.size(), needle);
+		text.resize(3000);
+		REQUIRE(StrFind(text.data(), text.size(), needle.data(), needle.size()) == text.find(needle));
+		REQUIRE(StrRFind(text.data(), text.size(), needle.data(), needle.size()) == text.rfind(needle));
+	}
+	const std::string text(3000, 'a');
+	REQUIRE(StrFind(text.data(), text.size(), needle.data(), needle.size()) == STR_NPOS);
+	REQUIRE(StrRFind(text.data(), text.size(), needle.data(), needle.size()) == STR_NPOS);
+}
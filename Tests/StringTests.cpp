@@ -26,6 +26,20 @@ TEST_CASE("String - StrLen", "[String]")
 		wchar_t pData[] = L"";
 		REQUIRE(StrLen(pData) == 0);
 	}
+	SECTION("Every length and alignment")
+	{
+		//The lengths cross the 16 characters blocks of the vectorized search from every start in a block
+		char pData[128];
+		for (size_t offset = 0; offset < 16; ++offset)
+		{
+			for (size_t length = 0; length < 64; ++length)
+			{
+				memset(pData, 'a', sizeof(pData));
+				pData[offset + length] = '\0';
+				REQUIRE(StrLen(pData + offset) == length);
+			}
+		}
+	}
 }
 
 #pragma endregion StrLen
@@ -40,19 +54,19 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(s.Empty());
 		REQUIRE(s == "");
 		REQUIRE(s.Size() == 0);
-		REQUIRE(s.Capacity() == 0);
-		REQUIRE(s.begin() == nullptr);
-		REQUIRE(s.end() == nullptr);
-		REQUIRE(s.Data() == nullptr);
-		REQUIRE(s.C_Str() == nullptr);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s.begin() == s.end());
+		REQUIRE(*s.Data() == '\0');
+		REQUIRE(s.C_Str() == s.Data());
 	}
 	SECTION("int")
 	{
 		String s(10);
 		REQUIRE(!s.Empty());
-		REQUIRE(s == "");
+		REQUIRE(s != "");
+		REQUIRE(StrLen(s.C_Str()) == 0);
 		REQUIRE(s.Size() == 10);
-		REQUIRE(s.Capacity() == 10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.Data() != nullptr);
@@ -64,7 +78,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s.Empty());
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.Data() != nullptr);
@@ -76,7 +90,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s.Empty());
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.Data() != nullptr);
@@ -89,7 +103,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s.Empty());
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.Data() != nullptr);
@@ -101,7 +115,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s1.Empty());
 		REQUIRE(s1 == "Hello world");
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s1.begin() != nullptr);
 		REQUIRE(s1.end() != nullptr);
 		REQUIRE(s1.Data() != nullptr);
@@ -111,16 +125,15 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(s1.Empty());
 		REQUIRE(s1 == "");
 		REQUIRE(s1.Size() == 0);
-		REQUIRE(s1.Capacity() == 0);
-		REQUIRE(s1.begin() == nullptr);
-		REQUIRE(s1.end() == nullptr);
-		REQUIRE(s1.Data() == nullptr);
-		REQUIRE(s1.C_Str() == nullptr);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s1.begin() == s1.end());
+		REQUIRE(*s1.Data() == '\0');
+		REQUIRE(s1.C_Str() == s1.Data());
 
 		REQUIRE(!s2.Empty());
 		REQUIRE(s2 == "Hello world");
 		REQUIRE(s2.Size() == 11);
-		REQUIRE(s2.Capacity() == 11);
+		REQUIRE(s2.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s2.begin() != nullptr);
 		REQUIRE(s2.end() != nullptr);
 		REQUIRE(s2.Data() != nullptr);
@@ -132,7 +145,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s1.Empty());
 		REQUIRE(s1 == "Hello world");
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s1.begin() != nullptr);
 		REQUIRE(s1.end() != nullptr);
 		REQUIRE(s1.Data() != nullptr);
@@ -142,7 +155,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s1.Empty());
 		REQUIRE(s1 == "Hello world");
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s1.begin() != nullptr);
 		REQUIRE(s1.end() != nullptr);
 		REQUIRE(s1.Data() != nullptr);
@@ -151,7 +164,7 @@ TEST_CASE("String - Constructor", "[String]")
 		REQUIRE(!s2.Empty());
 		REQUIRE(s2 == "Hello world");
 		REQUIRE(s2.Size() == 11);
-		REQUIRE(s2.Capacity() == 11);
+		REQUIRE(s2.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s2.begin() != nullptr);
 		REQUIRE(s2.end() != nullptr);
 		REQUIRE(s2.Data() != nullptr);
@@ -161,6 +174,66 @@ TEST_CASE("String - Constructor", "[String]")
 	}
 }
 
+TEST_CASE("String - Small string", "[String]")
+{
+	SECTION("Size of the object")
+	{
+		REQUIRE(sizeof(String) == 3 * sizeof(size_t));
+		REQUIRE(String::LOCAL_CAPACITY == sizeof(String) - 1);
+	}
+	SECTION("In the object")
+	{
+		String s("Hello");
+		const char* pObject = reinterpret_cast<const char*>(&s);
+		REQUIRE(!s.IsLarge());
+		REQUIRE(s.Data() >= pObject);
+		REQUIRE(s.Data() < pObject + sizeof(String));
+	}
+	SECTION("Boundary")
+	{
+		String full(String::LOCAL_CAPACITY, 'a');
+		REQUIRE(!full.IsLarge());
+		REQUIRE(full.Size() == String::LOCAL_CAPACITY);
+		REQUIRE(full.Length() == String::LOCAL_CAPACITY);
+		REQUIRE(full.C_Str()[String::LOCAL_CAPACITY] == '\0');
+
+		String over(String::LOCAL_CAPACITY + 1, 'a');
+		REQUIRE(over.IsLarge());
+		REQUIRE(over.Size() == String::LOCAL_CAPACITY + 1);
+		REQUIRE(over.Capacity() == String::LOCAL_CAPACITY + 1);
+
+		full.Append("a");
+		REQUIRE(full.IsLarge());
+		REQUIRE(full == over);
+	}
+	SECTION("Copy and move")
+	{
+		String s1("Hello");
+		String s2(s1);
+		REQUIRE(s2 == "Hello");
+		REQUIRE(s2.Data() != s1.Data());
+
+		String s3(Move(s1));
+		REQUIRE(s3 == "Hello");
+		REQUIRE(!s3.IsLarge());
+		REQUIRE(s1.Empty());
+		REQUIRE(s1 == "");
+
+		s1 = s3;
+		REQUIRE(s1 == "Hello");
+		REQUIRE(s3 == "Hello");
+	}
+	SECTION("Append to itself")
+	{
+		String s("Hello world");
+		s += s;
+		REQUIRE(s == "Hello worldHello world");
+		s += s;
+		REQUIRE(s.IsLarge());
+		REQUIRE(s == "Hello worldHello worldHello worldHello world");
+	}
+}
+
 #pragma endregion Constructors
 
 #pragma region Assignment
@@ -173,7 +246,7 @@ TEST_CASE("String - Assignment", "[String]")
 		REQUIRE(!s1.Empty());
 		REQUIRE(s1 == "Hello world");
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s1.begin() != nullptr);
 		REQUIRE(s1.end() != nullptr);
 		REQUIRE(s1.Data() != nullptr);
@@ -185,7 +258,7 @@ TEST_CASE("String - Assignment", "[String]")
 		REQUIRE(!s1.Empty());
 		REQUIRE(s1 == "Hello world");
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s1.begin() != nullptr);
 		REQUIRE(s1.end() != nullptr);
 		REQUIRE(s1.Data() != nullptr);
@@ -194,7 +267,7 @@ TEST_CASE("String - Assignment", "[String]")
 		REQUIRE(!s2.Empty());
 		REQUIRE(s2 == "Hello world");
 		REQUIRE(s2.Size() == 11);
-		REQUIRE(s2.Capacity() == 11);
+		REQUIRE(s2.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s2.begin() != nullptr);
 		REQUIRE(s2.end() != nullptr);
 		REQUIRE(s2.Data() != nullptr);
@@ -211,23 +284,59 @@ TEST_CASE("String - Assignment", "[String]")
 		REQUIRE(s1.Empty());
 		REQUIRE(s1 == "");
 		REQUIRE(s1.Size() == 0);
-		REQUIRE(s1.Capacity() == 0);
-		REQUIRE(s1.begin() == nullptr);
-		REQUIRE(s1.end() == nullptr);
-		REQUIRE(s1.Data() == nullptr);
-		REQUIRE(s1.C_Str() == nullptr);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s1.begin() == s1.end());
+		REQUIRE(*s1.Data() == '\0');
+		REQUIRE(s1.C_Str() == s1.Data());
 
-		REQUIRE(!s2.Empty());
-		REQUIRE(s2 == "Hello World");
-		REQUIRE(s2.Size() == 11);
-		REQUIRE(s2.Capacity() == 11);
-		REQUIRE(s2.begin() != nullptr);
-		REQUIRE(s2.end() != nullptr);
-		REQUIRE(s2.Data() != nullptr);
-		REQUIRE(s2.C_Str() != nullptr);
+		REQUIRE(s2.Empty());
+		REQUIRE(s2 == "");
+		REQUIRE(s2.Size() == 0);
+		REQUIRE(s2.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s2.begin() == s2.end());
 
 		REQUIRE(s1.Data() != s2.Data());
 	}
+	SECTION("Deep copy heap")
+	{
+		String s1 = "Hello World, this doesn't fit in the object";
+		String s2 = "Hello";
+		String s3 = "Hello World, this also doesn't fit in the object";
+		const char* pData3 = s3.Data();
+		s2 = s1;
+		s3 = s1;
+
+		REQUIRE(s2 == s1);
+		REQUIRE(s2.IsLarge());
+		REQUIRE(s2.Data() != s1.Data());
+		//The buffer is reused when it is big enough
+		REQUIRE(s3 == s1);
+		REQUIRE(s3.Data() == pData3);
+
+		s1 = "Short";
+		REQUIRE(s1 == "Short");
+		REQUIRE(s1.Size() == 5);
+		const String& self = s1;
+		s1 = self;
+		REQUIRE(s1 == "Short");
+	}
+	SECTION("Move")
+	{
+		String s1 = "Hello World, this doesn't fit in the object";
+		const char* pData = s1.Data();
+		String s2 = "Hello";
+		s2 = Move(s1);
+		REQUIRE(s2.Data() == pData);
+		REQUIRE(s2 == "Hello World, this doesn't fit in the object");
+		REQUIRE(s1.Empty());
+		REQUIRE(!s1.IsLarge());
+
+		String s3 = "Hello";
+		s2 = Move(s3);
+		REQUIRE(s2 == "Hello");
+		REQUIRE(!s2.IsLarge());
+		REQUIRE(s3.Empty());
+	}
 }
 
 #pragma endregion Assignment
@@ -243,9 +352,10 @@ TEST_CASE("String - Operator+", "[String]")
 		String s2(" World");
 		s1 = s1 + s2;
 		REQUIRE(s1 == "Hello World");
-		REQUIRE(s1.Data() != pData);
+		//Still fits in the object
+		REQUIRE(s1.Data() == pData);
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 	}
 	SECTION("char array")
 	{
@@ -253,9 +363,10 @@ TEST_CASE("String - Operator+", "[String]")
 		char* pData = s1.Data();
 		s1 = s1 + " World";
 		REQUIRE(s1 == "Hello World");
-		REQUIRE(s1.Data() != pData);
+		//Still fits in the object
+		REQUIRE(s1.Data() == pData);
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 	}
 }
 
@@ -268,9 +379,10 @@ TEST_CASE("String - Operator+=", "[String]")
 		String s2(" World");
 		s1 += s2;
 		REQUIRE(s1 == "Hello World");
-		REQUIRE(s1.Data() != pData);
+		//Still fits in the object
+		REQUIRE(s1.Data() == pData);
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 	}
 	SECTION("char array")
 	{
@@ -278,9 +390,10 @@ TEST_CASE("String - Operator+=", "[String]")
 		char* pData = s1.Data();
 		s1 += " World";
 		REQUIRE(s1 == "Hello World");
-		REQUIRE(s1.Data() != pData);
+		//Still fits in the object
+		REQUIRE(s1.Data() == pData);
 		REQUIRE(s1.Size() == 11);
-		REQUIRE(s1.Capacity() == 11);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 	}
 }
 
@@ -308,6 +421,25 @@ TEST_CASE("String - Operator== & Operator!=", "[String]")
 		REQUIRE(!(s1 == "HeLlo"));
 		REQUIRE(!(s1 != "Hello"));
 	}
+	SECTION("Long")
+	{
+		String s1("Hello world, this doesn't fit in the object");
+		String s2("Hello world, this doesn't fit in the objecT");
+		String s3(s1);
+		REQUIRE(s1 != s2);
+		REQUIRE(s1 == s3);
+		REQUIRE(s1 != "Hello world, this doesn't fit in the objec");
+		REQUIRE(s1 == "Hello world, this doesn't fit in the object");
+	}
+	SECTION("Embedded null")
+	{
+		String s1(3, '\0');
+		String s2(2, '\0');
+		REQUIRE(s1.Length() == 3);
+		REQUIRE(s1 != s2);
+		REQUIRE(s1 == String(3, '\0'));
+		REQUIRE(s1 != "");
+	}
 	SECTION("wchar_t array")
 	{
 		String s1("Hello");
@@ -317,6 +449,45 @@ TEST_CASE("String - Operator== & Operator!=", "[String]")
 		REQUIRE(!(s1 == L"HeLlo"));
 		REQUIRE(!(s1 != L"Hello"));
 	}
+	SECTION("StringView")
+	{
+		String s1("Hello");
+		REQUIRE(s1 == StringView("Hello World", 5));
+		REQUIRE(s1 != StringView("Hello World"));
+		REQUIRE(StringView("Hello") == s1);
+		REQUIRE(StringView("HeLlo") != s1);
+		REQUIRE("Hello" == s1);
+		REQUIRE("HeLlo" != s1);
+	}
+}
+
+TEST_CASE("String - Operator<", "[String]")
+{
+	String s1("Apple");
+	String s2("Banana");
+	String s3("App");
+	REQUIRE(s1 < s2);
+	REQUIRE(!(s2 < s1));
+	REQUIRE(s3 < s1);
+	REQUIRE(!(s1 < s1));
+	REQUIRE(String() < s3);
+
+	REQUIRE(s1 < "Banana");
+	REQUIRE("App" < s1);
+	REQUIRE(!(s1 < "App"));
+	REQUIRE(s1 < StringView("Apples"));
+	REQUIRE(StringView("Apple", 3) < s1);
+}
+
+TEST_CASE("String - Hash", "[String]")
+{
+	String s1("Hello World");
+	String::Hash hash;
+	REQUIRE(hash(s1) == FNV1aHash("Hello World", 11));
+	REQUIRE(hash("Hello World") == hash(s1));
+	REQUIRE(hash(StringView("Hello World!", 11)) == hash(s1));
+	REQUIRE(hash(String()) == hash(""));
+	REQUIRE(hash("Hello") != hash(s1));
 }
 
 TEST_CASE("String - Accessors", "[String]")
@@ -339,22 +510,32 @@ TEST_CASE("String - Clear", "[String]")
 	{
 		String s;
 		REQUIRE(s.Size() == 0);
-		REQUIRE(s.Capacity() == 0);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		s.Clear();
 		REQUIRE(s.Size() == 0);
-		REQUIRE(s.Capacity() == 0);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 	}
 	SECTION("Non-empty")
 	{
 		String s("Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != s.end());
 		s.Clear();
 		REQUIRE(s.Size() == 0);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() == s.end());
 	}
+	SECTION("Heap")
+	{
+		String s("Hello world, this doesn't fit in the object");
+		REQUIRE(s.Size() == 43);
+		REQUIRE(s.Capacity() == 43);
+		s.Clear();
+		REQUIRE(s.Size() == 0);
+		REQUIRE(s.Capacity() == 43);
+		REQUIRE(s == "");
+	}
 }
 
 TEST_CASE("String - Resize", "[String]")
@@ -364,12 +545,25 @@ TEST_CASE("String - Resize", "[String]")
 		String s = "Hello";
 		char* pData = s.Data();
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 5);
-		s.Resize(10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		s.Resize(100);
 		REQUIRE(pData != s.Data());
 		pData = s.Data();
+		REQUIRE(s.Size() == 100);
+		REQUIRE(s.Capacity() == 100);
+		for (size_t i = 5; i < 100; ++i)
+		{
+			REQUIRE(s[i] == 0);
+		}
+	}
+	SECTION("Increase size in the object")
+	{
+		String s = "Hello";
+		char* pData = s.Data();
+		s.Resize(10);
+		REQUIRE(pData == s.Data());
 		REQUIRE(s.Size() == 10);
-		REQUIRE(s.Capacity() == 10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		for (size_t i = 5; i < 10; ++i)
 		{
 			REQUIRE(s[i] == 0);
@@ -377,12 +571,18 @@ TEST_CASE("String - Resize", "[String]")
 	}
 	SECTION("Decrease size")
 	{
-		String s = "Hello";
-		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 5);
+		String s = "Hello world, this doesn't fit in the object";
+		REQUIRE(s.Size() == 43);
+		REQUIRE(s.Capacity() == 43);
+		s.Resize(30);
+		REQUIRE(s.Size() == 30);
+		REQUIRE(s.Capacity() == 30);
+		//Moves back into the object
 		s.Resize(2);
 		REQUIRE(s.Size() == 2);
-		REQUIRE(s.Capacity() == 2);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(!s.IsLarge());
+		REQUIRE(s == "He");
 	}
 }
 
@@ -393,32 +593,34 @@ TEST_CASE("String - Reserve", "[String]")
 		String s = "Hello";
 		char* pData = s.Data();
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 5);
-		s.Reserve(10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		s.Reserve(100);
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 10);
+		REQUIRE(s.Capacity() == 100);
 		REQUIRE(s.Data() != pData);
+		REQUIRE(s == "Hello");
 		pData = s.Data();
-		s.Reserve(10);
+		s.Reserve(100);
 		REQUIRE(s.Data() == pData);
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 10);
+		REQUIRE(s.Capacity() == 100);
 	}
 	SECTION("Lower capacity")
 	{
 		String s = "Hello";
 		char* pData = s.Data();
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 5);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		s.Reserve(2);
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 5);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.Data() == pData);
-		pData = s.Data();
-		s.Reserve(10);
+		s.Reserve(String::LOCAL_CAPACITY);
+		REQUIRE(s.Data() == pData);
+		s.Reserve(100);
 		REQUIRE(s.Data() != pData);
 		REQUIRE(s.Size() == 5);
-		REQUIRE(s.Capacity() == 10);
+		REQUIRE(s.Capacity() == 100);
 	}
 }
 
@@ -428,32 +630,44 @@ TEST_CASE("String - ShrinkToFit", "[String]")
 	{
 		String s = "Hello";
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 5);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		s.Push('C');
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 6);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s == "HelloC");
 	}
 	SECTION("After resize")
 	{
 		String s = "Hello";
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 5);
-		s.Resize(10);
-		REQUIRE(s.Capacity() == 10);
-		REQUIRE(s.Size() == 10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		s.Resize(100);
+		REQUIRE(s.Capacity() == 100);
+		REQUIRE(s.Size() == 100);
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 10);
-		REQUIRE(s.Size() == 10);
+		REQUIRE(s.Capacity() == 100);
+		REQUIRE(s.Size() == 100);
 	}
 	SECTION("After reserve")
 	{
 		String s = "Hello";
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 5);
-		s.Reserve(10);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
+		s.Reserve(100);
+		REQUIRE(s.IsLarge());
 		s.ShrinkToFit();
-		REQUIRE(s.Capacity() == 5);
+		REQUIRE(!s.IsLarge());
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.Size() == 5);
+		REQUIRE(s == "Hello");
+	}
+	SECTION("Heap")
+	{
+		String s = "Hello world, this doesn't fit in the object";
+		s.Reserve(100);
+		s.ShrinkToFit();
+		REQUIRE(s.Capacity() == 43);
+		REQUIRE(s == "Hello world, this doesn't fit in the object");
 	}
 }
 
@@ -476,9 +690,26 @@ TEST_CASE("String - Push", "[String]")
 		REQUIRE(s.Size() == 3);
 		char* pData = s.Data();
 		s.Push('P');
-		REQUIRE(pData != s.Data());
-		pData = s.Data();
+		REQUIRE(pData == s.Data());
 		REQUIRE(s.Size() == 4);
+		REQUIRE(s == "HelP");
+	}
+	SECTION("Out of the object")
+	{
+		String s;
+		char* pData = s.Data();
+		for (size_t i = 0; i < String::LOCAL_CAPACITY; ++i)
+			s.Push('a');
+		REQUIRE(pData == s.Data());
+		REQUIRE(s.Size() == String::LOCAL_CAPACITY);
+		REQUIRE(!s.IsLarge());
+		REQUIRE(s.Data()[String::LOCAL_CAPACITY] == '\0');
+		s.Push('b');
+		REQUIRE(pData != s.Data());
+		REQUIRE(s.IsLarge());
+		REQUIRE(s.Size() == String::LOCAL_CAPACITY + 1);
+		REQUIRE(s.Back() == 'b');
+		REQUIRE(s.Front() == 'a');
 	}
 }
 
@@ -504,37 +735,40 @@ TEST_CASE("String - Swap", "[String]")
 	{
 		String s1 = "Hello";
 		String s2 = "Lol";
-		char* pData1 = s1.Data();
-		char* pData2 = s2.Data();
 		REQUIRE(s1.Size() == 5);
-		REQUIRE(s1.Capacity() == 5);
 		REQUIRE(s2.Size() == 3);
-		REQUIRE(s2.Capacity() == 3);
-		s1.StringSwap(s2);
+		s1.Swap(s2);
 		REQUIRE(s1.Size() == 3);
-		REQUIRE(s1.Capacity() == 3);
+		REQUIRE(s1.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s2.Size() == 5);
-		REQUIRE(s2.Capacity() == 5);
-		REQUIRE(s1.Data() == pData2);
-		REQUIRE(s2.Data() == pData1);
+		REQUIRE(s2.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(s1 == "Lol");
+		REQUIRE(s2 == "Hello");
 	}
 	SECTION("One filled")
 	{
 		String s1 = "Hello";
 		String s2;
-		char* pData1 = s1.Data();
-		char* pData2 = s2.Data();
 		REQUIRE(s1.Size() == 5);
-		REQUIRE(s1.Capacity() == 5);
 		REQUIRE(s2.Size() == 0);
-		REQUIRE(s2.Capacity() == 0);
-		s1.StringSwap(s2);
+		s1.Swap(s2);
 		REQUIRE(s1.Size() == 0);
-		REQUIRE(s1.Capacity() == 0);
+		REQUIRE(s1 == "");
 		REQUIRE(s2.Size() == 5);
-		REQUIRE(s2.Capacity() == 5);
-		REQUIRE(s1.Data() == pData2);
+		REQUIRE(s2 == "Hello");
+	}
+	SECTION("Heap")
+	{
+		String s1 = "Hello world, this doesn't fit in the object";
+		String s2 = "Lol";
+		char* pData1 = s1.Data();
+		s1.Swap(s2);
+		REQUIRE(s1 == "Lol");
 		REQUIRE(s2.Data() == pData1);
+		REQUIRE(s2.Capacity() == 43);
+		Swap(s1, s2);
+		REQUIRE(s1.Data() == pData1);
+		REQUIRE(s2 == "Lol");
 	}
 }
 
@@ -544,11 +778,9 @@ TEST_CASE("String - Assign multiple", "[String]")
 	{
 		String s = "Hello";
 		REQUIRE(s.Size() == 5);
-		char* pData = s.Data();
-		s.Assign(4, 10);
-		REQUIRE(pData != s.Data());
-		REQUIRE(s.Size() == 9);
-		REQUIRE(s.Capacity() == 9);
+		s.Assign(40, 10);
+		REQUIRE(s.Size() == 45);
+		REQUIRE(s.Capacity() == 45);
 		for (size_t i = 5; i < s.Size(); ++i)
 		{
 			REQUIRE(s[i] == 10);
@@ -591,7 +823,8 @@ TEST_CASE("String - Insert", "[String]")
 		String s = "Hello";
 		char* pData = s.Data();
 		s.Insert(2, 'A');
-		REQUIRE(pData != s.Data());
+		//Still fits in the object
+		REQUIRE(pData == s.Data());
 		REQUIRE(s[0] == 'H');
 		REQUIRE(s[1] == 'e');
 		REQUIRE(s[2] == 'A');
@@ -660,13 +893,38 @@ TEST_CASE("String - Insert", "[String]")
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
 	}
+	SECTION("char array - Out of the object")
+	{
+		String s = "Hello";
+		s.Insert(1, " world, this doesn't fit in the object ");
+		REQUIRE(s == "H world, this doesn't fit in the object ello");
+		REQUIRE(s.Size() == 44);
+		REQUIRE(s.IsLarge());
+	}
+	SECTION("char array - From itself")
+	{
+		//In place with the data before, around and after the index, then growing
+		String s = "Hello";
+		s.Reserve(100);
+		s.Insert(4, s.Data() + 3);
+		REQUIRE(s == "Hellloo");
+		s.Insert(2, s.Data() + 1);
+		REQUIRE(s == "Heellloollloo");
+		s.Insert(0, s.Data() + 9);
+		REQUIRE(s == "llooHeellloollloo");
+
+		String large = "A string that is already on the heap";
+		REQUIRE(large.Capacity() < 72);
+		large.Insert(9, large.Data());
+		REQUIRE(large == "A string A string that is already on the heapthat is already on the heap");
+	}
 	SECTION("char array - From empty string")
 	{
 		String s;
 		s.Append("Hello world");
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.begin() != s.end());
@@ -681,7 +939,7 @@ TEST_CASE("String - Append", "[String]")
 		s.Append(" world");
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.begin() != s.end());
@@ -692,7 +950,7 @@ TEST_CASE("String - Append", "[String]")
 		s.Append(L"Hello world");
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.begin() != s.end());
@@ -703,11 +961,134 @@ TEST_CASE("String - Append", "[String]")
 		s.Append(L" world");
 		REQUIRE(s == "Hello world");
 		REQUIRE(s.Size() == 11);
-		REQUIRE(s.Capacity() == 11);
+		REQUIRE(s.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(s.begin() != nullptr);
 		REQUIRE(s.end() != nullptr);
 		REQUIRE(s.begin() != s.end());
 	}
+	SECTION("Geometric growth")
+	{
+		String s;
+		size_t reallocations = 0;
+		const char* pData = s.Data();
+		for (int i = 0; i < 10000; ++i)
+		{
+			s.Append("ab");
+			if (s.Data() != pData)
+			{
+				++reallocations;
+				pData = s.Data();
+			}
+		}
+		REQUIRE(s.Size() == 20000);
+		REQUIRE(s.Capacity() >= 20000);
+		REQUIRE(reallocations < 30);
+		REQUIRE(s[19998] == 'a');
+		REQUIRE(s[19999] == 'b');
+	}
+	SECTION("Grows to the needed size")
+	{
+		String s("Hello world, this doesn't fit in the object");
+		const size_t capacity = s.Capacity();
+		s.Append(1000, 'x');
+		REQUIRE(s.Size() == 1043);
+		REQUIRE(s.Capacity() == 1043);
+		s.Push('x');
+		REQUIRE(s.Capacity() > 1043 + capacity);
+	}
+	SECTION("Char run")
+	{
+		String s("a");
+		s.Append(3, 'b').Append((size_t)0, 'c');
+		REQUIRE(s == "abbb");
+		s.Append(30, '-');
+		REQUIRE(s.Size() == 34);
+		REQUIRE(s[33] == '-');
+		REQUIRE(s.Data()[34] == '\0');
+	}
+	SECTION("StringView")
+	{
+		String s("Hello");
+		s.Append(StringView(" world, ignored", 6));
+		REQUIRE(s == "Hello world");
+	}
+	SECTION("Chained")
+	{
+		String s;
+		s.Append("x = ").AppendNumber(42).Append(", y = ").AppendNumber(-7);
+		s += '!';
+		REQUIRE(s == "x = 42, y = -7!");
+	}
+}
+
+TEST_CASE("String - AppendNumber", "[String]")
+{
+	SECTION("Signed")
+	{
+		String s;
+		s.AppendNumber(0).Append(' ').AppendNumber(-1).Append(' ').AppendNumber(2147483647).Append(' ').AppendNumber((int)(-2147483647 - 1));
+		REQUIRE(s == "0 -1 2147483647 -2147483648");
+	}
+	SECTION("64 bits")
+	{
+		String s;
+		s.AppendNumber(-9223372036854775807ll - 1);
+		REQUIRE(s == "-9223372036854775808");
+		s.Clear();
+		s.AppendNumber(18446744073709551615ull);
+		REQUIRE(s == "18446744073709551615");
+		REQUIRE(s.Size() == 20);
+	}
+	SECTION("Unsigned")
+	{
+		String s;
+		s.AppendNumber(4294967295u).Append(' ').AppendNumber((size_t)12);
+		REQUIRE(s == "4294967295 12");
+	}
+	SECTION("Floating point")
+	{
+		String s;
+		s.AppendNumber(1.5).Append(' ').AppendNumber(-0.125, 2).Append(' ').AppendNumber(2.0f, 0);
+		REQUIRE(s == "1.500000 -0.12 2");
+	}
+}
+
+TEST_CASE("String - AppendFormat", "[String]")
+{
+	SECTION("In the object")
+	{
+		String s("id");
+		s.AppendFormat(": %d", 12);
+		REQUIRE(s == "id: 12");
+		REQUIRE(!s.IsLarge());
+	}
+	SECTION("Fills the object")
+	{
+		String s;
+		s.AppendFormat("%0*d", (int)String::LOCAL_CAPACITY, 7);
+		REQUIRE(s.Size() == String::LOCAL_CAPACITY);
+		REQUIRE(!s.IsLarge());
+		REQUIRE(s[String::LOCAL_CAPACITY - 1] == '7');
+		REQUIRE(s.Data()[String::LOCAL_CAPACITY] == '\0');
+	}
+	SECTION("Out of the object")
+	{
+		String s("Hello");
+		s.AppendFormat(" %s %d", "world, this doesn't fit in the object", 42);
+		REQUIRE(s == "Hello world, this doesn't fit in the object 42");
+		REQUIRE(s.IsLarge());
+	}
+	SECTION("On the heap")
+	{
+		String s("Hello world, this doesn't fit in the object");
+		s.Reserve(100);
+		const char* pData = s.Data();
+		s.AppendFormat("%s", "!");
+		REQUIRE(s.Data() == pData);
+		REQUIRE(s.Size() == 44);
+		s.AppendFormat("%200s", "");
+		REQUIRE(s.Size() == 244);
+	}
 }
 
 TEST_CASE("String - Substring", "[String]")
@@ -717,15 +1098,15 @@ TEST_CASE("String - Substring", "[String]")
 		String s;
 		String output = s.Substring(0);
 		REQUIRE(output.Size() == 0);
-		REQUIRE(output.Capacity() == 0);
-		REQUIRE(output.Data() == nullptr);
+		REQUIRE(output.Capacity() == String::LOCAL_CAPACITY);
+		REQUIRE(*output.Data() == '\0');
 	}
 	SECTION("No length")
 	{
 		String s = "Hello World";
 		String output = s.Substring(6);
 		REQUIRE(output.Size() == 5);
-		REQUIRE(output.Capacity() == 5);
+		REQUIRE(output.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(output.Data() != nullptr);
 		REQUIRE(output == "World");
 	}
@@ -734,7 +1115,7 @@ TEST_CASE("String - Substring", "[String]")
 		String s = "Hello World";
 		String output = s.Substring(6, 5);
 		REQUIRE(output.Size() == 5);
-		REQUIRE(output.Capacity() == 5);
+		REQUIRE(output.Capacity() == String::LOCAL_CAPACITY);
 		REQUIRE(output.Data() != nullptr);
 		REQUIRE(output == "World");
 	}
@@ -772,6 +1153,35 @@ TEST_CASE("String - Find", "[String]")
 		String s2;
 		REQUIRE(s2.Find(String("llo")) == String::Npos);
 	}
+	SECTION("char array")
+	{
+		String s1 = "Hello World Hello";
+		REQUIRE(s1.Find("llo") == 2);
+		REQUIRE(s1.Find("Test") == String::Npos);
+		REQUIRE(s1.Find("") == String::Npos);
+
+		String s2;
+		REQUIRE(s2.Find("llo") == String::Npos);
+	}
+	SECTION("At the end")
+	{
+		String s1 = "Hello World";
+		REQUIRE(s1.Find("World") == 6);
+		REQUIRE(s1.Find("d") == 10);
+		REQUIRE(s1.Find("Hello World") == 0);
+		REQUIRE(s1.Find("Hello World!") == String::Npos);
+	}
+	SECTION("Long string")
+	{
+		String s1(1000, 'a');
+		s1.Append("needle in the haystack, long enough for the skips");
+		s1.Append(100, 'b');
+		REQUIRE(s1.Find("needle") == 1000);
+		REQUIRE(s1.Find("needle in the haystack, long enough for the skips") == 1000);
+		REQUIRE(s1.Find('n') == 1000);
+		REQUIRE(s1.Find("bbbb") == 1049);
+		REQUIRE(s1.Find("needle in the haystack, long enough for the trees") == String::Npos);
+	}
 }
 
 TEST_CASE("String - RFind", "[String]")
@@ -812,6 +1222,24 @@ TEST_CASE("String - RFind", "[String]")
 		String s2;
 		REQUIRE(s2.RFind("llo") == String::Npos);
 	}
+	SECTION("At the start")
+	{
+		String s1 = "Hello World";
+		REQUIRE(s1.RFind("Hello") == 0);
+		REQUIRE(s1.RFind("H") == 0);
+		REQUIRE(s1.RFind("Hello World") == 0);
+	}
+	SECTION("Long string")
+	{
+		String s1(100, 'b');
+		s1.Append("needle in the haystack, long enough for the skips");
+		s1.Append(1000, 'a');
+		REQUIRE(s1.RFind("needle") == 100);
+		REQUIRE(s1.RFind("needle in the haystack, long enough for the skips") == 100);
+		REQUIRE(s1.RFind('n') == 130);
+		REQUIRE(s1.RFind("bbbb") == 96);
+		REQUIRE(s1.RFind("needle in the haystack, long enough for the trees") == String::Npos);
+	}
 }
 
 #pragma endregion Search
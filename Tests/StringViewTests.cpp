@@ -0,0 +1,242 @@
+#include "../catch.hpp"
+#include "../Std/StringView.h"
+#include "../Std/String.h"
+#include "../Std/HashMap.h"
+#include "../Std/Map.h"
+using namespace StlStd;
+
+TEST_CASE("StringView - Constructor", "[StringView]")
+{
+	SECTION("Empty")
+	{
+		StringView view;
+		REQUIRE(view.Empty());
+		REQUIRE(view.Size() == 0);
+		REQUIRE(view.Data() == nullptr);
+	}
+	SECTION("char array")
+	{
+		const char* pData = "Hello World";
+		StringView view(pData);
+		REQUIRE(view.Data() == pData);
+		REQUIRE(view.Size() == 11);
+		REQUIRE(view.Length() == 11);
+		REQUIRE(view[4] == 'o');
+	}
+	SECTION("char array with size")
+	{
+		const char* pData = "Hello World";
+		StringView view(pData + 6, 5);
+		REQUIRE(view.Data() == pData + 6);
+		REQUIRE(view.Size() == 5);
+		REQUIRE(view == "World");
+	}
+}
+
+TEST_CASE("StringView - Comparison", "[StringView]")
+{
+	StringView hello("Hello World", 5);
+	REQUIRE(hello == StringView("Hello"));
+	REQUIRE(hello != StringView("Hello World"));
+	REQUIRE(hello != StringView("HeLlo"));
+	REQUIRE(StringView() == StringView(""));
+
+	REQUIRE(StringView("Apple") < StringView("Banana"));
+	REQUIRE(StringView("App") < StringView("Apple"));
+	REQUIRE(!(StringView("Apple") < StringView("Apple")));
+	REQUIRE(StringView() < StringView("A"));
+
+	REQUIRE(StringView("Banana") > StringView("Apple"));
+	REQUIRE(StringView("Apple") <= StringView("Apple"));
+	REQUIRE(StringView("Apple") >= StringView("App"));
+	REQUIRE(StringView("Apple").Compare(StringView("Apple")) == 0);
+	REQUIRE(StringView("Apple").Compare(StringView("Apples")) < 0);
+	REQUIRE(StringView("b").Compare(StringView("abc")) > 0);
+}
+
+TEST_CASE("StringView - Find", "[StringView]")
+{
+	StringView view("key = value = other", 11);
+	SECTION("char")
+	{
+		REQUIRE(view.Find('=') == 4);
+		REQUIRE(view.RFind('e') == 10);
+		//The characters after the view aren't part of it
+		REQUIRE(view.Find('o') == StringView::Npos);
+		REQUIRE(StringView().Find('a') == StringView::Npos);
+	}
+	SECTION("StringView")
+	{
+		REQUIRE(view.Find(" = ") == 3);
+		REQUIRE(view.RFind("e") == 10);
+		REQUIRE(view.Find("value") == 6);
+		REQUIRE(view.RFind("key") == 0);
+		REQUIRE(view.Find("value = ") == StringView::Npos);
+		REQUIRE(view.Find("") == StringView::Npos);
+		REQUIRE(StringView().Find("a") == StringView::Npos);
+	}
+	SECTION("StartsWith & EndsWith")
+	{
+		REQUIRE(view.StartsWith("key"));
+		REQUIRE(view.EndsWith("value"));
+		REQUIRE(!view.EndsWith("other"));
+		REQUIRE(view.StartsWith(""));
+		REQUIRE(!StringView("ke").StartsWith("key"));
+	}
+}
+
+TEST_CASE("StringView - Substring", "[StringView]")
+{
+	const char* pData = "Hello World";
+	StringView view(pData);
+	SECTION("With length")
+	{
+		StringView world = view.Substring(6, 5);
+		REQUIRE(world == "World");
+		REQUIRE(world.Data() == pData + 6);
+	}
+	SECTION("No length")
+	{
+		REQUIRE(view.Substring(6) == "World");
+		REQUIRE(view.Substring(11).Empty());
+	}
+	SECTION("Clamped length")
+	{
+		REQUIRE(view.Substring(6, 100) == "World");
+	}
+	SECTION("Iteration")
+	{
+		String copy;
+		for (const char c : view.Substring(0, 5))
+			copy.Push(c);
+		REQUIRE(copy == "Hello");
+		REQUIRE(view.Front() == 'H');
+		REQUIRE(view.Back() == 'd');
+	}
+}
+
+TEST_CASE("StringView - Split", "[StringView]")
+{
+	SECTION("char")
+	{
+		const char* pData = "a,bc,,def";
+		Vector<StringView> parts = StringView(pData).Split(',');
+		REQUIRE(parts.Size() == 4);
+		REQUIRE(parts[0] == "a");
+		REQUIRE(parts[1] == "bc");
+		REQUIRE(parts[2].Empty());
+		REQUIRE(parts[3] == "def");
+		REQUIRE(parts[3].Data() == pData + 6);
+	}
+	SECTION("StringView")
+	{
+		Vector<StringView> parts = StringView("key = value = other").Split(" = ");
+		REQUIRE(parts.Size() == 3);
+		REQUIRE(parts[0] == "key");
+		REQUIRE(parts[1] == "value");
+		REQUIRE(parts[2] == "other");
+	}
+	SECTION("Delimiters at the ends")
+	{
+		Vector<StringView> parts = StringView("\nline\n").Split('\n');
+		REQUIRE(parts.Size() == 3);
+		REQUIRE(parts[0].Empty());
+		REQUIRE(parts[1] == "line");
+		REQUIRE(parts[2].Empty());
+	}
+	SECTION("No delimiter")
+	{
+		Vector<StringView> parts = StringView("line").Split('\n');
+		REQUIRE(parts.Size() == 1);
+		REQUIRE(parts[0] == "line");
+
+		Vector<StringView> empty = StringView().Split('\n');
+		REQUIRE(empty.Size() == 1);
+		REQUIRE(empty[0].Empty());
+	}
+}
+
+TEST_CASE("StringView - Hash", "[StringView]")
+{
+	StringView view("Hello World!", 11);
+	REQUIRE(view.GetHash() == FNV1aHash("Hello World", 11));
+	REQUIRE(StringView::Hash()(view) == view.GetHash());
+}
+
+TEST_CASE("StringView - String", "[StringView]")
+{
+	String s("Hello world, this doesn't fit in the object");
+	SECTION("View")
+	{
+		StringView view = s.View();
+		REQUIRE(view.Data() == s.Data());
+		REQUIRE(view.Size() == s.Size());
+		REQUIRE(view.GetHash() == s.GetHash());
+	}
+	SECTION("SubView")
+	{
+		StringView world = s.SubView(6, 5);
+		REQUIRE(world == "world");
+		REQUIRE(world.Data() == s.Data() + 6);
+		REQUIRE(s.SubView(13) == "this doesn't fit in the object");
+		REQUIRE(s.Find(world) == 6);
+		REQUIRE(s.RFind(StringView("the")) == 33);
+	}
+	SECTION("To String")
+	{
+		String world(s.SubView(6, 5));
+		REQUIRE(world == "world");
+		REQUIRE(String(StringView()).Empty());
+	}
+}
+
+TEST_CASE("StringView - Keys", "[StringView]")
+{
+	//A config is split in views and looked up without a String for each token
+	const char* pConfig = "width=1280\nheight=720\nfullscreen=1";
+	Vector<StringView> lines = StringView(pConfig).Split('\n');
+	SECTION("HashMap of views")
+	{
+		HashMap<StringView, StringView, StringView::Hash> settings;
+		for (size_t i = 0; i < lines.Size(); ++i)
+		{
+			const size_t equal = lines[i].Find('=');
+			settings[lines[i].Substring(0, equal)] = lines[i].Substring(equal + 1);
+		}
+		REQUIRE(settings.Size() == 3);
+		REQUIRE(settings[StringView("height")] == "720");
+		REQUIRE(settings.Find(StringView("depth")) == settings.End());
+	}
+	SECTION("HashMap of String looked up by view")
+	{
+		HashMap<String, int, String::Hash, EqualTo<>> settings;
+		settings[String("width")] = 0;
+		settings[String("height")] = 0;
+		for (size_t i = 0; i < lines.Size(); ++i)
+		{
+			auto it = settings.Find(lines[i].Substring(0, lines[i].Find('=')));
+			if (it != settings.End())
+				++it->Value;
+		}
+		REQUIRE(settings[String("width")] == 1);
+		REQUIRE(settings[String("height")] == 1);
+		REQUIRE(settings.Size() == 2);
+	}
+	SECTION("Map of String looked up by view")
+	{
+		Map<String, int, LessThan<>> settings;
+		settings[String("fullscreen")] = 0;
+		StringView key = lines[2].Substring(0, lines[2].Find('='));
+		REQUIRE(settings.Contains(key));
+		REQUIRE(settings.Find(key) != settings.End());
+		REQUIRE(!settings.Contains(StringView("full")));
+	}
+	SECTION("Map of views")
+	{
+		Map<StringView, int> settings;
+		for (size_t i = 0; i < lines.Size(); ++i)
+			settings[lines[i].Substring(0, lines[i].Find('='))] = (int)i;
+		REQUIRE(settings[StringView("fullscreen")] == 2);
+		REQUIRE(settings.Begin()->Key == "fullscreen");
+	}
+}
@@ -0,0 +1,108 @@
+#include "../catch.hpp"
+#include "../Std/TaskScheduler.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+using namespace StlStd;
+
+namespace
+{
+	//Spawns both branches and waits for them, so groups are nested as deep as the recursion
+	long long Fibonacci(const int n, TaskScheduler& scheduler)
+	{
+		if (n < 2)
+			return n;
+		long long a = 0;
+		TaskGroup group(scheduler);
+		group.Run([&a, n, &scheduler]() { a = Fibonacci(n - 1, scheduler); });
+		const long long b = Fibonacci(n - 2, scheduler);
+		group.Wait();
+		return a + b;
+	}
+}
+
+TEST_CASE("TaskScheduler - Run and Wait", "[TaskScheduler]")
+{
+	TaskScheduler scheduler(4);
+	REQUIRE(scheduler.GetThreadCount() == 4);
+
+	SECTION("Every task runs once")
+	{
+		std::vector<std::atomic<int>> runs(10000);
+		TaskGroup group(scheduler);
+		for (size_t i = 0; i < runs.size(); ++i)
+			group.Run([&runs, i]() { ++runs[i]; });
+		group.Wait();
+		for (size_t i = 0; i < runs.size(); ++i)
+			REQUIRE(runs[i] == 1);
+	}
+	SECTION("Nested groups")
+	{
+		REQUIRE(Fibonacci(20, scheduler) == 6765);
+	}
+	SECTION("Groups on several threads")
+	{
+		//Threads that aren't part of the scheduler share a queue
+		std::atomic<int> count(0);
+		std::vector<std::thread> threads;
+		for (int t = 0; t < 4; ++t)
+		{
+			threads.emplace_back([&count, &scheduler]()
+			{
+				TaskGroup group(scheduler);
+				for (int i = 0; i < 1000; ++i)
+					group.Run([&count]() { ++count; });
+			});
+		}
+		for (std::thread& thread : threads)
+			thread.join();
+		REQUIRE(count == 4000);
+	}
+	SECTION("Large functors")
+	{
+		//Too large for the SmallObjectPool
+		char data[2000] = { 1 };
+		std::atomic<int> sum(0);
+		TaskGroup group(scheduler);
+		for (int i = 0; i < 100; ++i)
+			group.Run([data, &sum]() { sum += data[0]; });
+		group.Wait();
+		REQUIRE(sum == 100);
+	}
+}
+
+TEST_CASE("TaskScheduler - Single thread", "[TaskScheduler]")
+{
+	//The tasks run on the thread that waits
+	TaskScheduler scheduler(1);
+	const std::thread::id caller = std::this_thread::get_id();
+	bool onCaller = true;
+	{
+		TaskGroup group(scheduler);
+		for (int i = 0; i < 100; ++i)
+			group.Run([&onCaller, caller]() { onCaller = onCaller && std::this_thread::get_id() == caller; });
+	}
+	REQUIRE(onCaller);
+	REQUIRE(Fibonacci(15, scheduler) == 610);
+}
+
+TEST_CASE("TaskScheduler - ParallelFor", "[TaskScheduler]")
+{
+	TaskScheduler scheduler(3);
+	std::vector<std::atomic<int>> visits(100003);
+	std::atomic<size_t> largestPiece(0);
+	ParallelFor(0, visits.size(), 1000, [&](size_t begin, size_t end)
+	{
+		for (size_t i = begin; i < end; ++i)
+			++visits[i];
+		size_t largest = largestPiece.load();
+		while (end - begin > largest && !largestPiece.compare_exchange_weak(largest, end - begin));
+	}, scheduler);
+	for (size_t i = 0; i < visits.size(); ++i)
+		REQUIRE(visits[i] == 1);
+	REQUIRE(largestPiece <= 1000);
+
+	int calls = 0;
+	ParallelFor(5, 5, 10, [&calls](size_t, size_t) { ++calls; }, scheduler);
+	REQUIRE(calls == 0);
+}
@@ -1,7 +1,36 @@
 #include "../catch.hpp"
 #include "../Std/Vector.h"
+#include "../Std/String.h"
 using namespace StlStd;
 
+namespace
+{
+	//Counts the live objects and how they were made, the vector must construct and destroy each of them exactly once
+	struct Tracked
+	{
+		static int Alive;
+		static int Copies;
+		static int Moves;
+
+		Tracked() : Value(0) { ++Alive; }
+		Tracked(const int value) : Value(value) { ++Alive; }
+		Tracked(const int a, const int b) : Value(a * 10 + b) { ++Alive; }
+		Tracked(const Tracked& other) : Value(other.Value) { ++Alive; ++Copies; }
+		Tracked(Tracked&& other) : Value(other.Value) { other.Value = -1; ++Alive; ++Moves; }
+		~Tracked() { --Alive; }
+		Tracked& operator=(const Tracked& other) { Value = other.Value; ++Copies; return *this; }
+		Tracked& operator=(Tracked&& other) { Value = other.Value; other.Value = -1; ++Moves; return *this; }
+		bool operator!=(const Tracked& other) const { return Value != other.Value; }
+
+		static void Reset() { Alive = 0; Copies = 0; Moves = 0; }
+
+		int Value;
+	};
+	int Tracked::Alive = 0;
+	int Tracked::Copies = 0;
+	int Tracked::Moves = 0;
+}
+
 #pragma region Constructors
 
 TEST_CASE("Vector - Constructor", "[Vector]")
@@ -15,6 +44,14 @@ TEST_CASE("Vector - Constructor", "[Vector]")
 		REQUIRE(v.begin() == nullptr);
 		REQUIRE(v.end() == nullptr);
 	}
+	SECTION("Literal zero size")
+	{
+		//0 is the size, not a null memory resource
+		Vector<int> v(0);
+		REQUIRE(v.Size() == 0);
+		REQUIRE(v.Empty());
+		REQUIRE(v.GetResource() == GetDefaultResource());
+	}
 	SECTION("int")
 	{
 		const size_t size = 5;
@@ -432,7 +469,7 @@ TEST_CASE("Vector - Swap", "[Vector]")
 		REQUIRE(v1.Capacity() == 5);
 		REQUIRE(v2.Size() == 3);
 		REQUIRE(v2.Capacity() == 3);
-		v1.SwapVector(v2);
+		v1.Swap(v2);
 		REQUIRE(v1.Size() == 3);
 		REQUIRE(v1.Capacity() == 3);
 		REQUIRE(v2.Size() == 5);
@@ -450,7 +487,7 @@ TEST_CASE("Vector - Swap", "[Vector]")
 		REQUIRE(v1.Capacity() == 5);
 		REQUIRE(v2.Size() == 0);
 		REQUIRE(v2.Capacity() == 0);
-		v1.SwapVector(v2);
+		v1.Swap(v2);
 		REQUIRE(v1.Size() == 0);
 		REQUIRE(v1.Capacity() == 0);
 		REQUIRE(v2.Size() == 5);
@@ -603,6 +640,108 @@ TEST_CASE("Vector - Find", "[Vector]")
 
 #pragma endregion Search
 
+#pragma region Construction
+
+TEST_CASE("Vector - Construction of items", "[Vector]")
+{
+	Tracked::Reset();
+	SECTION("Reserve doesn't construct")
+	{
+		Vector<Tracked> v;
+		v.Reserve(100);
+		REQUIRE(Tracked::Alive == 0);
+		v.Push(Tracked(1));
+		REQUIRE(Tracked::Alive == 1);
+		v.Resize(3);
+		REQUIRE(Tracked::Alive == 3);
+		REQUIRE(v[0].Value == 1);
+		REQUIRE(v[2].Value == 0);
+	}
+	SECTION("Growth moves")
+	{
+		Vector<Tracked> v;
+		for (int i = 0; i < 100; ++i)
+			v.Push(Tracked(i));
+		REQUIRE(Tracked::Alive == 100);
+		REQUIRE(Tracked::Copies == 0);
+		for (int i = 0; i < 100; ++i)
+			REQUIRE(v[(size_t)i].Value == i);
+	}
+	SECTION("EmplaceBack")
+	{
+		Vector<Tracked> v;
+		Tracked& item = v.EmplaceBack(4, 2);
+		REQUIRE(item.Value == 42);
+		REQUIRE(&item == &v.Back());
+		REQUIRE(Tracked::Copies == 0);
+		REQUIRE(Tracked::Moves == 0);
+		v.EmplaceBack();
+		REQUIRE(v.Size() == 2);
+		REQUIRE(v[1].Value == 0);
+	}
+	SECTION("Push an item of the vector")
+	{
+		Vector<Tracked> v = { Tracked(1), Tracked(2), Tracked(3) };
+		REQUIRE(v.Size() == v.Capacity());
+		v.Push(v[0]);
+		REQUIRE(v.Size() == 4);
+		REQUIRE(v[3].Value == 1);
+		v.Insert(1, v[3]);
+		REQUIRE(v[1].Value == 1);
+		REQUIRE(v[4].Value == 1);
+	}
+	SECTION("Erase destroys")
+	{
+		Vector<Tracked> v = { Tracked(1), Tracked(2), Tracked(3), Tracked(4) };
+		REQUIRE(Tracked::Alive == 4);
+		v.EraseAt(1);
+		REQUIRE(Tracked::Alive == 3);
+		v.SwapEraseAt(0);
+		REQUIRE(Tracked::Alive == 2);
+		REQUIRE(v[0].Value == 4);
+		REQUIRE(v.Pop().Value == 3);
+		REQUIRE(Tracked::Alive == 1);
+		v.Clear();
+		REQUIRE(Tracked::Alive == 0);
+		REQUIRE(v.Capacity() == 4);
+	}
+	SECTION("Copy and move")
+	{
+		Vector<Tracked> v1 = { Tracked(1), Tracked(2) };
+		Vector<Tracked> v2(v1);
+		REQUIRE(Tracked::Alive == 4);
+		Vector<Tracked> v3;
+		v3 = Move(v1);
+		REQUIRE(Tracked::Alive == 4);
+		REQUIRE(v1.Empty());
+		v2 = v3;
+		REQUIRE(Tracked::Alive == 4);
+		REQUIRE(v2[1].Value == 2);
+	}
+	REQUIRE(Tracked::Alive == 0);
+}
+
+TEST_CASE("Vector - String items", "[Vector]")
+{
+	Vector<String> v;
+	for (int i = 0; i < 50; ++i)
+		v.Push(String::Printf("Item %d, this doesn't fit in the object", i));
+	Vector<String> copy(v);
+	v.Insert(0, String("First"));
+	v.EraseAt(10);
+	v.Resize(20);
+	v.ShrinkToFit();
+	REQUIRE(v.Size() == 20);
+	REQUIRE(v[0] == "First");
+	REQUIRE(v[1] == "Item 0, this doesn't fit in the object");
+	REQUIRE(v[10] == "Item 10, this doesn't fit in the object");
+	REQUIRE(copy[49] == "Item 49, this doesn't fit in the object");
+	copy = v;
+	REQUIRE(copy == v);
+}
+
+#pragma endregion Construction
+
 #pragma region Misc
 
 TEST_CASE("Vector - Conversion", "[Vector]")